@@ -0,0 +1,48 @@
+#!/bin/bash
+#
+# Benchmark: reparse a source file versus loading its binary AST image (written with --emit-ast).
+#
+# Usage: bench_ast_image.sh [number of statements] [path to cq_parser]
+#
+
+NUM_OF_STMTS=${1:-100000}
+PARSER=$(cd "$(dirname "${2:-./cq_parser}")" && pwd)/$(basename "${2:-./cq_parser}")
+WORK_DIR=$(mktemp -d "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+awk -v n="$NUM_OF_STMTS" 'BEGIN {
+    printf "const int[%d] table = {", n;
+    for (i = 0; i < n; ++i) {
+        printf "%s%d", (i > 0) ? ", " : "", i % 100;
+    }
+    printf "};\n\nvoid main() {\n    int a = 0;\n";
+    for (i = 0; i < n; ++i) {
+        if (i % 2 == 0) {
+            printf "    a += table[%d];\n", i;
+        } else {
+            printf "    a -= %d * (a + %d);\n", i % 7, i % 5;
+        }
+    }
+    printf "}\n";
+}' > "$WORK_DIR/bench.cq"
+
+cd "$WORK_DIR" || exit 1
+"$PARSER" bench.cq --emit-ast bench.cqa || exit 1
+printf "Reparsing %s statements (%s bytes) versus loading their AST image (%s bytes)\n" \
+       "$NUM_OF_STMTS" "$(wc -c < bench.cq | tr -d ' ')" "$(wc -c < bench.cqa | tr -d ' ')"
+TIMEFORMAT="|- %R s wall, %U s user, %S s sys"
+printf "|- parse\n"
+time "$PARSER" bench.cq || exit 1
+printf "|- parse and write image\n"
+time "$PARSER" bench.cq --emit-ast bench.cqa || exit 1
+printf "|- load image\n"
+time "$PARSER" --load-ast bench.cqa || exit 1
+
+"$PARSER" bench.cq --dump && mv tree_dump.out parsed_tree_dump.out && mv symbol_table_dump.out parsed_symbol_table_dump.out
+"$PARSER" --load-ast bench.cqa --dump || exit 1
+if cmp -s tree_dump.out parsed_tree_dump.out && cmp -s symbol_table_dump.out parsed_symbol_table_dump.out; then
+    printf "|- dumps of parsed and loaded tree match\n"
+else
+    printf "|- dumps of parsed and loaded tree differ\n"
+    exit 1
+fi
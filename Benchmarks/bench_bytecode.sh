@@ -0,0 +1,42 @@
+#!/bin/bash
+#
+# Benchmark: run a loop-heavy classical program once through the AST walker of --simulate and once compiled to
+# bytecode (see --run), and report wall time of both, the speedup and whether both agree on the value of main.
+#
+# Usage: bench_bytecode.sh [number of outer iterations] [path to cq_parser]
+#
+
+NUM_OF_ITERATIONS=${1:-100000}
+PARSER=${2:-./cq_parser}
+BENCH_FILE=$(mktemp "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -f "$BENCH_FILE"' EXIT
+
+awk -v n="$NUM_OF_ITERATIONS" 'BEGIN {
+    printf "bool marker(int x) {\n    return x %% 7 == 3;\n}\n\n";
+    printf "int fib(unsigned n) {\n    int a = 0;\n    int b = 1;\n";
+    printf "    for (unsigned i = 0; i < n; i += 1) {\n        int t = a + b;\n        a = b;\n        b = t;\n    }\n";
+    printf "    return a;\n}\n\n";
+    printf "int main() {\n    int[8] table = {3, 1, 4, 1, 5, 9, 2, 6};\n    int sum = 0;\n";
+    printf "    for (int i = 0; i < %d; i += 1) {\n", n;
+    printf "        for (unsigned j = 0; j < 8; j += 1) {\n            sum += table[j] * i;\n        }\n";
+    printf "        if (marker(i)) {\n            sum -= i;\n        }\n";
+    printf "        switch (i %% 3) {\n            case 0:\n                sum += 1;\n";
+    printf "            case 1:\n                sum ^= 5;\n            default:\n                sum -= 2;\n        }\n";
+    printf "        unsigned k = 0;\n        do {\n            k += 1;\n        } while (k < 4);\n";
+    printf "    }\n    return sum + fib(20);\n}\n";
+}' > "$BENCH_FILE"
+
+printf "Running %s outer iterations of a classical program\n" "$NUM_OF_ITERATIONS"
+START=$(date +%s.%N)
+WALKER_RESULT=$("$PARSER" --simulate "$BENCH_FILE" | tail -n 1)
+MIDDLE=$(date +%s.%N)
+BYTECODE_OUTPUT=$("$PARSER" --run "$BENCH_FILE")
+END=$(date +%s.%N)
+WALKER_SECONDS=$(awk -v a="$START" -v b="$MIDDLE" 'BEGIN { print b - a }')
+BYTECODE_SECONDS=$(awk -v a="$MIDDLE" -v b="$END" 'BEGIN { print b - a }')
+BYTECODE_RESULT=$(echo "$BYTECODE_OUTPUT" | tail -n 1)
+printf "|- AST walker: %s in %.3f s\n" "$WALKER_RESULT" "$WALKER_SECONDS"
+printf "|- Bytecode:   %s in %.3f s\n" "$BYTECODE_RESULT" "$BYTECODE_SECONDS"
+printf "|- %s\n" "$(echo "$BYTECODE_OUTPUT" | head -n 1)"
+printf "|- Speedup %.1fx, results %s\n" "$(awk -v a="$WALKER_SECONDS" -v b="$BYTECODE_SECONDS" 'BEGIN { print a / b }')" \
+    "$([ "$WALKER_RESULT" = "$BYTECODE_RESULT" ] && echo match || echo differ)"
@@ -0,0 +1,30 @@
+#!/bin/bash
+#
+# Benchmark: parse a batch of files with a cold and then with a warm cache directory (see --cache-dir).
+#
+# Usage: bench_cache.sh [number of files] [path to cq_parser]
+#
+
+NUM_OF_FILES=${1:-200}
+PARSER=$(cd "$(dirname "${2:-./cq_parser}")" && pwd)/$(basename "${2:-./cq_parser}")
+WORK_DIR=$(mktemp -d "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+for ((f = 0; f < NUM_OF_FILES; ++f)); do
+    awk -v n=2000 -v f="$f" 'BEGIN {
+        printf "void main() {\n    int a = %d;\n", f;
+        for (i = 0; i < n; ++i) {
+            printf "    a += %d * (a - %d);\n", i % 7, (i + f) % 5;
+        }
+        printf "}\n";
+    }' > "$WORK_DIR/bench_$f.cq"
+done
+
+cd "$WORK_DIR" || exit 1
+printf "Parsing %s files (%s bytes) with a cold and a warm cache\n" \
+       "$NUM_OF_FILES" "$(cat bench_*.cq | wc -c | tr -d ' ')"
+printf "|- cold\n"
+"$PARSER" --jobs 1 --cache-dir cache bench_*.cq | tail -n 2
+printf "|- warm\n"
+"$PARSER" --jobs 1 --cache-dir cache bench_*.cq | tail -n 2
+printf "|- %s bytes in cache\n" "$(cat cache/* | wc -c | tr -d ' ')"
@@ -0,0 +1,51 @@
+#!/bin/bash
+#
+# Benchmark: parse deeply nested blocks, function calls and array accesses at several nesting depths.
+#
+# Usage: bench_deep_nesting.sh [path to cq_parser] [nesting depths...]
+#
+
+PARSER=${1:-./cq_parser}
+shift
+DEPTHS=${*:-1000 2000 5000 10000}
+BENCH_FILE=$(mktemp "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -f "$BENCH_FILE"' EXIT
+
+for depth in $DEPTHS; do
+    awk -v n="$depth" 'BEGIN {
+        printf "int f(int x, int y) {\n    return x;\n}\n\nvoid main() {\n    int[2] t = {0, 1};\n    int a = 0;\n";
+        for (i = 0; i < n; ++i) {
+            printf "if (a < %d) {\n", i;
+        }
+        printf "a += 1;\n";
+        for (i = 0; i < n; ++i) {
+            printf "}\n";
+        }
+        printf "    a = ";
+        for (i = 0; i < n; ++i) {
+            printf "f(%d, ", i % 100;
+        }
+        printf "a";
+        for (i = 0; i < n; ++i) {
+            printf ")";
+        }
+        printf ";\n    a = ";
+        for (i = 0; i < n; ++i) {
+            printf "t[";
+        }
+        printf "0";
+        for (i = 0; i < n; ++i) {
+            printf "]";
+        }
+        printf ";\n}\n";
+    }' > "$BENCH_FILE"
+
+    start=$(date +%s%N)
+    if ! "$PARSER" "$BENCH_FILE"; then
+        exit 1
+    fi
+    end=$(date +%s%N)
+    awk -v n="$depth" -v ns="$((end - start))" -v bytes="$(wc -c < "$BENCH_FILE" | tr -d ' ')" 'BEGIN {
+        printf "|- depth %6d (%8d bytes): %8.3f s (%6.3f us per nesting level)\n", n, bytes, ns / 1e9, ns / 1e3 / n;
+    }'
+done
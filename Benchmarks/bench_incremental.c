@@ -0,0 +1,468 @@
+/**
+ * \file                                bench_incremental.c
+ * \brief                               Keystroke latency of incremental edits in the parse server against full requests
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "server.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define DEFAULT_NUM_OF_LINES 20000
+#define DEFAULT_NUM_OF_KEYSTROKES 2000
+#define NUM_OF_FULL_REQUESTS 50
+#define NUM_OF_CONNECT_ATTEMPTS 500
+#define LINES_PER_FUNCTION 8
+#define TYPED_STMT "    y = y + c_0;\n"
+#define RECOVERY_SOURCE "const unsigned GROVER_ITER = 10000;\n    for (unsigned i = 0; i < GROVER_ITER; i += 1) {\n" \
+                        "int main() {\n    do { s -= 1; } while (s > 1000);\n}\n"
+#define RECOVERY_EDIT_OFFSET 4
+#define RECOVERY_EDIT "return 1;"
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Response buffer
+ */
+typedef struct response {
+    response_status_t status;               /*!< Status of last response */
+    char *content;                          /*!< Sections of last response with their lengths */
+    size_t size;                            /*!< Number of bytes of last response behind its status */
+    size_t capacity;                        /*!< Number of bytes the buffer can hold */
+} response_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return monotonic wall-clock time in seconds
+ * \return                              Current time in seconds
+ */
+static double get_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+/**
+ * \brief                               Encode little-endian 32-bit integer
+ * \param[out]                          bytes: Encoded integer
+ * \param[in]                           value: Integer to be encoded
+ */
+static void encode_u32(unsigned char bytes[4], uint32_t value) {
+    bytes[0] = (unsigned char) value;
+    bytes[1] = (unsigned char) (value >> 8);
+    bytes[2] = (unsigned char) (value >> 16);
+    bytes[3] = (unsigned char) (value >> 24);
+}
+
+/**
+ * \brief                               Decode little-endian 32-bit integer
+ * \param[in]                           bytes: Encoded integer
+ * \return                              Decoded integer
+ */
+static uint32_t decode_u32(const unsigned char bytes[4]) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+/**
+ * \brief                               Read exactly a number of bytes from a file descriptor
+ * \param[in]                           fd: File descriptor
+ * \param[out]                          buffer: Buffer to be filled
+ * \param[in]                           size: Number of bytes to be read
+ * \return                              Whether all bytes were read
+ */
+static bool read_fully(int fd, void *buffer, size_t size) {
+    size_t num_of_read = 0;
+    while (num_of_read < size) {
+        ssize_t result = read(fd, (char *) buffer + num_of_read, size - num_of_read);
+        if (result <= 0 && !(result == -1 && errno == EINTR)) {
+            return false;
+        }
+        num_of_read += (result > 0) ? (size_t) result : 0;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Write exactly a number of bytes to a file descriptor
+ * \param[in]                           fd: File descriptor
+ * \param[in]                           buffer: Bytes to be written
+ * \param[in]                           size: Number of bytes to be written
+ * \return                              Whether all bytes were written
+ */
+static bool write_fully(int fd, const void *buffer, size_t size) {
+    size_t num_of_written = 0;
+    while (num_of_written < size) {
+        ssize_t result = write(fd, (const char *) buffer + num_of_written, size - num_of_written);
+        if (result <= 0 && !(result == -1 && errno == EINTR)) {
+            return false;
+        }
+        num_of_written += (result > 0) ? (size_t) result : 0;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Generate a program of functions calling each other
+ * \note                                Every function takes `LINES_PER_FUNCTION` lines including its constant
+ * \param[in]                           num_of_functions: Number of functions
+ * \param[out]                          size: Number of bytes of program
+ * \return                              Newly allocated program or `NULL` upon failure
+ */
+static char *generate_program(unsigned num_of_functions, size_t *size) {
+    char *source = NULL;
+    FILE *stream = open_memstream(&source, size);
+    if (stream == NULL) {
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < num_of_functions; ++i) {
+        fprintf(stream, "const int c_%u = %u;\n\nint f_%u(int x) {\n    int y = x + c_%u;\n", i, i % 97, i, i);
+        if (i > 0) {
+            fprintf(stream, "    y = y + f_%u(y);\n", i - 1);
+        }
+        fprintf(stream, "    return y * 2;\n}\n\n");
+    }
+    fprintf(stream, "int main() {\n    return f_%u(1);\n}\n", (num_of_functions > 0) ? num_of_functions - 1 : 0);
+    fclose(stream);
+    return source;
+}
+
+/**
+ * \brief                               Send request and receive its response
+ * \param[in]                           fd: Socket of connection to the server
+ * \param[in]                           options: Options of request
+ * \param[in]                           prefix: Bytes in front of the text (edit range or `NULL`)
+ * \param[in]                           prefix_size: Number of bytes of prefix
+ * \param[in]                           text: Source code or replacement
+ * \param[in]                           size: Number of bytes of text
+ * \param[in,out]                       response: Pointer to response buffer (grown as needed)
+ * \return                              Whether a response was received
+ */
+static bool send_request(int fd, uint32_t options, const unsigned char *prefix, size_t prefix_size, const char *text,
+                         size_t size, response_t *response) {
+    unsigned char header[REQUEST_HEADER_SIZE];
+    encode_u32(header, (uint32_t) (4 + prefix_size + size));
+    encode_u32(header + 4, options);
+    if (!write_fully(fd, header, REQUEST_HEADER_SIZE) || !write_fully(fd, prefix, prefix_size)
+        || !write_fully(fd, text, size) || !read_fully(fd, header, RESPONSE_HEADER_SIZE)) {
+        return false;
+    }
+
+    response->status = (response_status_t) decode_u32(header + 4);
+    response->size = decode_u32(header) - 4;
+    if (response->size > response->capacity) {
+        char *temp = realloc(response->content, response->size);
+        if (temp == NULL) {
+            return false;
+        }
+        response->content = temp;
+        response->capacity = response->size;
+    }
+    return read_fully(fd, response->content, response->size) && response->status != REJECTED_R;
+}
+
+/**
+ * \brief                               Replace a range of source code in the server's document
+ * \param[in]                           fd: Socket of connection to the server
+ * \param[in]                           options: Options besides `REQUEST_EDIT`
+ * \param[in]                           start: Offset of first replaced byte
+ * \param[in]                           end: Offset behind last replaced byte
+ * \param[in]                           text: Replacement
+ * \param[in]                           length: Number of bytes of replacement
+ * \param[in,out]                       response: Pointer to response buffer (grown as needed)
+ * \return                              Whether a response was received
+ */
+static bool send_edit(int fd, uint32_t options, size_t start, size_t end, const char *text, size_t length,
+                      response_t *response) {
+    unsigned char range[8];
+    encode_u32(range, (uint32_t) start);
+    encode_u32(range + 4, (uint32_t) end);
+    return send_request(fd, options | REQUEST_EDIT, range, sizeof (range), text, length, response);
+}
+
+/**
+ * \brief                               Compare two latencies
+ * \param[in]                           a: Pointer to first latency
+ * \param[in]                           b: Pointer to second latency
+ * \return                              Negative, zero or positive value if a is less than, equal to or greater than b
+ */
+static int compare_latencies(const void *a, const void *b) {
+    double difference = *(const double *) a - *(const double *) b;
+    return (difference > 0.0) - (difference < 0.0);
+}
+
+/**
+ * \brief                               Print latency percentiles
+ * \param[in]                           label: Label of measurement
+ * \param[in,out]                       latencies: Array of latencies in seconds (sorted in place)
+ * \param[in]                           num_of_requests: Number of requests
+ */
+static void report(const char *label, double latencies[], unsigned num_of_requests) {
+    qsort(latencies, num_of_requests, sizeof (double), compare_latencies);
+    printf("|- %-24s %7u requests, p50 %9.1f us, p99 %9.1f us\n", label, num_of_requests,
+           1e6 * latencies[num_of_requests / 2], 1e6 * latencies[(size_t) (0.99 * (num_of_requests - 1))]);
+}
+
+/**
+ * \brief                               Connect to the server, retrying while it starts up
+ * \param[in]                           socket_path: Path of socket file
+ * \return                              Socket of connection or `-1` upon failure
+ */
+static int connect_to_server(const char *socket_path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof (address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof (address.sun_path), "%s", socket_path);
+    for (unsigned i = 0; i < NUM_OF_CONNECT_ATTEMPTS; ++i) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            return -1;
+        }
+        if (connect(fd, (const struct sockaddr *) &address, sizeof (address)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+/**
+ * \brief                               Type a statement into a function in the middle of a program and delete it again
+ * \note                                Every keystroke is one edit request; the number of keystrokes is a multiple of
+ *                                      twice the length of the statement, so the program is unchanged in the end
+ * \param[in]                           fd: Socket of connection to the server
+ * \param[in]                           source: Program
+ * \param[in]                           size: Number of bytes of program
+ * \param[in]                           num_of_keystrokes: Number of keystrokes
+ * \param[out]                          latencies: Array of latencies in seconds
+ * \param[in,out]                       response: Pointer to response buffer (grown as needed)
+ * \return                              Whether all edits were served
+ */
+static bool type_keystrokes(int fd, const char *source, size_t size, unsigned num_of_keystrokes, double latencies[],
+                            response_t *response) {
+    /* statements are typed behind the first statement of the function in the middle */
+    const char *stmt = strstr(source + size / 2, "    int y");
+    if (stmt == NULL) {
+        return false;
+    }
+    size_t position = (size_t) (strchr(stmt, '\n') + 1 - source);
+    size_t stmt_length = strlen(TYPED_STMT);
+    size_t num_of_typed = 0;
+    bool success = true;
+    for (unsigned i = 0; i < num_of_keystrokes && success; ++i) {
+        double request_start = get_time();
+        if ((i / stmt_length) % 2 == 0) {
+            success = send_edit(fd, REQUEST_DIAGNOSTICS_ONLY, position + num_of_typed, position + num_of_typed,
+                                TYPED_STMT + num_of_typed, 1, response);
+            ++num_of_typed;
+        } else {
+            success = send_edit(fd, REQUEST_DIAGNOSTICS_ONLY, position + num_of_typed - 1, position + num_of_typed, "",
+                                0, response);
+            --num_of_typed;
+        }
+        latencies[i] = get_time() - request_start;
+    }
+    return success;
+}
+
+/**
+ * \brief                               Compare an edited document with a full request of the edited source code
+ * \note                                The document is replaced by the source code, the text is inserted and the edited
+ *                                      document is dumped; status and dumps must equal those of a full request
+ * \param[in]                           fd: Socket of connection to the server
+ * \param[in]                           source: Source code
+ * \param[in]                           offset: Offset at which the text is inserted
+ * \param[in]                           text: Inserted text
+ * \param[in,out]                       response: Pointer to response buffer (grown as needed)
+ * \return                              Whether all requests were served and the responses match
+ */
+static bool edit_matches_full_request(int fd, const char *source, size_t offset, const char *text,
+                                      response_t *response) {
+    size_t size = strlen(source);
+    size_t length = strlen(text);
+    char *edited = malloc(size + length);
+    if (edited == NULL || !send_request(fd, REQUEST_DIAGNOSTICS_ONLY, NULL, 0, source, size, response)
+        || !send_edit(fd, REQUEST_DIAGNOSTICS_ONLY, offset, offset, text, length, response)
+        || !send_edit(fd, REQUEST_TREE_DUMP, 0, 0, "", 0, response)) {
+        free(edited);
+        return false;
+    }
+
+    /* the dumps of the edited document stay in the response buffer, the full request gets a buffer of its own */
+    response_t full_response = {PARSED_R, NULL, 0, 0};
+    memcpy(edited, source, offset);
+    memcpy(edited + offset, text, length);
+    memcpy(edited + offset + length, source + offset, size - offset);
+    bool matches = send_request(fd, REQUEST_TREE_DUMP, NULL, 0, edited, size + length, &full_response)
+                   && full_response.status == response->status && full_response.size == response->size
+                   && memcmp(full_response.content, response->content, response->size) == 0;
+    free(full_response.content);
+    free(edited);
+    return matches;
+}
+
+/**
+ * \note                                Usage: bench_incremental <path to cq_parser> [number of lines] [keystrokes]
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <path to cq_parser> [number of lines] [number of keystrokes]\n", argv[0]);
+        return 1;
+    }
+    const char *parser = argv[1];
+    unsigned num_of_lines = (argc > 2) ? (unsigned) strtoul(argv[2], NULL, 10) : DEFAULT_NUM_OF_LINES;
+    unsigned num_of_keystrokes = (argc > 3) ? (unsigned) strtoul(argv[3], NULL, 10) : DEFAULT_NUM_OF_KEYSTROKES;
+    if (num_of_lines < 2 * LINES_PER_FUNCTION) {
+        num_of_lines = DEFAULT_NUM_OF_LINES;
+    }
+    if (num_of_keystrokes == 0) {
+        num_of_keystrokes = DEFAULT_NUM_OF_KEYSTROKES;
+    }
+    unsigned cycle_length = 2 * (unsigned) strlen(TYPED_STMT);
+    num_of_keystrokes = (num_of_keystrokes + cycle_length - 1) / cycle_length * cycle_length;
+
+    size_t size;
+    char *source = generate_program(num_of_lines / LINES_PER_FUNCTION, &size);
+    double *latencies = malloc((num_of_keystrokes + NUM_OF_FULL_REQUESTS) * sizeof (double));
+    char socket_dir[] = "/tmp/cq_bench_XXXXXX";
+    if (source == NULL || latencies == NULL || mkdtemp(socket_dir) == NULL) {
+        fprintf(stderr, "Setting up the benchmark failed\n");
+        free(source);
+        free(latencies);
+        return 1;
+    }
+    char socket_path[sizeof (socket_dir) + 16];
+    snprintf(socket_path, sizeof (socket_path), "%s/serve.sock", socket_dir);
+
+    pid_t server = fork();
+    if (server == 0) {
+        execl(parser, parser, "--serve", socket_path, (char *) NULL);
+        _exit(127);
+    }
+    int fd = (server > 0) ? connect_to_server(socket_path) : -1;
+    response_t response = {PARSED_R, NULL, 0, 0};
+    bool success = fd != -1;
+
+    printf("Editing a program of %u lines (%zu bytes) with %u keystrokes\n", num_of_lines, size, num_of_keystrokes);
+    for (unsigned i = 0; i < NUM_OF_FULL_REQUESTS && success; ++i) {
+        double request_start = get_time();
+        success = send_request(fd, REQUEST_DIAGNOSTICS_ONLY, NULL, 0, source, size, &response)
+                  && response.status == PARSED_R;
+        latencies[i] = get_time() - request_start;
+    }
+    if (success) {
+        report("full request", latencies, NUM_OF_FULL_REQUESTS);
+        success = type_keystrokes(fd, source, size, num_of_keystrokes, latencies, &response);
+    }
+    if (success) {
+        report("incremental edit", latencies, num_of_keystrokes);
+    }
+
+    /* an empty edit dumps the edited document, which must match a full request of the unchanged program */
+    char *dumps = NULL;
+    size_t dumps_size = 0;
+    if (success && send_edit(fd, REQUEST_TREE_DUMP, 0, 0, "", 0, &response)) {
+        dumps = malloc(response.size + 1);
+        dumps_size = response.size;
+        success = dumps != NULL && response.status == PARSED_R;
+        if (success) {
+            memcpy(dumps, response.content, response.size);
+        }
+    } else {
+        success = false;
+    }
+    if (success) {
+        success = send_request(fd, REQUEST_TREE_DUMP, NULL, 0, source, size, &response) && response.status == PARSED_R
+                  && response.size == dumps_size && memcmp(response.content, dumps, dumps_size) == 0;
+        printf("|- edited document %s a full request\n", success ? "matches" : "does not match");
+    }
+
+    /* error recovery must leave the symbols of an edited document intact, diagnostics included */
+    if (success) {
+        success = edit_matches_full_request(fd, RECOVERY_SOURCE, RECOVERY_EDIT_OFFSET, RECOVERY_EDIT, &response);
+        printf("|- document edited after error recovery %s a full request\n", success ? "matches" : "does not match");
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+    if (server > 0) {
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+    }
+    unlink(socket_path);
+    rmdir(socket_dir);
+    if (!success) {
+        fprintf(stderr, "Serving requests failed\n");
+    }
+
+    free(dumps);
+    free(response.content);
+    free(latencies);
+    free(source);
+    return success ? 0 : 1;
+}
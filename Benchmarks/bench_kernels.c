@@ -0,0 +1,245 @@
+/**
+ * \file                                bench_kernels.c
+ * \brief                               State vector kernel microbenchmark
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "state_vector.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define DEFAULT_NUM_OF_QUBITS 22
+#define NUM_OF_REPETITIONS 8
+#define NUM_OF_WIDTHS 6
+#define NUM_OF_KERNELS 6
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return monotonic wall-clock time in seconds
+ * \return                              Current time in seconds
+ */
+static double get_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+/**
+ * \brief                               Fill state vector with deterministic pseudo-random amplitudes
+ * \param[in,out]                       state: Pointer to state vector
+ */
+static void fill_state(state_vector_t *state) {
+    for (size_t i = 0; i < state->num_of_amplitudes; ++i) {
+        uint64_t hash = (uint64_t) i * 0x9e3779b97f4a7c15ULL;
+        state->amplitudes[i] = (double) (hash >> 40 & 0xffff) / 65536.0 - 0.5
+                               + I * ((double) (hash >> 20 & 0xffff) / 65536.0 - 0.5);
+    }
+}
+
+/**
+ * \brief                               Return checksum of the amplitudes of a state vector
+ * \note                                Every amplitude is weighted by its index, so that misplaced amplitudes change
+ *                                      the checksum as well
+ * \param[in]                           state: Pointer to state vector
+ * \return                              Checksum
+ */
+static double get_checksum(const state_vector_t *state) {
+    double checksum = 0.0;
+    for (size_t i = 0; i < state->num_of_amplitudes; ++i) {
+        checksum += (creal(state->amplitudes[i]) + 2.0 * cimag(state->amplitudes[i])) * (double) (i % 7 + 1);
+    }
+    return checksum;
+}
+
+/**
+ * \brief                               Run one kernel repeatedly on a register
+ * \note                                Kernels 0 to 5 are: phase of all amplitudes, phase of the amplitudes whose
+ *                                      register value is odd, permutation adding one to the register at qubit 0 and
+ *                                      at the topmost qubits, and reflection of the register at qubit 0 and at the
+ *                                      topmost qubits about the axis of a uniform superposition
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           kernel: Index of kernel
+ * \param[in]                           width: Number of qubits of register
+ * \param[out]                          seconds: Wall-clock time of the repetitions in seconds
+ * \return                              Whether the kernel could be run
+ */
+static bool run_kernel(state_vector_t *state, unsigned kernel, unsigned width, double *seconds) {
+    char error_msg[ERROR_MSG_LENGTH];
+    size_t num_of_values = (size_t) 1 << width;
+    unsigned first_qubit = (kernel % 2 == 0) ? 0 : state->num_of_qubits - width;
+    uint64_t domain = (num_of_values - 1) << first_qubit;
+    size_t *values = malloc(num_of_values * sizeof (size_t));
+    bool *is_odd = malloc(num_of_values * sizeof (bool));
+    double *axis = malloc(num_of_values * sizeof (double));
+    if (values == NULL || is_odd == NULL || axis == NULL) {
+        fprintf(stderr, "Allocating memory for kernel arguments failed\n");
+        free(values);
+        free(is_odd);
+        free(axis);
+        return false;
+    }
+
+    double norm = sqrt(2.0 - 2.0 / sqrt((double) num_of_values));
+    for (size_t v = 0; v < num_of_values; ++v) {
+        values[v] = (v + 1) % num_of_values;
+        is_odd[v] = (v & 1) != 0;
+        axis[v] = (((v == 0) ? 1.0 : 0.0) - 1.0 / sqrt((double) num_of_values)) / norm;
+    }
+    control_mask_t mask;
+    bool success = build_mask(state, domain, is_odd, NULL, &mask, error_msg);
+
+    double complex factor = -1.0;
+    bool is_independent;
+    double start = get_time();
+    for (unsigned i = 0; i < NUM_OF_REPETITIONS && success; ++i) {
+        switch (kernel) {
+            case 0: case 1: {
+                apply_phase(state, 0, &factor, (kernel == 0) ? NULL : &mask);
+                break;
+            }
+            case 2: case 3: {
+                success = apply_register_map(state, first_qubit, width, domain, values, NULL, true, error_msg);
+                break;
+            }
+            default: {
+                success = apply_reflection(state, first_qubit, width, axis, NULL, &is_independent, error_msg);
+                break;
+            }
+        }
+    }
+    *seconds = get_time() - start;
+    if (!success) {
+        fprintf(stderr, "Running kernel %u failed\n", kernel);
+    }
+    free(values);
+    free(is_odd);
+    free(axis);
+    free_mask(&mask);
+    return success;
+}
+
+/**
+ * \brief                               Measure the throughput of the phase, masked phase, permutation and reflection
+ *                                      kernels of every supported kernel level for registers of growing width, and
+ *                                      check that all levels agree with the scalar kernels
+ * \note                                Usage: bench_kernels [number of qubits] [number of threads]
+ */
+int main(int argc, char **argv) {
+    static const char *kernel_names[NUM_OF_KERNELS] = {
+        "phase", "mask phase", "permute@0", "permute@top", "reflect@0", "reflect@top",
+    };
+    static const unsigned widths[NUM_OF_WIDTHS] = {1, 2, 4, 8, 12, 16};
+    unsigned num_of_qubits = (argc > 1) ? (unsigned) strtoul(argv[1], NULL, 10) : DEFAULT_NUM_OF_QUBITS;
+    unsigned num_of_threads = (argc > 2) ? (unsigned) strtoul(argv[2], NULL, 10) : 1;
+    if (num_of_qubits < widths[NUM_OF_WIDTHS - 1] || num_of_qubits > MAX_NUM_OF_QUBITS) {
+        fprintf(stderr, "Number of qubits must be between %u and %u\n", widths[NUM_OF_WIDTHS - 1], MAX_NUM_OF_QUBITS);
+        return 1;
+    }
+
+    char error_msg[ERROR_MSG_LENGTH];
+    state_vector_t state;
+    if (!init_state_vector(&state, num_of_qubits, num_of_threads, false, error_msg)) {
+        fprintf(stderr, "%s\n", error_msg);
+        return 1;
+    }
+
+    kernel_level_t supported_level = get_supported_kernel_level();
+    printf("Kernel benchmark on %u qubits (%zu amplitudes, %.1f MiB, %u partitions), %u repetitions, G amplitudes/s "
+           "per register width\n", num_of_qubits, state.num_of_amplitudes,
+           (double) (state.num_of_amplitudes * sizeof (double complex)) / 1048576.0, state.num_of_partitions,
+           NUM_OF_REPETITIONS);
+    printf("|- %-12s %-7s", "kernel", "level");
+    for (unsigned w = 0; w < NUM_OF_WIDTHS; ++w) {
+        printf(" %6s%-2u", "w=", widths[w]);
+    }
+    printf("\n");
+
+    double checksums[NUM_OF_KERNELS][NUM_OF_WIDTHS];
+    double max_deviation = 0.0;
+    for (unsigned kernel = 0; kernel < NUM_OF_KERNELS; ++kernel) {
+        for (kernel_level_t level = SCALAR_K; level <= supported_level; ++level) {
+            select_kernel_level(level);
+            printf("|- %-12s %-7s", kernel_names[kernel], get_kernel_level_name(level));
+            for (unsigned w = 0; w < NUM_OF_WIDTHS; ++w) {
+                double seconds;
+                fill_state(&state);
+                if (!run_kernel(&state, kernel, widths[w], &seconds)) {
+                    free_state_vector(&state);
+                    return 1;
+                }
+                printf(" %8.2f", 1e-9 * (double) (NUM_OF_REPETITIONS * state.num_of_amplitudes) / seconds);
+
+                double checksum = get_checksum(&state);
+                if (level == SCALAR_K) {
+                    checksums[kernel][w] = checksum;
+                } else {
+                    double deviation = fabs(checksum - checksums[kernel][w]) / (fabs(checksums[kernel][w]) + 1.0);
+                    max_deviation = (deviation > max_deviation) ? deviation : max_deviation;
+                }
+            }
+            printf("\n");
+        }
+    }
+    printf("|- maximal relative deviation from scalar kernels: %.3g\n", max_deviation);
+    free_state_vector(&state);
+    if (max_deviation > 1e-9) {
+        fprintf(stderr, "Kernel levels disagree\n");
+        return 1;
+    }
+    return 0;
+}
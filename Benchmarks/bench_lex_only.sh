@@ -0,0 +1,37 @@
+#!/bin/bash
+#
+# Benchmark: scan keyword-dense source code without parsing it (see --lex-only) and report the table sizes of the
+# scanners generated from the given lexer specifications, e.g. the current one and one of an earlier revision.
+#
+# Usage: bench_lex_only.sh [number of lines] [path to cq_parser] [lexer specification ...]
+#
+
+NUM_OF_LINES=${1:-200000}
+PARSER=${2:-./cq_parser}
+BENCH_FILE=$(mktemp "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -f "$BENCH_FILE"' EXIT
+
+awk -v n="$NUM_OF_LINES" 'BEGIN {
+    printf "const unsigned limit = 1000;\n\nbool flag(unsigned x) {\n    return true;\n}\n\nint main() {\n";
+    printf "    quantum int qubit = 0;\n    int value = 0;\n";
+    for (i = 9; i < n - 1; i += 4) {
+        printf "    for (unsigned index_%d = 0; index_%d < limit; index_%d += 1) {\n", i, i, i;
+        printf "        if (flag(index_%d) && false) { value += 1; } else { value -= 1; }\n", i;
+        printf "    }\n";
+        printf "    value = measure (qubit);\n";
+    }
+    printf "    return value;\n}\n";
+}' > "$BENCH_FILE"
+
+printf "Scanning %s lines (%s bytes)\n" "$NUM_OF_LINES" "$(wc -c < "$BENCH_FILE" | tr -d ' ')"
+printf "|- "
+"$PARSER" --lex-only "$BENCH_FILE"
+
+for LEXER in "${@:3}"; do
+    if ! command -v flex > /dev/null; then
+        printf "|- flex not found, table sizes are not reported\n"
+        break
+    fi
+    printf "|- tables of %s\n" "$LEXER"
+    flex --verbose --outfile=/dev/null "$LEXER" 2>&1 | grep -E "DFA states|table entries" | sed 's/^ */   /'
+done
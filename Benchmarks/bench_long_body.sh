@@ -0,0 +1,32 @@
+#!/bin/bash
+#
+# Benchmark: parse a function body of many statements and a large constant initializer list.
+#
+# Usage: bench_long_body.sh [number of statements] [path to cq_parser]
+#
+
+NUM_OF_STMTS=${1:-100000}
+PARSER=${2:-./cq_parser}
+BENCH_FILE=$(mktemp "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -f "$BENCH_FILE"' EXIT
+
+awk -v n="$NUM_OF_STMTS" 'BEGIN {
+    printf "const int[%d] table = {", n;
+    for (i = 0; i < n; ++i) {
+        printf "%s%d", (i > 0) ? ", " : "", i % 100;
+    }
+    printf "};\n\nvoid main() {\n    int a = 0;\n";
+    for (i = 0; i < n; ++i) {
+        if (i % 2 == 0) {
+            printf "    a += table[%d];\n", i;
+        } else {
+            printf "    a -= %d;\n", i % 7;
+        }
+    }
+    printf "}\n";
+}' > "$BENCH_FILE"
+
+printf "Parsing %s statements and a %s-element initializer list (%s bytes)\n" \
+       "$NUM_OF_STMTS" "$NUM_OF_STMTS" "$(wc -c < "$BENCH_FILE" | tr -d ' ')"
+TIMEFORMAT="|- %R s wall, %U s user, %S s sys"
+time "$PARSER" "$BENCH_FILE"
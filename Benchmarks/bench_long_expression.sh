@@ -0,0 +1,29 @@
+#!/bin/bash
+#
+# Benchmark: parse and dump a single left-deep expression of many operands (regression test for stack-safe tree walks).
+#
+# Usage: bench_long_expression.sh [number of operands] [path to cq_parser]
+#
+
+NUM_OF_OPERANDS=${1:-1000000}
+PARSER=$(cd "$(dirname "${2:-./cq_parser}")" && pwd)/$(basename "${2:-./cq_parser}")
+WORK_DIR=$(mktemp -d "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+awk -v n="$NUM_OF_OPERANDS" 'BEGIN {
+    printf "void main() {\n    int a = 1;\n    int b = a";
+    for (i = 1; i < n; ++i) {
+        printf " %s a", (i % 3 == 0) ? "-" : "+";
+    }
+    printf ";\n}\n";
+}' > "$WORK_DIR/bench.cq"
+
+printf "Parsing and dumping an expression of %s operands (%s bytes)\n" \
+       "$NUM_OF_OPERANDS" "$(wc -c < "$WORK_DIR/bench.cq" | tr -d ' ')"
+TIMEFORMAT="|- %R s wall, %U s user, %S s sys"
+cd "$WORK_DIR" || exit 1
+printf "|- parse only\n"
+time "$PARSER" bench.cq || exit 1
+printf "|- parse and dump\n"
+time "$PARSER" bench.cq --dump || exit 1
+printf "|- %s lines of tree dump\n" "$(wc -l < tree_dump.out | tr -d ' ')"
@@ -0,0 +1,358 @@
+/**
+ * \file                                bench_serve.c
+ * \brief                               Load test of the parse server against one parser process per request
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "server.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define DEFAULT_NUM_OF_REQUESTS 10000
+#define MAX_NUM_OF_SPAWNS 200
+#define NUM_OF_CONNECT_ATTEMPTS 500
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return monotonic wall-clock time in seconds
+ * \return                              Current time in seconds
+ */
+static double get_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+/**
+ * \brief                               Encode little-endian 32-bit integer
+ * \param[out]                          bytes: Encoded integer
+ * \param[in]                           value: Integer to be encoded
+ */
+static void encode_u32(unsigned char bytes[4], uint32_t value) {
+    bytes[0] = (unsigned char) value;
+    bytes[1] = (unsigned char) (value >> 8);
+    bytes[2] = (unsigned char) (value >> 16);
+    bytes[3] = (unsigned char) (value >> 24);
+}
+
+/**
+ * \brief                               Decode little-endian 32-bit integer
+ * \param[in]                           bytes: Encoded integer
+ * \return                              Decoded integer
+ */
+static uint32_t decode_u32(const unsigned char bytes[4]) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+/**
+ * \brief                               Read exactly a number of bytes from a file descriptor
+ * \param[in]                           fd: File descriptor
+ * \param[out]                          buffer: Buffer to be filled
+ * \param[in]                           size: Number of bytes to be read
+ * \return                              Whether all bytes were read
+ */
+static bool read_fully(int fd, void *buffer, size_t size) {
+    size_t num_of_read = 0;
+    while (num_of_read < size) {
+        ssize_t result = read(fd, (char *) buffer + num_of_read, size - num_of_read);
+        if (result <= 0 && !(result == -1 && errno == EINTR)) {
+            return false;
+        }
+        num_of_read += (result > 0) ? (size_t) result : 0;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Write exactly a number of bytes to a file descriptor
+ * \param[in]                           fd: File descriptor
+ * \param[in]                           buffer: Bytes to be written
+ * \param[in]                           size: Number of bytes to be written
+ * \return                              Whether all bytes were written
+ */
+static bool write_fully(int fd, const void *buffer, size_t size) {
+    size_t num_of_written = 0;
+    while (num_of_written < size) {
+        ssize_t result = write(fd, (const char *) buffer + num_of_written, size - num_of_written);
+        if (result <= 0 && !(result == -1 && errno == EINTR)) {
+            return false;
+        }
+        num_of_written += (result > 0) ? (size_t) result : 0;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Read whole file into memory
+ * \param[in]                           file_name: Name of file
+ * \param[out]                          size: Number of bytes read
+ * \return                              Newly allocated file content or `NULL` upon failure
+ */
+static char *read_file(const char *file_name, size_t *size) {
+    FILE *input_file = fopen(file_name, "rb");
+    if (input_file == NULL) {
+        return NULL;
+    }
+
+    char *content = NULL;
+    size_t capacity = 0;
+    *size = 0;
+    for (;;) {
+        if (*size == capacity) {
+            capacity = (capacity > 0) ? 2 * capacity : 65536;
+            char *temp = realloc(content, capacity);
+            if (temp == NULL) {
+                free(content);
+                fclose(input_file);
+                return NULL;
+            }
+            content = temp;
+        }
+        size_t num_of_read = fread(content + *size, 1, capacity - *size, input_file);
+        if (num_of_read == 0) {
+            break;
+        }
+        *size += num_of_read;
+    }
+    fclose(input_file);
+    return content;
+}
+
+/**
+ * \brief                               Send parse request and receive its response
+ * \note                                The sections of the response are only checked for their framing; the diagnostics
+ *                                      of a response are printed unless it reports success
+ * \param[in]                           fd: Socket of connection to the server
+ * \param[in]                           source: Source code
+ * \param[in]                           size: Number of bytes of source code
+ * \param[in,out]                       response: Pointer to response buffer (grown as needed)
+ * \param[in,out]                       response_capacity: Number of bytes the response buffer can hold
+ * \return                              Whether the server parsed the source code successfully
+ */
+static bool send_request(int fd, const char *source, size_t size, char **response, size_t *response_capacity) {
+    unsigned char header[REQUEST_HEADER_SIZE];
+    encode_u32(header, (uint32_t) (size + 4));
+    encode_u32(header + 4, 0);
+    if (!write_fully(fd, header, REQUEST_HEADER_SIZE) || !write_fully(fd, source, size)
+        || !read_fully(fd, header, RESPONSE_HEADER_SIZE)) {
+        return false;
+    }
+
+    size_t response_size = decode_u32(header) - 4;
+    if (response_size > *response_capacity) {
+        char *temp = realloc(*response, response_size);
+        if (temp == NULL) {
+            return false;
+        }
+        *response = temp;
+        *response_capacity = response_size;
+    }
+    if (!read_fully(fd, *response, response_size)) {
+        return false;
+    }
+    if (decode_u32(header + 4) != PARSED_R) {
+        uint32_t length = decode_u32((const unsigned char *) *response);
+        fprintf(stderr, "%.*s", (int) length, *response + 4);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Compare two latencies
+ * \param[in]                           a: Pointer to first latency
+ * \param[in]                           b: Pointer to second latency
+ * \return                              Negative, zero or positive value if a is less than, equal to or greater than b
+ */
+static int compare_latencies(const void *a, const void *b) {
+    double difference = *(const double *) a - *(const double *) b;
+    return (difference > 0.0) - (difference < 0.0);
+}
+
+/**
+ * \brief                               Print throughput and latency percentiles
+ * \param[in]                           label: Label of measurement
+ * \param[in,out]                       latencies: Array of latencies in seconds (sorted in place)
+ * \param[in]                           num_of_requests: Number of requests
+ * \param[in]                           seconds: Total time in seconds
+ */
+static void report(const char *label, double latencies[], unsigned num_of_requests, double seconds) {
+    qsort(latencies, num_of_requests, sizeof (double), compare_latencies);
+    printf("|- %-24s %7u requests in %7.3f s (%9.1f requests/s), p50 %8.1f us, p99 %8.1f us\n", label,
+           num_of_requests, seconds, num_of_requests / seconds, 1e6 * latencies[num_of_requests / 2],
+           1e6 * latencies[(size_t) (0.99 * (num_of_requests - 1))]);
+}
+
+/**
+ * \brief                               Connect to the server, retrying while it starts up
+ * \param[in]                           socket_path: Path of socket file
+ * \return                              Socket of connection or `-1` upon failure
+ */
+static int connect_to_server(const char *socket_path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof (address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof (address.sun_path), "%s", socket_path);
+    for (unsigned i = 0; i < NUM_OF_CONNECT_ATTEMPTS; ++i) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            return -1;
+        }
+        if (connect(fd, (const struct sockaddr *) &address, sizeof (address)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+/**
+ * \brief                               Parse a file by starting the parser once per request
+ * \param[in]                           parser: Path of parser
+ * \param[in]                           file_name: Name of file to be parsed
+ * \return                              Whether the parser succeeded
+ */
+static bool spawn_parser(const char *parser, const char *file_name) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl(parser, parser, file_name, (char *) NULL);
+        _exit(127);
+    }
+    int status;
+    return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <path to cq_parser> <file> [number of requests]\n", argv[0]);
+        return 1;
+    }
+    const char *parser = argv[1];
+    unsigned num_of_requests = (argc > 3) ? (unsigned) strtoul(argv[3], NULL, 10) : DEFAULT_NUM_OF_REQUESTS;
+    if (num_of_requests == 0) {
+        num_of_requests = DEFAULT_NUM_OF_REQUESTS;
+    }
+
+    size_t size;
+    char *source = read_file(argv[2], &size);
+    double *latencies = malloc(num_of_requests * sizeof (double));
+    char socket_dir[] = "/tmp/cq_bench_XXXXXX";
+    if (source == NULL || latencies == NULL || mkdtemp(socket_dir) == NULL) {
+        fprintf(stderr, "Setting up the benchmark failed\n");
+        free(source);
+        free(latencies);
+        return 1;
+    }
+    char socket_path[sizeof (socket_dir) + 16];
+    snprintf(socket_path, sizeof (socket_path), "%s/serve.sock", socket_dir);
+
+    pid_t server = fork();
+    if (server == 0) {
+        execl(parser, parser, "--serve", socket_path, (char *) NULL);
+        _exit(127);
+    }
+    int fd = (server > 0) ? connect_to_server(socket_path) : -1;
+    char *response = NULL;
+    size_t response_capacity = 0;
+    bool success = fd != -1 && send_request(fd, source, size, &response, &response_capacity);
+
+    printf("Serving %u requests of %s (%zu bytes)\n", num_of_requests, argv[2], size);
+    double start = get_time();
+    for (unsigned i = 0; i < num_of_requests && success; ++i) {
+        double request_start = get_time();
+        success = send_request(fd, source, size, &response, &response_capacity);
+        latencies[i] = get_time() - request_start;
+    }
+    double seconds = get_time() - start;
+    if (success) {
+        report("resident server", latencies, num_of_requests, seconds);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+    if (server > 0) {
+        kill(server, SIGTERM);
+        waitpid(server, NULL, 0);
+    }
+    unlink(socket_path);
+    rmdir(socket_dir);
+
+    unsigned num_of_spawns = (num_of_requests < MAX_NUM_OF_SPAWNS) ? num_of_requests : MAX_NUM_OF_SPAWNS;
+    start = get_time();
+    for (unsigned i = 0; i < num_of_spawns && success; ++i) {
+        double request_start = get_time();
+        success = spawn_parser(parser, argv[2]);
+        latencies[i] = get_time() - request_start;
+    }
+    seconds = get_time() - start;
+    if (success) {
+        report("one process per request", latencies, num_of_spawns, seconds);
+    } else {
+        fprintf(stderr, "Serving requests failed\n");
+    }
+
+    free(response);
+    free(latencies);
+    free(source);
+    return success ? 0 : 1;
+}
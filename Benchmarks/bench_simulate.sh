@@ -0,0 +1,33 @@
+#!/bin/bash
+#
+# Benchmark: simulate Grover iterations (see --simulate) on one quantum int while up to the given number of further
+# quantum ints are held in uniform superposition, and report wall time and amplitude throughput per state vector size.
+#
+# Usage: bench_simulate.sh [number of Grover iterations] [path to cq_parser] [maximal number of spectator registers]
+#
+
+NUM_OF_ITERATIONS=${1:-100}
+PARSER=${2:-./cq_parser}
+MAX_NUM_OF_SPECTATORS=${3:-1}
+BENCH_FILE=$(mktemp "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -f "$BENCH_FILE"' EXIT
+
+for ((NUM_OF_SPECTATORS = 0; NUM_OF_SPECTATORS <= MAX_NUM_OF_SPECTATORS; ++NUM_OF_SPECTATORS)); do
+    awk -v n="$NUM_OF_ITERATIONS" -v s="$NUM_OF_SPECTATORS" 'BEGIN {
+        printf "bool marker(int x) {\n    return x == 42;\n}\n\nbool all_true(int x) {\n    return true;\n}\n\n";
+        printf "int main() {\n    quantum int state = [all_true];\n";
+        for (i = 0; i < s; ++i) {
+            printf "    quantum int spectator_%d = [all_true];\n", i;
+        }
+        printf "    for (unsigned i = 0; i < %d; i += 1) {\n", n;
+        printf "        if (marker(state)) {\n            phase (state) += 1;\n        }\n";
+        printf "        ~[all_true](state);\n";
+        printf "        if (state == 0) {\n            phase (state) += 1;\n        }\n";
+        printf "        [all_true](state);\n";
+        printf "    }\n    return measure (state);\n}\n";
+    }' > "$BENCH_FILE"
+
+    printf "Simulating %s Grover iterations with %s spectator registers\n" "$NUM_OF_ITERATIONS" "$NUM_OF_SPECTATORS"
+    printf "|- "
+    "$PARSER" --simulate "$BENCH_FILE" | head -n 1
+done
@@ -0,0 +1,60 @@
+#!/bin/bash
+#
+# Benchmark: simulate a mostly classical program (see --simulate) whose quantum ints each hold two values and control
+# each other in a ring, once per number of registers from two up to the given maximum, with the dense and with the
+# sparse representation, and report wall time and speedup of the sparse one. A final Grover search next to a register
+# in uniform superposition checks that a sparse state vector filling up turns dense without a loss.
+#
+# Usage: bench_sparse.sh [number of iterations] [path to cq_parser] [maximal number of registers]
+#
+
+NUM_OF_ITERATIONS=${1:-10}
+PARSER=${2:-./cq_parser}
+MAX_NUM_OF_REGISTERS=${3:-3}
+BENCH_FILE=$(mktemp "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -f "$BENCH_FILE"' EXIT
+
+run_representations() {
+    BASE_SECONDS=""
+    for REPRESENTATION in dense sparse; do
+        SUMMARY=$("$PARSER" --simulate "$BENCH_FILE" --representation "$REPRESENTATION" | head -n 1)
+        SECONDS_TAKEN=$(printf "%s\n" "$SUMMARY" | sed -n 's/.* in \([0-9.]*\) s .*/\1/p')
+        BASE_SECONDS=${BASE_SECONDS:-$SECONDS_TAKEN}
+        printf "|- %6s: %s (speedup %s)\n" "$REPRESENTATION" "$SUMMARY" \
+               "$(awk -v b="$BASE_SECONDS" -v t="$SECONDS_TAKEN" 'BEGIN { printf "%.2f", b / t }')"
+    done
+}
+
+for ((NUM_OF_REGISTERS = 2; NUM_OF_REGISTERS <= MAX_NUM_OF_REGISTERS; ++NUM_OF_REGISTERS)); do
+    awk -v n="$NUM_OF_ITERATIONS" -v r="$NUM_OF_REGISTERS" 'BEGIN {
+        printf "bool two_values(int x) {\n    return x == 3 || x == 12;\n}\n\n";
+        printf "int main() {\n";
+        for (i = 0; i < r; ++i) {
+            printf "    quantum int register_%d = [two_values];\n", i;
+        }
+        printf "    for (unsigned i = 0; i < %d; i += 1) {\n", n;
+        for (i = 0; i < r; ++i) {
+            printf "        if (register_%d == 3) {\n            register_%d += 1;\n", i, (i + 1) % r;
+            printf "            phase (register_%d) += 1;\n        }\n", i;
+            printf "        register_%d -= 1;\n", (i + 1) % r;
+        }
+        printf "    }\n    return measure (register_0);\n}\n";
+    }' > "$BENCH_FILE"
+
+    printf "Simulating %s iterations on %s registers of two values each\n" "$NUM_OF_ITERATIONS" "$NUM_OF_REGISTERS"
+    run_representations
+done
+
+awk -v n="$NUM_OF_ITERATIONS" 'BEGIN {
+    printf "bool marker(int x) {\n    return x == 42;\n}\n\nbool all_true(int x) {\n    return true;\n}\n\n";
+    printf "int main() {\n    quantum int spectator = [all_true];\n    quantum int state = [all_true];\n";
+    printf "    for (unsigned i = 0; i < %d; i += 1) {\n", n;
+    printf "        if (marker(state)) {\n            phase (state) += 1;\n        }\n";
+    printf "        ~[all_true](state);\n";
+    printf "        if (state == 0) {\n            phase (state) += 1;\n        }\n";
+    printf "        [all_true](state);\n";
+    printf "    }\n    return measure (state);\n}\n";
+}' > "$BENCH_FILE"
+
+printf "Simulating %s Grover iterations next to a register in uniform superposition\n" "$NUM_OF_ITERATIONS"
+run_representations
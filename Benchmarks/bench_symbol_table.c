@@ -0,0 +1,191 @@
+/**
+ * \file                                bench_symbol_table.c
+ * \brief                               Symbol table microbenchmark
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "intern.h"
+#include "symbol_table.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define DEFAULT_NUM_OF_IDS 1000000
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return monotonic wall-clock time in seconds
+ * \return                              Current time in seconds
+ */
+static double get_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+/**
+ * \brief                               Print timing of one benchmark phase
+ * \param[in]                           phase: Name of benchmark phase
+ * \param[in]                           num_of_ops: Number of operations in phase
+ * \param[in]                           seconds: Wall-clock time of phase in seconds
+ */
+static void print_phase(const char *phase, unsigned num_of_ops, double seconds) {
+    printf("|- %-10s %10u ops %9.3f s %9.1f ns/op %9.2f Mops/s\n",
+           phase, num_of_ops, seconds, 1e9 * seconds / num_of_ops, 1e-6 * num_of_ops / seconds);
+}
+
+/**
+ * \brief                               Intern, insert, look up and hide a large number of distinct identifiers, and enter
+ *                                      and leave as many small scopes while all of them are visible
+ * \note                                Usage: bench_symbol_table [number of identifiers]
+ */
+int main(int argc, char **argv) {
+    unsigned num_of_ids = (argc > 1) ? (unsigned) strtoul(argv[1], NULL, 10) : DEFAULT_NUM_OF_IDS;
+    if (num_of_ids == 0) {
+        fprintf(stderr, "Number of identifiers must be positive\n");
+        return 1;
+    }
+
+    char (*names)[MAX_TOKEN_LENGTH] = malloc(num_of_ids * sizeof (*names));
+    unsigned *lengths = malloc(num_of_ids * sizeof (unsigned));
+    const interned_str_t **handles = malloc(num_of_ids * sizeof (interned_str_t *));
+    if (names == NULL || lengths == NULL || handles == NULL) {
+        fprintf(stderr, "Allocating memory for identifiers failed\n");
+        return 1;
+    }
+    for (unsigned i = 0; i < num_of_ids; ++i) {
+        lengths[i] = (unsigned) snprintf(names[i], MAX_TOKEN_LENGTH, "id_%x_%u", i * 2654435761u, i);
+    }
+
+    char error_msg[ERROR_MSG_LENGTH];
+    intern_table_t intern_table;
+    symbol_table_t symbol_table;
+    init_intern_table(&intern_table);
+    init_symbol_table(&symbol_table);
+    printf("Symbol table benchmark with %u identifiers\n", num_of_ids);
+
+    double start = get_time();
+    for (unsigned i = 0; i < num_of_ids; ++i) {
+        handles[i] = intern(&intern_table, names[i], lengths[i]);
+        if (handles[i] == NULL) {
+            fprintf(stderr, "Interning %s failed\n", names[i]);
+            return 1;
+        }
+    }
+    print_phase("intern", num_of_ids, get_time() - start);
+
+    start = get_time();
+    for (unsigned i = 0; i < num_of_ids; ++i) {
+        unsigned j = (unsigned) ((i * 40503ull) % num_of_ids);
+        if (intern(&intern_table, names[j], lengths[j]) != handles[j]) {
+            fprintf(stderr, "Re-interning %s failed\n", names[j]);
+            return 1;
+        }
+    }
+    print_phase("re-intern", num_of_ids, get_time() - start);
+
+    start = get_time();
+    incr_scope(&symbol_table);
+    for (unsigned i = 0; i < num_of_ids; ++i) {
+        if (insert(&symbol_table, handles[i], i, true, error_msg) == NULL) {
+            fprintf(stderr, "%s\n", error_msg);
+            return 1;
+        }
+    }
+    print_phase("declare", num_of_ids, get_time() - start);
+
+    start = get_time();
+    for (unsigned i = 0; i < num_of_ids; ++i) {
+        unsigned j = (unsigned) ((i * 40503ull) % num_of_ids);
+        if (insert(&symbol_table, handles[j], i, false, error_msg) == NULL) {
+            fprintf(stderr, "%s\n", error_msg);
+            return 1;
+        }
+    }
+    print_phase("reference", num_of_ids, get_time() - start);
+
+    const interned_str_t *scoped_handles[16];
+    for (unsigned i = 0; i < 16; ++i) {
+        char scoped_name[MAX_TOKEN_LENGTH];
+        unsigned length = (unsigned) snprintf(scoped_name, MAX_TOKEN_LENGTH, "scoped_%u", i);
+        scoped_handles[i] = intern(&intern_table, scoped_name, length);
+        if (scoped_handles[i] == NULL) {
+            fprintf(stderr, "Interning %s failed\n", scoped_name);
+            return 1;
+        }
+    }
+    start = get_time();
+    for (unsigned i = 0; i < num_of_ids; ++i) {
+        incr_scope(&symbol_table);
+        if (insert(&symbol_table, scoped_handles[i % 16], i, true, error_msg) == NULL) {
+            fprintf(stderr, "%s\n", error_msg);
+            return 1;
+        }
+        hide_scope(&symbol_table);
+    }
+    print_phase("scope", num_of_ids, get_time() - start);
+
+    start = get_time();
+    hide_scope(&symbol_table);
+    print_phase("hide", num_of_ids, get_time() - start);
+
+    start = get_time();
+    free_symbol_table(&symbol_table);
+    free_intern_table(&intern_table);
+    print_phase("free", num_of_ids, get_time() - start);
+
+    free(names);
+    free(lengths);
+    free(handles);
+    return 0;
+}
@@ -0,0 +1,43 @@
+#!/bin/bash
+#
+# Benchmark: simulate Grover iterations (see --simulate) on one quantum int while further quantum ints are held in
+# uniform superposition, once per power-of-two number of threads up to the given maximum, and report wall time and
+# speedup over a single thread. The search register is declared last, so that it lies on the partition-selecting
+# qubits and its diffusion crosses partitions.
+#
+# Usage: bench_threads.sh [number of Grover iterations] [path to cq_parser] [maximal number of threads]
+#                         [number of spectator registers]
+#
+
+NUM_OF_ITERATIONS=${1:-20}
+PARSER=${2:-./cq_parser}
+MAX_NUM_OF_THREADS=${3:-64}
+NUM_OF_SPECTATORS=${4:-2}
+BENCH_FILE=$(mktemp "${TMPDIR:-/tmp}/cq_bench_XXXXXX")
+trap 'rm -f "$BENCH_FILE"' EXIT
+
+awk -v n="$NUM_OF_ITERATIONS" -v s="$NUM_OF_SPECTATORS" 'BEGIN {
+    printf "bool marker(int x) {\n    return x == 42;\n}\n\nbool all_true(int x) {\n    return true;\n}\n\n";
+    printf "int main() {\n";
+    for (i = 0; i < s; ++i) {
+        printf "    quantum int spectator_%d = [all_true];\n", i;
+    }
+    printf "    quantum int state = [all_true];\n";
+    printf "    for (unsigned i = 0; i < %d; i += 1) {\n", n;
+    printf "        if (marker(state)) {\n            phase (state) += 1;\n        }\n";
+    printf "        ~[all_true](state);\n";
+    printf "        if (state == 0) {\n            phase (state) += 1;\n        }\n";
+    printf "        [all_true](state);\n";
+    printf "    }\n    return measure (state);\n}\n";
+}' > "$BENCH_FILE"
+
+printf "Simulating %s Grover iterations with %s spectator registers on %s processors\n" "$NUM_OF_ITERATIONS" \
+       "$NUM_OF_SPECTATORS" "$(getconf _NPROCESSORS_ONLN)"
+BASE_SECONDS=""
+for ((NUM_OF_THREADS = 1; NUM_OF_THREADS <= MAX_NUM_OF_THREADS; NUM_OF_THREADS *= 2)); do
+    SUMMARY=$("$PARSER" --simulate "$BENCH_FILE" --threads "$NUM_OF_THREADS" | head -n 1)
+    SECONDS_TAKEN=$(printf "%s\n" "$SUMMARY" | sed -n 's/.* in \([0-9.]*\) s .*/\1/p')
+    BASE_SECONDS=${BASE_SECONDS:-$SECONDS_TAKEN}
+    printf "|- %2s threads: %s (speedup %s)\n" "$NUM_OF_THREADS" "$SUMMARY" \
+           "$(awk -v b="$BASE_SECONDS" -v t="$SECONDS_TAKEN" 'BEGIN { printf "%.2f", b / t }')"
+done
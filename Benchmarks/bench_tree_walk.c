@@ -0,0 +1,391 @@
+/**
+ * \file                                bench_tree_walk.c
+ * \brief                               Tree-walk microbenchmark over a large expression tree
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif /* __linux__ */
+#include "arena.h"
+#include "ast.h"
+#include "intern.h"
+#include "symbol_table.h"
+#include "visitor.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define DEFAULT_NUM_OF_STMTS 1000000
+#define NUM_OF_WALKS 10
+#define NUM_OF_VARS 16
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return monotonic wall-clock time in seconds
+ * \return                              Current time in seconds
+ */
+static double get_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+/**
+ * \brief                               Open a hardware counter of cache misses of the calling thread
+ * \return                              File descriptor of the counter or `-1` if it is not available
+ */
+static int open_cache_miss_counter() {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof (attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof (attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif /* __linux__ */
+}
+
+/**
+ * \brief                               Reset and enable a cache miss counter
+ * \param[in]                           counter: File descriptor of the counter (ignored if `-1`)
+ */
+static void start_cache_miss_counter(int counter) {
+#ifdef __linux__
+    if (counter != -1) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void) counter;
+#endif /* __linux__ */
+}
+
+/**
+ * \brief                               Disable a cache miss counter and read its value
+ * \param[in]                           counter: File descriptor of the counter (ignored if `-1`)
+ * \param[out]                          num_of_misses: Number of cache misses since the counter was started
+ * \return                              Whether the counter could be read
+ */
+static bool stop_cache_miss_counter(int counter, uint64_t *num_of_misses) {
+#ifdef __linux__
+    if (counter != -1) {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        return read(counter, num_of_misses, sizeof (uint64_t)) == sizeof (uint64_t);
+    }
+#else
+    (void) counter;
+    (void) num_of_misses;
+#endif /* __linux__ */
+    return false;
+}
+
+/**
+ * \brief                               Sum up bytes handed out by an arena
+ * \param[in]                           arena: Pointer to arena
+ * \return                              Number of bytes in use
+ */
+static size_t get_arena_usage(const arena_t *arena) {
+    size_t usage = 0;
+    for (const arena_block_t *block = arena->blocks; block != NULL; block = block->next) {
+        usage += block->used;
+    }
+    return usage;
+}
+
+/**
+ * \brief                               Visit every node of a tree and read the fields a type-checking pass reads
+ * \param[in]                           root: Pointer to root of the tree
+ * \param[in,out]                       num_of_nodes: Number of visited nodes
+ * \return                              Checksum over type information and flags of visited nodes
+ */
+static unsigned walk(const node_t *root, unsigned *num_of_nodes) {
+    ++*num_of_nodes;
+    switch (root->node_type) {
+        case STMT_LIST_NODE_T: {
+            const stmt_list_node_t *stmt_list_node = (const stmt_list_node_t *) root;
+            unsigned checksum = stmt_list_node->is_quantizable + stmt_list_node->return_style;
+            for (unsigned i = 0; i < stmt_list_node->num_of_stmts; ++i) {
+                checksum += walk(stmt_list_node->stmt_list[i], num_of_nodes);
+            }
+            return checksum;
+        }
+        case ASSIGN_NODE_T: {
+            const assign_node_t *assign_node = (const assign_node_t *) root;
+            return assign_node->is_unitary + assign_node->op + walk(assign_node->left, num_of_nodes)
+                   + walk(assign_node->right, num_of_nodes);
+        }
+        case INTEGER_OP_NODE_T: {
+            const integer_op_node_t *integer_op_node = (const integer_op_node_t *) root;
+            return integer_op_node->type_info.qualifier + integer_op_node->type_info.type
+                   + integer_op_node->type_info.depth + integer_op_node->op
+                   + walk(integer_op_node->left, num_of_nodes) + walk(integer_op_node->right, num_of_nodes);
+        }
+        case REFERENCE_NODE_T: {
+            const reference_node_t *reference_node = (const reference_node_t *) root;
+            return reference_node->type_info.qualifier + reference_node->type_info.type
+                   + reference_node->type_info.depth + reference_node->is_quantizable;
+        }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * \brief                               Add type information and flags of a statement list node to a checksum
+ * \param[in]                           node: Pointer to visited node
+ * \param[in]                           depth: Layer depth of visited node
+ * \param[in,out]                       data: Pointer to checksum
+ * \return                              Always `CONTINUE_W`
+ */
+static walk_result_t visit_stmt_list_node(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    *(unsigned *) data += ((stmt_list_node_t *) node)->is_quantizable + ((stmt_list_node_t *) node)->return_style;
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Add flags and operator of an assignment node to a checksum
+ * \param[in]                           node: Pointer to visited node
+ * \param[in]                           depth: Layer depth of visited node
+ * \param[in,out]                       data: Pointer to checksum
+ * \return                              Always `CONTINUE_W`
+ */
+static walk_result_t visit_assign_node(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    *(unsigned *) data += ((assign_node_t *) node)->is_unitary + ((assign_node_t *) node)->op;
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Add type information and operator of an integer operation node to a checksum
+ * \param[in]                           node: Pointer to visited node
+ * \param[in]                           depth: Layer depth of visited node
+ * \param[in,out]                       data: Pointer to checksum
+ * \return                              Always `CONTINUE_W`
+ */
+static walk_result_t visit_integer_op_node(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    const integer_op_node_t *integer_op_node = (const integer_op_node_t *) node;
+    *(unsigned *) data += integer_op_node->type_info.qualifier + integer_op_node->type_info.type
+                          + integer_op_node->type_info.depth + integer_op_node->op;
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Add type information and flags of a reference node to a checksum
+ * \param[in]                           node: Pointer to visited node
+ * \param[in]                           depth: Layer depth of visited node
+ * \param[in,out]                       data: Pointer to checksum
+ * \return                              Always `CONTINUE_W`
+ */
+static walk_result_t visit_reference_node(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    const reference_node_t *reference_node = (const reference_node_t *) node;
+    *(unsigned *) data += reference_node->type_info.qualifier + reference_node->type_info.type
+                          + reference_node->type_info.depth + reference_node->is_quantizable;
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Build a function body of many compound assignments of integer expressions,
+ *                                      report its node sizes and memory footprint, and walk it repeatedly by a
+ *                                      hand-written recursive switch and by a tree pass
+ * \note                                Usage: bench_tree_walk [number of statements]
+ */
+int main(int argc, char **argv) {
+    unsigned num_of_stmts = (argc > 1) ? (unsigned) strtoul(argv[1], NULL, 10) : DEFAULT_NUM_OF_STMTS;
+    if (num_of_stmts == 0) {
+        fprintf(stderr, "Number of statements must be positive\n");
+        return 1;
+    }
+
+    char error_msg[ERROR_MSG_LENGTH];
+    arena_t arena;
+    intern_table_t intern_table;
+    symbol_table_t symbol_table;
+    init_arena(&arena);
+    init_intern_table(&intern_table);
+    init_symbol_table(&symbol_table);
+    incr_scope(&symbol_table);
+
+    entry_t *vars[NUM_OF_VARS];
+    for (unsigned i = 0; i < NUM_OF_VARS; ++i) {
+        char name[MAX_TOKEN_LENGTH];
+        unsigned length = (unsigned) snprintf(name, MAX_TOKEN_LENGTH, "v_%u", i);
+        const interned_str_t *handle = intern(&intern_table, name, length);
+        vars[i] = (handle != NULL) ? insert(&symbol_table, handle, 1, true, error_msg) : NULL;
+        if (vars[i] == NULL || !set_type_info(vars[i], NONE_T, INT_T, NULL, error_msg)) {
+            fprintf(stderr, "Declaring %s failed\n", name);
+            return 1;
+        }
+        vars[i]->has_been_initialized = true;
+    }
+
+    node_t **stmt_list = malloc(num_of_stmts * sizeof (node_t *));
+    if (stmt_list == NULL) {
+        fprintf(stderr, "Allocating memory for statement list failed\n");
+        return 1;
+    }
+
+    double start = get_time();
+    for (unsigned i = 0; i < num_of_stmts; ++i) {
+        node_t *refs[5];
+        for (unsigned j = 0; j < 5; ++j) {
+            refs[j] = new_reference_node(&arena, vars[(i * 7 + j * 5) % NUM_OF_VARS], NULL, NULL, 0, error_msg);
+            if (refs[j] == NULL) {
+                fprintf(stderr, "%s\n", error_msg);
+                return 1;
+            }
+        }
+        node_t *product = new_integer_op_node(&arena, refs[1], MUL_OP, refs[2], error_msg);
+        node_t *disjunction = (product != NULL)
+                              ? new_integer_op_node(&arena, refs[3], OR_OP, refs[4], error_msg) : NULL;
+        node_t *difference = (disjunction != NULL)
+                             ? new_integer_op_node(&arena, product, SUB_OP, disjunction, error_msg) : NULL;
+        stmt_list[i] = (difference != NULL) ? new_assign_node(&arena, refs[0], ASSIGN_ADD_OP, difference, error_msg)
+                                            : NULL;
+        if (stmt_list[i] == NULL) {
+            fprintf(stderr, "%s\n", error_msg);
+            return 1;
+        }
+    }
+    node_t *root = new_stmt_list_node(&arena, false, false, stmt_list, num_of_stmts, error_msg);
+    if (root == NULL) {
+        fprintf(stderr, "%s\n", error_msg);
+        return 1;
+    }
+    double build_time = get_time() - start;
+
+    unsigned num_of_nodes = 0;
+    walk(root, &num_of_nodes);
+    size_t tree_size = get_arena_usage(&arena);
+    printf("Tree-walk benchmark with %u statements (%u nodes, %.1f MiB in arena, %.1f bytes/node)\n",
+           num_of_stmts, num_of_nodes, tree_size / 1048576.0, (double) tree_size / num_of_nodes);
+    printf("|- node sizes: reference %zu, integer operation %zu, assignment %zu, type information %zu bytes\n",
+           sizeof (reference_node_t), sizeof (integer_op_node_t), sizeof (assign_node_t), sizeof (type_info_t));
+    printf("|- %-10s %10u stmts %9.3f s %9.1f ns/node\n", "build", num_of_stmts, build_time,
+           1e9 * build_time / num_of_nodes);
+
+    int counter = open_cache_miss_counter();
+    uint64_t num_of_misses = 0;
+    unsigned num_of_visits = 0;
+    unsigned walk_checksum = 0;
+    start_cache_miss_counter(counter);
+    start = get_time();
+    for (unsigned i = 0; i < NUM_OF_WALKS; ++i) {
+        walk_checksum += walk(root, &num_of_visits);
+    }
+    double walk_time = get_time() - start;
+    bool has_misses = stop_cache_miss_counter(counter, &num_of_misses);
+    printf("|- %-10s %10u nodes %9.3f s %9.1f ns/node", "walk", num_of_visits, walk_time,
+           1e9 * walk_time / num_of_visits);
+    if (has_misses) {
+        printf(" %9.3f cache misses/node\n", (double) num_of_misses / num_of_visits);
+    } else {
+        printf("   (cache miss counter unavailable)\n");
+    }
+
+    tree_pass_t pass = {
+        .pre_visitors = {
+            [STMT_LIST_NODE_T] = visit_stmt_list_node,
+            [ASSIGN_NODE_T] = visit_assign_node,
+            [INTEGER_OP_NODE_T] = visit_integer_op_node,
+            [REFERENCE_NODE_T] = visit_reference_node,
+        },
+    };
+    unsigned pass_checksum = 0;
+    start_cache_miss_counter(counter);
+    start = get_time();
+    for (unsigned i = 0; i < NUM_OF_WALKS; ++i) {
+        if (!run_tree_pass(&pass, root, 0, &pass_checksum, error_msg)) {
+            fprintf(stderr, "%s\n", error_msg);
+            return 1;
+        }
+    }
+    double pass_time = get_time() - start;
+    has_misses = stop_cache_miss_counter(counter, &num_of_misses);
+    printf("|- %-10s %10u nodes %9.3f s %9.1f ns/node", "pass", num_of_visits, pass_time,
+           1e9 * pass_time / num_of_visits);
+    if (has_misses) {
+        printf(" %9.3f cache misses/node\n", (double) num_of_misses / num_of_visits);
+    } else {
+        printf("   (cache miss counter unavailable)\n");
+    }
+    if (pass_checksum != walk_checksum) {
+        fprintf(stderr, "Checksums of walk (%u) and pass (%u) differ\n", walk_checksum, pass_checksum);
+        return 1;
+    }
+    printf("|- checksum %u\n", walk_checksum);
+
+#ifdef __linux__
+    if (counter != -1) {
+        close(counter);
+    }
+#endif /* __linux__ */
+    free(stmt_list);
+    free_symbol_table(&symbol_table);
+    free_intern_table(&intern_table);
+    free_arena(&arena);
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * \file                                arena.c
+ * \brief                               Arena allocator source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Round size up to the alignment of arena allocations
+ * \param[in]                           size: Size to be rounded up
+ * \return                              Rounded-up size
+ */
+static size_t align_size(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * \brief                               Allocate new block and prepend it to the block list of an arena
+ * \param[in,out]                       arena: Pointer to arena receiving the new block
+ * \param[in]                           capacity: Number of usable bytes of the new block
+ * \return                              Pointer to new block or `NULL` upon failure
+ */
+static arena_block_t *new_arena_block(arena_t *arena, size_t capacity) {
+    arena_block_t *new_block = malloc(sizeof (arena_block_t) + capacity);
+    if (new_block == NULL) {
+        return NULL;
+    }
+
+    new_block->capacity = capacity;
+    new_block->used = 0;
+    new_block->next = arena->blocks;
+    arena->blocks = new_block;
+    return new_block;
+}
+
+/* See header for documentation */
+void init_arena(arena_t *arena) {
+    arena->blocks = NULL;
+}
+
+/* See header for documentation */
+void *alloc_from_arena(arena_t *arena, size_t size) {
+    size = align_size(size);
+    arena_block_t *block = arena->blocks;
+    if (block == NULL || block->capacity - block->used < size) {
+        if (size > ARENA_BLOCK_SIZE / 4) { /* oversized request gets a block of its own behind the current one */
+            arena_block_t *current_block = arena->blocks;
+            if (current_block != NULL) {
+                arena->blocks = current_block->next;
+            }
+            arena_block_t *own_block = new_arena_block(arena, size);
+            if (current_block != NULL) {
+                current_block->next = arena->blocks;
+                arena->blocks = current_block;
+            }
+            if (own_block == NULL) {
+                return NULL;
+            }
+            own_block->used = size;
+            return own_block->data;
+        }
+
+        block = new_arena_block(arena, ARENA_BLOCK_SIZE);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    void *memory = (char *) block->data + block->used;
+    block->used += size;
+    return memory;
+}
+
+/* See header for documentation */
+void *copy_to_arena(arena_t *arena, const void *src, size_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+
+    void *memory = alloc_from_arena(arena, size);
+    if (memory != NULL) {
+        memcpy(memory, src, size);
+    }
+    return memory;
+}
+
+/* See header for documentation */
+void reset_arena(arena_t *arena) {
+    arena_block_t *kept_block = NULL;
+    arena_block_t *block = arena->blocks;
+    while (block != NULL) {
+        arena_block_t *next = block->next;
+        if (kept_block == NULL && block->capacity == ARENA_BLOCK_SIZE) {
+            kept_block = block;
+        } else {
+            free(block);
+        }
+        block = next;
+    }
+
+    if (kept_block != NULL) {
+        kept_block->used = 0;
+        kept_block->next = NULL;
+    }
+    arena->blocks = kept_block;
+}
+
+/* See header for documentation */
+void free_arena(arena_t *arena) {
+    arena_block_t *block = arena->blocks;
+    while (block != NULL) {
+        arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+}
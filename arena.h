@@ -0,0 +1,149 @@
+/**
+ * \file                                arena.h
+ * \brief                               Arena allocator include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stddef.h>
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Arena block struct
+ * \note                                This structure defines one contiguous chunk of memory owned by an arena
+ */
+typedef struct arena_block {
+    struct arena_block *next;               /*!< Pointer to previously allocated block */
+    size_t capacity;                        /*!< Number of usable bytes in block */
+    size_t used;                            /*!< Number of bytes already handed out */
+    max_align_t data[];                     /*!< Memory of block */
+} arena_block_t;
+
+/**
+ * \brief                               Arena struct
+ * \note                                This structure defines a bump allocator whose memory can only be released as a
+ *                                      whole; a zero-initialized arena is empty and ready for use
+ */
+typedef struct arena {
+    arena_block_t *blocks;                  /*!< Pointer to most recently allocated block */
+} arena_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Initialize empty arena at a given address
+ * \param[out]                          arena: Address of arena to be initialized
+ */
+void init_arena(arena_t *arena);
+
+/**
+ * \brief                               Allocate memory from arena and return pointer to it
+ * \note                                Memory is aligned for pointers (and thus for every node and value type) and stays
+ *                                      valid until the arena is reset or freed; it must not be passed to free()
+ * \param[in,out]                       arena: Pointer to arena to allocate from
+ * \param[in]                           size: Number of bytes to be allocated
+ * \return                              Pointer to allocated memory or `NULL` upon failure
+ */
+void *alloc_from_arena(arena_t *arena, size_t size);
+
+/**
+ * \brief                               Copy memory into arena and return pointer to the copy
+ * \param[in,out]                       arena: Pointer to arena to allocate from
+ * \param[in]                           src: Pointer to memory to be copied
+ * \param[in]                           size: Number of bytes to be copied
+ * \return                              Pointer to copy or `NULL` upon failure (or if size is zero)
+ */
+void *copy_to_arena(arena_t *arena, const void *src, size_t size);
+
+/**
+ * \brief                               Release all memory handed out by arena at once
+ * \note                                One standard-sized block is kept for reuse, all other blocks are freed
+ * \param[in,out]                       arena: Pointer to arena to be reset
+ */
+void reset_arena(arena_t *arena);
+
+/**
+ * \brief                               Free all blocks of arena
+ * \param[in,out]                       arena: Pointer to arena to be freed
+ */
+void free_arena(arena_t *arena);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ARENA_H */
@@ -41,7 +41,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "arena.h"
 #include "ast.h"
+#include "visitor.h"
 
 
 /*
@@ -290,9 +292,10 @@ static void apply_equality_op(equality_op_t op, value_t *out, type_t in_type_1,
 static div_by_zero_flag_t apply_integer_op(integer_op_t op, value_t *out, type_t in_type_1,
                      value_t in_value_1, type_t in_type_2, value_t in_value_2) {
     if (in_type_1 == INT_T && in_type_2 == INT_T) {
+        /* integers wrap around as at runtime, so overflowing operations are carried out on unsigned integers */
         switch (op) {
             case ADD_OP: {
-                out->i_val = in_value_1.i_val + in_value_2.i_val;
+                out->i_val = (int) ((unsigned) in_value_1.i_val + (unsigned) in_value_2.i_val);
                 break;
             }
             case AND_OP: {
@@ -303,18 +306,19 @@ static div_by_zero_flag_t apply_integer_op(integer_op_t op, value_t *out, type_t
                 if (in_value_2.i_val == 0) {
                     return DIV_BY_ZERO_F;
                 }
-                out->i_val = in_value_1.i_val / in_value_2.i_val;
+                out->i_val = (in_value_2.i_val == -1) ? (int) (0U - (unsigned) in_value_1.i_val)
+                                                     : in_value_1.i_val / in_value_2.i_val;
                 break;
             }
             case MOD_OP: {
                 if (in_value_2.i_val == 0) {
                     return MOD_BY_ZERO_F;
                 }
-                out->i_val = in_value_1.i_val % in_value_2.i_val;
+                out->i_val = (in_value_2.i_val == -1) ? 0 : in_value_1.i_val % in_value_2.i_val;
                 break;
             }
             case MUL_OP: {
-                out->i_val = in_value_1.i_val * in_value_2.i_val;
+                out->i_val = (int) ((unsigned) in_value_1.i_val * (unsigned) in_value_2.i_val);
                 break;
             }
             case OR_OP: {
@@ -322,7 +326,7 @@ static div_by_zero_flag_t apply_integer_op(integer_op_t op, value_t *out, type_t
                 break;
             }
             case SUB_OP: {
-                out->i_val = in_value_1.i_val - in_value_2.i_val;
+                out->i_val = (int) ((unsigned) in_value_1.i_val - (unsigned) in_value_2.i_val);
                 break;
             }
             case XOR_OP: {
@@ -389,49 +393,26 @@ static bool is_sp(const entry_t *entry) {
             && entry->pars_type_info[0].depth == 0);
 }
 
-/**
- * \brief                               Calculate length of an array of the given sizes and depth
- * \param[in]                           sizes: Array of array-sizes
- * \param                               depth: Array-depth
- * \return                              Array length
- */
-static unsigned get_length_of_array(const unsigned sizes[MAX_ARRAY_DEPTH], unsigned depth) {
-    unsigned result = 1;
-    for (unsigned i = 0; i < depth; ++i) {
-        result *= sizes[i];
-    }
-    return result;
-}
-
 /**
  * \brief                               Allocate new array from accessing a given array via indices
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena
+ * \param[in,out]                       arena: Pointer to arena the reduced array is allocated from
  * \param[in]                           values: Unreduced array
- * \param[in]                           sizes: Array of sizes of unreduced array
- * \param[in]                           depth: Depth of unreduced array
+ * \param[in]                           shape: Shape of unreduced array
  * \param[in]                           indices: Array of indices of access to unreduced array
  * \param[in]                           index_depth: Number of indices of access to unreduced array
  * \return                              Newly allocated reduced array of values
  */
-static value_t *new_reduced_array(const value_t *values, const unsigned sizes[MAX_ARRAY_DEPTH], unsigned depth,
-                           const unsigned indices[MAX_ARRAY_DEPTH], unsigned index_depth) {
-    unsigned out_length = 1;
-    for (unsigned i = index_depth; i < depth; ++i) {
-        out_length *= sizes[i];
-    }
+static value_t *new_reduced_array(arena_t *arena, const value_t *values, const shape_t *shape,
+                                  const unsigned indices[MAX_ARRAY_DEPTH], unsigned index_depth) {
+    unsigned out_length = get_shape_length(get_inner_shape(shape, index_depth));
 
     unsigned reduced_index = 0;
     for (unsigned i = 0; i < index_depth; ++i) {
-        unsigned factor = 1;
-        for (unsigned j = i + 1; j <depth; ++j) {
-            factor *= sizes[j];
-        }
-        reduced_index += factor * indices[i];
+        reduced_index += get_shape_length(get_inner_shape(shape, i + 1)) * indices[i];
     }
 
-    value_t* output = malloc( out_length * sizeof (value_t));
-    memcpy(output, values + reduced_index, out_length * sizeof (value_t));
-    return output;
+    return copy_to_arena(arena, values + reduced_index, out_length * sizeof (value_t));
 }
 
 /**
@@ -777,7 +758,7 @@ static bool copy_type_info_of_entry(type_info_t *type_info, const entry_t *entry
 
     type_info->qualifier = entry->qualifier;
     type_info->type = entry->type;
-    memcpy(type_info->sizes, entry->sizes, sizeof (entry->sizes));
+    type_info->shape = entry->shape;
     type_info->depth = entry->depth;
     return true;
 }
@@ -911,30 +892,15 @@ static bool copy_return_type_info_of_node(type_info_t *type_info, const node_t *
 }
 
 /* See header for documentation */
-node_t *new_stmt_list_node(bool is_quantizable, bool is_unitary, node_t **stmt_list, unsigned num_of_stmts,
-                           char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_stmt_list_node(arena_t *arena, bool is_quantizable, bool is_unitary, node_t **stmt_list,
+                           unsigned num_of_stmts, char error_msg[ERROR_MSG_LENGTH]) {
     return_style_t result_return_style = NONE_ST;
     type_info_t result_return_type_info;
     for (unsigned i = 0; i < num_of_stmts; ++i) {
         return_style_t current_return_style = get_return_style(stmt_list[i]);
         if ((stmt_list[i]->node_type == BREAK_NODE_T || stmt_list[i]->node_type == CONTINUE_NODE_T
             || current_return_style == DEFINITE_ST) && i < num_of_stmts - 1) {
-            for (unsigned j = i + 1; j < num_of_stmts; ++j) {
-                free_tree(stmt_list[j]);
-            }
             num_of_stmts = i + 1;
-            node_t **temp = realloc(stmt_list, num_of_stmts * sizeof (node_t *));
-            if (temp == NULL) {
-                snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for statement list node failed");
-                for (unsigned j = 0; j < num_of_stmts; ++j) {
-                    free_tree(stmt_list[j]);
-                }
-                free(stmt_list);
-                free_symbol_table();
-                return NULL;
-            }
-
-            stmt_list = temp;
         }
 
         if (current_return_style != NONE_ST) {
@@ -954,13 +920,13 @@ node_t *new_stmt_list_node(bool is_quantizable, bool is_unitary, node_t **stmt_l
                     return NULL;
                 }
 
-                for (unsigned j = 0; j < result_return_type_info.depth; ++j) {
-                    if (result_return_type_info.sizes[j] != current_return_type_info.sizes[j]) {
-                        snprintf(error_msg, ERROR_MSG_LENGTH,
-                                 "Non-matching sizes in depth %u (%u and %u) in return statements",
-                                 j, result_return_type_info.sizes[j], current_return_type_info.sizes[j]);
-                        return NULL;
-                    }
+                if (result_return_type_info.shape != current_return_type_info.shape) {
+                    unsigned j = get_mismatching_dimension(result_return_type_info.shape,
+                                                           current_return_type_info.shape);
+                    snprintf(error_msg, ERROR_MSG_LENGTH,
+                             "Non-matching sizes in depth %u (%u and %u) in return statements",
+                             j, result_return_type_info.shape->sizes[j], current_return_type_info.shape->sizes[j]);
+                    return NULL;
                 }
             } else {
                 copy_return_type_info_of_node(&result_return_type_info, stmt_list[i]);
@@ -969,21 +935,16 @@ node_t *new_stmt_list_node(bool is_quantizable, bool is_unitary, node_t **stmt_l
             result_return_style = current_return_style;
         }
     }
-    stmt_list_node_t *new_node = malloc(sizeof (stmt_list_node_t));
+    stmt_list_node_t *new_node = alloc_from_arena(arena, sizeof (stmt_list_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for statement list node failed");
-        for (unsigned j = 0; j < num_of_stmts; ++j) {
-            free_tree(stmt_list[j]);
-        }
-        free(stmt_list);
-        free_symbol_table();
         return NULL;
     }
 
     new_node->node_type = STMT_LIST_NODE_T;
     new_node->is_unitary = is_unitary;
     new_node->is_quantizable = is_quantizable;
-    new_node->stmt_list = stmt_list;
+    new_node->stmt_list = copy_to_arena(arena, stmt_list, num_of_stmts * sizeof (node_t *));
     new_node->num_of_stmts = num_of_stmts;
     new_node->return_style = result_return_style;
     if (result_return_style != NONE_ST) {
@@ -993,17 +954,15 @@ node_t *new_stmt_list_node(bool is_quantizable, bool is_unitary, node_t **stmt_l
 }
 
 /* See header for documentation */
-node_t *new_var_decl_node(entry_t *entry, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_var_decl_node(arena_t *arena, entry_t *entry, char error_msg[ERROR_MSG_LENGTH]) {
     if (entry->is_function) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "%s is a function", entry->name);
-        free_symbol_table();
         return NULL;
     }
 
-    var_decl_node_t *new_node = malloc(sizeof (var_decl_node_t));
+    var_decl_node_t *new_node = alloc_from_arena(arena, sizeof (var_decl_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for variable declaration node failed");
-        free_symbol_table();
         return NULL;
     }
 
@@ -1014,24 +973,18 @@ node_t *new_var_decl_node(entry_t *entry, char error_msg[ERROR_MSG_LENGTH]) {
 }
 
 /* See header for documentation */
-node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type_t *qualified_types,
+node_t *new_var_def_node(arena_t *arena, entry_t *entry, bool is_init_list, node_t *node, q_type_t *qualified_types,
                          array_value_t *values, unsigned length, char error_msg[ERROR_MSG_LENGTH]) {
     bool result_is_quantizable = true;
     bool result_is_unitary = true;
     if (is_init_list) {
         if (entry->depth == 0) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "%s is not an array, but is initialized as such", entry->name);
-            free(qualified_types);
-            free(values);
-            free_symbol_table();
             return NULL;
         } else if (length > entry->length) {
             snprintf(error_msg, ERROR_MSG_LENGTH,
                      "Too many (%u) elements initialized for array %s of total length %u",
                      length, entry->name, entry->length);
-            free(qualified_types);
-            free(values);
-            free_symbol_table();
             return NULL;
         }
 
@@ -1046,9 +999,6 @@ node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type
                              "Element %u: Quantizable function %s takes %s instead of %s",
                              i, current_entry->name, type_to_str(current_entry->pars_type_info[0].type),
                              type_to_str(entry->type));
-                    free(qualified_types);
-                    free(values);
-                    free_symbol_table();
                     return NULL;
                 }
             } else if (entry->qualifier != QUANTUM_T
@@ -1057,34 +1007,22 @@ node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type
                 snprintf(error_msg, ERROR_MSG_LENGTH,
                          "Element %u in initialization of classical array %s is a superposition instruction",
                          i, entry->name);
-                free(qualified_types);
-                free(values);
-                free_symbol_table();
                 return NULL;
             } else if (entry->qualifier != QUANTUM_T
                        && qualified_types[i].qualifier == QUANTUM_T) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Element %u in initialization of classical array %s is quantum",
                          i, entry->name);
-                free(qualified_types);
-                free(values);
-                free_symbol_table();
                 return NULL;
             } else if (entry->qualifier == CONST_T
                        && qualified_types[i].qualifier != CONST_T) {
                 snprintf(error_msg, ERROR_MSG_LENGTH,
                          "Element %u in initialization of constant array %s is not constant", i, entry->name);
-                free(qualified_types);
-                free(values);
-                free_symbol_table();
                 return NULL;
             } else if (!are_matching_types(entry->type, qualified_types[i].type)) {
                 snprintf(error_msg, ERROR_MSG_LENGTH,
                          "Element %u in initialization of %s-array %s is of type %s",
                          i, type_to_str(entry->type), entry->name,
                          type_to_str(qualified_types[i].type));
-                free(qualified_types);
-                free(values);
-                free_symbol_table();
                 return NULL;
             }
 
@@ -1098,101 +1036,72 @@ node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type
         if (!copy_type_info_of_node(&type_info, node)) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Right-hand side in initialization of %s is not an expression",
                      entry->name);
-            free_tree(node);
-            free_symbol_table();
             return NULL;
         } else if (entry->qualifier == QUANTUM_T && node->node_type == FUNC_SP_NODE_T) {
             entry_t *current_entry = ((func_sp_node_t *) node)->entry;
             if (current_entry->num_of_pars != 1) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Quantizable function %s must take exactly 1 parameter",
                          ((func_sp_node_t *) node)->entry->name);
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             } else if (current_entry->pars_type_info[0].qualifier != NONE_T) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Quantizable function %s must take a classical parameter",
                          ((func_sp_node_t *) node)->entry->name);
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             } else if (current_entry->pars_type_info[0].type != entry->type) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Quantizable function %s takes %s instead of %s",
                          ((func_sp_node_t *) node)->entry->name,
                          type_to_str(current_entry->pars_type_info[0].type), type_to_str(entry->type));
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             } else if (current_entry->pars_type_info[0].depth != 0) {
                 snprintf(error_msg, ERROR_MSG_LENGTH,
                          "Quantizable function %s takes an array of depth %u instead of a scalar",
                          ((func_sp_node_t *) node)->entry->name, current_entry->pars_type_info[0].depth);
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             }
         } else if (entry->qualifier != QUANTUM_T && node->node_type == FUNC_SP_NODE_T) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Classical variable %s cannot be initialized in superposition",
                      entry->name);
-            free_tree(node);
-            free_symbol_table();
             return NULL;
         } else if (!are_matching_types(entry->type, type_info.type)) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Variable %s of type %s is initialized with value%s of type %s",
                      type_to_str(entry->type), entry->name, (type_info.depth == 0) ? "" : "s",
                      type_to_str(type_info.type));
-            free_tree(node);
-            free_symbol_table();
             return NULL;
         } else if (entry->depth == 0 && type_info.depth != 0) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "%s is not an array, but is initialized as such", entry->name);
-            free_tree(node);
-            free_symbol_table();
             return NULL;
         } else if (entry->depth != type_info.depth) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Non-matching depths in array initialization of %s (%u != %u)",
                      entry->name, entry->depth, type_info.depth);
-            free_tree(node);
-            free_symbol_table();
             return NULL;
         }
 
-        for (unsigned i = 0; i < entry->depth; ++i) {
-            if (entry->sizes[i] != type_info.sizes[i]) {
-                snprintf(error_msg, ERROR_MSG_LENGTH,
-                         "Non-matching sizes at position %u in array initialization of %s (%u != %u)",
-                         i, entry->name, entry->sizes[i], type_info.sizes[i]);
-                free_tree(node);
-                free_symbol_table();
-                return NULL;
-            }
+        if (entry->shape != type_info.shape) {
+            unsigned i = get_mismatching_dimension(entry->shape, type_info.shape);
+            snprintf(error_msg, ERROR_MSG_LENGTH,
+                     "Non-matching sizes at position %u in array initialization of %s (%u != %u)",
+                     i, entry->name, entry->shape->sizes[i], type_info.shape->sizes[i]);
+            return NULL;
         }
 
         if (entry->qualifier != QUANTUM_T && type_info.qualifier == QUANTUM_T) {
             if (entry->depth == 0) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Initialization of classical scalar %s with quantum value",
                          entry->name);
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             } else {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Initialization of classical array %s with quantum array",
                          entry->name);
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             }
         } else if (entry->qualifier == CONST_T && type_info.qualifier != CONST_T) {
             if (entry->depth == 0) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Initialization of constant scalar %s with non-constant value",
                          entry->name);
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             } else {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Initialization of constant array %s with non-constant array",
                          entry->name);
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             }
         } else if (node->node_type != FUNC_SP_NODE_T
@@ -1200,14 +1109,10 @@ node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type
             if (entry->depth == 0) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Initialization of scalar %s of type %s with value of type %s",
                          entry->name, type_to_str(entry->type), type_to_str(type_info.type));
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             } else {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Initialization of %s-array %s with %s-array",
                          type_to_str(entry->type), entry->name, type_to_str(type_info.type));
-                free_tree(node);
-                free_symbol_table();
                 return NULL;
             }
         }
@@ -1216,16 +1121,9 @@ node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type
         result_is_unitary = is_unitary(node);
     }
 
-    var_def_node_t *new_node = malloc(sizeof (var_def_node_t));
+    var_def_node_t *new_node = alloc_from_arena(arena, sizeof (var_def_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for variable declaration node failed");
-        if (is_init_list) {
-            free(qualified_types);
-            free(values);
-        } else {
-            free_tree(node);
-        }
-        free_symbol_table();
         return NULL;
     }
 
@@ -1235,8 +1133,8 @@ node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type
     new_node->entry = entry;
     new_node->is_init_list = is_init_list;
     if (is_init_list) {
-        new_node->q_types = qualified_types;
-        new_node->values = values;
+        new_node->q_types = copy_to_arena(arena, qualified_types, length * sizeof (q_type_t));
+        new_node->values = copy_to_arena(arena, values, length * sizeof (array_value_t));
     } else {
         new_node->node = node;
     }
@@ -1251,18 +1149,17 @@ node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type
         } else {
             const_node_t *const_node_view = (const_node_t *) node;
             memcpy(entry->values, const_node_view->values, sizeof (value_t) *
-                   get_length_of_array(const_node_view->type_info.sizes, const_node_view->type_info.depth));
+                   get_shape_length(const_node_view->type_info.shape));
         }
     }
     return (node_t *) new_node;
 }
 
 /* See header for documentation */
-node_t *new_func_def_node(entry_t *entry, node_t *func_tail, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_func_def_node(arena_t *arena, entry_t *entry, node_t *func_tail, bool is_complete,
+                          char error_msg[ERROR_MSG_LENGTH]) {
     if (!(entry->is_function)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "%s is not a function", entry->name);
-        free_tree(func_tail);
-        free_symbol_table();
         return NULL;
     }
 
@@ -1277,7 +1174,7 @@ node_t *new_func_def_node(entry_t *entry, node_t *func_tail, char error_msg[ERRO
                      "Function %s is declared to return void, but has non-void return statement", entry->name);
             return NULL;
         }
-    } else {
+    } else if (is_complete || func_tail_return_style == DEFINITE_ST) {
         if (func_tail_return_style == NONE_ST) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Non-void function %s has no return statement", entry->name);
             return NULL;
@@ -1302,23 +1199,20 @@ node_t *new_func_def_node(entry_t *entry, node_t *func_tail, char error_msg[ERRO
                 return NULL;
             }
 
-            for (unsigned j = 0; j < entry->depth; ++j) {
-                if (entry->sizes[j] != func_tail_return_type_info.sizes[j]) {
-                    snprintf(error_msg, ERROR_MSG_LENGTH,
-                             "Declared return size of %u in depth %u of function %s does not match the actually "
-                             "returned size of %u",
-                             entry->sizes[j], j, entry->name, func_tail_return_type_info.sizes[j]);
-                    return NULL;
-                }
+            if (entry->shape != func_tail_return_type_info.shape) {
+                unsigned j = get_mismatching_dimension(entry->shape, func_tail_return_type_info.shape);
+                snprintf(error_msg, ERROR_MSG_LENGTH,
+                         "Declared return size of %u in depth %u of function %s does not match the actually "
+                         "returned size of %u",
+                         entry->shape->sizes[j], j, entry->name, func_tail_return_type_info.shape->sizes[j]);
+                return NULL;
             }
         }
     }
 
-    func_def_node_t *new_node = malloc(sizeof (func_def_node_t));
+    func_def_node_t *new_node = alloc_from_arena(arena, sizeof (func_def_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for function declaration node failed");
-        free_tree(func_tail);
-        free_symbol_table();
         return NULL;
     }
 
@@ -1329,22 +1223,21 @@ node_t *new_func_def_node(entry_t *entry, node_t *func_tail, char error_msg[ERRO
 }
 
 /* See header for documentation */
-node_t *new_const_node(type_t type, value_t value, char error_msg[ERROR_MSG_LENGTH]) {
-    const_node_t *new_node = malloc(sizeof (const_node_t));
+node_t *new_const_node(arena_t *arena, type_t type, value_t value, char error_msg[ERROR_MSG_LENGTH]) {
+    const_node_t *new_node = alloc_from_arena(arena, sizeof (const_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for constant node failed");
-        free_symbol_table();
         return NULL;
     }
 
     new_node->node_type = CONST_NODE_T;
     new_node->type_info.qualifier = CONST_T;
     new_node->type_info.type = type;
+    new_node->type_info.shape = NULL;
     new_node->type_info.depth = 0;
-    new_node->values = malloc(sizeof (value_t));
+    new_node->values = alloc_from_arena(arena, sizeof (value_t));
     if (new_node->values == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for value array of constant node failed");
-        free_symbol_table();
         return NULL;
     }
 
@@ -1353,17 +1246,16 @@ node_t *new_const_node(type_t type, value_t value, char error_msg[ERROR_MSG_LENG
 }
 
 /* See header for documentation */
-node_t *new_reference_node(entry_t *entry, const bool index_is_const[MAX_ARRAY_DEPTH],
+node_t *new_reference_node(arena_t *arena, entry_t *entry, const bool index_is_const[MAX_ARRAY_DEPTH],
                            const index_t indices[MAX_ARRAY_DEPTH], unsigned index_depth,
                            char error_msg[ERROR_MSG_LENGTH]) {
     bool all_indices_const = true;
     for (unsigned i = 0; i < index_depth; ++i) {
         all_indices_const &= index_is_const[i];
-        if (index_is_const[i] && indices[i].const_index >= entry->sizes[i]) {
+        if (index_is_const[i] && indices[i].const_index >= entry->shape->sizes[i]) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "%u-th index (%u) of array %s%s out of bounds (%u)",
                      i, indices[i].const_index, (entry->is_function) ? "returned by " : "", entry->name,
-                     entry->sizes[i]);
-            free_symbol_table();
+                     entry->shape->sizes[i]);
             return NULL;
         }
     }
@@ -1373,33 +1265,29 @@ node_t *new_reference_node(entry_t *entry, const bool index_is_const[MAX_ARRAY_D
         for (unsigned i = 0; i < index_depth; ++i) {
             const_indices[i] = indices[i].const_index;
         }
-        value_t *values = new_reduced_array(entry->values, entry->sizes, entry->depth, const_indices,
-                                            index_depth);
+        value_t *values = new_reduced_array(arena, entry->values, entry->shape, const_indices, index_depth);
         if (values == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for value extraction of %s failed", entry->name);
-            free_symbol_table();
             return NULL;
         }
 
-        const_node_t *new_node = malloc(sizeof (const_node_t));
+        const_node_t *new_node = alloc_from_arena(arena, sizeof (const_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for constant reference node failed");
-            free_symbol_table();
             return NULL;
         }
 
         new_node->node_type = CONST_NODE_T;
         new_node->type_info.qualifier = CONST_T;
         new_node->type_info.type = entry->type;
-        memcpy(new_node->type_info.sizes, entry->sizes + index_depth, (entry->depth - index_depth) * sizeof (unsigned));
+        new_node->type_info.shape = get_inner_shape(entry->shape, index_depth);
         new_node->type_info.depth = entry->depth - index_depth;
         new_node->values = values;
         return (node_t *) new_node;
     } else {
-        reference_node_t *new_node = malloc(sizeof (reference_node_t));
+        reference_node_t *new_node = alloc_from_arena(arena, sizeof (reference_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for reference node failed");
-            free_symbol_table();
             return NULL;
         }
 
@@ -1408,35 +1296,29 @@ node_t *new_reference_node(entry_t *entry, const bool index_is_const[MAX_ARRAY_D
         new_node->is_unitary = entry->qualifier == QUANTUM_T && all_indices_const;
         new_node->type_info.qualifier = (entry->qualifier == CONST_T) ? NONE_T : entry->qualifier;
         new_node->type_info.type = entry->type;
-        memcpy(new_node->type_info.sizes, entry->sizes + index_depth, (entry->depth - index_depth) * sizeof (unsigned));
+        new_node->type_info.shape = get_inner_shape(entry->shape, index_depth);
         new_node->type_info.depth = entry->depth - index_depth;
-        memcpy(new_node->index_is_const, index_is_const, sizeof (new_node->index_is_const));
-        memcpy(new_node->indices, indices, sizeof (new_node->indices));
+        new_node->index_is_const = copy_to_arena(arena, index_is_const, index_depth * sizeof (bool));
+        new_node->indices = copy_to_arena(arena, indices, index_depth * sizeof (index_t));
+        if (index_depth > 0 && (new_node->index_is_const == NULL || new_node->indices == NULL)) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for indices of reference node failed");
+            return NULL;
+        }
         new_node->entry = entry;
         return (node_t *) new_node;
     }
 }
 
 /* See header for documentation */
-node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_of_pars,
+node_t *new_func_call_node(arena_t *arena, bool sp, entry_t *entry, node_t **pars, unsigned num_of_pars,
                            char error_msg[ERROR_MSG_LENGTH]) {
     if (!entry->is_function) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Trying to call non-function %s", entry->name);
-        for (unsigned i = 0; i < num_of_pars; ++i) {
-            free_tree(pars[i]);
-        }
-        free(pars);
-        free_symbol_table();
         return NULL;
     } else if (entry->num_of_pars != num_of_pars) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Function %s requires %u parameter%s, but is called with %u parameter%s",
                  entry->name, entry->num_of_pars, (entry->num_of_pars == 1) ? "" : "s",
                  num_of_pars, (num_of_pars == 1) ? "" : "s");
-        for (unsigned i = 0; i < num_of_pars; ++i) {
-            free_tree(pars[i]);
-        }
-        free(pars);
-        free_symbol_table();
         return NULL;
     }
 
@@ -1444,20 +1326,10 @@ node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_
     if (sp) {
         if (!is_sp(entry)) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Function %s cannot be used to create a superposition", entry->name);
-            for (unsigned i = 0; i < num_of_pars; ++i) {
-                free_tree(pars[i]);
-            }
-            free(pars);
-            free_symbol_table();
             return NULL;
         } else if (pars[0]->node_type != REFERENCE_NODE_T) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Parameter in call to function %s is not a quantum variable",
                      entry->name);
-            for (unsigned i = 0; i < num_of_pars; ++i) {
-                free_tree(pars[i]);
-            }
-            free(pars);
-            free_symbol_table();
             return NULL;
         }
 
@@ -1465,21 +1337,11 @@ node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_
         if (reference_node_view->type_info.qualifier != QUANTUM_T) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Parameter in call to function %s is not a quantum variable",
                      entry->name);
-            for (unsigned i = 0; i < num_of_pars; ++i) {
-                free_tree(pars[i]);
-            }
-            free(pars);
-            free_symbol_table();
             return NULL;
         } else if (reference_node_view->type_info.type != entry->pars_type_info[0].type) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Parameter in call to function %s is of type %s instead of %s",
                      entry->name, type_to_str(reference_node_view->type_info.type),
                      type_to_str(entry->pars_type_info[0].type));
-            for (unsigned i = 0; i < num_of_pars; ++i) {
-                free_tree(pars[i]);
-            }
-            free(pars);
-            free_symbol_table();
             return NULL;
         }
     } else {
@@ -1488,11 +1350,6 @@ node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_
             if (!copy_type_info_of_node(&type_info_of_par, pars[i])) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Parameter %u in call to function %s is not an expression",
                          i + 1, entry->name);
-                for (unsigned j = 0; j < num_of_pars; ++j) {
-                    free_tree(pars[j]);
-                }
-                free(pars);
-                free_symbol_table();
                 return NULL;
             }
 
@@ -1501,11 +1358,6 @@ node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_
                     snprintf(error_msg, ERROR_MSG_LENGTH,
                              "Parameter %u in call to function %s is required to be classical, but is quantum",
                              i + 1, entry->name);
-                    for (unsigned j = 0; j < num_of_pars; ++j) {
-                        free_tree(pars[j]);
-                    }
-                    free(pars);
-                    free_symbol_table();
                     return NULL;
                 } else {
                     is_quantized = true;
@@ -1517,69 +1369,39 @@ node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_
                          "Parameter %u in call to function %s is required to be of type %s, but is of type %s",
                          i + 1, entry->name, type_to_str(entry->pars_type_info[i].type),
                          type_to_str(type_info_of_par.type));
-                for (unsigned j = 0; j < num_of_pars; ++j) {
-                    free_tree(pars[j]);
-                }
-                free(pars);
-                free_symbol_table();
                 return NULL;
             } else if (entry->pars_type_info[i].depth != type_info_of_par.depth) {
                 if (entry->pars_type_info[i].depth == 0) {
                     snprintf(error_msg, ERROR_MSG_LENGTH,
                              "Parameter %u in call to function %s is required to be a scalar, but is a depth-%u array",
                              i + 1, entry->name, type_info_of_par.depth);
-                    for (unsigned j = 0; j < num_of_pars; ++j) {
-                        free_tree(pars[j]);
-                    }
-                    free(pars);
-                    free_symbol_table();
                     return NULL;
                 } else if (type_info_of_par.depth == 0) {
                     snprintf(error_msg, ERROR_MSG_LENGTH,
                              "Parameter %u in call to function %s is required to be a depth-%u array, but is a scalar",
                              i + 1, entry->name, entry->pars_type_info[i].depth);
-                    for (unsigned j = 0; j < num_of_pars; ++j) {
-                        free_tree(pars[j]);
-                    }
-                    free(pars);
-                    free_symbol_table();
                     return NULL;
                 } else {
                     snprintf(error_msg, ERROR_MSG_LENGTH,
                              "Parameter %u in call to function %s is required to be a depth-%u array, but has depth %u",
                              i + 1, entry->name, entry->pars_type_info[i].depth, type_info_of_par.depth);
-                    for (unsigned j = 0; j < num_of_pars; ++j) {
-                        free_tree(pars[j]);
-                    }
-                    free(pars);
-                    free_symbol_table();
                     return NULL;
                 }
             }
-            for (unsigned j = 0; j < type_info_of_par.depth; ++j) {
-                if (entry->pars_type_info[i].sizes[j] != type_info_of_par.sizes[j]) {
-                    snprintf(error_msg, ERROR_MSG_LENGTH,
-                             "Parameter %u in call to function %s has size %u instead of %u in dimension %u",
-                             i + 1, entry->name, entry->pars_type_info[i].sizes[j], type_info_of_par.sizes[j], j + 1);
-                    for (unsigned k = 0; k < num_of_pars; ++k) {
-                        free_tree(pars[k]);
-                    }
-                    free(pars);
-                    free_symbol_table();
-                    return NULL;
-                }
+            if (entry->pars_type_info[i].shape != type_info_of_par.shape) {
+                unsigned j = get_mismatching_dimension(entry->pars_type_info[i].shape, type_info_of_par.shape);
+                snprintf(error_msg, ERROR_MSG_LENGTH,
+                         "Parameter %u in call to function %s has size %u instead of %u in dimension %u",
+                         i + 1, entry->name, entry->pars_type_info[i].shape->sizes[j], type_info_of_par.shape->sizes[j],
+                         j + 1);
+                return NULL;
             }
         }
     }
 
-    func_call_node_t *new_node = malloc(sizeof (func_call_node_t));
+    func_call_node_t *new_node = alloc_from_arena(arena, sizeof (func_call_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for reference node failed");
-        for (unsigned i = 0; i < num_of_pars; ++i) {
-            free_tree(pars[i]);
-        }
-        free(pars);
-        free_symbol_table();
         return NULL;
     }
 
@@ -1589,18 +1411,13 @@ node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_
         new_node->is_unitary = true;
         new_node->type_info.qualifier = NONE_T;
         new_node->type_info.type = VOID_T;
+        new_node->type_info.shape = NULL;
         new_node->type_info.depth = 0;
     } else if (is_quantized) {
         new_node->is_quantizable = false;
         new_node->is_unitary = true;
         if (!copy_type_info_of_entry(&new_node->type_info, entry)) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Copying type information for reference node failed");
-            for (unsigned i = 0; i < num_of_pars; ++i) {
-                free_tree(pars[i]);
-            }
-            free(pars);
-            free(new_node);
-            free_symbol_table();
             return NULL;
         }
 
@@ -1613,27 +1430,24 @@ node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_
     new_node->entry = entry;
     new_node->inverse = false;
     new_node->sp = sp;
-    new_node->pars = pars;
+    new_node->pars = copy_to_arena(arena, pars, num_of_pars * sizeof (node_t *));
     new_node->num_of_pars = num_of_pars;
     return (node_t *) new_node;
 }
 
 /* See header for documentation */
-node_t *new_func_sp_node(entry_t *entry, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_func_sp_node(arena_t *arena, entry_t *entry, char error_msg[ERROR_MSG_LENGTH]) {
     if (!entry->is_function) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "%s is not a function", entry->name);
-        free_symbol_table();
         return NULL;
     } else if (!is_sp(entry)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Function %s cannot be used to create a superposition", entry->name);
-        free_symbol_table();
         return NULL;
     }
 
-    func_def_node_t *new_node = malloc(sizeof (func_sp_node_t));
+    func_def_node_t *new_node = alloc_from_arena(arena, sizeof (func_sp_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for function superposition node failed");
-        free_symbol_table();
         return NULL;
     }
 
@@ -1643,7 +1457,8 @@ node_t *new_func_sp_node(entry_t *entry, char error_msg[ERROR_MSG_LENGTH]) {
 }
 
 /* See header for documentation */
-node_t *new_logical_op_node(node_t *left, logical_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_logical_op_node(arena_t *arena, node_t *left, logical_op_t op, node_t *right,
+                            char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t left_type_info;
     type_info_t right_type_info;
     if (!copy_type_info_of_node(&left_type_info, left)) {
@@ -1680,16 +1495,15 @@ node_t *new_logical_op_node(node_t *left, logical_op_t op, node_t *right, char e
     }
 
     unsigned depth = left_type_info.depth;
-    for (unsigned i = 0; i < depth; ++i) {
-        if (left_type_info.sizes[i] != right_type_info.sizes[i]) {
-            snprintf(error_msg, ERROR_MSG_LENGTH,
-                     "Applying \"%s\" to arrays of different sizes in dimension %u (%u != %u)",
-                     logical_op_to_str(op), depth, left_type_info.sizes[i], right_type_info.sizes[i]);
-            return NULL;
-        }
+    if (left_type_info.shape != right_type_info.shape) {
+        unsigned i = get_mismatching_dimension(left_type_info.shape, right_type_info.shape);
+        snprintf(error_msg, ERROR_MSG_LENGTH,
+                 "Applying \"%s\" to arrays of different sizes in dimension %u (%u != %u)",
+                 logical_op_to_str(op), depth, left_type_info.shape->sizes[i], right_type_info.shape->sizes[i]);
+        return NULL;
     }
 
-    unsigned length = get_length_of_array(left_type_info.sizes, depth);
+    unsigned length = get_shape_length(left_type_info.shape);
     if (result_qualifier == CONST_T) { /* left and right are of node_type CONST_NODE_T */
         const_node_t *const_node_view_left = (const_node_t *) left;
         const_node_t *const_node_view_right = (const_node_t *) right;
@@ -1699,11 +1513,9 @@ node_t *new_logical_op_node(node_t *left, logical_op_t op, node_t *right, char e
             apply_logical_op(op, const_node_view_left->values + i, const_node_view_left->values[i],
                              const_node_view_right->values[i]);
         }
-        free(const_node_view_right->values);
-        free(const_node_view_right);
         return left;
     } else {
-        logical_op_node_t *new_node = malloc(sizeof (logical_op_node_t));
+        logical_op_node_t *new_node = alloc_from_arena(arena, sizeof (logical_op_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for logical operator node failed");
             return NULL;
@@ -1714,7 +1526,7 @@ node_t *new_logical_op_node(node_t *left, logical_op_t op, node_t *right, char e
         new_node->is_unitary = is_unitary(left) && is_unitary(right);
         new_node->type_info.qualifier = result_qualifier;
         new_node->type_info.type = BOOL_T;
-        memcpy(new_node->type_info.sizes, left_type_info.sizes, sizeof (left_type_info.sizes));
+        new_node->type_info.shape = left_type_info.shape;
         new_node->type_info.depth = depth;
         new_node->op = op;
         new_node->left = left;
@@ -1724,7 +1536,8 @@ node_t *new_logical_op_node(node_t *left, logical_op_t op, node_t *right, char e
 }
 
 /* See header for documentation */
-node_t *new_comparison_op_node(node_t *left, comparison_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_comparison_op_node(arena_t *arena, node_t *left, comparison_op_t op, node_t *right,
+                               char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t left_type_info;
     type_info_t right_type_info;
     if (!copy_type_info_of_node(&left_type_info, left)) {
@@ -1760,16 +1573,15 @@ node_t *new_comparison_op_node(node_t *left, comparison_op_t op, node_t *right,
     }
 
     unsigned depth = left_type_info.depth;
-    for (unsigned i = 0; i < depth; ++i) {
-        if (left_type_info.sizes[i] != right_type_info.sizes[i]) {
-            snprintf(error_msg, ERROR_MSG_LENGTH,
-                     "\"%s\"-comparison of arrays of different sizes in dimension %u (%u != %u)",
-                     comparison_op_to_str(op), depth, left_type_info.sizes[i], right_type_info.sizes[i]);
-            return NULL;
-        }
+    if (left_type_info.shape != right_type_info.shape) {
+        unsigned i = get_mismatching_dimension(left_type_info.shape, right_type_info.shape);
+        snprintf(error_msg, ERROR_MSG_LENGTH,
+                 "\"%s\"-comparison of arrays of different sizes in dimension %u (%u != %u)",
+                 comparison_op_to_str(op), depth, left_type_info.shape->sizes[i], right_type_info.shape->sizes[i]);
+        return NULL;
     }
 
-    unsigned length = get_length_of_array(left_type_info.sizes, depth);
+    unsigned length = get_shape_length(left_type_info.shape);
     if (result_qualifier == CONST_T) { /* left and right are of node_type CONST_NODE_T */
         const_node_t *const_node_view_left = (const_node_t *) left;
         const_node_t *const_node_view_right = (const_node_t *) right;
@@ -1780,11 +1592,9 @@ node_t *new_comparison_op_node(node_t *left, comparison_op_t op, node_t *right,
                                 const_node_view_left->values[i], right_type_info.type,
                                 const_node_view_right->values[i]);
         }
-        free(const_node_view_right->values);
-        free(const_node_view_right);
         return left;
     } else {
-        comparison_op_node_t *new_node = malloc(sizeof (comparison_op_node_t));
+        comparison_op_node_t *new_node = alloc_from_arena(arena, sizeof (comparison_op_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for comparison operator node failed");
             return NULL;
@@ -1795,7 +1605,7 @@ node_t *new_comparison_op_node(node_t *left, comparison_op_t op, node_t *right,
         new_node->is_unitary = is_unitary(left) && is_unitary(right);
         new_node->type_info.qualifier = result_qualifier;
         new_node->type_info.type = BOOL_T;
-        memcpy(new_node->type_info.sizes, left_type_info.sizes, sizeof (left_type_info.sizes));
+        new_node->type_info.shape = left_type_info.shape;
         new_node->type_info.depth = depth;
         new_node->op = op;
         new_node->left = left;
@@ -1805,7 +1615,8 @@ node_t *new_comparison_op_node(node_t *left, comparison_op_t op, node_t *right,
 }
 
 /* See header for documentation */
-node_t *new_equality_op_node(node_t *left, equality_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_equality_op_node(arena_t *arena, node_t *left, equality_op_t op, node_t *right,
+                             char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t left_type_info;
     type_info_t right_type_info;
     if (!copy_type_info_of_node(&left_type_info, left)) {
@@ -1841,16 +1652,15 @@ node_t *new_equality_op_node(node_t *left, equality_op_t op, node_t *right, char
     }
 
     unsigned depth = left_type_info.depth;
-    for (unsigned i = 0; i < depth; ++i) {
-        if (left_type_info.sizes[i] != right_type_info.sizes[i]) {
-            snprintf(error_msg, ERROR_MSG_LENGTH,
-                     "Checking %sequality of arrays of different sizes in dimension %u (%u != %u)",
-                     (op == EQ_OP) ? "" : "in", depth, left_type_info.sizes[i], right_type_info.sizes[i]);
-            return NULL;
-        }
+    if (left_type_info.shape != right_type_info.shape) {
+        unsigned i = get_mismatching_dimension(left_type_info.shape, right_type_info.shape);
+        snprintf(error_msg, ERROR_MSG_LENGTH,
+                 "Checking %sequality of arrays of different sizes in dimension %u (%u != %u)",
+                 (op == EQ_OP) ? "" : "in", depth, left_type_info.shape->sizes[i], right_type_info.shape->sizes[i]);
+        return NULL;
     }
 
-    unsigned length = get_length_of_array(left_type_info.sizes, depth);
+    unsigned length = get_shape_length(left_type_info.shape);
     if (result_qualifier == CONST_T) { /* left and right are of node_type CONST_NODE_T */
         const_node_t *const_node_view_left = (const_node_t *) left;
         const_node_t *const_node_view_right = (const_node_t *) right;
@@ -1864,11 +1674,9 @@ node_t *new_equality_op_node(node_t *left, equality_op_t op, node_t *right, char
                               right_type_info.type,
                               const_node_view_right->values[i]);
         }
-        free(const_node_view_right->values);
-        free(const_node_view_right);
         return left;
     } else {
-        equality_op_node_t *new_node = malloc( sizeof (equality_op_node_t));
+        equality_op_node_t *new_node = alloc_from_arena(arena, sizeof (equality_op_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for equality operator node failed");
             return NULL;
@@ -1879,7 +1687,7 @@ node_t *new_equality_op_node(node_t *left, equality_op_t op, node_t *right, char
         new_node->is_unitary = is_unitary(left) && is_unitary(right);
         new_node->type_info.qualifier = result_qualifier;
         new_node->type_info.type = BOOL_T;
-        memcpy(new_node->type_info.sizes, left_type_info.sizes, sizeof (left_type_info.sizes));
+        new_node->type_info.shape = left_type_info.shape;
         new_node->type_info.depth = depth;
         new_node->op = op;
         new_node->left = left;
@@ -1889,7 +1697,7 @@ node_t *new_equality_op_node(node_t *left, equality_op_t op, node_t *right, char
 }
 
 /* See header for documentation */
-node_t *new_not_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_not_op_node(arena_t *arena, node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t child_type_info;
     if (!copy_type_info_of_node(&child_type_info, child)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Applying \"!\" to a non-expression");
@@ -1904,7 +1712,7 @@ node_t *new_not_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
     }
 
     if (result_qualifier == CONST_T) { /* child is of node_type CONST_NODE_T */
-        unsigned length = get_length_of_array(child_type_info.sizes, child_type_info.depth);
+        unsigned length = get_shape_length(child_type_info.shape);
         const_node_t *const_node_view_child = (const_node_t *) child;
         for (unsigned i = 0; i < length; ++i) {
             const_node_view_child->values[i].b_val = !(const_node_view_child->values[i].b_val);
@@ -1912,11 +1720,9 @@ node_t *new_not_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
         return child;
     } else if (child->node_type == NOT_OP_NODE_T) {
         not_op_node_t *not_op_node_view_child = (not_op_node_t *) child;
-        node_t *result = not_op_node_view_child->child;
-        free(not_op_node_view_child);
-        return result;
+        return not_op_node_view_child->child;
     } else {
-        not_op_node_t *new_node = malloc(sizeof (not_op_node_t));
+        not_op_node_t *new_node = alloc_from_arena(arena, sizeof (not_op_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for not-operator node failed");
             return NULL;
@@ -1927,7 +1733,7 @@ node_t *new_not_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
         new_node->is_unitary = is_unitary(child);
         new_node->type_info.qualifier = result_qualifier;
         new_node->type_info.type = BOOL_T;
-        memcpy(new_node->type_info.sizes, child_type_info.sizes, sizeof (child_type_info.sizes));
+        new_node->type_info.shape = child_type_info.shape;
         new_node->type_info.depth = child_type_info.depth;
         new_node->child = child;
         return (node_t *) new_node;
@@ -1935,7 +1741,8 @@ node_t *new_not_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
 }
 
 /* See header for documentation */
-node_t *new_integer_op_node(node_t *left, integer_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_integer_op_node(arena_t *arena, node_t *left, integer_op_t op, node_t *right,
+                            char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t left_type_info;
     type_info_t right_type_info;
     if (!copy_type_info_of_node(&left_type_info, left)) {
@@ -1973,16 +1780,15 @@ node_t *new_integer_op_node(node_t *left, integer_op_t op, node_t *right, char e
     }
     unsigned depth = left_type_info.depth;
 
-    for (unsigned i = 0; i < depth; ++i) {
-        if (left_type_info.sizes[i] != right_type_info.sizes[i]) {
-            snprintf(error_msg, ERROR_MSG_LENGTH,
-                     "Applying \"%s\" to arrays of different sizes in dimension %u (%u != %u)",
-                     integer_op_to_str(op), depth, left_type_info.sizes[i], right_type_info.sizes[i]);
-            return NULL;
-        }
+    if (left_type_info.shape != right_type_info.shape) {
+        unsigned i = get_mismatching_dimension(left_type_info.shape, right_type_info.shape);
+        snprintf(error_msg, ERROR_MSG_LENGTH,
+                 "Applying \"%s\" to arrays of different sizes in dimension %u (%u != %u)",
+                 integer_op_to_str(op), depth, left_type_info.shape->sizes[i], right_type_info.shape->sizes[i]);
+        return NULL;
     }
 
-    unsigned length = get_length_of_array(left_type_info.sizes, depth);
+    unsigned length = get_shape_length(left_type_info.shape);
     if (result_qualifier == CONST_T) { /* left and right are of node_type CONST_NODE_T */
         const_node_t *const_node_view_left = (const_node_t *) left;
         const_node_t *const_node_view_right = (const_node_t *) right;
@@ -1996,26 +1802,16 @@ node_t *new_integer_op_node(node_t *left, integer_op_t op, node_t *right, char e
                                                   right_type_info.type,
                                                   const_node_view_right->values[i]);
             if (validity_check == 1) {
-                free(const_node_view_left->values);
-                free(const_node_view_left);
-                free(const_node_view_right->values);
-                free(const_node_view_right);
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Division by zero");
                 return NULL;
             } else if (validity_check == 2) {
-                free(const_node_view_left->values);
-                free(const_node_view_left);
-                free(const_node_view_right->values);
-                free(const_node_view_right);
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Modulo by zero");
                 return NULL;
             }
         }
-        free(const_node_view_right->values);
-        free(const_node_view_right);
         return left;
     } else {
-        integer_op_node_t *new_node = malloc(sizeof (integer_op_node_t));
+        integer_op_node_t *new_node = alloc_from_arena(arena, sizeof (integer_op_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for integer operator node failed");
             return NULL;
@@ -2026,7 +1822,7 @@ node_t *new_integer_op_node(node_t *left, integer_op_t op, node_t *right, char e
         new_node->is_unitary = is_unitary(left) && is_unitary(right);
         new_node->type_info.qualifier = result_qualifier;
         new_node->type_info.type = result_type;
-        memcpy(new_node->type_info.sizes, left_type_info.sizes, sizeof (left_type_info.sizes));
+        new_node->type_info.shape = left_type_info.shape;
         new_node->type_info.depth = depth;
         new_node->op = op;
         new_node->left = left;
@@ -2036,7 +1832,7 @@ node_t *new_integer_op_node(node_t *left, integer_op_t op, node_t *right, char e
 }
 
 /* See header for documentation */
-node_t *new_invert_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_invert_op_node(arena_t *arena, node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t child_type_info;
     if (!copy_type_info_of_node(&child_type_info, child)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Applying \"~\" to a non-expression");
@@ -2051,7 +1847,7 @@ node_t *new_invert_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
     }
 
     if (result_qualifier == CONST_T) { /* child is of node_type CONST_NODE_T */
-        unsigned length = get_length_of_array(child_type_info.sizes, child_type_info.depth);
+        unsigned length = get_shape_length(child_type_info.shape);
         const_node_t *const_node_view_child = (const_node_t *) child;
         if (result_type == INT_T) {
             for (unsigned i = 0; i < length; ++i) {
@@ -2065,11 +1861,9 @@ node_t *new_invert_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
         return child;
     } else if (child->node_type == INVERT_OP_NODE_T) {
         invert_op_node_t *invert_op_node_view_child = (invert_op_node_t *) child;
-        node_t *result = invert_op_node_view_child->child;
-        free(invert_op_node_view_child);
-        return result;
+        return invert_op_node_view_child->child;
     } else {
-        invert_op_node_t *new_node = malloc(sizeof(invert_op_node_t));
+        invert_op_node_t *new_node = alloc_from_arena(arena, sizeof (invert_op_node_t));
         if (new_node == NULL) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for invert-operator node failed");
             return NULL;
@@ -2080,7 +1874,7 @@ node_t *new_invert_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
         new_node->is_unitary = is_unitary(child);
         new_node->type_info.qualifier = result_qualifier;
         new_node->type_info.type = result_type;
-        memcpy(new_node->type_info.sizes, child_type_info.sizes, sizeof (child_type_info.sizes));
+        new_node->type_info.shape = child_type_info.shape;
         new_node->type_info.depth = child_type_info.depth;
         new_node->child = child;
         return (node_t *) new_node;
@@ -2088,7 +1882,7 @@ node_t *new_invert_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
 }
 
 /* See header for documentation */
-node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, unsigned num_of_else_ifs,
+node_t *new_if_node(arena_t *arena, node_t *condition, node_t *if_branch, node_t **else_ifs, unsigned num_of_else_ifs,
                     node_t *else_branch, char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t if_condition_type_info;
     return_style_t if_return_style = get_return_style(if_branch);
@@ -2100,63 +1894,23 @@ node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, uns
     bool result_is_unitary = is_unitary(condition);
     if (!copy_type_info_of_node(&if_condition_type_info, condition)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "If-condition is not an expression");
-        free_tree(condition);
-        free_tree(if_branch);
-        for (unsigned i = 0; i < num_of_else_ifs; ++i) {
-            free_tree(else_ifs[i]);
-        }
-        free(else_ifs);
-        free_tree(else_branch);
-        free_symbol_table();
         return NULL;
     } else if (if_condition_type_info.type != BOOL_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "If-condition must be of type bool, but is of type %s",
                  type_to_str(if_condition_type_info.type));
-        free_tree(condition);
-        free_tree(if_branch);
-        for (unsigned i = 0; i < num_of_else_ifs; ++i) {
-            free_tree(else_ifs[i]);
-        }
-        free(else_ifs);
-        free_tree(else_branch);
-        free_symbol_table();
         return NULL;
     } else if (if_condition_type_info.depth != 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "If-condition must be a single bool, but is an array of depth %u",
                  if_condition_type_info.depth);
-        free_tree(condition);
-        free_tree(if_branch);
-        for (unsigned i = 0; i < num_of_else_ifs; ++i) {
-            free_tree(else_ifs[i]);
-        }
-        free(else_ifs);
-        free_tree(else_branch);
-        free_symbol_table();
         return NULL;
     } else if (if_condition_type_info.qualifier == QUANTUM_T) {
         if (!is_unitary(if_branch) || if_return_style != NONE_ST) {
             snprintf(error_msg, ERROR_MSG_LENGTH,
                      "If-condition is quantum, but statements in if-branch are not unitary");
-            free_tree(condition);
-            free_tree(if_branch);
-            for (unsigned i = 0; i < num_of_else_ifs; ++i) {
-                free_tree(else_ifs[i]);
-            }
-            free(else_ifs);
-            free_tree(else_branch);
-            free_symbol_table();
             return NULL;
         } else if (else_branch != NULL && (!is_unitary(else_branch) || else_return_style != NONE_ST)) {
             snprintf(error_msg, ERROR_MSG_LENGTH,
                      "If-condition is quantum, but statements in else-branch are not unitary");
-            free_tree(condition);
-            free_tree(if_branch);
-            for (unsigned i = 0; i < num_of_else_ifs; ++i) {
-                free_tree(else_ifs[i]);
-            }
-            free(else_ifs);
-            free_tree(else_branch);
-            free_symbol_table();
             return NULL;
         }
     }
@@ -2177,14 +1931,6 @@ node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, uns
             snprintf(error_msg, ERROR_MSG_LENGTH, "Else-if-condition %u is %s while if-condition is %s",
                      i + 1, (else_if_condition_type_info.qualifier  == QUANTUM_T) ? "quantum" : "classical",
                      (if_condition_type_info.qualifier == QUANTUM_T) ? "quantum" : "classical");
-            free_tree(condition);
-            free_tree(if_branch);
-            for (unsigned j = 0; j < num_of_else_ifs; ++j) {
-                free_tree(else_ifs[j]);
-            }
-            free(else_ifs);
-            free_tree(else_branch);
-            free_symbol_table();
             return NULL;
         }
 
@@ -2212,14 +1958,13 @@ node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, uns
                     return NULL;
                 }
 
-                for (unsigned j = 0; j < result_return_type_info.depth; ++j) {
-                    if (result_return_type_info.sizes[j] != elif_return_type_info.sizes[j]) {
-                        snprintf(error_msg, ERROR_MSG_LENGTH,
-                                 "Non-matching sizes in depth %u (%u and %u) in return statements in if-branch"
-                                 "and else-if-branch %u",
-                                 j, result_return_type_info.sizes[j], elif_return_type_info.sizes[j], i + 1);
-                        return NULL;
-                    }
+                if (result_return_type_info.shape != elif_return_type_info.shape) {
+                    unsigned j = get_mismatching_dimension(result_return_type_info.shape, elif_return_type_info.shape);
+                    snprintf(error_msg, ERROR_MSG_LENGTH,
+                             "Non-matching sizes in depth %u (%u and %u) in return statements in if-branch"
+                             "and else-if-branch %u",
+                             j, result_return_type_info.shape->sizes[j], elif_return_type_info.shape->sizes[j], i + 1);
+                    return NULL;
                 }
                 result_return_style = (current_return_style == DEFINITE_ST && result_return_style == DEFINITE_ST) ?
                 DEFINITE_ST : CONDITIONAL_ST;
@@ -2251,14 +1996,13 @@ node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, uns
                 return NULL;
             }
 
-            for (unsigned j = 0; j < result_return_type_info.depth; ++j) {
-                if (result_return_type_info.sizes[j] != else_return_type_info.sizes[j]) {
-                    snprintf(error_msg, ERROR_MSG_LENGTH,
-                             "Non-matching sizes in depth %u (%u and %u) in return statements in if-branch"
-                             " and else-branch",
-                             j, result_return_type_info.sizes[j], else_return_type_info.sizes[j]);
-                    return NULL;
-                }
+            if (result_return_type_info.shape != else_return_type_info.shape) {
+                unsigned j = get_mismatching_dimension(result_return_type_info.shape, else_return_type_info.shape);
+                snprintf(error_msg, ERROR_MSG_LENGTH,
+                         "Non-matching sizes in depth %u (%u and %u) in return statements in if-branch"
+                         " and else-branch",
+                         j, result_return_type_info.shape->sizes[j], else_return_type_info.shape->sizes[j]);
+                return NULL;
             }
 
             result_return_style = (else_return_style == DEFINITE_ST && result_return_style == DEFINITE_ST) ?
@@ -2271,17 +2015,9 @@ node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, uns
         copy_return_type_info_of_node(&result_return_type_info, else_branch);
     }
 
-    if_node_t *new_node = malloc(sizeof (if_node_t));
+    if_node_t *new_node = alloc_from_arena(arena, sizeof (if_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for if node failed");
-        free_tree(condition);
-        free_tree(if_branch);
-        for (unsigned i = 0; i < num_of_else_ifs; ++i) {
-            free_tree(else_ifs[i]);
-        }
-        free(else_ifs);
-        free_tree(else_branch);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2290,7 +2026,7 @@ node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, uns
     new_node->is_unitary = result_is_unitary;
     new_node->condition = condition;
     new_node->if_branch = if_branch;
-    new_node->else_ifs = else_ifs;
+    new_node->else_ifs = copy_to_arena(arena, else_ifs, num_of_else_ifs * sizeof (node_t *));
     new_node->num_of_else_ifs = num_of_else_ifs;
     new_node->else_branch = else_branch;
     new_node->return_style = result_return_style;
@@ -2301,44 +2037,29 @@ node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, uns
 }
 
 /* See header for documentation */
-node_t *new_else_if_node(node_t *condition, node_t *else_if_branch, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_else_if_node(arena_t *arena, node_t *condition, node_t *else_if_branch, char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t condition_type_info;
     return_style_t else_if_return_style = get_return_style(else_if_branch);
     if (!copy_type_info_of_node(&condition_type_info, condition)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Else-if-condition is not an expression");
-        free_tree(condition);
-        free_tree(else_if_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.type != BOOL_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Else-if-condition must be of type bool, but is of type %s",
                  type_to_str(condition_type_info.type));
-        free_tree(condition);
-        free_tree(else_if_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.depth != 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Else-if-condition must be a single bool, but is an array of depth %u",
                  condition_type_info.depth);
-        free_tree(condition);
-        free_tree(else_if_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.qualifier == QUANTUM_T && (!(((stmt_list_node_t *) else_if_branch)->is_unitary)
                 || else_if_return_style != NONE_ST)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Else-if-condition is quantum, but statements are not unitary");
-        free_tree(condition);
-        free_tree(else_if_branch);
-        free_symbol_table();
         return NULL;
     }
 
-    else_if_node_t *new_node = malloc(sizeof (else_if_node_t));
+    else_if_node_t *new_node = alloc_from_arena(arena, sizeof (else_if_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for else-if node failed");
-        free_tree(condition);
-        free_tree(else_if_branch);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2358,7 +2079,8 @@ node_t *new_else_if_node(node_t *condition, node_t *else_if_branch, char error_m
 }
 
 /* See header for documentation */
-node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_cases, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_switch_node(arena_t *arena, node_t *expression, node_t **cases, unsigned num_of_cases,
+                        char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t expression_type_info;
     return_style_t result_return_style = NONE_ST;
     type_info_t result_return_type_info;
@@ -2366,22 +2088,10 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
     bool result_is_unitary = is_unitary(expression);
     if (!copy_type_info_of_node(&expression_type_info, expression)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "No valid switch-expression");
-        free_tree(expression);
-        for (unsigned i = 0; i < num_of_cases; ++i) {
-            free_tree(cases[i]);
-        }
-        free(cases);
-        free_symbol_table();
         return NULL;
     } else if (expression_type_info.depth != 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Switch-expression must be a scalar, but is an array of depth %u",
                  expression_type_info.depth);
-        free_tree(expression);
-        for (unsigned i = 0; i < num_of_cases; ++i) {
-            free_tree(cases[i]);
-        }
-        free(cases);
-        free_symbol_table();
         return NULL;
     }
     bool has_default_case = false;
@@ -2393,22 +2103,10 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
             && !are_matching_types(expression_type_info.type, case_node_view->case_const_type)) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Case %u is of type %s while switch-expression is of type %s",
                      i + 1, type_to_str(case_node_view->case_const_type), type_to_str(expression_type_info.type));
-            free_tree(expression);
-            for (unsigned j = 0; j < num_of_cases; ++j) {
-                free_tree(cases[j]);
-            }
-            free(cases);
-            free_symbol_table();
             return NULL;
         } else if (expression_type_info.qualifier == QUANTUM_T && !(case_node_view->is_unitary)) {
             snprintf(error_msg, ERROR_MSG_LENGTH,
                      "Switch-expression is quantum, but statements in case %u are not unitary", i + 1);
-            free_tree(expression);
-            for (unsigned j = 0; j < num_of_cases; ++j) {
-                free_tree(cases[j]);
-            }
-            free(cases);
-            free_symbol_table();
             return NULL;
         }
 
@@ -2433,13 +2131,12 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
                     return NULL;
                 }
 
-                for (unsigned j = 0; j < result_return_type_info.depth; ++j) {
-                    if (result_return_type_info.sizes[j] != case_return_type_info.sizes[j]) {
-                        snprintf(error_msg, ERROR_MSG_LENGTH,
-                                 "Non-matching sizes in depth %u (%u and %u) in return statements in case-branches",
-                                 j, result_return_type_info.sizes[j], case_return_type_info.sizes[j]);
-                        return NULL;
-                    }
+                if (result_return_type_info.shape != case_return_type_info.shape) {
+                    unsigned j = get_mismatching_dimension(result_return_type_info.shape, case_return_type_info.shape);
+                    snprintf(error_msg, ERROR_MSG_LENGTH,
+                             "Non-matching sizes in depth %u (%u and %u) in return statements in case-branches",
+                             j, result_return_type_info.shape->sizes[j], case_return_type_info.shape->sizes[j]);
+                    return NULL;
                 }
                 result_return_style = (current_return_style == DEFINITE_ST && result_return_style == DEFINITE_ST) ?
                                       DEFINITE_ST : CONDITIONAL_ST;
@@ -2452,22 +2149,7 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
         if (case_node_view->case_const_type == VOID_T) {
             has_default_case = true;
             if (i < num_of_cases - 1) { /* default statement reached */
-                for (unsigned j = i + 1; j < num_of_cases; ++j) {
-                    free_tree(cases[j]);
-                }
                 num_of_cases = i + 1;
-                node_t **temp = realloc(cases, num_of_cases * sizeof(node_t *));
-                if (temp == NULL) {
-                    snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating case list in switch node failed");
-                    free_tree(expression);
-                    for (unsigned j = 0; j < num_of_cases; ++j) {
-                        free_tree(cases[j]);
-                    }
-                    free(cases);
-                    free_symbol_table();
-                    return NULL;
-                }
-                cases = temp;
                 break;
             }
         }
@@ -2479,12 +2161,6 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
                 || (case_node_view->case_const_type == INT_T
                     && case_node_view->case_const_value.i_val == prior_case_node_view->case_const_value.i_val)) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Cases %u and %u have the same value", j + 1, i + 1);
-                free_tree(expression);
-                for (unsigned k = 0; k < num_of_cases; ++k) {
-                    free_tree(cases[k]);
-                }
-                free(cases);
-                free_symbol_table();
                 return NULL;
             }
         }
@@ -2497,15 +2173,9 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
     if (!has_default_case) {
         result_return_style = (result_return_style == NONE_ST) ? NONE_ST : CONDITIONAL_ST;
     }
-    switch_node_t *new_node = malloc(sizeof (switch_node_t));
+    switch_node_t *new_node = alloc_from_arena(arena, sizeof (switch_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for switch node failed");
-        free_tree(expression);
-        for (unsigned i = 0; i < num_of_cases; ++i) {
-            free_tree(cases[i]);
-        }
-        free(cases);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2513,7 +2183,7 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
     new_node->is_quantizable = result_is_quantizable;
     new_node->is_unitary = result_is_unitary;
     new_node->expression = expression;
-    new_node->cases = cases;
+    new_node->cases = copy_to_arena(arena, cases, num_of_cases * sizeof (node_t *));
     new_node->num_of_cases = num_of_cases;
     new_node->return_style = result_return_style;
     if (result_return_style != NONE_ST) {
@@ -2523,14 +2193,11 @@ node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_case
 }
 
 /* See header for documentation */
-node_t *new_case_node(node_t *case_const, node_t *case_branch, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_case_node(arena_t *arena, node_t *case_const, node_t *case_branch, char error_msg[ERROR_MSG_LENGTH]) {
     return_style_t case_return_style = get_return_style(case_branch);
-    case_node_t *new_node = malloc(sizeof (case_node_t));
+    case_node_t *new_node = alloc_from_arena(arena, sizeof (case_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for case node failed");
-        free_tree(case_const);
-        free_tree(case_branch);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2546,7 +2213,6 @@ node_t *new_case_node(node_t *case_const, node_t *case_branch, char error_msg[ER
     if (case_const != NULL) {
         new_node->case_const_type = ((const_node_t *) case_const)->type_info.type;
         new_node->case_const_value = ((const_node_t *) case_const)->values[0];
-        free(case_const);
     } else {
         new_node->case_const_type = VOID_T;
     }
@@ -2556,53 +2222,28 @@ node_t *new_case_node(node_t *case_const, node_t *case_branch, char error_msg[ER
 }
 
 /* See header for documentation */
-node_t *new_for_node(node_t *initialize, node_t *condition, node_t *increment, node_t *for_branch,
+node_t *new_for_node(arena_t *arena, node_t *initialize, node_t *condition, node_t *increment, node_t *for_branch,
                      char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t condition_type_info;
     if (!copy_type_info_of_node(&condition_type_info, condition)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "For-loop-condition is not an expression");
-        free_tree(initialize);
-        free_tree(condition);
-        free_tree(increment);
-        free_tree(for_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.qualifier == QUANTUM_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "For-loop condition cannot be quantum");
-        free_tree(initialize);
-        free_tree(condition);
-        free_tree(increment);
-        free_tree(for_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.type != BOOL_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "For-loop-condition must be of type bool, but is of type %s",
                  type_to_str(condition_type_info.type));
-        free_tree(initialize);
-        free_tree(condition);
-        free_tree(increment);
-        free_tree(for_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.depth != 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "For-loop-condition must be a single bool, but is an array of depth %u",
                  condition_type_info.depth);
-        free_tree(initialize);
-        free_tree(condition);
-        free_tree(increment);
-        free_tree(for_branch);
-        free_symbol_table();
         return NULL;
     }
 
-    for_node_t *new_node = malloc(sizeof (for_node_t));
+    for_node_t *new_node = alloc_from_arena(arena, sizeof (for_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for for-loop node failed");
-        free_tree(initialize);
-        free_tree(condition);
-        free_tree(increment);
-        free_tree(for_branch);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2615,43 +2256,28 @@ node_t *new_for_node(node_t *initialize, node_t *condition, node_t *increment, n
 }
 
 /* See header for documentation */
-node_t *new_do_node(node_t *do_branch, node_t *condition, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_do_node(arena_t *arena, node_t *do_branch, node_t *condition, char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t condition_type_info;
     if (!copy_type_info_of_node(&condition_type_info, condition)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Do-while-loop-condition is not an expression");
-        free_tree(do_branch);
-        free_tree(condition);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.qualifier == QUANTUM_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Do-while-loop-condition cannot be quantum");
-        free_tree(do_branch);
-        free_tree(condition);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.type != BOOL_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Do-while-loop-condition must be of type bool, but is of type %s",
                  type_to_str(condition_type_info.type));
-        free_tree(do_branch);
-        free_tree(condition);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.depth != 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH,
                  "Do-while-loop-condition must be a single bool, but is an array of depth %u",
                  condition_type_info.depth);
-        free_tree(do_branch);
-        free_tree(condition);
-        free_symbol_table();
         return NULL;
     }
 
-    do_node_t *new_node = malloc(sizeof (do_node_t));
+    do_node_t *new_node = alloc_from_arena(arena, sizeof (do_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for do-while-loop node failed");
-        free_tree(do_branch);
-        free_tree(condition);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2662,42 +2288,27 @@ node_t *new_do_node(node_t *do_branch, node_t *condition, char error_msg[ERROR_M
 }
 
 /* See header for documentation */
-node_t *new_while_node(node_t *condition, node_t *while_branch, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_while_node(arena_t *arena, node_t *condition, node_t *while_branch, char error_msg[ERROR_MSG_LENGTH]) {
     type_info_t condition_type_info;
     if (!copy_type_info_of_node(&condition_type_info, condition)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "While-loop-condition is not an expression");
-        free_tree(condition);
-        free_tree(while_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.qualifier == QUANTUM_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "While-loop-condition cannot be quantum");
-        free_tree(condition);
-        free_tree(while_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.type != BOOL_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "While-loop-condition must be of type bool, but is of type %s",
                  type_to_str(condition_type_info.type));
-        free_tree(condition);
-        free_tree(while_branch);
-        free_symbol_table();
         return NULL;
     } else if (condition_type_info.depth != 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "While-loop-condition must be a single bool, but is an array of depth %u",
                  condition_type_info.depth);
-        free_tree(condition);
-        free_tree(while_branch);
-        free_symbol_table();
         return NULL;
     }
 
-    while_node_t *new_node = malloc(sizeof (while_node_t));
+    while_node_t *new_node = alloc_from_arena(arena, sizeof (while_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for while-loop node failed");
-        free_tree(condition);
-        free_tree(while_branch);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2708,18 +2319,12 @@ node_t *new_while_node(node_t *condition, node_t *while_branch, char error_msg[E
 }
 
 /* See header for documentation */
-node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_assign_node(arena_t *arena, node_t *left, assign_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]) {
     if (left->node_type == CONST_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Trying to reassign constant value");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (left->node_type != REFERENCE_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Left-hand side of assignment is not a variable");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2728,15 +2333,9 @@ node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_
     type_info_t right_type_info;
     if (!copy_type_info_of_node(&right_type_info, right)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Right-hand side of assignment is not an expression");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (left_type_info.qualifier != QUANTUM_T && right_type_info.qualifier == QUANTUM_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Classical left-hand side of assignment, but quantum right-hand side");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2745,17 +2344,11 @@ node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_
             if (!are_matching_types(left_type_info.type, right_type_info.type)) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Assigning %s to %s",
                          type_to_str(right_type_info.type), type_to_str(left_type_info.type));
-                free_tree(left);
-                free_tree(right);
-                free_symbol_table();
                 return NULL;
             } else if (left_type_info.qualifier == QUANTUM_T
                        && ((reference_node_t *) left)->entry->has_been_initialized) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Quantum variable %s has been previously initialized",
                          ((reference_node_t *) left)->entry->name);
-                free_tree(left);
-                free_tree(right);
-                free_symbol_table();
                 return NULL;
             }
             break;
@@ -2765,9 +2358,6 @@ node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_
                 snprintf(error_msg, ERROR_MSG_LENGTH, "%s Assigning %s to %s",
                          (left_type_info.type == BOOL_T) ? "Logically" : "Bitwisely", type_to_str(right_type_info.type),
                          type_to_str(left_type_info.type));
-                free_tree(left);
-                free_tree(right);
-                free_symbol_table();
                 return NULL;
             }
             break;
@@ -2775,22 +2365,13 @@ node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_
         case ASSIGN_ADD_OP: case ASSIGN_SUB_OP: case ASSIGN_MUL_OP: case ASSIGN_DIV_OP: case ASSIGN_MOD_OP: {
             if (left_type_info.type == BOOL_T) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Arithmetically assigning to bool");
-                free_tree(left);
-                free_tree(right);
-                free_symbol_table();
                 return NULL;
             } else if (right_type_info.type == BOOL_T) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Arithmetically assigning bool to %s",
                          type_to_str(left_type_info.type));
-                free_tree(left);
-                free_tree(right);
-                free_symbol_table();
                 return NULL;
             } else if (left_type_info.type == INT_T && right_type_info.type == UNSIGNED_T) {
                 snprintf(error_msg, ERROR_MSG_LENGTH, "Arithmetically assigning unsigned to int");
-                free_tree(left);
-                free_tree(right);
-                free_symbol_table();
                 return NULL;
             }
             break;
@@ -2801,52 +2382,35 @@ node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_
         snprintf(error_msg, ERROR_MSG_LENGTH,
                  "Left-hand side of \"%s\" is a scalar, right-hand side is an array of depth %u)",
                  assign_op_to_str(op), right_type_info.depth);
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (left_type_info.depth != 0 && right_type_info.depth == 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH,
                  "Left-hand side of \"%s\" is an array of depth %u, right-hand side is a scalar)",
                  assign_op_to_str(op), left_type_info.depth);
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (left_type_info.depth != right_type_info.depth) {
         snprintf(error_msg, ERROR_MSG_LENGTH,
                  "Left-hand and right-hand side of \"%s\" are arrays of different depth (%u != %u)",
                  assign_op_to_str(op), left_type_info.depth, right_type_info.depth);
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
     unsigned depth = left_type_info.depth;
-    for (unsigned i = 0; i < depth; ++i) {
-        if (left_type_info.sizes[i] != right_type_info.sizes[i]) {
-            snprintf(error_msg, ERROR_MSG_LENGTH,
-                     "Left-hand and right-hand side of \"%s\" are arrays of different sizes in dimension %u (%u != %u)",
-                     assign_op_to_str(op), depth, left_type_info.sizes[i], right_type_info.sizes[i]);
-            free_tree(left);
-            free_tree(right);
-            free_symbol_table();
-            return NULL;
-        }
+    if (left_type_info.shape != right_type_info.shape) {
+        unsigned i = get_mismatching_dimension(left_type_info.shape, right_type_info.shape);
+        snprintf(error_msg, ERROR_MSG_LENGTH,
+                 "Left-hand and right-hand side of \"%s\" are arrays of different sizes in dimension %u (%u != %u)",
+                 assign_op_to_str(op), depth, left_type_info.shape->sizes[i], right_type_info.shape->sizes[i]);
+        return NULL;
     }
 
-    unsigned *sizes = left_type_info.sizes;
-    unsigned length = get_length_of_array(sizes, depth);
+    unsigned length = get_shape_length(left_type_info.shape);
     if (right_type_info.qualifier == CONST_T) { /* right is of node_type CONST_NODE_T */
         const_node_t *const_node_view_right = (const_node_t *) right;
         if (op == ASSIGN_DIV_OP) {
             for (unsigned i = 0; i < length; ++i) {
                 if (const_node_view_right->values[i].i_val == 0) {
                     snprintf(error_msg, ERROR_MSG_LENGTH, "Division by zero");
-                    free_tree(left);
-                    free_tree(right);
-                    free_symbol_table();
                     return NULL;
                 }
             }
@@ -2854,21 +2418,15 @@ node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_
             for (unsigned i = 0; i < length; ++i) {
                 if (const_node_view_right->values[i].i_val == 0) {
                     snprintf(error_msg, ERROR_MSG_LENGTH, "Modulo by zero");
-                    free_tree(left);
-                    free_tree(right);
-                    free_symbol_table();
                     return NULL;
                 }
             }
         }
     }
 
-    assign_node_t *new_node = malloc(sizeof (assign_node_t));
+    assign_node_t *new_node = alloc_from_arena(arena, sizeof (assign_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for assignment node failed");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2883,18 +2441,13 @@ node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_
 }
 
 /* See header for documentation */
-node_t *new_phase_node(node_t *left, bool is_positive, node_t *right, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_phase_node(arena_t *arena, node_t *left, bool is_positive, node_t *right,
+                       char error_msg[ERROR_MSG_LENGTH]) {
     if (left->node_type == CONST_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Trying to change the phase of a classical value");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (left->node_type != REFERENCE_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Left-hand side of assignment is not a variable");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2902,47 +2455,29 @@ node_t *new_phase_node(node_t *left, bool is_positive, node_t *right, char error
     copy_type_info_of_node(&left_type_info, left);
     if (left_type_info.qualifier != QUANTUM_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Trying to change the phase of a classical value");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
     type_info_t right_type_info;
     if (!copy_type_info_of_node(&right_type_info, right)) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Right-hand side of phase change is not an expression");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (right_type_info.qualifier == QUANTUM_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Cannot change the phase by a quantum value");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (right_type_info.type == BOOL_T || right_type_info.type == VOID_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Cannot change the phase by a value of type %s",
                  type_to_str(right_type_info.type));
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     } else if (right_type_info.depth != 0) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Right-hand side of phase change is an array of depth %u",
                  right_type_info.depth);
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
-    phase_node_t *new_node = malloc(sizeof (phase_node_t));
+    phase_node_t *new_node = alloc_from_arena(arena, sizeof (phase_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for phase node failed");
-        free_tree(left);
-        free_tree(right);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2955,16 +2490,12 @@ node_t *new_phase_node(node_t *left, bool is_positive, node_t *right, char error
 }
 
 /* See header for documentation */
-node_t *new_measure_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
+node_t *new_measure_node(arena_t *arena, node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
     if (child->node_type == CONST_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Trying to measure a classical variable");
-        free_tree(child);
-        free_symbol_table();
         return NULL;
     } else if (child->node_type != REFERENCE_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Trying to measure a non-variable");
-        free_tree(child);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2972,16 +2503,12 @@ node_t *new_measure_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
     copy_type_info_of_node(&type_info, child);
     if (type_info.qualifier != QUANTUM_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Trying to measure a classical variable");
-        free_tree(child);
-        free_symbol_table();
         return NULL;
     }
 
-    measure_node_t *new_node = malloc(sizeof (measure_node_t));
+    measure_node_t *new_node = alloc_from_arena(arena, sizeof (measure_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for measure child failed");
-        free_tree(child);
-        free_symbol_table();
         return NULL;
     }
 
@@ -2993,11 +2520,10 @@ node_t *new_measure_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]) {
 }
 
 /* See header for documentation */
-node_t *new_break_node(char error_msg[ERROR_MSG_LENGTH]) {
-    break_node_t *new_node = malloc(sizeof (break_node_t));
+node_t *new_break_node(arena_t *arena, char error_msg[ERROR_MSG_LENGTH]) {
+    break_node_t *new_node = alloc_from_arena(arena, sizeof (break_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for break node failed");
-        free_symbol_table();
         return NULL;
     }
 
@@ -3006,11 +2532,10 @@ node_t *new_break_node(char error_msg[ERROR_MSG_LENGTH]) {
 }
 
 /* See header for documentation */
-node_t *new_continue_node(char error_msg[ERROR_MSG_LENGTH]) {
-    continue_node_t *new_node = malloc(sizeof (continue_node_t));
+node_t *new_continue_node(arena_t *arena, char error_msg[ERROR_MSG_LENGTH]) {
+    continue_node_t *new_node = alloc_from_arena(arena, sizeof (continue_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for continue node failed");
-        free_symbol_table();
         return NULL;
     }
 
@@ -3019,12 +2544,10 @@ node_t *new_continue_node(char error_msg[ERROR_MSG_LENGTH]) {
 }
 
 /* See header for documentation */
-node_t *new_return_node(node_t *return_value, char error_msg[ERROR_MSG_LENGTH]) {
-    return_node_t *new_node = malloc(sizeof (return_node_t));
+node_t *new_return_node(arena_t *arena, node_t *return_value, char error_msg[ERROR_MSG_LENGTH]) {
+    return_node_t *new_node = alloc_from_arena(arena, sizeof (return_node_t));
     if (new_node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for return return_value failed");
-        free_tree(return_value);
-        free_symbol_table();
         return NULL;
     }
 
@@ -3034,8 +2557,6 @@ node_t *new_return_node(node_t *return_value, char error_msg[ERROR_MSG_LENGTH])
         new_node->is_unitary = is_unitary(return_value);
         if (!copy_type_info_of_node(&(new_node->type_info), return_value)) {
             snprintf(error_msg, ERROR_MSG_LENGTH, "Return value is not an expression");
-            free_tree(return_value);
-            free_symbol_table();
             return NULL;
         }
         new_node->type_info.qualifier = (new_node->type_info.qualifier == QUANTUM_T) ? QUANTUM_T : NONE_T;
@@ -3044,6 +2565,7 @@ node_t *new_return_node(node_t *return_value, char error_msg[ERROR_MSG_LENGTH])
         new_node->is_unitary = true;
         new_node->type_info.qualifier = NONE_T;
         new_node->type_info.type = VOID_T;
+        new_node->type_info.shape = NULL;
         new_node->type_info.depth = 0;
     }
     new_node->return_value = return_value;
@@ -3052,179 +2574,7 @@ node_t *new_return_node(node_t *return_value, char error_msg[ERROR_MSG_LENGTH])
 
 /* See header for documentation */
 void free_tree(node_t *root) {
-    if (root == NULL) {
-        return;
-    }
-
-    switch (root->node_type) {
-        case BASIC_NODE_T: {
-            free_tree(root->left);
-            free_tree(root->right);
-            free(root);
-            return;
-        }
-        case STMT_LIST_NODE_T: {
-            for (unsigned i = 0; i < ((stmt_list_node_t *) root)->num_of_stmts; ++i) {
-                free_tree(((stmt_list_node_t *) root)->stmt_list[i]);
-            }
-            free(((stmt_list_node_t *) root)->stmt_list);
-            free((stmt_list_node_t *) root);
-            return;
-        }
-        case FUNC_DEF_NODE_T: {
-            free_tree(((func_def_node_t *) root)->func_tail);
-            free((func_def_node_t *) root);
-            return;
-        }
-        case VAR_DECL_NODE_T: {
-            free((var_decl_node_t *) root);
-            return;
-        }
-        case VAR_DEF_NODE_T: {
-            if (((var_def_node_t *) root)->is_init_list) {
-                free(((var_def_node_t *) root)->q_types);
-                free(((var_def_node_t *) root)->values);
-            } else {
-                free_tree(((var_def_node_t *) root)->node);
-            }
-            free((var_def_node_t *) root);
-            return;
-        }
-        case CONST_NODE_T: {
-            free(((const_node_t *) root)->values);
-            free((const_node_t *) root);
-            return;
-        }
-        case REFERENCE_NODE_T: {
-            free((reference_node_t *) root);
-            return;
-        }
-        case FUNC_CALL_NODE_T: {
-            for (unsigned i = 0; i < ((func_call_node_t *) root)->num_of_pars; ++i) {
-                free_tree(((func_call_node_t *) root)->pars[i]);
-            }
-            free(((func_call_node_t *) root)->pars);
-            free((func_call_node_t *) root);
-            return;
-        }
-        case FUNC_SP_NODE_T: {
-            free((func_sp_node_t *) root);
-            return;
-        }
-        case LOGICAL_OP_NODE_T: {
-            free_tree(((logical_op_node_t *) root)->left);
-            free_tree(((logical_op_node_t *) root)->right);
-            free((logical_op_node_t *) root);
-            return;
-        }
-        case COMPARISON_OP_NODE_T: {
-            free_tree(((comparison_op_node_t *) root)->left);
-            free_tree(((comparison_op_node_t *) root)->right);
-            free((comparison_op_node_t *) root);
-            return;
-        }
-        case EQUALITY_OP_NODE_T: {
-            free_tree(((equality_op_node_t *) root)->left);
-            free_tree(((equality_op_node_t *) root)->right);
-            free((equality_op_node_t *) root);
-            return;
-        }
-        case NOT_OP_NODE_T: {
-            free_tree(((not_op_node_t *) root)->child);
-            free((not_op_node_t *) root);
-            return;
-        }
-        case INTEGER_OP_NODE_T: {
-            free_tree(((integer_op_node_t *) root)->left);
-            free_tree(((integer_op_node_t *) root)->right);
-            free((integer_op_node_t *) root);
-            return;
-        }
-        case INVERT_OP_NODE_T: {
-            free_tree(((invert_op_node_t *) root)->child);
-            free((invert_op_node_t *) root);
-            return;
-        }
-        case IF_NODE_T: {
-            free_tree(((if_node_t *) root)->condition);
-            free_tree(((if_node_t *) root)->if_branch);
-            for (unsigned i = 0; i < ((if_node_t *) root)->num_of_else_ifs; ++i) {
-                free_tree(((if_node_t *) root)->else_ifs[i]);
-            }
-            free_tree(((if_node_t *) root)->else_branch);
-            free((if_node_t *) root);
-            return;
-        }
-        case ELSE_IF_NODE_T: {
-            free_tree(((else_if_node_t *) root)->condition);
-            free_tree(((else_if_node_t *) root)->else_if_branch);
-            free((else_if_node_t *) root);
-            return;
-        }
-        case SWITCH_NODE_T: {
-            free_tree(((switch_node_t *) root)->expression);
-            for (unsigned i = 0; i < ((switch_node_t *) root)->num_of_cases; ++i) {
-                free_tree(((switch_node_t *) root)->cases[i]);
-            }
-            free((switch_node_t *) root);
-            return;
-        }
-        case CASE_NODE_T: {
-            free_tree(((case_node_t *) root)->case_branch);
-            free((case_node_t *) root);
-            return;
-        }
-        case FOR_NODE_T: {
-            free_tree(((for_node_t *) root)->initialize);
-            free_tree(((for_node_t *) root)->condition);
-            free_tree(((for_node_t *) root)->increment);
-            free_tree(((for_node_t *) root)->for_branch);
-            free((for_node_t *) root);
-            return;
-        }
-        case DO_NODE_T: {
-            free_tree(((do_node_t *) root)->do_branch);
-            free_tree(((do_node_t *) root)->condition);
-            free((do_node_t *) root);
-            return;
-        }
-        case WHILE_NODE_T: {
-            free_tree(((while_node_t *) root)->condition);
-            free_tree(((while_node_t *) root)->while_branch);
-            free((while_node_t *) root);
-            return;
-        }
-        case ASSIGN_NODE_T: {
-            free_tree(((assign_node_t *) root)->left);
-            free_tree(((assign_node_t *) root)->right);
-            free((assign_node_t *) root);
-            return;
-        }
-        case PHASE_NODE_T: {
-            free_tree(((phase_node_t *) root)->left);
-            free_tree(((phase_node_t *) root)->right);
-            free((phase_node_t *) root);
-            return;
-        }
-        case MEASURE_NODE_T: {
-            free_tree(((measure_node_t *) root)->child);
-            free((measure_node_t *) root);
-            return;
-        }
-        case BREAK_NODE_T: {
-            free((break_node_t *) root);
-            return;
-        }
-        case CONTINUE_NODE_T: {
-            free((continue_node_t *) root);
-            return;
-        }
-        case RETURN_NODE_T: {
-            free_tree(((return_node_t *) root)->return_value);
-            free((return_node_t *) root);
-            return;
-        }
-    }
+    (void) root; /* nodes are owned by the arena they were allocated from and released with it */
 }
 
 /**
@@ -3278,7 +2628,7 @@ static void fprint_type_info(FILE *output_file, const type_info_t *type_info) {
     }
     fprintf(output_file, "%s", type_to_str(type_info->type));
     for (unsigned i = 0; i < type_info->depth; ++i) {
-        fprintf(output_file, "[%u]", type_info->sizes[i]);
+        fprintf(output_file, "[%u]", type_info->shape->sizes[i]);
     }
 }
 
@@ -3349,7 +2699,7 @@ void fprint_node(FILE *output_file, const node_t *node) {
                 }
             } else {
                 fprintf(output_file, "{");
-                for (unsigned i = 0; i < get_length_of_array(type_info.sizes, type_info.depth); ++i) {
+                for (unsigned i = 0; i < get_shape_length(type_info.shape); ++i) {
                     if (i != 0) {
                         fprintf(output_file, ", ");
                     }
@@ -3558,140 +2908,30 @@ void fprint_node(FILE *output_file, const node_t *node) {
     }
 }
 
-/* See header for documentation */
-void fprint_tree(FILE *output_file, const node_t *root, size_t depth) {
-    if (root == NULL) {
-        return;
-    }
-    for (size_t i = 0; i < 2 * depth; ++i) {
+/**
+ * \brief                               Write one node of a tree indented by its layer depth to output file
+ * \note                                Indentation is capped at `MAX_TREE_DUMP_INDENTATION` layers, below which the
+ *                                      layer depth is written explicitly, so that the dump of a deep tree (e.g., of a
+ *                                      long expression) grows linearly in its number of nodes
+ * \param[in]                           node: Pointer to node to be written
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to output file
+ * \return                              Always `true` (the whole tree is written)
+ */
+static bool fprint_tree_node(const node_t *node, size_t depth, void *data) {
+    FILE *output_file = data;
+    size_t indentation = (depth > MAX_TREE_DUMP_INDENTATION) ? MAX_TREE_DUMP_INDENTATION : depth;
+    for (size_t i = 0; i < 2 * indentation; ++i) {
         fprintf(output_file, " ");
     }
-    fprint_node(output_file, root);
-    switch (root->node_type) {
-        case BASIC_NODE_T: {
-            fprint_tree(output_file, root->left, depth + 1);
-            fprint_tree(output_file, root->right, depth + 1);
-            break;
-        }
-        case STMT_LIST_NODE_T: {
-            for (unsigned i = 0; i < ((stmt_list_node_t *) root)->num_of_stmts; ++i) {
-                fprint_tree(output_file, ((stmt_list_node_t *) root)->stmt_list[i], depth + 1);
-            }
-            break;
-        }
-        case FUNC_DEF_NODE_T: {
-            fprint_tree(output_file, ((func_def_node_t *) root)->func_tail, depth + 1);
-            break;
-        }
-        case VAR_DEF_NODE_T: {
-            if (((var_def_node_t *) root)->is_init_list) {
-                for (unsigned i = 0; i < get_length_of_array(((var_def_node_t *) root)->entry->sizes,
-                                                             ((var_def_node_t *) root)->entry->depth); ++i) {
-                    if ((((var_def_node_t *) root)->q_types[i].qualifier != CONST_T)) {
-                        fprint_tree(output_file, ((var_def_node_t *) root)->values[i].node_value, depth + 1);
-                    }
-                }
-            } else {
-                fprint_tree(output_file, ((var_def_node_t *) root)->node, depth + 1);
-            }
-            break;
-        }
-        case LOGICAL_OP_NODE_T: {
-            fprint_tree(output_file, ((logical_op_node_t *) root)->left, depth + 1);
-            fprint_tree(output_file, ((logical_op_node_t *) root)->right, depth + 1);
-            break;
-        }
-        case COMPARISON_OP_NODE_T: {
-            fprint_tree(output_file, ((comparison_op_node_t *) root)->left, depth + 1);
-            fprint_tree(output_file, ((comparison_op_node_t *) root)->right, depth + 1);
-            break;
-        }
-        case EQUALITY_OP_NODE_T: {
-            fprint_tree(output_file, ((equality_op_node_t *) root)->left, depth + 1);
-            fprint_tree(output_file, ((equality_op_node_t *) root)->right, depth + 1);
-            break;
-        }
-        case NOT_OP_NODE_T: {
-            fprint_tree(output_file, ((not_op_node_t *) root)->child, depth + 1);
-            break;
-        }
-        case INTEGER_OP_NODE_T: {
-            fprint_tree(output_file, ((integer_op_node_t *) root)->left, depth + 1);
-            fprint_tree(output_file, ((integer_op_node_t *) root)->right, depth + 1);
-            break;
-        }
-        case INVERT_OP_NODE_T: {
-            fprint_tree(output_file, ((invert_op_node_t *) root)->child, depth + 1);
-            break;
-        }
-        case FUNC_CALL_NODE_T: {
-            for (unsigned i = 0; i < ((func_call_node_t *) root)->num_of_pars; ++i) {
-                fprint_tree(output_file, ((func_call_node_t *) root)->pars[i], depth + 1);
-            }
-            break;
-        }
-        case IF_NODE_T: {
-            fprint_tree(output_file, ((if_node_t *) root)->condition, depth + 1);
-            fprint_tree(output_file, ((if_node_t *) root)->if_branch, depth + 1);
-            for (unsigned i = 0; i < ((if_node_t *) root)->num_of_else_ifs; ++i) {
-                fprint_tree(output_file, ((if_node_t *) root)->else_ifs[i], depth + 1);
-            }
-            fprint_tree(output_file, ((if_node_t *) root)->else_branch, depth + 1);
-            break;
-        }
-        case ELSE_IF_NODE_T: {
-            fprint_tree(output_file, ((else_if_node_t *) root)->condition, depth + 1);
-            fprint_tree(output_file, ((else_if_node_t *) root)->else_if_branch, depth + 1);
-            break;
-        }
-        case SWITCH_NODE_T: {
-            fprint_tree(output_file, ((switch_node_t *) root)->expression, depth + 1);
-            for (unsigned i = 0; i < ((switch_node_t *) root)->num_of_cases; ++i) {
-                fprint_tree(output_file, ((switch_node_t *) root)->cases[i], depth + 1);
-            }
-            break;
-        }
-        case CASE_NODE_T: {
-            fprint_tree(output_file, ((case_node_t *) root)->case_branch, depth + 1);
-            break;
-        }
-        case FOR_NODE_T: {
-            fprint_tree(output_file, ((for_node_t *) root)->initialize, depth + 1);
-            fprint_tree(output_file, ((for_node_t *) root)->condition, depth + 1);
-            fprint_tree(output_file, ((for_node_t *) root)->increment, depth + 1);
-            fprint_tree(output_file, ((for_node_t *) root)->for_branch, depth + 1);
-            break;
-        }
-        case DO_NODE_T: {
-            fprint_tree(output_file, ((do_node_t *) root)->do_branch, depth + 1);
-            fprint_tree(output_file, ((do_node_t *) root)->condition, depth + 1);
-            break;
-        }
-        case WHILE_NODE_T: {
-            fprint_tree(output_file, ((while_node_t *) root)->condition, depth + 1);
-            fprint_tree(output_file, ((while_node_t *) root)->while_branch, depth + 1);
-            break;
-        }
-        case ASSIGN_NODE_T: {
-            fprint_tree(output_file, ((assign_node_t *) root)->left, depth + 1);
-            fprint_tree(output_file, ((assign_node_t *) root)->right, depth + 1);
-            break;
-        }
-        case PHASE_NODE_T: {
-            fprint_tree(output_file, ((phase_node_t *) root)->left, depth + 1);
-            fprint_tree(output_file, ((phase_node_t *) root)->right, depth + 1);
-            break;
-        }
-        case MEASURE_NODE_T: {
-            fprint_tree(output_file, ((measure_node_t *) root)->child, depth + 1);
-            break;
-        }
-        case RETURN_NODE_T: {
-            fprint_tree(output_file, ((return_node_t *) root)->return_value, depth + 1);
-            break;
-        }
-        default: {
-            break;
-        }
+    if (depth > MAX_TREE_DUMP_INDENTATION) {
+        fprintf(output_file, "[%zu] ", depth);
     }
+    fprint_node(output_file, node);
+    return true;
+}
+
+/* See header for documentation */
+bool fprint_tree(FILE *output_file, const node_t *root, size_t depth, char error_msg[ERROR_MSG_LENGTH]) {
+    return walk_tree(root, depth, fprint_tree_node, output_file, error_msg);
 }
@@ -201,7 +201,7 @@ typedef union array_value {
  * \note                                This structure defines a basic-node with two child nodes
  */
 typedef struct node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     struct node *left;                      /*!< Pointer to left child */
     struct node *right;                     /*!< Pointer to right child */
 } node_t;
@@ -211,12 +211,12 @@ typedef struct node {
  * \note                                This structure defines a statement-list-node with at least one child node
  */
 typedef struct stmt_list_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether all statements are quantizable */
-    bool is_unitary;                        /*!< Whether all statements are unitary */
-    node_t **stmt_list;                     /*!< List of statements (pointers to child nodes) */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether all statements are quantizable */
+    bool is_unitary : 1;                    /*!< Whether all statements are unitary */
+    return_style_t return_style : 2;        /*!< Return style of statements */
     unsigned num_of_stmts;                  /*!< Number of statements */
-    return_style_t return_style;            /*!< Return style of statements */
+    node_t **stmt_list;                     /*!< List of statements (pointers to child nodes) */
     type_info_t return_type_info;           /*!< Return type information of statements */
 } stmt_list_node_t;
 
@@ -225,7 +225,7 @@ typedef struct stmt_list_node {
  * \note                                This structure defines a variable-declaration-node with no child nodes
  */
 typedef struct var_decl_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     entry_t *entry;                         /*!< Pointer to corresponding entry in the symbol table */
 } var_decl_node_t;
 
@@ -235,11 +235,12 @@ typedef struct var_decl_node {
  *                                          child nodes
  */
 typedef struct var_def_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether the variable definition is quantizable */
-    bool is_unitary;                        /*!< Whether the variable definition is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether the variable definition is quantizable */
+    bool is_unitary : 1;                    /*!< Whether the variable definition is unitary */
+    bool is_init_list : 1;                  /*!< Whether the variable is initialized with an initializer list */
+    unsigned length;                        /*!< Length of initializer list */
     entry_t *entry;                         /*!< Pointer to corresponding entry in the symbol table */
-    bool is_init_list;                      /*!< Whether the variable is initialized with an initializer list */
     union {
         node_t *node;                       /*!< Pointer to right-hand side of variable definition (child node) */
         struct {
@@ -247,7 +248,6 @@ typedef struct var_def_node {
             array_value_t *values;          /*!< Array of initializer list entries (possibly child nodes) */
         };
     };
-    unsigned length;                        /*!< Length of initializer list */
 } var_def_node_t;
 
 /**
@@ -255,7 +255,7 @@ typedef struct var_def_node {
  * \note                                This structure defines a function-definition-node with one child node
  */
 typedef struct func_def_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     entry_t *entry;                         /*!< Pointer to corresponding entry in the symbol table */
     node_t *func_tail;                      /*!< Pointer to function tail (child node) */
 } func_def_node_t;
@@ -265,7 +265,7 @@ typedef struct func_def_node {
  * \note                                This structure defines a constant-node with no child nodes
  */
 typedef struct const_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     type_info_t type_info;                  /*!< Type information of constant */
     value_t *values;                        /*!< Array of constant values */
 } const_node_t;
@@ -275,12 +275,12 @@ typedef struct const_node {
  * \note                                This structure defines a reference-node with an arbitrary number of child nodes
  */
 typedef struct reference_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether reference is quantizable */
-    bool is_unitary;                        /*!< Whether reference is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether reference is quantizable */
+    bool is_unitary : 1;                    /*!< Whether reference is unitary */
     type_info_t type_info;                  /*!< Type information of reference */
-    bool index_is_const[MAX_ARRAY_DEPTH];   /*!< Array of whether indices have constant values */
-    index_t indices[MAX_ARRAY_DEPTH];       /*!< Array of indices (possibly child nodes) */
+    const bool *index_is_const;             /*!< Array of whether indices have constant values (one per index) */
+    const index_t *indices;                 /*!< Array of indices (possibly child nodes, one per index) */
     entry_t *entry;                         /*!< Pointer to entry of referenced variable in the symbol table */
 } reference_node_t;
 
@@ -290,15 +290,15 @@ typedef struct reference_node {
  *                                          nodes
  */
 typedef struct func_call_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether function call is quantizable */
-    bool is_unitary;                        /*!< Whether function call is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether function call is quantizable */
+    bool is_unitary : 1;                    /*!< Whether function call is unitary */
+    bool inverse : 1;                       /*!< Whether the inverted function is called */
+    bool sp : 1;                            /*!< Whether it is a superposition-creating function call */
+    unsigned num_of_pars;                   /*!< Number of function parameters */
     type_info_t type_info;                  /*!< Type information of the function's return */
     entry_t *entry;                         /*!< Pointer to entry of called function in the symbol table */
-    bool inverse;                           /*!< Whether the inverted function is called */
-    bool sp;                                /*!< Whether it is a superposition-creating function call */
     node_t **pars;                          /*!< Array of function parameters (pointers to child nodes) */
-    unsigned num_of_pars;                   /*!< Number of function parameters */
 } func_call_node_t;
 
 /**
@@ -306,7 +306,7 @@ typedef struct func_call_node {
  * \note                                This structure defines a function-superposition-node with no child nodes
  */
 typedef struct func_sp_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     entry_t *entry;                         /*!< Pointer to entry of the function in the symbol table */
 } func_sp_node_t;
 
@@ -315,11 +315,11 @@ typedef struct func_sp_node {
  * \note                                This structure defines a logical-operator-node with two child nodes
  */
 typedef struct logical_op_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether logical operation is quantizable */
-    bool is_unitary;                        /*!< Whether logical operation is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether logical operation is quantizable */
+    bool is_unitary : 1;                    /*!< Whether logical operation is unitary */
+    logical_op_t op : 4;                    /*!< Logical operator */
     type_info_t type_info;                  /*!< Type information of the logical operation's result */
-    logical_op_t op;                        /*!< Logical operator */
     node_t *left;                           /*!< Pointer to left operand (child node) */
     node_t *right;                          /*!< Pointer tp right operand (child node) */
 } logical_op_node_t;
@@ -329,11 +329,11 @@ typedef struct logical_op_node {
  * \note                                This structure defines a comparison-operator-node with two child nodes
  */
 typedef struct comparison_op_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether comparison operation is quantizable */
-    bool is_unitary;                        /*!< Whether comparison operation is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether comparison operation is quantizable */
+    bool is_unitary : 1;                    /*!< Whether comparison operation is unitary */
+    comparison_op_t op : 4;                 /*!< Comparison operator */
     type_info_t type_info;                  /*!< Type information of the comparison operation's result */
-    comparison_op_t op;                     /*!< Comparison operator */
     node_t *left;                           /*!< Pointer to left operand (child node) */
     node_t *right;                          /*!< Pointer to right operand (child node) */
 } comparison_op_node_t;
@@ -343,11 +343,11 @@ typedef struct comparison_op_node {
  * \note                                This structure defines an equality-operator-node with two child nodes
  */
 typedef struct equality_op_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether equality operation is quantizable */
-    bool is_unitary;                        /*!< Whether equality operation is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether equality operation is quantizable */
+    bool is_unitary : 1;                    /*!< Whether equality operation is unitary */
+    equality_op_t op : 4;                   /*!< Equality operator */
     type_info_t type_info;                  /*!< Type information of the equality operation's result */
-    equality_op_t op;                       /*!< Equality operator */
     node_t *left;                           /*!< Pointer to left operand (child node) */
     node_t *right;                          /*!< Pointer to right operand (child node) */
 } equality_op_node_t;
@@ -357,9 +357,9 @@ typedef struct equality_op_node {
  * \note                                This structure defines a not-operator-node with one child node
  */
 typedef struct not_op_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether not-operation is quantizable */
-    bool is_unitary;                        /*!< Whether not-operation is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether not-operation is quantizable */
+    bool is_unitary : 1;                    /*!< Whether not-operation is unitary */
     type_info_t type_info;                  /*!< Type information of the not-operation's result */
     node_t *child;                          /*!< Pointer to operand (child node) */
 } not_op_node_t;
@@ -369,11 +369,11 @@ typedef struct not_op_node {
  * \note                                This structure defines an integer-operator-node with two child nodes
  */
 typedef struct integer_op_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether integer operation is quantizable */
-    bool is_unitary;                        /*!< Whether integer operation is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether integer operation is quantizable */
+    bool is_unitary : 1;                    /*!< Whether integer operation is unitary */
+    integer_op_t op : 4;                    /*!< Integer operator */
     type_info_t type_info;                  /*!< Type information of the integer operation's result */
-    integer_op_t op;                        /*!< Integer operator */
     node_t *left;                           /*!< Pointer to left operand (child node) */
     node_t *right;                          /*!< Pointer to right operand (child node) */
 } integer_op_node_t;
@@ -383,9 +383,9 @@ typedef struct integer_op_node {
  * \note                                This structure defines an invert-operator-node with one child node
  */
 typedef struct invert_op_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether invert-operation is quantizable */
-    bool is_unitary;                        /*!< Whether invert-operation is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether invert-operation is quantizable */
+    bool is_unitary : 1;                    /*!< Whether invert-operation is unitary */
     type_info_t type_info;                  /*!< Type information of the invert-operation's result */
     node_t *child;                          /*!< Pointer to operand (child node) */
 } invert_op_node_t;
@@ -395,15 +395,15 @@ typedef struct invert_op_node {
  * \note                                This structure defines an if-node with at least two child nodes
  */
 typedef struct if_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether if(-else)-statement is quantizable */
-    bool is_unitary;                        /*!< Whether if(-else)-statement is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether if(-else)-statement is quantizable */
+    bool is_unitary : 1;                    /*!< Whether if(-else)-statement is unitary */
+    return_style_t return_style : 2;        /*!< Return style of if(-else)-statement */
+    unsigned num_of_else_ifs;               /*!< Number of else-ifs */
     node_t *condition;                      /*!< Pointer to if-condition (child node) */
     node_t *if_branch;                      /*!< Pointer to if-branch (child node) */
     node_t **else_ifs;                      /*!< Array of else-ifs (pointers to child nodes) */
-    unsigned num_of_else_ifs;               /*!< Number of else-ifs */
     node_t *else_branch;                    /*!< Optional pointer to else-branch (child node) */
-    return_style_t return_style;            /*!< Return style of if(-else)-statement */
     type_info_t return_type_info;           /*!< Return type information of if(-else)-statement */
 } if_node_t;
 
@@ -412,12 +412,12 @@ typedef struct if_node {
  * \note                                This structure defines an else-if-node with two child nodes
  */
 typedef struct else_if_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether else-if-statement is quantizable */
-    bool is_unitary;                        /*!< Whether else-if-statement is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether else-if-statement is quantizable */
+    bool is_unitary : 1;                    /*!< Whether else-if-statement is unitary */
+    return_style_t return_style : 2;        /*!< Return style of else-if-statement */
     node_t *condition;                      /*!< Pointer to else-if-condition (child node) */
     node_t *else_if_branch;                 /*!< Pointer to else-if-branch (child node) */
-    return_style_t return_style;            /*!< Return style of else-if-statement */
     type_info_t return_type_info;           /*!< Return type information of else-if-statement */
 } else_if_node_t;
 
@@ -426,13 +426,13 @@ typedef struct else_if_node {
  * \note                                This structure defines a switch-node with at least one child node
  */
 typedef struct switch_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether switch-statement is quantizable */
-    bool is_unitary;                        /*!< Whether switch-statement is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether switch-statement is quantizable */
+    bool is_unitary : 1;                    /*!< Whether switch-statement is unitary */
+    return_style_t return_style : 2;        /*!< Return style of switch-statement */
+    unsigned num_of_cases;                  /*!< Number of cases */
     node_t *expression;                     /*!< Pointer to switch-expression (child node) */
     node_t **cases;                         /*!< Array of cases (pointers to child nodes) */
-    unsigned num_of_cases;                  /*!< Number of cases */
-    return_style_t return_style;            /*!< Return style of switch-statement */
     type_info_t return_type_info;           /*!< Return type information of switch-statement */
 } switch_node_t;
 
@@ -441,13 +441,13 @@ typedef struct switch_node {
  * \note                                This structure defines a case-node with one child nodes
  */
 typedef struct case_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether case is quantizable */
-    bool is_unitary;                        /*!< Whether case is unitary */
-    type_t case_const_type;                 /*!< Type of case value */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether case is quantizable */
+    bool is_unitary : 1;                    /*!< Whether case is unitary */
+    return_style_t return_style : 2;        /*!< Return style of case */
+    type_t case_const_type : 2;             /*!< Type of case value */
     value_t case_const_value;               /*!< Case value */
     node_t *case_branch;                    /*!< Pointer to case branch (child node) */
-    return_style_t return_style;            /*!< Return style of case */
     type_info_t return_type_info;           /*!< Return type information of case */
 } case_node_t;
 
@@ -456,7 +456,7 @@ typedef struct case_node {
  * \note                                This structure defines a for-loop-node with four child nodes
  */
 typedef struct for_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     node_t *initialize;                     /*!< Pointer to for-loop-initialization statement (child node) */
     node_t *condition;                      /*!< Pointer to for-loop-condition (child node) */
     node_t *increment;                      /*!< Pointer to for-loop-increment (child node) */
@@ -468,7 +468,7 @@ typedef struct for_node {
  * \note                                This structure defines a do-while-loop-node with two child nodes
  */
 typedef struct do_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     node_t *do_branch;                      /*!< Pointer to do-while-loop-branch (child node) */
     node_t *condition;                      /*!< Pointer to do-while-loop-condition (child node) */
 } do_node_t;
@@ -478,7 +478,7 @@ typedef struct do_node {
  * \note                                This structure defines a while-loop-node with two child nodes
  */
 typedef struct while_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     node_t *condition;                      /*!< Pointer to while-loop-condition (child node) */
     node_t *while_branch;                   /*!< Pointer to while-loop-branch (child node) */
 } while_node_t;
@@ -488,10 +488,10 @@ typedef struct while_node {
  * \note                                This structure defines an assignment-node with two child nodes
  */
 typedef struct assign_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether assignment is quantizable */
-    bool is_unitary;                        /*!< Whether assignment is unitary */
-    assign_op_t op;                         /*!< Assignment operator */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether assignment is quantizable */
+    bool is_unitary : 1;                    /*!< Whether assignment is unitary */
+    assign_op_t op : 4;                     /*!< Assignment operator */
     node_t *left;                           /*!< Pointer to left-hand side of assignment (child node) */
     node_t *right;                          /*!< Pointer to right-hand side of assignment (child node) */
 } assign_node_t;
@@ -501,9 +501,9 @@ typedef struct assign_node {
  * \note                                This structure defines a phase-node with two child nodes
  */
 typedef struct phase_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_unitary;                        /*!< Whether change of phase is unitary */
-    bool is_positive;                       /*!< Whether change of phase is positive */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_unitary : 1;                    /*!< Whether change of phase is unitary */
+    bool is_positive : 1;                   /*!< Whether change of phase is positive */
     node_t *left;                           /*!< Pointer to variable whose phase is changed (child node) */
     node_t *right;                          /*!< Pointer to change of phase (child node) */
 } phase_node_t;
@@ -513,7 +513,7 @@ typedef struct phase_node {
  * \note                                This structure defines a measurement-node with one child node
  */
 typedef struct measure_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
     type_info_t type_info;                  /*!< Type information of measurement result */
     node_t *child;                          /*!< Pointer to quantity to be measured */
 } measure_node_t;
@@ -523,7 +523,7 @@ typedef struct measure_node {
  * \note                                This structure defines a break-node with zero child nodes
  */
 typedef struct break_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
 } break_node_t;
 
 /**
@@ -531,7 +531,7 @@ typedef struct break_node {
  * \note                                This structure defines a continue-node with zero child nodes
  */
 typedef struct continue_node {
-    node_type_t node_type;                  /*!< Node type */
+    node_type_t node_type : 8;              /*!< Node type */
 } continue_node_t;
 
 /**
@@ -539,9 +539,9 @@ typedef struct continue_node {
  * \note                                This structure defines a return-node with one child node
  */
 typedef struct return_node {
-    node_type_t node_type;                  /*!< Node type */
-    bool is_quantizable;                    /*!< Whether return statement is quantizable */
-    bool is_unitary;                        /*!< Whether return statement is unitary */
+    node_type_t node_type : 8;              /*!< Node type */
+    bool is_quantizable : 1;                /*!< Whether return statement is quantizable */
+    bool is_unitary : 1;                    /*!< Whether return statement is unitary */
     type_info_t type_info;                  /*!< Return style */
     node_t *return_value;                   /*!< Pointer to returned quantity (child node) */
 } return_node_t;
@@ -612,7 +612,8 @@ bool is_unitary(const node_t *node);
 
 /**
  * \brief                               Allocate new statement-list-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           is_quantizable: Whether statement list is quantizable
  * \param[in]                           is_unitary: Whether statement list is unitary
  * \param[in]                           stmt_list: Statement list
@@ -620,21 +621,23 @@ bool is_unitary(const node_t *node);
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated statement-list-node or `NULL` upon failure
  */
-node_t *new_stmt_list_node(bool is_quantizable, bool is_unitary, node_t **stmt_list, unsigned num_of_stmts,
-                           char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_stmt_list_node(arena_t *arena, bool is_quantizable, bool is_unitary, node_t **stmt_list,
+                           unsigned num_of_stmts, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new variable-declaration-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           entry: Pointer to entry of declared variable in the symbol table
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated variable-declaration-node or `NULL` upon failure
  */
-node_t *new_var_decl_node(entry_t *entry, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_var_decl_node(arena_t *arena, entry_t *entry, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new variable-definition-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           entry: Pointer to entry of defined variable in the symbol table
  * \param[in]                           is_init_list: Whether variable definition is done via an initializer list
  * \param[in]                           node: Pointer to right-hand side of list-free variable definition
@@ -644,32 +647,38 @@ node_t *new_var_decl_node(entry_t *entry, char error_msg[ERROR_MSG_LENGTH]);
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated variable-definition-node or `NULL` upon failure
  */
-node_t *new_var_def_node(entry_t *entry, bool is_init_list, node_t *node, q_type_t *q_types,
+node_t *new_var_def_node(arena_t *arena, entry_t *entry, bool is_init_list, node_t *node, q_type_t *q_types,
                          array_value_t *values, unsigned length, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new function-definition-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           entry: Pointer to entry of defined function in the symbol table
  * \param[in]                           func_tail: Pointer to tail of function definition
+ * \param[in]                           is_complete: Whether the tail holds all statements of the definition (if not,
+ *                                      missing return statements are not reported)
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated function-definition-node or `NULL` upon failure
  */
-node_t *new_func_def_node(entry_t *entry, node_t *func_tail, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_func_def_node(arena_t *arena, entry_t *entry, node_t *func_tail, bool is_complete,
+                          char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new constant-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           type: Type of constant value
  * \param[in]                           value: Constant value
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated constant-node or `NULL` upon failure
  */
-node_t *new_const_node(type_t type, value_t value, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_const_node(arena_t *arena, type_t type, value_t value, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new reference-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           entry: Pointer to entry of referenced variable in the symbol table
  * \param[in]                           index_is_const: Array of whether indices in reference are constant
  * \param[in]                           indices: Array of indices of reference
@@ -677,13 +686,14 @@ node_t *new_const_node(type_t type, value_t value, char error_msg[ERROR_MSG_LENG
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated reference-node or `NULL` upon failure
  */
-node_t *new_reference_node(entry_t *entry, const bool index_is_const[MAX_ARRAY_DEPTH],
+node_t *new_reference_node(arena_t *arena, entry_t *entry, const bool index_is_const[MAX_ARRAY_DEPTH],
                            const index_t indices[MAX_ARRAY_DEPTH], unsigned index_depth,
                            char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new function-call-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           sp: Whether function is called as a superposition-creating function
  * \param[in]                           entry: Pointer to entry of called function in the symbol table
  * \param[in]                           pars: Parameters of function call
@@ -691,83 +701,95 @@ node_t *new_reference_node(entry_t *entry, const bool index_is_const[MAX_ARRAY_D
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated function-call-node or `NULL` upon failure
  */
-node_t *new_func_call_node(bool sp, entry_t *entry, node_t **pars, unsigned num_of_pars,
+node_t *new_func_call_node(arena_t *arena, bool sp, entry_t *entry, node_t **pars, unsigned num_of_pars,
                            char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new function-superposition-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           entry: Pointer to entry of called function in the symbol table
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated function-superposition-node or `NULL` upon failure
  */
-node_t *new_func_sp_node(entry_t *entry, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_func_sp_node(arena_t *arena, entry_t *entry, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new logical-operator-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           left: Pointer to left-hand side of logical operation
  * \param[in]                           op: Logical operator
  * \param[in]                           right: Pointer to right-hand side of logical operation
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated logical-operator-node or `NULL` upon failure
  */
-node_t *new_logical_op_node(node_t *left, logical_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_logical_op_node(arena_t *arena, node_t *left, logical_op_t op, node_t *right,
+                            char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new comparison-operator-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           left: Pointer to left-hand side of comparison operation
  * \param[in]                           op: Comparison operator
  * \param[in]                           right: Pointer to right-hand side of comparison operation
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated comparison-operator-node or `NULL` upon failure
  */
-node_t *new_comparison_op_node(node_t *left, comparison_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_comparison_op_node(arena_t *arena, node_t *left, comparison_op_t op, node_t *right,
+                               char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new equality-operator-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           left: Pointer to left-hand side of equality operation
  * \param[in]                           op: Equality operator
  * \param[in]                           right: Pointer to right-hand side of equality operation
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated equality-operator-node or `NULL` upon failure
  */
-node_t *new_equality_op_node(node_t *left, equality_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_equality_op_node(arena_t *arena, node_t *left, equality_op_t op, node_t *right,
+                             char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new not-operator-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           child: Pointer to operand of not-operation
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated not-operator-node or `NULL` upon failure
  */
-node_t *new_not_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_not_op_node(arena_t *arena, node_t *child, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new integer-operator-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           left: Pointer to left-hand side of integer operation
  * \param[in]                           op: Integer operator
  * \param[in]                           right: Pointer to right-hand side of integer operation
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated integer-operator-node or `NULL` upon failure
  */
-node_t *new_integer_op_node(node_t *left, integer_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_integer_op_node(arena_t *arena, node_t *left, integer_op_t op, node_t *right,
+                            char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new invert-operator-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           child: Pointer to operand of invert-operation
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated invert-operator-node or `NULL` upon failure
  */
-node_t *new_invert_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_invert_op_node(arena_t *arena, node_t *child, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new if-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           condition: Pointer to if-condition
  * \param[in]                           if_branch: Pointer to if-branch
  * \param[in]                           else_ifs: Pointer to else-if-statements
@@ -776,43 +798,48 @@ node_t *new_invert_op_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]);
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated if-node or `NULL` upon failure
  */
-node_t *new_if_node(node_t *condition, node_t *if_branch, node_t **else_ifs, unsigned num_of_else_ifs,
+node_t *new_if_node(arena_t *arena, node_t *condition, node_t *if_branch, node_t **else_ifs, unsigned num_of_else_ifs,
                     node_t *else_branch, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new else-if-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           condition: Pointer to else-if-condition
  * \param[in]                           else_if_branch: Pointer to else-if-branch
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated else-if-node or `NULL` upon failure
  */
-node_t *new_else_if_node(node_t *condition, node_t *else_if_branch, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_else_if_node(arena_t *arena, node_t *condition, node_t *else_if_branch, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new switch-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           expression: Pointer to switch-expression
  * \param[in]                           cases: Cases
  * \param[in]                           num_of_cases: Number of cases
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated switch-node or `NULL` upon failure
  */
-node_t *new_switch_node(node_t *expression, node_t **cases, unsigned num_of_cases, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_switch_node(arena_t *arena, node_t *expression, node_t **cases, unsigned num_of_cases,
+                        char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new case-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           case_const: Pointer to case constant (qualified type and value)
  * \param[in]                           case_branch: Pointer to case-branch
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated case-node or `NULL` upon failure
  */
-node_t *new_case_node(node_t *case_const, node_t *case_branch, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_case_node(arena_t *arena, node_t *case_const, node_t *case_branch, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new for-loop-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           initialize: Pointer to for-loop-initialization statement
  * \param[in]                           condition: Pointer to for-loop-condition statement
  * \param[in]                           increment: Pointer to for-loop-increment statement
@@ -820,87 +847,97 @@ node_t *new_case_node(node_t *case_const, node_t *case_branch, char error_msg[ER
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated for-loop-node or `NULL` upon failure
  */
-node_t *new_for_node(node_t *initialize, node_t *condition, node_t *increment, node_t *for_branch,
+node_t *new_for_node(arena_t *arena, node_t *initialize, node_t *condition, node_t *increment, node_t *for_branch,
                      char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new do-while-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           do_branch: Pointer to do-while-loop-branch
  * \param[in]                           condition: Pointer to do-while-loop-condition
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated do-while-loop-node or `NULL` upon failure
  */
-node_t *new_do_node(node_t *do_branch, node_t *condition, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_do_node(arena_t *arena, node_t *do_branch, node_t *condition, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new while-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           condition: Pointer to while-loop-condition
  * \param[in]                           while_branch: Pointer to while-loop-branch
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated while-loop-node or `NULL` upon failure
  */
-node_t *new_while_node(node_t *condition, node_t *while_branch, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_while_node(arena_t *arena, node_t *condition, node_t *while_branch, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new assignment-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           left: Pointer to left-hand side of assignment
  * \param[in]                           op: Assignment operator
  * \param[in]                           right: Pointer to right-hand side of assignment
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated assignment-node or `NULL` upon failure
  */
-node_t *new_assign_node(node_t *left, assign_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_assign_node(arena_t *arena, node_t *left, assign_op_t op, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new phase-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           left: Pointer to variable whose phase is changed
  * \param[in]                           positive: Whether change of phase is positive
  * \param[in]                           right: Pointer to change of phase
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated phase-node or `NULL` upon failure
  */
-node_t *new_phase_node(node_t *left, bool is_positive, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_phase_node(arena_t *arena, node_t *left, bool is_positive, node_t *right, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new measurement-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           child: Pointer to quantity to be measured
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated measurement-node or `NULL` upon failure
  */
-node_t *new_measure_node(node_t *child, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_measure_node(arena_t *arena, node_t *child, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new break-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated break-node or `NULL` upon failure
  */
-node_t *new_break_node(char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_break_node(arena_t *arena, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new continue-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated continue-node or `NULL` upon failure
  */
-node_t *new_continue_node(char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_continue_node(arena_t *arena, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Allocate new return-node and return pointer to it
- * \note                                Memory is allocated dynamically and must therefore be freed manually
+ * \note                                Memory is allocated from the given arena and released together with it
+ * \param[in,out]                       arena: Pointer to arena the node is allocated from
  * \param[in]                           return_value: Pointer to returned quantity
  * \param[out]                          error_msg: Message to be written in case of an error or illegal parameters
  * \return                              Pointer to newly allocated return-node or `NULL` upon failure
  */
-node_t *new_return_node(node_t *return_value, char error_msg[ERROR_MSG_LENGTH]);
+node_t *new_return_node(arena_t *arena, node_t *return_value, char error_msg[ERROR_MSG_LENGTH]);
 
 /**
- * \brief                               Recursively free the tree emerging from a root node
+ * \brief                               Free the tree emerging from a root node
+ * \note                                Kept for compatibility only: all nodes live in the arena they were allocated
+ *                                      from, so this does not touch the tree; reset or free that arena to release it
  * \param[in]                           root: Pointer to root node of the tree to be freed
  */
 void free_tree(node_t *root);
@@ -916,9 +953,11 @@ void fprint_node(FILE *output_file, const node_t *node);
  * \brief                               Write tree information to output file
  * \param[out]                          output_file: Pointer to output file for tree information
  * \param[in]                           root: Pointer to root node of the tree whose information is to be written
- * \param[in]                           depth: Current layer depth
+ * \param[in]                           depth: Layer depth of root node
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether writing the tree information was successful
  */
-void fprint_tree(FILE *output_file, const node_t *root, size_t depth);
+bool fprint_tree(FILE *output_file, const node_t *root, size_t depth, char error_msg[ERROR_MSG_LENGTH]);
 
 
 /*
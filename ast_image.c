@@ -0,0 +1,914 @@
+/**
+ * \file                                ast_image.c
+ * \brief                               Binary AST image source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast_image.h"
+#include "intern.h"
+#include "shape.h"
+#include "visitor.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Image writer struct
+ * \note                                This structure defines the image under construction together with a hash map
+ *                                      from the address of every copied object to its offset in the image, so that
+ *                                      objects referenced more than once (entries, shapes, names) are copied once
+ */
+typedef struct image_writer {
+    char *buffer;                           /*!< Image (header and objects) */
+    size_t size;                            /*!< Number of bytes of the image */
+    size_t capacity;                        /*!< Number of bytes the buffer can hold */
+    uint64_t *relocations;                  /*!< Array of offsets of pointers in the image */
+    size_t num_of_relocations;              /*!< Number of relocations */
+    size_t relocations_capacity;            /*!< Number of relocations the array can hold */
+    const void **addresses;                 /*!< Hash map keys: addresses of copied objects (`NULL` if empty) */
+    uint64_t *offsets;                      /*!< Hash map values: offsets of copied objects */
+    size_t map_capacity;                    /*!< Number of hash map slots (a power of two) */
+    size_t map_size;                        /*!< Number of copied objects */
+    uint32_t num_of_nodes;                  /*!< Number of copied nodes */
+    bool failed;                            /*!< Whether an allocation failed */
+} image_writer_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Sizes of all node types
+ */
+static const size_t node_sizes[NUM_OF_NODE_TYPES] = {
+    [BASIC_NODE_T] = sizeof (node_t),
+    [STMT_LIST_NODE_T] = sizeof (stmt_list_node_t),
+    [VAR_DECL_NODE_T] = sizeof (var_decl_node_t),
+    [VAR_DEF_NODE_T] = sizeof (var_def_node_t),
+    [FUNC_DEF_NODE_T] = sizeof (func_def_node_t),
+    [CONST_NODE_T] = sizeof (const_node_t),
+    [REFERENCE_NODE_T] = sizeof (reference_node_t),
+    [FUNC_CALL_NODE_T] = sizeof (func_call_node_t),
+    [FUNC_SP_NODE_T] = sizeof (func_sp_node_t),
+    [LOGICAL_OP_NODE_T] = sizeof (logical_op_node_t),
+    [COMPARISON_OP_NODE_T] = sizeof (comparison_op_node_t),
+    [EQUALITY_OP_NODE_T] = sizeof (equality_op_node_t),
+    [NOT_OP_NODE_T] = sizeof (not_op_node_t),
+    [INTEGER_OP_NODE_T] = sizeof (integer_op_node_t),
+    [INVERT_OP_NODE_T] = sizeof (invert_op_node_t),
+    [IF_NODE_T] = sizeof (if_node_t),
+    [ELSE_IF_NODE_T] = sizeof (else_if_node_t),
+    [SWITCH_NODE_T] = sizeof (switch_node_t),
+    [CASE_NODE_T] = sizeof (case_node_t),
+    [FOR_NODE_T] = sizeof (for_node_t),
+    [DO_NODE_T] = sizeof (do_node_t),
+    [WHILE_NODE_T] = sizeof (while_node_t),
+    [ASSIGN_NODE_T] = sizeof (assign_node_t),
+    [PHASE_NODE_T] = sizeof (phase_node_t),
+    [MEASURE_NODE_T] = sizeof (measure_node_t),
+    [BREAK_NODE_T] = sizeof (break_node_t),
+    [CONTINUE_NODE_T] = sizeof (continue_node_t),
+    [RETURN_NODE_T] = sizeof (return_node_t),
+};
+
+/**
+ * \brief                               Calculate hash value of the layouts of all structures in an image
+ * \note                                The sizes are hashed in their in-memory representation, so builds differing in
+ *                                      pointer size or byte order get different hash values as well
+ * \return                              Hash value of layouts
+ */
+static uint32_t get_layout_hash(void) {
+    size_t layouts[NUM_OF_NODE_TYPES + 7];
+    memcpy(layouts, node_sizes, sizeof (node_sizes));
+    layouts[NUM_OF_NODE_TYPES] = sizeof (entry_t);
+    layouts[NUM_OF_NODE_TYPES + 1] = sizeof (symbol_table_t);
+    layouts[NUM_OF_NODE_TYPES + 2] = sizeof (shape_t);
+    layouts[NUM_OF_NODE_TYPES + 3] = sizeof (type_info_t);
+    layouts[NUM_OF_NODE_TYPES + 4] = sizeof (index_t);
+    layouts[NUM_OF_NODE_TYPES + 5] = sizeof (array_value_t);
+    layouts[NUM_OF_NODE_TYPES + 6] = sizeof (void *);
+    return hash_str((const char *) layouts, sizeof (layouts));
+}
+
+/**
+ * \brief                               Continue checksum over further bytes
+ * \note                                FNV-1a over 64-bit words rather than bytes, so that checking an image takes a
+ *                                      fraction of mapping it; a trailing partial word is hashed byte by byte
+ * \param[in]                           hash_value: Checksum of the bytes so far
+ * \param[in]                           bytes: Pointer to further bytes
+ * \param[in]                           size: Number of further bytes
+ * \return                              Checksum including the further bytes
+ */
+static uint64_t update_checksum(uint64_t hash_value, const char *bytes, size_t size) {
+    size_t i = 0;
+    for (; i + sizeof (uint64_t) <= size; i += sizeof (uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof (word));
+        hash_value = (hash_value ^ word) * 0x100000001b3u;
+    }
+    for (; i < size; ++i) {
+        hash_value = (hash_value ^ (unsigned char) bytes[i]) * 0x100000001b3u;
+    }
+    return hash_value;
+}
+
+/**
+ * \brief                               Calculate hash value of an address
+ * \param[in]                           address: Address
+ * \return                              Hash value of address
+ */
+static size_t hash_address(const void *address) {
+    uint64_t value = (uint64_t) (uintptr_t) address;
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdu;
+    value ^= value >> 33;
+    return (size_t) value;
+}
+
+/**
+ * \brief                               Find offset of a copied object
+ * \param[in]                           writer: Pointer to image writer
+ * \param[in]                           address: Address of object
+ * \return                              Offset of the object in the image or `0` if it is `NULL` or not copied yet
+ */
+static uint64_t find_object(const image_writer_t *writer, const void *address) {
+    if (address == NULL) {
+        return 0;
+    }
+
+    size_t mask = writer->map_capacity - 1;
+    for (size_t slot = hash_address(address) & mask; writer->addresses[slot] != NULL; slot = (slot + 1) & mask) {
+        if (writer->addresses[slot] == address) {
+            return writer->offsets[slot];
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief                               Remember offset of a copied object
+ * \note                                The hash map is doubled once it is half full
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           address: Address of object (not copied yet)
+ * \param[in]                           offset: Offset of the object in the image
+ */
+static void remember_object(image_writer_t *writer, const void *address, uint64_t offset) {
+    if (writer->failed) {
+        return;
+    }
+
+    if (2 * (writer->map_size + 1) > writer->map_capacity) {
+        size_t new_capacity = 2 * writer->map_capacity;
+        const void **new_addresses = calloc(new_capacity, sizeof (const void *));
+        uint64_t *new_offsets = malloc(new_capacity * sizeof (uint64_t));
+        if (new_addresses == NULL || new_offsets == NULL) {
+            free(new_addresses);
+            free(new_offsets);
+            writer->failed = true;
+            return;
+        }
+        for (size_t i = 0; i < writer->map_capacity; ++i) {
+            if (writer->addresses[i] != NULL) {
+                size_t slot = hash_address(writer->addresses[i]) & (new_capacity - 1);
+                while (new_addresses[slot] != NULL) {
+                    slot = (slot + 1) & (new_capacity - 1);
+                }
+                new_addresses[slot] = writer->addresses[i];
+                new_offsets[slot] = writer->offsets[i];
+            }
+        }
+        free(writer->addresses);
+        free(writer->offsets);
+        writer->addresses = new_addresses;
+        writer->offsets = new_offsets;
+        writer->map_capacity = new_capacity;
+    }
+
+    size_t slot = hash_address(address) & (writer->map_capacity - 1);
+    while (writer->addresses[slot] != NULL) {
+        slot = (slot + 1) & (writer->map_capacity - 1);
+    }
+    writer->addresses[slot] = address;
+    writer->offsets[slot] = offset;
+    ++(writer->map_size);
+}
+
+/**
+ * \brief                               Append copy of an object to the image
+ * \note                                Objects are aligned like nodes in an arena; the padding in front is zeroed
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           object: Pointer to object
+ * \param[in]                           size: Size of object
+ * \return                              Offset of the copy in the image or `0` if allocating memory failed
+ */
+static uint64_t append_object(image_writer_t *writer, const void *object, size_t size) {
+    if (writer->failed) {
+        return 0;
+    }
+
+    size_t offset = (writer->size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    if (offset + size > writer->capacity) {
+        size_t new_capacity = writer->capacity;
+        while (offset + size > new_capacity) {
+            new_capacity *= 2;
+        }
+        char *new_buffer = realloc(writer->buffer, new_capacity);
+        if (new_buffer == NULL) {
+            writer->failed = true;
+            return 0;
+        }
+        writer->buffer = new_buffer;
+        writer->capacity = new_capacity;
+    }
+
+    memset(writer->buffer + writer->size, 0, offset - writer->size);
+    memcpy(writer->buffer + offset, object, size);
+    writer->size = offset + size;
+    return (uint64_t) offset;
+}
+
+/**
+ * \brief                               Append copy of an array to the image
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           array: Pointer to array (may be `NULL`)
+ * \param[in]                           size: Size of array
+ * \return                              Offset of the copy in the image or `0` if the array is `NULL` or empty
+ */
+static uint64_t append_array(image_writer_t *writer, const void *array, size_t size) {
+    return (array != NULL && size > 0) ? append_object(writer, array, size) : 0;
+}
+
+/**
+ * \brief                               Set pointer of a copied object to another copied object
+ * \note                                Non-null pointers are stored as offsets and recorded as relocations
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           object: Offset of copied object
+ * \param[in]                           field: Offset of pointer within the object
+ * \param[in]                           target: Offset of object pointed to (`0` for `NULL`)
+ */
+static void set_pointer(image_writer_t *writer, uint64_t object, size_t field, uint64_t target) {
+    if (writer->failed) {
+        return;
+    }
+
+    uintptr_t value = (uintptr_t) target;
+    memcpy(writer->buffer + object + field, &value, sizeof (value));
+    if (target == 0) {
+        return;
+    }
+
+    if (writer->num_of_relocations == writer->relocations_capacity) {
+        uint64_t *new_relocations = realloc(writer->relocations, 2 * writer->relocations_capacity * sizeof (uint64_t));
+        if (new_relocations == NULL) {
+            writer->failed = true;
+            return;
+        }
+        writer->relocations = new_relocations;
+        writer->relocations_capacity *= 2;
+    }
+    writer->relocations[(writer->num_of_relocations)++] = object + field;
+}
+
+/**
+ * \brief                               Set unsigned integer of a copied object
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           object: Offset of copied object
+ * \param[in]                           field: Offset of unsigned integer within the object
+ * \param[in]                           value: Value to be set
+ */
+static void set_unsigned(image_writer_t *writer, uint64_t object, size_t field, unsigned value) {
+    if (!writer->failed) {
+        memcpy(writer->buffer + object + field, &value, sizeof (value));
+    }
+}
+
+/**
+ * \brief                               Write name to the image (once)
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           name: Null-terminated name (may be `NULL`)
+ * \return                              Offset of name in the image (`0` for `NULL`)
+ */
+static uint64_t write_name(image_writer_t *writer, const char *name) {
+    uint64_t offset = find_object(writer, name);
+    if (name == NULL || offset != 0) {
+        return offset;
+    }
+
+    offset = append_object(writer, name, strlen(name) + 1);
+    remember_object(writer, name, offset);
+    return offset;
+}
+
+/**
+ * \brief                               Write shape and its inner shapes to the image (once)
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           shape: Pointer to shape (may be `NULL`)
+ * \return                              Offset of shape in the image (`0` for `NULL`)
+ */
+static uint64_t write_shape(image_writer_t *writer, const shape_t *shape) {
+    uint64_t offset = find_object(writer, shape);
+    if (shape == NULL || offset != 0) {
+        return offset;
+    }
+
+    offset = append_object(writer, shape, sizeof (shape_t) + shape->depth * sizeof (unsigned));
+    remember_object(writer, shape, offset);
+    set_pointer(writer, offset, offsetof(shape_t, inner), write_shape(writer, shape->inner));
+    set_pointer(writer, offset, offsetof(shape_t, next), 0);
+    return offset;
+}
+
+/**
+ * \brief                               Write shape of a type information embedded into a copied object
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           object: Offset of copied object
+ * \param[in]                           field: Offset of type information within the object
+ * \param[in]                           type_info: Pointer to original type information
+ */
+static void write_type_info(image_writer_t *writer, uint64_t object, size_t field, const type_info_t *type_info) {
+    set_pointer(writer, object, field + offsetof(type_info_t, shape), write_shape(writer, type_info->shape));
+}
+
+/**
+ * \brief                               Write shape of a return type information embedded into a copied node
+ * \note                                Return type information is only set for nodes whose return style is not
+ *                                      `NONE_ST`
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           object: Offset of copied node
+ * \param[in]                           field: Offset of return type information within the node
+ * \param[in]                           type_info: Pointer to original return type information
+ * \param[in]                           return_style: Return style of node
+ */
+static void write_return_type_info(image_writer_t *writer, uint64_t object, size_t field, const type_info_t *type_info,
+                                   return_style_t return_style) {
+    set_pointer(writer, object, field + offsetof(type_info_t, shape),
+                (return_style != NONE_ST) ? write_shape(writer, type_info->shape) : 0);
+}
+
+/**
+ * \brief                               Write symbol table entry to the image (once)
+ * \note                                Bucket and scope chains are dropped; the chain in order of declaration is set by
+ *                                      write_symbol_table()
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           entry: Pointer to entry (may be `NULL`)
+ * \return                              Offset of entry in the image (`0` for `NULL`)
+ */
+static uint64_t write_entry(image_writer_t *writer, const entry_t *entry) {
+    uint64_t offset = find_object(writer, entry);
+    if (entry == NULL || offset != 0) {
+        return offset;
+    }
+
+    offset = append_object(writer, entry, sizeof (entry_t));
+    remember_object(writer, entry, offset);
+    set_pointer(writer, offset, offsetof(entry_t, name), write_name(writer, entry->name));
+    set_pointer(writer, offset, offsetof(entry_t, lines),
+                append_array(writer, entry->lines, entry->num_of_lines * sizeof (unsigned)));
+    set_unsigned(writer, offset, offsetof(entry_t, lines_capacity), entry->num_of_lines);
+    set_pointer(writer, offset, offsetof(entry_t, shape), write_shape(writer, entry->shape));
+    if (entry->is_function) {
+        uint64_t pars_type_info = append_array(writer, entry->pars_type_info,
+                                               entry->num_of_pars * sizeof (type_info_t));
+        for (unsigned i = 0; i < entry->num_of_pars; ++i) {
+            write_type_info(writer, pars_type_info, i * sizeof (type_info_t), entry->pars_type_info + i);
+        }
+        set_pointer(writer, offset, offsetof(entry_t, pars_type_info), pars_type_info);
+    } else {
+        set_pointer(writer, offset, offsetof(entry_t, values),
+                    append_array(writer, entry->values, entry->length * sizeof (value_t)));
+    }
+    set_pointer(writer, offset, offsetof(entry_t, next), 0);
+    set_pointer(writer, offset, offsetof(entry_t, next_declared), 0);
+    set_pointer(writer, offset, offsetof(entry_t, next_in_scope), 0);
+    return offset;
+}
+
+/**
+ * \brief                               Write symbol table and all its entries to the image
+ * \note                                The copy keeps the entries in order of declaration only; it has neither buckets
+ *                                      nor open scopes
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           symbol_table: Pointer to symbol table
+ * \return                              Offset of symbol table in the image
+ */
+static uint64_t write_symbol_table(image_writer_t *writer, const symbol_table_t *symbol_table) {
+    uint64_t offset = append_object(writer, symbol_table, sizeof (symbol_table_t));
+    for (const entry_t *entry = symbol_table->first_entry; entry != NULL; entry = entry->next_declared) {
+        write_entry(writer, entry);
+    }
+    for (const entry_t *entry = symbol_table->first_entry; entry != NULL; entry = entry->next_declared) {
+        set_pointer(writer, find_object(writer, entry), offsetof(entry_t, next_declared),
+                    find_object(writer, entry->next_declared));
+    }
+
+    set_pointer(writer, offset, offsetof(symbol_table_t, buckets), 0);
+    set_unsigned(writer, offset, offsetof(symbol_table_t, capacity), 0);
+    set_unsigned(writer, offset, offsetof(symbol_table_t, num_of_visible_entries), 0);
+    set_pointer(writer, offset, offsetof(symbol_table_t, first_entry), find_object(writer, symbol_table->first_entry));
+    set_pointer(writer, offset, offsetof(symbol_table_t, last_entry), find_object(writer, symbol_table->last_entry));
+    set_pointer(writer, offset, offsetof(symbol_table_t, scope_stack), 0);
+    set_unsigned(writer, offset, offsetof(symbol_table_t, scope_stack_capacity), 0);
+    return offset;
+}
+
+/**
+ * \brief                               Set child pointer of a copied node
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           object: Offset of copied node (or child list)
+ * \param[in]                           field: Offset of child pointer within the object
+ * \param[in]                           child: Pointer to original child (already copied, or `NULL`)
+ */
+static void set_child(image_writer_t *writer, uint64_t object, size_t field, const node_t *child) {
+    set_pointer(writer, object, field, find_object(writer, child));
+}
+
+/**
+ * \brief                               Write child list to the image
+ * \param[in,out]                       writer: Pointer to image writer
+ * \param[in]                           children: Array of pointers to children (already copied)
+ * \param[in]                           num_of_children: Number of children
+ * \return                              Offset of child list in the image (`0` if empty)
+ */
+static uint64_t write_child_list(image_writer_t *writer, node_t *const *children, unsigned num_of_children) {
+    uint64_t offset = append_array(writer, children, num_of_children * sizeof (node_t *));
+    for (unsigned i = 0; i < num_of_children; ++i) {
+        set_child(writer, offset, i * sizeof (node_t *), children[i]);
+    }
+    return offset;
+}
+
+/**
+ * \brief                               Write node to the image (post-order visitor)
+ * \note                                Children have been written before, so their offsets are known
+ * \param[in]                           node: Pointer to node
+ * \param[in]                           depth: Layer depth of node (unused)
+ * \param[in,out]                       data: Pointer to image writer
+ * \return                              `CONTINUE_W` or `STOP_W` if allocating memory failed
+ */
+static walk_result_t write_node(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    image_writer_t *writer = (image_writer_t *) data;
+    if (find_object(writer, node) != 0) {
+        return CONTINUE_W;
+    }
+
+    uint64_t offset = append_object(writer, node, node_sizes[node->node_type]);
+    remember_object(writer, node, offset);
+    ++(writer->num_of_nodes);
+    switch (node->node_type) {
+        case BASIC_NODE_T: {
+            set_child(writer, offset, offsetof(node_t, left), node->left);
+            set_child(writer, offset, offsetof(node_t, right), node->right);
+            break;
+        }
+        case STMT_LIST_NODE_T: {
+            const stmt_list_node_t *stmt_list_node_view = (const stmt_list_node_t *) node;
+            set_pointer(writer, offset, offsetof(stmt_list_node_t, stmt_list),
+                        write_child_list(writer, stmt_list_node_view->stmt_list, stmt_list_node_view->num_of_stmts));
+            write_return_type_info(writer, offset, offsetof(stmt_list_node_t, return_type_info),
+                                   &(stmt_list_node_view->return_type_info), stmt_list_node_view->return_style);
+            break;
+        }
+        case VAR_DECL_NODE_T: {
+            set_pointer(writer, offset, offsetof(var_decl_node_t, entry),
+                        write_entry(writer, ((const var_decl_node_t *) node)->entry));
+            break;
+        }
+        case VAR_DEF_NODE_T: {
+            const var_def_node_t *var_def_node_view = (const var_def_node_t *) node;
+            set_pointer(writer, offset, offsetof(var_def_node_t, entry), write_entry(writer, var_def_node_view->entry));
+            if (var_def_node_view->is_init_list) {
+                unsigned length = var_def_node_view->length;
+                set_pointer(writer, offset, offsetof(var_def_node_t, q_types),
+                            append_array(writer, var_def_node_view->q_types, length * sizeof (q_type_t)));
+                uint64_t values = append_array(writer, var_def_node_view->values, length * sizeof (array_value_t));
+                for (unsigned i = 0; i < length; ++i) {
+                    if (var_def_node_view->q_types[i].qualifier != CONST_T) {
+                        set_child(writer, values, i * sizeof (array_value_t), var_def_node_view->values[i].node_value);
+                    }
+                }
+                set_pointer(writer, offset, offsetof(var_def_node_t, values), values);
+            } else {
+                set_child(writer, offset, offsetof(var_def_node_t, node), var_def_node_view->node);
+            }
+            break;
+        }
+        case FUNC_DEF_NODE_T: {
+            const func_def_node_t *func_def_node_view = (const func_def_node_t *) node;
+            set_pointer(writer, offset, offsetof(func_def_node_t, entry),
+                        write_entry(writer, func_def_node_view->entry));
+            set_child(writer, offset, offsetof(func_def_node_t, func_tail), func_def_node_view->func_tail);
+            break;
+        }
+        case CONST_NODE_T: {
+            const const_node_t *const_node_view = (const const_node_t *) node;
+            write_type_info(writer, offset, offsetof(const_node_t, type_info), &(const_node_view->type_info));
+            set_pointer(writer, offset, offsetof(const_node_t, values),
+                        append_array(writer, const_node_view->values,
+                                     get_shape_length(const_node_view->type_info.shape) * sizeof (value_t)));
+            break;
+        }
+        case REFERENCE_NODE_T: {
+            const reference_node_t *reference_node_view = (const reference_node_t *) node;
+            unsigned num_of_indices = reference_node_view->entry->depth - reference_node_view->type_info.depth;
+            write_type_info(writer, offset, offsetof(reference_node_t, type_info), &(reference_node_view->type_info));
+            set_pointer(writer, offset, offsetof(reference_node_t, index_is_const),
+                        append_array(writer, reference_node_view->index_is_const, num_of_indices * sizeof (bool)));
+            uint64_t indices = append_array(writer, reference_node_view->indices, num_of_indices * sizeof (index_t));
+            for (unsigned i = 0; i < num_of_indices; ++i) {
+                if (!reference_node_view->index_is_const[i]) {
+                    set_child(writer, indices, i * sizeof (index_t), reference_node_view->indices[i].node_index);
+                }
+            }
+            set_pointer(writer, offset, offsetof(reference_node_t, indices), indices);
+            set_pointer(writer, offset, offsetof(reference_node_t, entry),
+                        write_entry(writer, reference_node_view->entry));
+            break;
+        }
+        case FUNC_CALL_NODE_T: {
+            const func_call_node_t *func_call_node_view = (const func_call_node_t *) node;
+            write_type_info(writer, offset, offsetof(func_call_node_t, type_info), &(func_call_node_view->type_info));
+            set_pointer(writer, offset, offsetof(func_call_node_t, entry),
+                        write_entry(writer, func_call_node_view->entry));
+            set_pointer(writer, offset, offsetof(func_call_node_t, pars),
+                        write_child_list(writer, func_call_node_view->pars, func_call_node_view->num_of_pars));
+            break;
+        }
+        case FUNC_SP_NODE_T: {
+            set_pointer(writer, offset, offsetof(func_sp_node_t, entry),
+                        write_entry(writer, ((const func_sp_node_t *) node)->entry));
+            break;
+        }
+        case LOGICAL_OP_NODE_T: {
+            const logical_op_node_t *logical_op_node_view = (const logical_op_node_t *) node;
+            write_type_info(writer, offset, offsetof(logical_op_node_t, type_info), &(logical_op_node_view->type_info));
+            set_child(writer, offset, offsetof(logical_op_node_t, left), logical_op_node_view->left);
+            set_child(writer, offset, offsetof(logical_op_node_t, right), logical_op_node_view->right);
+            break;
+        }
+        case COMPARISON_OP_NODE_T: {
+            const comparison_op_node_t *comparison_op_node_view = (const comparison_op_node_t *) node;
+            write_type_info(writer, offset, offsetof(comparison_op_node_t, type_info),
+                            &(comparison_op_node_view->type_info));
+            set_child(writer, offset, offsetof(comparison_op_node_t, left), comparison_op_node_view->left);
+            set_child(writer, offset, offsetof(comparison_op_node_t, right), comparison_op_node_view->right);
+            break;
+        }
+        case EQUALITY_OP_NODE_T: {
+            const equality_op_node_t *equality_op_node_view = (const equality_op_node_t *) node;
+            write_type_info(writer, offset, offsetof(equality_op_node_t, type_info),
+                            &(equality_op_node_view->type_info));
+            set_child(writer, offset, offsetof(equality_op_node_t, left), equality_op_node_view->left);
+            set_child(writer, offset, offsetof(equality_op_node_t, right), equality_op_node_view->right);
+            break;
+        }
+        case NOT_OP_NODE_T: {
+            const not_op_node_t *not_op_node_view = (const not_op_node_t *) node;
+            write_type_info(writer, offset, offsetof(not_op_node_t, type_info), &(not_op_node_view->type_info));
+            set_child(writer, offset, offsetof(not_op_node_t, child), not_op_node_view->child);
+            break;
+        }
+        case INTEGER_OP_NODE_T: {
+            const integer_op_node_t *integer_op_node_view = (const integer_op_node_t *) node;
+            write_type_info(writer, offset, offsetof(integer_op_node_t, type_info), &(integer_op_node_view->type_info));
+            set_child(writer, offset, offsetof(integer_op_node_t, left), integer_op_node_view->left);
+            set_child(writer, offset, offsetof(integer_op_node_t, right), integer_op_node_view->right);
+            break;
+        }
+        case INVERT_OP_NODE_T: {
+            const invert_op_node_t *invert_op_node_view = (const invert_op_node_t *) node;
+            write_type_info(writer, offset, offsetof(invert_op_node_t, type_info), &(invert_op_node_view->type_info));
+            set_child(writer, offset, offsetof(invert_op_node_t, child), invert_op_node_view->child);
+            break;
+        }
+        case IF_NODE_T: {
+            const if_node_t *if_node_view = (const if_node_t *) node;
+            set_child(writer, offset, offsetof(if_node_t, condition), if_node_view->condition);
+            set_child(writer, offset, offsetof(if_node_t, if_branch), if_node_view->if_branch);
+            set_pointer(writer, offset, offsetof(if_node_t, else_ifs),
+                        write_child_list(writer, if_node_view->else_ifs, if_node_view->num_of_else_ifs));
+            set_child(writer, offset, offsetof(if_node_t, else_branch), if_node_view->else_branch);
+            write_return_type_info(writer, offset, offsetof(if_node_t, return_type_info),
+                                   &(if_node_view->return_type_info), if_node_view->return_style);
+            break;
+        }
+        case ELSE_IF_NODE_T: {
+            const else_if_node_t *else_if_node_view = (const else_if_node_t *) node;
+            set_child(writer, offset, offsetof(else_if_node_t, condition), else_if_node_view->condition);
+            set_child(writer, offset, offsetof(else_if_node_t, else_if_branch), else_if_node_view->else_if_branch);
+            write_return_type_info(writer, offset, offsetof(else_if_node_t, return_type_info),
+                                   &(else_if_node_view->return_type_info), else_if_node_view->return_style);
+            break;
+        }
+        case SWITCH_NODE_T: {
+            const switch_node_t *switch_node_view = (const switch_node_t *) node;
+            set_child(writer, offset, offsetof(switch_node_t, expression), switch_node_view->expression);
+            set_pointer(writer, offset, offsetof(switch_node_t, cases),
+                        write_child_list(writer, switch_node_view->cases, switch_node_view->num_of_cases));
+            write_return_type_info(writer, offset, offsetof(switch_node_t, return_type_info),
+                                   &(switch_node_view->return_type_info), switch_node_view->return_style);
+            break;
+        }
+        case CASE_NODE_T: {
+            const case_node_t *case_node_view = (const case_node_t *) node;
+            set_child(writer, offset, offsetof(case_node_t, case_branch), case_node_view->case_branch);
+            write_return_type_info(writer, offset, offsetof(case_node_t, return_type_info),
+                                   &(case_node_view->return_type_info), case_node_view->return_style);
+            break;
+        }
+        case FOR_NODE_T: {
+            const for_node_t *for_node_view = (const for_node_t *) node;
+            set_child(writer, offset, offsetof(for_node_t, initialize), for_node_view->initialize);
+            set_child(writer, offset, offsetof(for_node_t, condition), for_node_view->condition);
+            set_child(writer, offset, offsetof(for_node_t, increment), for_node_view->increment);
+            set_child(writer, offset, offsetof(for_node_t, for_branch), for_node_view->for_branch);
+            break;
+        }
+        case DO_NODE_T: {
+            const do_node_t *do_node_view = (const do_node_t *) node;
+            set_child(writer, offset, offsetof(do_node_t, do_branch), do_node_view->do_branch);
+            set_child(writer, offset, offsetof(do_node_t, condition), do_node_view->condition);
+            break;
+        }
+        case WHILE_NODE_T: {
+            const while_node_t *while_node_view = (const while_node_t *) node;
+            set_child(writer, offset, offsetof(while_node_t, condition), while_node_view->condition);
+            set_child(writer, offset, offsetof(while_node_t, while_branch), while_node_view->while_branch);
+            break;
+        }
+        case ASSIGN_NODE_T: {
+            const assign_node_t *assign_node_view = (const assign_node_t *) node;
+            set_child(writer, offset, offsetof(assign_node_t, left), assign_node_view->left);
+            set_child(writer, offset, offsetof(assign_node_t, right), assign_node_view->right);
+            break;
+        }
+        case PHASE_NODE_T: {
+            const phase_node_t *phase_node_view = (const phase_node_t *) node;
+            set_child(writer, offset, offsetof(phase_node_t, left), phase_node_view->left);
+            set_child(writer, offset, offsetof(phase_node_t, right), phase_node_view->right);
+            break;
+        }
+        case MEASURE_NODE_T: {
+            const measure_node_t *measure_node_view = (const measure_node_t *) node;
+            write_type_info(writer, offset, offsetof(measure_node_t, type_info), &(measure_node_view->type_info));
+            set_child(writer, offset, offsetof(measure_node_t, child), measure_node_view->child);
+            break;
+        }
+        case BREAK_NODE_T:
+        case CONTINUE_NODE_T: {
+            break;
+        }
+        case RETURN_NODE_T: {
+            const return_node_t *return_node_view = (const return_node_t *) node;
+            write_type_info(writer, offset, offsetof(return_node_t, type_info), &(return_node_view->type_info));
+            set_child(writer, offset, offsetof(return_node_t, return_value), return_node_view->return_value);
+            break;
+        }
+    }
+    return writer->failed ? STOP_W : CONTINUE_W;
+}
+
+/**
+ * \brief                               Release memory of an image writer
+ * \param[in,out]                       writer: Pointer to image writer
+ */
+static void free_image_writer(image_writer_t *writer) {
+    free(writer->buffer);
+    free(writer->relocations);
+    free(writer->addresses);
+    free(writer->offsets);
+}
+
+/* See header for documentation */
+bool write_ast_image(const char *file_name, const node_t *root, const symbol_table_t *symbol_table,
+                     char error_msg[ERROR_MSG_LENGTH]) {
+    image_writer_t writer = {
+        .buffer = malloc(INITIAL_AST_IMAGE_SIZE),
+        .capacity = INITIAL_AST_IMAGE_SIZE,
+        .relocations = malloc(INITIAL_OBJECT_MAP_SIZE * sizeof (uint64_t)),
+        .relocations_capacity = INITIAL_OBJECT_MAP_SIZE,
+        .addresses = calloc(INITIAL_OBJECT_MAP_SIZE, sizeof (const void *)),
+        .offsets = malloc(INITIAL_OBJECT_MAP_SIZE * sizeof (uint64_t)),
+        .map_capacity = INITIAL_OBJECT_MAP_SIZE,
+    };
+    writer.failed = writer.buffer == NULL || writer.relocations == NULL || writer.addresses == NULL
+                    || writer.offsets == NULL;
+
+    /* the header is the first object, so no other object has offset 0 */
+    ast_image_header_t header = {.magic = AST_IMAGE_MAGIC, .version = AST_IMAGE_VERSION};
+    append_object(&writer, &header, sizeof (header));
+    header.symbol_table = write_symbol_table(&writer, symbol_table);
+    tree_pass_t pass = {.default_post_visitor = write_node};
+    if (!run_tree_pass(&pass, (node_t *) root, 0, &writer, error_msg)) {
+        free_image_writer(&writer);
+        return false;
+    }
+    if (writer.failed) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for AST image %s failed", file_name);
+        free_image_writer(&writer);
+        return false;
+    }
+
+    /* relocations follow the objects at an offset aligned for them (the capacity is a multiple of their size) */
+    size_t padding_size = (sizeof (uint64_t) - writer.size % sizeof (uint64_t)) % sizeof (uint64_t);
+    memset(writer.buffer + writer.size, 0, padding_size);
+    writer.size += padding_size;
+    header.layout_hash = get_layout_hash();
+    header.num_of_nodes = writer.num_of_nodes;
+    header.image_size = writer.size;
+    header.num_of_relocations = writer.num_of_relocations;
+    header.root = find_object(&writer, root);
+    header.checksum = update_checksum(0xcbf29ce484222325u, writer.buffer + sizeof (header),
+                                      writer.size - sizeof (header));
+    header.checksum = update_checksum(header.checksum, (const char *) writer.relocations,
+                                      writer.num_of_relocations * sizeof (uint64_t));
+    memcpy(writer.buffer, &header, sizeof (header));
+
+    FILE *output_file = fopen(file_name, "wb");
+    if (output_file == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Could not open %s", file_name);
+        free_image_writer(&writer);
+        return false;
+    }
+    bool success = fwrite(writer.buffer, 1, writer.size, output_file) == writer.size
+                   && fwrite(writer.relocations, sizeof (uint64_t), writer.num_of_relocations, output_file)
+                      == writer.num_of_relocations;
+    success = (fclose(output_file) == 0) && success;
+    if (!success) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Writing AST image %s failed", file_name);
+    }
+    free_image_writer(&writer);
+    return success;
+}
+
+/**
+ * \brief                               Check type and position of every node of a relocated image
+ * \note                                Children are written before their parents, so every child has to lie in front of
+ *                                      its parent; this rules out cycles as well
+ * \param[in]                           base: Pointer to start of the image
+ * \param[in]                           image_size: Number of bytes of header and objects
+ * \param[in]                           root: Offset of root node (`0` for an empty tree)
+ * \param[out]                          is_corrupt: Whether a node is invalid
+ * \return                              Whether checking the nodes was successful (regardless of their validity)
+ */
+static bool check_nodes(const char *base, uint64_t image_size, uint64_t root, bool *is_corrupt) {
+    *is_corrupt = false;
+    if (root == 0) {
+        return true;
+    }
+
+    size_t capacity = INITIAL_WALK_STACK_SIZE;
+    const node_t **stack = malloc(capacity * sizeof (const node_t *));
+    if (stack == NULL) {
+        return false;
+    }
+    size_t size = 0;
+    stack[size++] = (const node_t *) (base + root);
+    while (size > 0 && !*is_corrupt) {
+        const node_t *node = stack[--size];
+        uintptr_t offset = (uintptr_t) node - (uintptr_t) base;
+        *is_corrupt = offset % ARENA_ALIGNMENT != 0 || offset >= image_size || image_size - offset < sizeof (node_t)
+                      || node->node_type >= NUM_OF_NODE_TYPES || image_size - offset < node_sizes[node->node_type];
+        unsigned num_of_children = *is_corrupt ? 0 : get_num_of_children(node);
+        if (size + num_of_children > capacity) {
+            while (size + num_of_children > capacity) {
+                capacity *= 2;
+            }
+            const node_t **new_stack = realloc(stack, capacity * sizeof (const node_t *));
+            if (new_stack == NULL) {
+                free(stack);
+                return false;
+            }
+            stack = new_stack;
+        }
+        for (unsigned i = 0; i < num_of_children && !*is_corrupt; ++i) {
+            const node_t *child = get_child(node, i);
+            *is_corrupt = child != NULL && (uintptr_t) child >= (uintptr_t) node;
+            if (child != NULL) {
+                stack[size++] = child;
+            }
+        }
+    }
+    free(stack);
+    return true;
+}
+
+/* See header for documentation */
+bool load_ast_image(ast_image_t *image, const char *file_name, char error_msg[ERROR_MSG_LENGTH]) {
+    image->root = NULL;
+    image->symbol_table = NULL;
+    if (!map_file(&(image->mapped_file), file_name, error_msg)) {
+        return false;
+    }
+
+    char *base = image->mapped_file.buffer;
+    size_t file_size = image->mapped_file.size - MAPPED_FILE_PADDING;
+    ast_image_header_t header;
+    if (file_size >= sizeof (header)) {
+        memcpy(&header, base, sizeof (header));
+    }
+    if (file_size < sizeof (header) || memcmp(header.magic, AST_IMAGE_MAGIC, sizeof (header.magic)) != 0) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "%s is not an AST image", file_name);
+        unmap_file(&(image->mapped_file));
+        return false;
+    }
+    if (header.version != AST_IMAGE_VERSION || header.layout_hash != get_layout_hash()) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "AST image %s was written by an incompatible build", file_name);
+        unmap_file(&(image->mapped_file));
+        return false;
+    }
+
+    bool is_corrupt = header.image_size < sizeof (header) || header.image_size > file_size
+                      || header.image_size % sizeof (uint64_t) != 0
+                      || header.num_of_relocations != (file_size - header.image_size) / sizeof (uint64_t)
+                      || (file_size - header.image_size) % sizeof (uint64_t) != 0
+                      || header.root >= header.image_size || header.symbol_table == 0
+                      || header.symbol_table + sizeof (symbol_table_t) > header.image_size;
+
+    is_corrupt = is_corrupt
+                 || update_checksum(update_checksum(0xcbf29ce484222325u, base + sizeof (header),
+                                                    header.image_size - sizeof (header)),
+                                    base + header.image_size, file_size - header.image_size) != header.checksum;
+
+    /* relocate every pointer from an offset to an address; each one must point into the image */
+    const uint64_t *relocations = (const uint64_t *) (base + header.image_size);
+    for (uint64_t i = 0; !is_corrupt && i < header.num_of_relocations; ++i) {
+        uint64_t field = relocations[i];
+        uintptr_t value;
+        is_corrupt = field % sizeof (uintptr_t) != 0 || field > header.image_size - sizeof (uintptr_t);
+        if (!is_corrupt) {
+            memcpy(&value, base + field, sizeof (value));
+            is_corrupt = value == 0 || value >= header.image_size;
+            value += (uintptr_t) base;
+            memcpy(base + field, &value, sizeof (value));
+        }
+    }
+    if (!is_corrupt && !check_nodes(base, header.image_size, header.root, &is_corrupt)) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for checking AST image %s failed", file_name);
+        unmap_file(&(image->mapped_file));
+        return false;
+    }
+    if (is_corrupt) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "AST image %s is corrupt", file_name);
+        unmap_file(&(image->mapped_file));
+        return false;
+    }
+
+    image->root = (header.root != 0) ? (node_t *) (base + header.root) : NULL;
+    image->symbol_table = (symbol_table_t *) (base + header.symbol_table);
+    return true;
+}
+
+/* See header for documentation */
+void unload_ast_image(ast_image_t *image) {
+    unmap_file(&(image->mapped_file));
+    image->root = NULL;
+    image->symbol_table = NULL;
+}
@@ -0,0 +1,166 @@
+/**
+ * \file                                ast_image.h
+ * \brief                               Binary AST image include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef AST_IMAGE_H
+#define AST_IMAGE_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ast.h"
+#include "mapped_file.h"
+#include "rules.h"
+#include "symbol_table.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define AST_IMAGE_MAGIC "CQA"
+#define AST_IMAGE_VERSION 2
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               AST image header struct
+ * \note                                This structure starts every AST image file; all offsets are counted from the
+ *                                      start of the file, and offset `0` (the header itself) stands for `NULL`
+ */
+typedef struct ast_image_header {
+    char magic[4];                          /*!< Magic bytes (`AST_IMAGE_MAGIC`) */
+    uint32_t version;                       /*!< Version of the image format (`AST_IMAGE_VERSION`) */
+    uint32_t layout_hash;                   /*!< Hash value of the layouts of all structures in the image */
+    uint32_t num_of_nodes;                  /*!< Number of nodes in the image */
+    uint64_t image_size;                    /*!< Number of bytes of header and objects */
+    uint64_t num_of_relocations;            /*!< Number of relocations following the objects */
+    uint64_t root;                          /*!< Offset of root node */
+    uint64_t symbol_table;                  /*!< Offset of symbol table */
+    uint64_t checksum;                      /*!< Checksum of objects and relocations */
+} ast_image_header_t;
+
+/**
+ * \brief                               AST image struct
+ * \note                                This structure defines a loaded AST image; tree and symbol table live inside the
+ *                                      mapping and stay valid until unload_ast_image() is called
+ */
+typedef struct ast_image {
+    mapped_file_t mapped_file;              /*!< Mapping of image file */
+    node_t *root;                           /*!< Pointer to root node of the tree */
+    symbol_table_t *symbol_table;           /*!< Pointer to symbol table (read-only: without buckets and scopes) */
+} ast_image_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Write tree and symbol table to an AST image file
+ * \note                                Nodes, entries, shapes and names are copied as they are laid out in memory, and
+ *                                      every pointer between them is replaced by an offset and recorded as relocation;
+ *                                      the image can thus only be loaded by a build with the same structure layouts
+ * \param[in]                           file_name: Name of image file to be written
+ * \param[in]                           root: Pointer to root node of the tree (may be `NULL`)
+ * \param[in]                           symbol_table: Pointer to symbol table
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether writing the image was successful
+ */
+bool write_ast_image(const char *file_name, const node_t *root, const symbol_table_t *symbol_table,
+                     char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Load tree and symbol table from an AST image file
+ * \note                                The file is mapped and its relocations are applied in place, so loading takes
+ *                                      one pass over the relocations and no allocation per node; images whose checksum
+ *                                      does not match or whose nodes are of unknown type are rejected as corrupt
+ * \param[out]                          image: Address of image to be set up
+ * \param[in]                           file_name: Name of image file to be loaded
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether loading the image was successful
+ */
+bool load_ast_image(ast_image_t *image, const char *file_name, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Unload AST image
+ * \param[in,out]                       image: Pointer to image
+ */
+void unload_ast_image(ast_image_t *image);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* AST_IMAGE_H */
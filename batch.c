@@ -0,0 +1,350 @@
+/**
+ * \file                                batch.c
+ * \brief                               Batch parsing source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "batch.h"
+#include "cq_parser.h"
+#include "pars_utils.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Work queue struct
+ * \note                                This structure defines the range of file indices a worker still has to parse; the
+ *                                      owner takes indices from the front, thieves take the back half
+ */
+typedef struct work_queue {
+    pthread_mutex_t lock;                   /*!< Lock guarding the range */
+    unsigned begin;                         /*!< First index of the range */
+    unsigned end;                           /*!< One past the last index of the range */
+} work_queue_t;
+
+/**
+ * \brief                               Batch struct
+ * \note                                This structure defines the state shared by all workers of one batch
+ */
+typedef struct batch {
+    char *const *file_names;                /*!< Array of names of files to be parsed */
+    batch_result_t *results;                /*!< Array of results, one per file */
+    const char *cache_dir;                  /*!< Name of cache directory (`NULL` for parsing without cache) */
+    work_queue_t queues[MAX_NUM_OF_JOBS];   /*!< Array of work queues, one per worker */
+    unsigned num_of_jobs;                   /*!< Number of workers */
+} batch_t;
+
+/**
+ * \brief                               Worker struct
+ * \note                                This structure defines the argument of one worker thread
+ */
+typedef struct worker {
+    batch_t *batch;                         /*!< Pointer to shared batch state */
+    unsigned id;                            /*!< Index of the worker's own work queue */
+} worker_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return monotonic wall-clock time in seconds
+ * \return                              Current time in seconds
+ */
+static double get_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+/**
+ * \brief                               Take next file index from the front of a worker's own work queue
+ * \param[in,out]                       queue: Pointer to own work queue
+ * \param[out]                          index: Index of the taken file
+ * \return                              Whether an index was taken
+ */
+static bool take_work(work_queue_t *queue, unsigned *index) {
+    pthread_mutex_lock(&(queue->lock));
+    bool has_work = queue->begin < queue->end;
+    if (has_work) {
+        *index = (queue->begin)++;
+    }
+    pthread_mutex_unlock(&(queue->lock));
+    return has_work;
+}
+
+/**
+ * \brief                               Move the back half of another worker's work queue into a worker's own work queue
+ * \note                                Indices never return to a queue once taken, so a worker finding every queue empty
+ *                                      may stop: all remaining indices are held by workers still running
+ * \param[in,out]                       batch: Pointer to shared batch state
+ * \param[in]                           id: Index of the stealing worker
+ * \return                              Whether any indices were stolen
+ */
+static bool steal_work(batch_t *batch, unsigned id) {
+    for (unsigned i = 1; i < batch->num_of_jobs; ++i) {
+        work_queue_t *victim = batch->queues + (id + i) % batch->num_of_jobs;
+        pthread_mutex_lock(&(victim->lock));
+        unsigned begin = victim->begin + (victim->end - victim->begin) / 2;
+        unsigned end = victim->end;
+        victim->end = begin;
+        pthread_mutex_unlock(&(victim->lock));
+        if (begin < end) {
+            work_queue_t *own_queue = batch->queues + id;
+            pthread_mutex_lock(&(own_queue->lock));
+            own_queue->begin = begin;
+            own_queue->end = end;
+            pthread_mutex_unlock(&(own_queue->lock));
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief                               Parse one file with a parse context and record the result
+ * \note                                The parse context is freed afterwards and can be reused for the next file
+ * \param[in,out]                       context: Pointer to initialized parse context
+ * \param[in]                           file_name: Name of file to be parsed
+ * \param[in]                           cache_dir: Name of cache directory (`NULL` for parsing without cache)
+ * \param[out]                          result: Pointer to result of the file
+ */
+static void parse_one(parse_context_t *context, const char *file_name, const char *cache_dir,
+                      batch_result_t *result) {
+    result->is_cached = false;
+    if (cache_dir != NULL) {
+        ast_image_t image;
+        result->success = parse_cached_file(context, file_name, cache_dir, &image, &(result->is_cached));
+        if (result->success && result->is_cached) {
+            unload_ast_image(&image);
+        }
+    } else {
+        result->success = parse_mapped_file(context, file_name);
+    }
+    if (!result->success) {
+        result->num_of_errors = context->num_of_diagnostics;
+        memcpy(&(result->first_error), context->diagnostics, sizeof (diagnostic_t));
+    }
+    free_parse_context(context);
+}
+
+/**
+ * \brief                               Parse files of own work queue, then steal from others until no work is left
+ * \param[in]                           arg: Pointer to worker
+ * \return                              `NULL`
+ */
+static void *run_worker(void *arg) {
+    worker_t *worker = arg;
+    batch_t *batch = worker->batch;
+    parse_context_t *context = malloc(sizeof (parse_context_t));
+    if (context == NULL) { /* leave own files to the other workers */
+        return NULL;
+    }
+
+    init_parse_context(context);
+    unsigned index;
+    do {
+        while (take_work(batch->queues + worker->id, &index)) {
+            parse_one(context, batch->file_names[index], batch->cache_dir, batch->results + index);
+        }
+    } while (steal_work(batch, worker->id));
+    free(context);
+    return NULL;
+}
+
+/* See header for documentation */
+bool parse_batch(char *const file_names[], unsigned num_of_files, unsigned num_of_jobs, const char *cache_dir,
+                 batch_result_t results[]) {
+    if (num_of_jobs == 0 || num_of_jobs > MAX_NUM_OF_JOBS) {
+        return false;
+    }
+
+    batch_t *batch = malloc(sizeof (batch_t));
+    if (batch == NULL) {
+        return false;
+    }
+
+    batch->file_names = file_names;
+    batch->results = results;
+    batch->cache_dir = cache_dir;
+    batch->num_of_jobs = num_of_jobs;
+    for (unsigned i = 0; i < num_of_jobs; ++i) {
+        pthread_mutex_init(&(batch->queues[i].lock), NULL);
+        batch->queues[i].begin = (unsigned) ((unsigned long long) num_of_files * i / num_of_jobs);
+        batch->queues[i].end = (unsigned) ((unsigned long long) num_of_files * (i + 1) / num_of_jobs);
+    }
+
+    pthread_t threads[MAX_NUM_OF_JOBS];
+    worker_t workers[MAX_NUM_OF_JOBS];
+    unsigned num_of_threads = 0;
+    for (unsigned i = 0; i < num_of_jobs; ++i) {
+        workers[i].batch = batch;
+        workers[i].id = i;
+        if (pthread_create(threads + i, NULL, run_worker, workers + i) != 0) {
+            break;
+        }
+        ++num_of_threads;
+    }
+    if (num_of_threads == 0) { /* nobody to steal the work */
+        for (unsigned i = 0; i < num_of_jobs; ++i) {
+            pthread_mutex_destroy(&(batch->queues[i].lock));
+        }
+        free(batch);
+        return false;
+    }
+
+    for (unsigned i = 0; i < num_of_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    bool all_done = true;
+    for (unsigned i = 0; i < num_of_jobs; ++i) {
+        all_done = all_done && batch->queues[i].begin == batch->queues[i].end;
+        pthread_mutex_destroy(&(batch->queues[i].lock));
+    }
+    free(batch);
+    return all_done;
+}
+
+/* See header for documentation */
+bool run_batch(FILE *output_file, char *const file_names[], unsigned num_of_files, unsigned num_of_jobs,
+               const char *cache_dir) {
+    batch_result_t *results = malloc((num_of_files > 0 ? num_of_files : 1) * sizeof (batch_result_t));
+    if (results == NULL) {
+        fprintf(stderr, "Allocating memory for batch results failed\n");
+        return false;
+    }
+
+    double start = get_time();
+    if (!parse_batch(file_names, num_of_files, num_of_jobs, cache_dir, results)) {
+        fprintf(stderr, "Running batch with %u jobs failed\n", num_of_jobs);
+        free(results);
+        return false;
+    }
+    double seconds = get_time() - start;
+
+    unsigned num_of_passed = 0;
+    unsigned num_of_hits = 0;
+    for (unsigned i = 0; i < num_of_files; ++i) {
+        num_of_hits += results[i].is_cached;
+        if (results[i].success) {
+            fprintf(output_file, "|- %s passed.\n", file_names[i]);
+            ++num_of_passed;
+        } else if (results[i].first_error.line == 0) {
+            fprintf(output_file, "|- %s failed: %s\n", file_names[i], results[i].first_error.msg);
+        } else if (results[i].num_of_errors == 1) {
+            fprintf(output_file, "|- %s failed in line %u, column %u: %s\n", file_names[i],
+                    results[i].first_error.line, results[i].first_error.column, results[i].first_error.msg);
+        } else {
+            fprintf(output_file, "|- %s failed in line %u, column %u: %s (%u errors)\n", file_names[i],
+                    results[i].first_error.line, results[i].first_error.column, results[i].first_error.msg,
+                    results[i].num_of_errors);
+        }
+    }
+    fprintf(output_file, "Parsed %u files (%u passed, %u failed) with %u jobs in %.3f s (%.1f files/s)\n",
+            num_of_files, num_of_passed, num_of_files - num_of_passed, num_of_jobs, seconds,
+            (seconds > 0.0) ? num_of_files / seconds : 0.0);
+    if (cache_dir != NULL) {
+        fprintf(output_file, "Cache: %u hits, %u misses (%.1f %% hit rate)\n", num_of_hits, num_of_files - num_of_hits,
+                (num_of_files > 0) ? 100.0 * num_of_hits / num_of_files : 0.0);
+    }
+    free(results);
+    return num_of_passed == num_of_files;
+}
+
+/* See header for documentation */
+char **read_file_list(FILE *input_file, unsigned *num_of_files) {
+    unsigned capacity = INITIAL_LIST_CAPACITY;
+    char **file_names = malloc(capacity * sizeof (char *));
+    if (file_names == NULL) {
+        return NULL;
+    }
+
+    *num_of_files = 0;
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &line_capacity, input_file)) != -1) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        if (length == 0) {
+            continue;
+        }
+
+        if (*num_of_files == capacity) {
+            char **temp = realloc(file_names, 2 * capacity * sizeof (char *));
+            if (temp == NULL) {
+                free(line);
+                free_file_list(file_names, *num_of_files);
+                return NULL;
+            }
+
+            file_names = temp;
+            capacity *= 2;
+        }
+        file_names[*num_of_files] = strdup(line);
+        if (file_names[*num_of_files] == NULL) {
+            free(line);
+            free_file_list(file_names, *num_of_files);
+            return NULL;
+        }
+        ++(*num_of_files);
+    }
+    free(line);
+    return file_names;
+}
+
+/* See header for documentation */
+void free_file_list(char **file_names, unsigned num_of_files) {
+    for (unsigned i = 0; i < num_of_files; ++i) {
+        free(file_names[i]);
+    }
+    free(file_names);
+}
@@ -0,0 +1,148 @@
+/**
+ * \file                                batch.h
+ * \brief                               Batch parsing include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "pars_utils.h"
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Batch result struct
+ * \note                                This structure defines the outcome of parsing one file of a batch
+ */
+typedef struct batch_result {
+    bool success;                           /*!< Whether parsing the file was successful */
+    bool is_cached;                         /*!< Whether the result was taken from the cache */
+    unsigned num_of_errors;                 /*!< Number of errors reported for the file */
+    diagnostic_t first_error;               /*!< First error reported for the file */
+} batch_result_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Parse files on a work-stealing thread pool
+ * \note                                Each worker owns one parse context; the result of file i is written to results[i]
+ *                                      regardless of which worker parsed it
+ * \param[in]                           file_names: Array of names of files to be parsed
+ * \param[in]                           num_of_files: Number of files to be parsed
+ * \param[in]                           num_of_jobs: Number of worker threads (at most `MAX_NUM_OF_JOBS`)
+ * \param[in]                           cache_dir: Name of cache directory (`NULL` for parsing without cache)
+ * \param[out]                          results: Array of results, one per file
+ * \return                              Whether all worker threads could be started
+ */
+bool parse_batch(char *const file_names[], unsigned num_of_files, unsigned num_of_jobs, const char *cache_dir,
+                 batch_result_t results[]);
+
+/**
+ * \brief                               Parse files on a thread pool and report per-file results and throughput
+ * \note                                Results are written in the order of the file names, independently of scheduling
+ * \param[out]                          output_file: Pointer to output file for the report
+ * \param[in]                           file_names: Array of names of files to be parsed
+ * \param[in]                           num_of_files: Number of files to be parsed
+ * \param[in]                           num_of_jobs: Number of worker threads (at most `MAX_NUM_OF_JOBS`)
+ * \param[in]                           cache_dir: Name of cache directory (`NULL` for parsing without cache)
+ * \return                              Whether all files were parsed successfully
+ */
+bool run_batch(FILE *output_file, char *const file_names[], unsigned num_of_files, unsigned num_of_jobs,
+               const char *cache_dir);
+
+/**
+ * \brief                               Read newline-separated file names from input file
+ * \note                                Empty lines are skipped; the list must be released by free_file_list()
+ * \param[in]                           input_file: Pointer to input file holding one file name per line
+ * \param[out]                          num_of_files: Number of file names read
+ * \return                              Newly allocated array of file names or `NULL` upon failure
+ */
+char **read_file_list(FILE *input_file, unsigned *num_of_files);
+
+/**
+ * \brief                               Free array of file names returned by read_file_list()
+ * \param[in]                           file_names: Array of file names
+ * \param[in]                           num_of_files: Number of file names
+ */
+void free_file_list(char **file_names, unsigned num_of_files);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* BATCH_H */
@@ -0,0 +1,2099 @@
+/**
+ * \file                                bytecode.c
+ * \brief                               Bytecode compiler and interpreter source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bytecode.h"
+#include "shape.h"
+#include "visitor.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+/* Computed gotos give every instruction its own indirect jump, which branch predictors follow far better */
+#if defined(__GNUC__) || defined(__clang__)
+#define THREADED_DISPATCH
+#endif /* __GNUC__ */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Compiler symbol struct
+ * \note                                This structure defines where the values of a symbol table entry live: global
+ *                                      variables in the global values, parameters and local variables in the registers
+ *                                      of the frame of their function
+ */
+typedef struct symbol {
+    const entry_t *entry;                   /*!< Pointer to entry in the symbol table */
+    const struct symbol *owner;             /*!< Pointer to symbol of function owning a local variable (else `NULL`) */
+    unsigned offset;                        /*!< Index of first global value or register of a variable */
+    unsigned num_of_local_values;           /*!< Number of registers of parameters and local variables of a function */
+    const node_t *func_tail;                /*!< Pointer to body of a function (`NULL` until its definition is found) */
+    bool is_queued;                         /*!< Whether a function has been added to the compiled functions */
+    unsigned function;                      /*!< Index of a queued function among the compiled functions */
+} symbol_t;
+
+/**
+ * \brief                               Pending jump struct
+ * \note                                This structure defines a break or continue whose target is only known once the
+ *                                      enclosing loop has been compiled
+ */
+typedef struct pending_jump {
+    unsigned instruction;                   /*!< Index of jump instruction */
+    bool is_continue;                       /*!< Whether the jump is a continue */
+} pending_jump_t;
+
+/**
+ * \brief                               Expression frame struct
+ * \note                                This structure defines an operator node whose operands are being compiled
+ */
+typedef struct expression_frame {
+    const node_t *node;                     /*!< Pointer to operator node */
+    unsigned destination;                   /*!< First register receiving the values */
+    unsigned num_of_registers;              /*!< Number of registers in use before the operands were compiled */
+    opcode_t opcode;                        /*!< Opcode applied to the operands */
+    bool is_swapped;                        /*!< Whether the operands are swapped */
+    type_t kind;                            /*!< Type whose representation the values are in */
+    unsigned num_of_operands;               /*!< Number of operands (`1` or `2`) */
+    unsigned num_of_compiled_operands;      /*!< Number of operands whose compilation has started */
+    const node_t *operands[2];              /*!< Array of pointers to operand nodes */
+    unsigned firsts[2];                     /*!< Array of first registers holding the values of the operands */
+    type_t kinds[2];                        /*!< Array of types whose representations the operands are in */
+} expression_frame_t;
+
+/**
+ * \brief                               Compiler struct
+ */
+typedef struct compiler {
+    bytecode_program_t *program;            /*!< Pointer to program being compiled */
+    symbol_t *symbols;                      /*!< Array of symbols in order of declaration */
+    unsigned num_of_symbols;                /*!< Number of symbols */
+    symbol_t **symbol_map;                  /*!< Open-addressing hash map from entries to symbols */
+    unsigned symbol_map_capacity;           /*!< Number of buckets of the symbol map (a power of two) */
+    const symbol_t *function;               /*!< Pointer to symbol of compiled function (`NULL` for global code) */
+    unsigned num_of_registers;              /*!< Number of registers in use */
+    unsigned max_num_of_registers;          /*!< Number of registers the frame of the compiled function needs */
+    pending_jump_t *jumps;                  /*!< Stack of pending jumps of the enclosing loops */
+    unsigned num_of_jumps;                  /*!< Number of pending jumps */
+    unsigned jumps_capacity;                /*!< Number of pending jumps the stack can hold */
+    unsigned loop_depth;                    /*!< Number of enclosing loops */
+    expression_frame_t *frames;             /*!< Stack of operator nodes whose operands are being compiled */
+    unsigned num_of_frames;                 /*!< Number of operator nodes on the stack */
+    unsigned frames_capacity;               /*!< Number of operator nodes the stack can hold */
+    long long hoisted_values[MAX_NUM_OF_HOISTED_CONSTANTS];  /*!< Array of constants held in registers */
+    unsigned num_of_hoisted_values;         /*!< Number of constants held in registers */
+    unsigned first_hoisted_register;        /*!< Register holding the first constant held in registers */
+    unsigned num_of_walked_loops;           /*!< Number of loops enclosing the node visited by the constant pass */
+    char *error_msg;                        /*!< Message to be written in case of an error */
+} compiler_t;
+
+/**
+ * \brief                               Location struct
+ * \note                                This structure defines the values referenced by a reference node; an index only
+ *                                      known at runtime adds the value of the offset register to the base
+ */
+typedef struct location {
+    const symbol_t *symbol;                 /*!< Pointer to symbol of referenced variable */
+    bool is_global;                         /*!< Whether the values are global values (instead of registers) */
+    unsigned base;                          /*!< Index of first referenced value for constant indices */
+    bool is_indexed;                        /*!< Whether the offset register is added to the base */
+    unsigned offset_register;               /*!< Register holding the offset of indices only known at runtime */
+    unsigned length;                        /*!< Number of referenced values */
+} location_t;
+
+/**
+ * \brief                               Call frame struct
+ */
+typedef struct call_frame {
+    unsigned function;                      /*!< Index of called function */
+    unsigned base;                          /*!< Index of first register of frame */
+    unsigned destination;                   /*!< Index of first register receiving the returned values */
+    unsigned return_instruction;            /*!< Index of instruction following the call */
+} call_frame_t;
+
+/**
+ * \brief                               Machine struct
+ * \note                                Frames are stacked in one array of registers; the registers below the first
+ *                                      frame receive the values returned by the function that is run
+ */
+typedef struct machine {
+    long long *registers;                   /*!< Array of registers */
+    size_t registers_capacity;              /*!< Number of registers the array of registers can hold */
+    long long *globals;                     /*!< Array of values of global variables */
+    call_frame_t *frames;                   /*!< Stack of call frames */
+    unsigned num_of_frames;                 /*!< Number of call frames */
+    unsigned frames_capacity;               /*!< Number of call frames the stack can hold */
+    unsigned long long num_of_steps;        /*!< Number of executed instructions */
+} machine_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                static data
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Names of opcodes (indexed by opcode)
+ */
+static const char *const opcode_names[NUM_OF_OPCODES] = {
+    [MOVE_I] = "move", [LOAD_CONST_I] = "load_const", [LOAD_GLOBAL_I] = "load_global",
+    [STORE_GLOBAL_I] = "store_global", [LOAD_INDEXED_I] = "load_indexed", [STORE_INDEXED_I] = "store_indexed",
+    [LOAD_GLOBAL_INDEXED_I] = "load_global_indexed", [STORE_GLOBAL_INDEXED_I] = "store_global_indexed",
+    [SET_INDEX_I] = "set_index", [ADD_INDEX_I] = "add_index", [OR_SIGNED_I] = "or_s", [OR_UNSIGNED_I] = "or_u",
+    [XOR_SIGNED_I] = "xor_s", [XOR_UNSIGNED_I] = "xor_u", [AND_SIGNED_I] = "and_s", [AND_UNSIGNED_I] = "and_u",
+    [ADD_SIGNED_I] = "add_s", [ADD_UNSIGNED_I] = "add_u", [SUB_SIGNED_I] = "sub_s", [SUB_UNSIGNED_I] = "sub_u",
+    [MUL_SIGNED_I] = "mul_s", [MUL_UNSIGNED_I] = "mul_u", [DIV_SIGNED_I] = "div_s", [DIV_UNSIGNED_I] = "div_u",
+    [MOD_SIGNED_I] = "mod_s", [MOD_UNSIGNED_I] = "mod_u", [LESS_SIGNED_I] = "less_s",
+    [LESS_UNSIGNED_I] = "less_u", [LESS_EQUAL_SIGNED_I] = "less_equal_s", [LESS_EQUAL_UNSIGNED_I] = "less_equal_u",
+    [EQUAL_SIGNED_I] = "equal_s", [EQUAL_UNSIGNED_I] = "equal_u", [EQUAL_BOOL_I] = "equal_b",
+    [NOT_EQUAL_SIGNED_I] = "not_equal_s", [NOT_EQUAL_UNSIGNED_I] = "not_equal_u", [NOT_EQUAL_BOOL_I] = "not_equal_b",
+    [LAND_I] = "land", [LOR_I] = "lor", [LXOR_I] = "lxor", [NOT_I] = "not", [INVERT_BOOL_I] = "invert_b",
+    [INVERT_SIGNED_I] = "invert_s", [INVERT_UNSIGNED_I] = "invert_u", [NORMALIZE_BOOL_I] = "normalize_b",
+    [NORMALIZE_SIGNED_I] = "normalize_s", [NORMALIZE_UNSIGNED_I] = "normalize_u", [JUMP_I] = "jump",
+    [JUMP_IF_ZERO_I] = "jump_if_zero", [JUMP_IF_NOT_ZERO_I] = "jump_if_not_zero", [JUMP_IF_CASE_I] = "jump_if_case",
+    [CALL_I] = "call", [RETURN_I] = "return", [RETURN_ZERO_I] = "return_zero",
+};
+
+/**
+ * \brief                               Signed opcodes of integer operators (indexed by integer operator)
+ * \note                                The unsigned variant of each opcode directly follows it
+ */
+static const opcode_t integer_opcodes[] = {
+    [OR_OP] = OR_SIGNED_I, [XOR_OP] = XOR_SIGNED_I, [AND_OP] = AND_SIGNED_I, [ADD_OP] = ADD_SIGNED_I,
+    [SUB_OP] = SUB_SIGNED_I, [MUL_OP] = MUL_SIGNED_I, [DIV_OP] = DIV_SIGNED_I, [MOD_OP] = MOD_SIGNED_I,
+};
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+static bool compile_expression(compiler_t *compiler, const node_t *node, unsigned destination, type_t *kind);
+static bool compile_statement(compiler_t *compiler, const node_t *node);
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Make room for one more element of a growable array
+ * \param[in,out]                       array: Address of array
+ * \param[in,out]                       capacity: Address of number of elements the array can hold
+ * \param[in]                           num_of_elements: Number of elements in the array
+ * \param[in]                           size: Size of one element
+ * \return                              Whether the array can hold one more element
+ */
+static bool reserve(void **array, unsigned *capacity, unsigned num_of_elements, size_t size) {
+    if (num_of_elements < *capacity) {
+        return true;
+    }
+    unsigned new_capacity = (*capacity == 0) ? INITIAL_BYTECODE_SIZE : 2 * *capacity;
+    void *new_array = realloc(*array, new_capacity * size);
+    if (new_array == NULL) {
+        return false;
+    }
+    *array = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * \brief                               Append instruction to the program
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           opcode: Opcode
+ * \param[in]                           a: First operand
+ * \param[in]                           b: Second operand
+ * \param[in]                           c: Third operand
+ * \return                              Whether the instruction could be appended
+ */
+static bool emit(compiler_t *compiler, opcode_t opcode, unsigned a, unsigned b, unsigned c) {
+    bytecode_program_t *program = compiler->program;
+    if (!reserve((void **) &(program->instructions), &(program->instructions_capacity),
+                 program->num_of_instructions, sizeof (instruction_t))) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u instructions failed",
+                 program->num_of_instructions + 1);
+        return false;
+    }
+    program->instructions[program->num_of_instructions++] = (instruction_t) {opcode, a, b, c};
+    return true;
+}
+
+/**
+ * \brief                               Append constant to the program
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           value: Value of constant
+ * \param[out]                          index: Address receiving the index of the constant
+ * \return                              Whether the constant could be appended
+ */
+static bool add_constant(compiler_t *compiler, long long value, unsigned *index) {
+    bytecode_program_t *program = compiler->program;
+    if (!reserve((void **) &(program->constants), &(program->constants_capacity), program->num_of_constants,
+                 sizeof (long long))) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u constants failed",
+                 program->num_of_constants + 1);
+        return false;
+    }
+    *index = program->num_of_constants;
+    program->constants[program->num_of_constants++] = value;
+    return true;
+}
+
+/**
+ * \brief                               Append instruction loading a constant into a register
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           destination: Register receiving the constant
+ * \param[in]                           value: Value of constant
+ * \return                              Whether the instruction could be appended
+ */
+static bool emit_constant(compiler_t *compiler, unsigned destination, long long value) {
+    unsigned index;
+    return add_constant(compiler, value, &index) && emit(compiler, LOAD_CONST_I, destination, index, 0);
+}
+
+/**
+ * \brief                               Reserve consecutive temporary registers
+ * \note                                Temporaries are released by resetting the number of registers in use
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           num_of_registers: Number of registers
+ * \return                              Index of first register
+ */
+static unsigned allocate_registers(compiler_t *compiler, unsigned num_of_registers) {
+    unsigned first = compiler->num_of_registers;
+    compiler->num_of_registers += num_of_registers;
+    if (compiler->num_of_registers > compiler->max_num_of_registers) {
+        compiler->max_num_of_registers = compiler->num_of_registers;
+    }
+    return first;
+}
+
+/**
+ * \brief                               Convert value to the representation of a type
+ * \note                                Booleans are `0` or `1`, integers and unsigned integers wrap around at 32 bits
+ * \param[in]                           type: Type of value
+ * \param[in]                           value: Value
+ * \return                              Converted value
+ */
+static long long normalize(type_t type, long long value) {
+    switch (type) {
+        case BOOL_T: {
+            return value != 0;
+        }
+        case INT_T: {
+            return (int32_t) (uint32_t) value;
+        }
+        default: {
+            return (uint32_t) value;
+        }
+    }
+}
+
+/**
+ * \brief                               Convert constant value of a type
+ * \param[in]                           type: Type of value
+ * \param[in]                           value: Constant value
+ * \return                              Converted value
+ */
+static long long from_value(type_t type, value_t value) {
+    switch (type) {
+        case BOOL_T: {
+            return value.b_val;
+        }
+        case INT_T: {
+            return value.i_val;
+        }
+        default: {
+            return value.u_val;
+        }
+    }
+}
+
+/**
+ * \brief                               Return number of flattened values of an expression
+ * \param[in]                           node: Pointer to expression node
+ * \return                              Number of values (`1` for scalars)
+ */
+static unsigned get_length_of_node(const node_t *node) {
+    type_info_t type_info;
+    if (!copy_type_info_of_node(&type_info, node)) {
+        return 1;
+    }
+    return get_shape_length(type_info.shape);
+}
+
+/**
+ * \brief                               Return type of an expression
+ * \param[in]                           node: Pointer to expression node
+ * \return                              Type of expression (`VOID_T` if the node is not an expression)
+ */
+static type_t get_type_of_node(const node_t *node) {
+    type_info_t type_info;
+    if (!copy_type_info_of_node(&type_info, node)) {
+        return VOID_T;
+    }
+    return type_info.type;
+}
+
+/**
+ * \brief                               Append instructions converting values to the representation of a type
+ * \note                                Values are known to be in the representation of their kind (`VOID_T` if
+ *                                      unknown), so nothing is appended if that already is the representation of the
+ *                                      type; booleans are valid integers and unsigned integers
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           type: Type of values
+ * \param[in]                           kind: Kind of values
+ * \param[in]                           destination: First register receiving the converted values
+ * \param[in]                           source: First register holding the values
+ * \param[in]                           length: Number of values
+ * \return                              Whether the instructions could be appended
+ */
+static bool emit_normalize(compiler_t *compiler, type_t type, type_t kind, unsigned destination, unsigned source,
+                           unsigned length) {
+    bool is_normalized = (type == BOOL_T) ? kind == BOOL_T
+                                          : kind == BOOL_T || kind == ((type == INT_T) ? INT_T : UNSIGNED_T);
+    opcode_t opcode = (type == BOOL_T) ? NORMALIZE_BOOL_I : (type == INT_T) ? NORMALIZE_SIGNED_I
+                                                                            : NORMALIZE_UNSIGNED_I;
+    for (unsigned i = 0; i < length; ++i) {
+        if (is_normalized && destination != source) {
+            if (!emit(compiler, MOVE_I, destination + i, source + i, 0)) {
+                return false;
+            }
+        } else if (!is_normalized && !emit(compiler, opcode, destination + i, source + i, 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Find symbol of symbol table entry
+ * \param[in]                           compiler: Pointer to compiler
+ * \param[in]                           entry: Pointer to entry
+ * \return                              Pointer to symbol or `NULL` if the entry is unknown
+ */
+static symbol_t *find_symbol(const compiler_t *compiler, const entry_t *entry) {
+    unsigned bucket = (unsigned) (((uintptr_t) entry >> 4) * 0x9e3779b97f4a7c15ULL >> 32)
+                      & (compiler->symbol_map_capacity - 1);
+    while (compiler->symbol_map[bucket] != NULL) {
+        if (compiler->symbol_map[bucket]->entry == entry) {
+            return compiler->symbol_map[bucket];
+        }
+        bucket = (bucket + 1) & (compiler->symbol_map_capacity - 1);
+    }
+    return NULL;
+}
+
+/**
+ * \brief                               Create symbols for all symbol table entries
+ * \note                                Parameters and local variables of a function are the entries declared after it
+ *                                      up to the next global entry, as in the simulator
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           root: Pointer to root node of the program
+ * \param[in]                           symbol_table: Pointer to symbol table of the program
+ * \return                              Whether setting up the compiler was successful
+ */
+static bool setup_compiler(compiler_t *compiler, const node_t *root, const symbol_table_t *symbol_table) {
+    unsigned num_of_entries = 0;
+    for (const entry_t *entry = symbol_table->first_entry; entry != NULL; entry = entry->next_declared) {
+        ++num_of_entries;
+    }
+    compiler->symbol_map_capacity = 16;
+    while (compiler->symbol_map_capacity < 2 * (num_of_entries + 1)) {
+        compiler->symbol_map_capacity *= 2;
+    }
+    compiler->symbols = calloc(num_of_entries + 1, sizeof (symbol_t));
+    compiler->symbol_map = calloc(compiler->symbol_map_capacity, sizeof (symbol_t *));
+    if (compiler->symbols == NULL || compiler->symbol_map == NULL) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u compiler symbols failed",
+                 num_of_entries);
+        return false;
+    }
+
+    symbol_t *function = NULL;
+    for (const entry_t *entry = symbol_table->first_entry; entry != NULL; entry = entry->next_declared) {
+        symbol_t *symbol = &(compiler->symbols[compiler->num_of_symbols++]);
+        symbol->entry = entry;
+        unsigned bucket = (unsigned) (((uintptr_t) entry >> 4) * 0x9e3779b97f4a7c15ULL >> 32)
+                          & (compiler->symbol_map_capacity - 1);
+        while (compiler->symbol_map[bucket] != NULL) {
+            bucket = (bucket + 1) & (compiler->symbol_map_capacity - 1);
+        }
+        compiler->symbol_map[bucket] = symbol;
+
+        if (entry->is_function) {
+            function = (entry->scope == 0) ? symbol : NULL;
+        } else if (entry->scope != 0 && function != NULL) {
+            symbol->owner = function;
+            symbol->offset = function->num_of_local_values;
+            function->num_of_local_values += entry->length;
+        } else {
+            function = (entry->scope == 0) ? NULL : function;
+            symbol->offset = compiler->program->num_of_globals;
+            compiler->program->num_of_globals += entry->length;
+        }
+    }
+
+    if (root != NULL && root->node_type == STMT_LIST_NODE_T) {
+        const stmt_list_node_t *stmt_list_node_view = (const stmt_list_node_t *) root;
+        for (unsigned i = 0; i < stmt_list_node_view->num_of_stmts; ++i) {
+            const node_t *stmt = stmt_list_node_view->stmt_list[i];
+            if (stmt != NULL && stmt->node_type == FUNC_DEF_NODE_T) {
+                const func_def_node_t *func_def_node_view = (const func_def_node_t *) stmt;
+                symbol_t *symbol = find_symbol(compiler, func_def_node_view->entry);
+                if (symbol != NULL) {
+                    symbol->func_tail = func_def_node_view->func_tail;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Add function to the compiled functions unless it has already been added
+ * \note                                Added functions are compiled in order after the global definitions
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           entry: Pointer to entry of function
+ * \param[out]                          index: Address receiving the index of the function among the compiled functions
+ * \return                              Whether the function is defined and could be added
+ */
+static bool queue_function(compiler_t *compiler, const entry_t *entry, unsigned *index) {
+    symbol_t *symbol = find_symbol(compiler, entry);
+    if (symbol == NULL || !entry->is_function || symbol->func_tail == NULL) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Function %s is not defined", entry->name);
+        return false;
+    } else if (symbol->is_queued) {
+        *index = symbol->function;
+        return true;
+    }
+
+    bytecode_program_t *program = compiler->program;
+    if (!reserve((void **) &(program->functions), &(program->functions_capacity), program->num_of_functions,
+                 sizeof (bytecode_function_t))) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u functions failed",
+                 program->num_of_functions + 1);
+        return false;
+    }
+
+    /* parameters are the first local variables, so the arguments are copied to the bottom of the frame */
+    unsigned num_of_parameter_values = 0;
+    for (unsigned i = 0; i < entry->num_of_pars; ++i) {
+        num_of_parameter_values += symbol[i + 1].entry->length;
+    }
+    symbol->is_queued = true;
+    symbol->function = program->num_of_functions;
+    *index = symbol->function;
+    program->functions[program->num_of_functions++] = (bytecode_function_t) {
+        .entry = entry,
+        .func_tail = symbol->func_tail,
+        .num_of_parameter_values = num_of_parameter_values,
+        .num_of_return_values = entry->length,
+    };
+    return true;
+}
+
+/**
+ * \brief                               Locate the values referenced by a reference node
+ * \note                                Indices only known at runtime are compiled into bounds-checked additions to the
+ *                                      offset register, which is allocated on the first such index
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to reference node
+ * \param[out]                          location: Pointer to location
+ * \return                              Whether the reference could be compiled
+ */
+static bool locate(compiler_t *compiler, const reference_node_t *node, location_t *location) {
+    const entry_t *entry = node->entry;
+    const symbol_t *symbol = find_symbol(compiler, entry);
+    if (symbol == NULL || entry->is_function) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "%s is not a variable", entry->name);
+        return false;
+    } else if (entry->qualifier == QUANTUM_T) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Quantum variable %s cannot be compiled to bytecode",
+                 entry->name);
+        return false;
+    } else if (symbol->owner != NULL && symbol->owner != compiler->function) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "%s is not a variable of the compiled function", entry->name);
+        return false;
+    }
+
+    location->symbol = symbol;
+    location->is_global = symbol->owner == NULL;
+    location->base = symbol->offset;
+    location->is_indexed = false;
+    location->length = get_shape_length(node->type_info.shape);
+    unsigned index_depth = entry->depth - node->type_info.depth;
+    for (unsigned i = 0; i < index_depth; ++i) {
+        unsigned stride = get_shape_length(get_inner_shape(entry->shape, i + 1));
+        if (node->index_is_const[i]) {
+            long long index = node->indices[i].const_index;
+            if (index < 0 || index >= entry->shape->sizes[i]) {
+                snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "%u-th index (%lld) of array %s out of bounds (%u)",
+                         i, index, entry->name, entry->shape->sizes[i]);
+                return false;
+            }
+            location->base += (unsigned) index * stride;
+            continue;
+        }
+
+        bytecode_program_t *program = compiler->program;
+        if (!reserve((void **) &(program->index_checks), &(program->index_checks_capacity),
+                     program->num_of_index_checks, sizeof (index_check_t))) {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u index checks failed",
+                     program->num_of_index_checks + 1);
+            return false;
+        }
+        program->index_checks[program->num_of_index_checks] = (index_check_t) {entry, i, entry->shape->sizes[i],
+                                                                                stride};
+        if (!location->is_indexed) {
+            location->offset_register = allocate_registers(compiler, 1);
+        }
+
+        unsigned index = allocate_registers(compiler, 1);
+        type_t kind;
+        if (!compile_expression(compiler, node->indices[i].node_index, index, &kind)
+            || !emit(compiler, location->is_indexed ? ADD_INDEX_I : SET_INDEX_I, location->offset_register, index,
+                     program->num_of_index_checks++)) {
+            return false;
+        }
+        compiler->num_of_registers = location->offset_register + 1;
+        location->is_indexed = true;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Append instructions loading located values into registers
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           location: Pointer to location
+ * \param[in]                           destination: First register receiving the values
+ * \return                              Whether the instructions could be appended
+ */
+static bool emit_load(compiler_t *compiler, const location_t *location, unsigned destination) {
+    for (unsigned i = 0; i < location->length; ++i) {
+        bool success;
+        if (location->is_indexed) {
+            success = emit(compiler, location->is_global ? LOAD_GLOBAL_INDEXED_I : LOAD_INDEXED_I, destination + i,
+                           location->base + i, location->offset_register);
+        } else if (location->is_global) {
+            success = emit(compiler, LOAD_GLOBAL_I, destination + i, location->base + i, 0);
+        } else {
+            success = destination + i == location->base + i
+                      || emit(compiler, MOVE_I, destination + i, location->base + i, 0);
+        }
+        if (!success) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Append instruction storing a register into a located value
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           location: Pointer to location
+ * \param[in]                           index: Index of value among the located values
+ * \param[in]                           source: Register holding the value
+ * \return                              Whether the instruction could be appended
+ */
+static bool emit_store(compiler_t *compiler, const location_t *location, unsigned index, unsigned source) {
+    if (location->is_indexed) {
+        return emit(compiler, location->is_global ? STORE_GLOBAL_INDEXED_I : STORE_INDEXED_I, location->base + index,
+                    location->offset_register, source);
+    } else if (location->is_global) {
+        return emit(compiler, STORE_GLOBAL_I, location->base + index, source, 0);
+    }
+    return location->base + index == source || emit(compiler, MOVE_I, location->base + index, source, 0);
+}
+
+/**
+ * \brief                               Compile expression into registers holding its values
+ * \note                                Local variables referenced with constant indices and hoisted constants are used
+ *                                      in place; any other expression is compiled into newly allocated temporaries
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to expression node
+ * \param[out]                          first: Address receiving the first register holding the values
+ * \param[out]                          kind: Address receiving the type whose representation the values are in
+ * \return                              Whether the expression could be compiled
+ */
+static bool compile_operand(compiler_t *compiler, const node_t *node, unsigned *first, type_t *kind) {
+    if (node->node_type == REFERENCE_NODE_T) {
+        location_t location;
+        if (!locate(compiler, (const reference_node_t *) node, &location)) {
+            return false;
+        }
+        *kind = location.symbol->entry->type;
+        if (!location.is_global && !location.is_indexed) {
+            *first = location.base;
+            return true;
+        }
+        *first = allocate_registers(compiler, location.length);
+        return emit_load(compiler, &location, *first);
+    } else if (node->node_type == CONST_NODE_T && ((const const_node_t *) node)->type_info.shape == NULL) {
+        const const_node_t *const_node_view = (const const_node_t *) node;
+        type_t type = const_node_view->type_info.type;
+        long long value = normalize(type, from_value(type, const_node_view->values[0]));
+        for (unsigned i = 0; i < compiler->num_of_hoisted_values; ++i) {
+            if (compiler->hoisted_values[i] == value) {
+                *first = compiler->first_hoisted_register + i;
+                *kind = type;
+                return true;
+            }
+        }
+    }
+
+    *first = allocate_registers(compiler, get_length_of_node(node));
+    return compile_expression(compiler, node, *first, kind);
+}
+
+/**
+ * \brief                               Compile function call into registers receiving the returned values
+ * \note                                Arguments are evaluated into consecutive temporaries and converted to the types
+ *                                      of the parameters before the call
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to function call node
+ * \param[in]                           destination: First register receiving the returned values
+ * \return                              Whether the function call could be compiled
+ */
+static bool compile_call(compiler_t *compiler, const func_call_node_t *node, unsigned destination) {
+    if (node->sp || node->inverse) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Quantum call of %s cannot be compiled to bytecode",
+                 node->entry->name);
+        return false;
+    }
+
+    unsigned function;
+    if (!queue_function(compiler, node->entry, &function)) {
+        return false;
+    }
+    const symbol_t *symbol = find_symbol(compiler, node->entry);
+    unsigned num_of_registers = compiler->num_of_registers;
+    unsigned arguments = allocate_registers(compiler, compiler->program->functions[function].num_of_parameter_values);
+    unsigned position = arguments;
+    for (unsigned i = 0; i < node->num_of_pars; ++i) {
+        const entry_t *parameter = symbol[i + 1].entry;
+        if (parameter->qualifier == QUANTUM_T) {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH,
+                     "Quantum parameter %s of %s cannot be compiled to bytecode", parameter->name, node->entry->name);
+            return false;
+        }
+
+        type_t kind;
+        unsigned num_of_arguments = compiler->num_of_registers;
+        if (!compile_expression(compiler, node->pars[i], position, &kind)
+            || !emit_normalize(compiler, parameter->type, kind, position, position, parameter->length)) {
+            return false;
+        }
+        compiler->num_of_registers = num_of_arguments;
+        position += parameter->length;
+    }
+    compiler->num_of_registers = num_of_registers;
+    return emit(compiler, CALL_I, destination, function, arguments);
+}
+
+/**
+ * \brief                               Return opcode of a binary operator node
+ * \note                                Comparisons by greater (or equal) are compiled as less (or equal) with swapped
+ *                                      operands
+ * \param[in]                           node: Pointer to logical, comparison, equality or integer operator node
+ * \param[in]                           left_type: Type of left operand
+ * \param[in]                           right_type: Type of right operand
+ * \param[out]                          is_swapped: Address receiving whether the operands are swapped
+ * \param[out]                          kind: Address receiving the type whose representation the result is in
+ * \return                              Opcode
+ */
+static opcode_t get_binary_opcode(const node_t *node, type_t left_type, type_t right_type, bool *is_swapped,
+                                  type_t *kind) {
+    bool is_signed = left_type == INT_T && right_type == INT_T;
+    *is_swapped = false;
+    *kind = BOOL_T;
+    switch (node->node_type) {
+        case LOGICAL_OP_NODE_T: {
+            logical_op_t op = ((const logical_op_node_t *) node)->op;
+            return (op == LAND_OP) ? LAND_I : (op == LOR_OP) ? LOR_I : LXOR_I;
+        }
+        case COMPARISON_OP_NODE_T: {
+            comparison_op_t op = ((const comparison_op_node_t *) node)->op;
+            *is_swapped = op == GE_OP || op == GEQ_OP;
+            opcode_t opcode = (op == GE_OP || op == LE_OP) ? LESS_SIGNED_I : LESS_EQUAL_SIGNED_I;
+            return is_signed ? opcode : (opcode_t) (opcode + 1);
+        }
+        case EQUALITY_OP_NODE_T: {
+            opcode_t opcode = (((const equality_op_node_t *) node)->op == EQ_OP) ? EQUAL_SIGNED_I
+                                                                                 : NOT_EQUAL_SIGNED_I;
+            return (left_type == BOOL_T) ? (opcode_t) (opcode + 2) : is_signed ? opcode : (opcode_t) (opcode + 1);
+        }
+        default: {
+            *kind = is_signed ? INT_T : UNSIGNED_T;
+            opcode_t opcode = integer_opcodes[((const integer_op_node_t *) node)->op];
+            return is_signed ? opcode : (opcode_t) (opcode + 1);
+        }
+    }
+}
+
+/**
+ * \brief                               Compile expression that is not an operator into given registers
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to expression node
+ * \param[in]                           destination: First register receiving the values
+ * \param[out]                          kind: Address receiving the type whose representation the values are in
+ * \return                              Whether the expression could be compiled
+ */
+static bool compile_value(compiler_t *compiler, const node_t *node, unsigned destination, type_t *kind) {
+    unsigned num_of_registers = compiler->num_of_registers;
+    bool success = true;
+    switch (node->node_type) {
+        case CONST_NODE_T: {
+            const const_node_t *const_node_view = (const const_node_t *) node;
+            type_t type = const_node_view->type_info.type;
+            unsigned length = get_shape_length(const_node_view->type_info.shape);
+            for (unsigned i = 0; success && i < length; ++i) {
+                success = emit_constant(compiler, destination + i,
+                                        normalize(type, from_value(type, const_node_view->values[i])));
+            }
+            *kind = type;
+            break;
+        }
+        case REFERENCE_NODE_T: {
+            location_t location;
+            success = locate(compiler, (const reference_node_t *) node, &location)
+                      && emit_load(compiler, &location, destination);
+            *kind = success ? location.symbol->entry->type : VOID_T;
+            break;
+        }
+        case FUNC_CALL_NODE_T: {
+            success = compile_call(compiler, (const func_call_node_t *) node, destination);
+            *kind = ((const func_call_node_t *) node)->entry->type;
+            break;
+        }
+        case MEASURE_NODE_T: {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Measurement cannot be compiled to bytecode");
+            return false;
+        }
+        default: {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Node is not an expression");
+            return false;
+        }
+    }
+    compiler->num_of_registers = num_of_registers;
+    return success;
+}
+
+/**
+ * \brief                               Push operator node onto the stack of expression frames
+ * \note                                Nothing is pushed if the node is not an operator
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to expression node
+ * \param[in]                           destination: First register receiving the values
+ * \param[out]                          is_pushed: Address receiving whether the node was pushed
+ * \return                              Whether the stack could hold the node
+ */
+static bool push_expression(compiler_t *compiler, const node_t *node, unsigned destination, bool *is_pushed) {
+    expression_frame_t frame = {.node = node, .destination = destination,
+                                .num_of_registers = compiler->num_of_registers, .num_of_operands = 2};
+    switch (node->node_type) {
+        case LOGICAL_OP_NODE_T: {
+            frame.operands[0] = ((const logical_op_node_t *) node)->left;
+            frame.operands[1] = ((const logical_op_node_t *) node)->right;
+            break;
+        }
+        case COMPARISON_OP_NODE_T: {
+            frame.operands[0] = ((const comparison_op_node_t *) node)->left;
+            frame.operands[1] = ((const comparison_op_node_t *) node)->right;
+            break;
+        }
+        case EQUALITY_OP_NODE_T: {
+            frame.operands[0] = ((const equality_op_node_t *) node)->left;
+            frame.operands[1] = ((const equality_op_node_t *) node)->right;
+            break;
+        }
+        case INTEGER_OP_NODE_T: {
+            frame.operands[0] = ((const integer_op_node_t *) node)->left;
+            frame.operands[1] = ((const integer_op_node_t *) node)->right;
+            break;
+        }
+        case NOT_OP_NODE_T: case INVERT_OP_NODE_T: {
+            frame.num_of_operands = 1;
+            frame.operands[0] = (node->node_type == NOT_OP_NODE_T) ? ((const not_op_node_t *) node)->child
+                                                                   : ((const invert_op_node_t *) node)->child;
+            type_t type = (node->node_type == NOT_OP_NODE_T) ? BOOL_T
+                                                             : ((const invert_op_node_t *) node)->type_info.type;
+            frame.opcode = (node->node_type == NOT_OP_NODE_T) ? NOT_I : (type == BOOL_T) ? INVERT_BOOL_I
+                                                                      : (type == INT_T) ? INVERT_SIGNED_I
+                                                                                        : INVERT_UNSIGNED_I;
+            frame.kind = (type == VOID_T) ? UNSIGNED_T : type;
+            break;
+        }
+        default: {
+            *is_pushed = false;
+            return true;
+        }
+    }
+
+    /* both operands are evaluated, as in the simulator */
+    if (frame.num_of_operands == 2) {
+        frame.opcode = get_binary_opcode(node, get_type_of_node(frame.operands[0]),
+                                         get_type_of_node(frame.operands[1]), &(frame.is_swapped), &(frame.kind));
+    }
+    if (!reserve((void **) &(compiler->frames), &(compiler->frames_capacity), compiler->num_of_frames,
+                 sizeof (expression_frame_t))) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u expression frames failed",
+                 compiler->num_of_frames + 1);
+        return false;
+    }
+    compiler->frames[compiler->num_of_frames++] = frame;
+    *is_pushed = true;
+    return true;
+}
+
+/**
+ * \brief                               Compile expression into given registers
+ * \note                                The destination is only written by the last instruction computing each value,
+ *                                      so it may be a variable the expression reads; operators are compiled in
+ *                                      post-order with the stack of expression frames, so long chains of operators
+ *                                      cannot overflow the call stack
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to expression node
+ * \param[in]                           destination: First register receiving the values
+ * \param[out]                          kind: Address receiving the type whose representation the values are in
+ * \return                              Whether the expression could be compiled
+ */
+static bool compile_expression(compiler_t *compiler, const node_t *node, unsigned destination, type_t *kind) {
+    /* function calls among the operands compile their arguments on top of the frames of this expression */
+    unsigned first_frame = compiler->num_of_frames;
+    bool is_pushed;
+    if (!push_expression(compiler, node, destination, &is_pushed)) {
+        return false;
+    } else if (!is_pushed) {
+        return compile_value(compiler, node, destination, kind);
+    }
+
+    bool success = true;
+    while (success && compiler->num_of_frames > first_frame) {
+        expression_frame_t *frame = &(compiler->frames[compiler->num_of_frames - 1]);
+        if (frame->num_of_compiled_operands < frame->num_of_operands) {
+            unsigned index = frame->num_of_compiled_operands++;
+            const node_t *operand = frame->operands[index];
+            unsigned first = compiler->num_of_registers;
+            success = push_expression(compiler, operand, first, &is_pushed);
+            if (success && is_pushed) {
+                /* the frame may have moved */
+                frame = &(compiler->frames[compiler->num_of_frames - 2]);
+                frame->firsts[index] = allocate_registers(compiler, get_length_of_node(operand));
+                compiler->frames[compiler->num_of_frames - 1].num_of_registers = compiler->num_of_registers;
+            } else if (success) {
+                type_t operand_kind;
+                success = compile_operand(compiler, operand, &first, &operand_kind);
+                frame = &(compiler->frames[compiler->num_of_frames - 1]);
+                frame->firsts[index] = first;
+                frame->kinds[index] = operand_kind;
+            }
+            continue;
+        }
+
+        unsigned left_first = frame->firsts[0];
+        unsigned right_first = (frame->num_of_operands == 2) ? frame->firsts[1] : 0;
+        unsigned length = get_length_of_node((frame->num_of_operands == 2) ? frame->operands[0] : frame->node);
+        for (unsigned i = 0; success && i < length; ++i) {
+            success = emit(compiler, frame->opcode, frame->destination + i,
+                           (frame->is_swapped ? right_first : left_first) + i,
+                           (frame->num_of_operands == 1) ? 0 : (frame->is_swapped ? left_first : right_first) + i);
+        }
+        compiler->num_of_registers = frame->num_of_registers;
+        --(compiler->num_of_frames);
+        if (compiler->num_of_frames > first_frame) {
+            expression_frame_t *parent = &(compiler->frames[compiler->num_of_frames - 1]);
+            parent->kinds[parent->num_of_compiled_operands - 1] = frame->kind;
+        } else {
+            *kind = frame->kind;
+        }
+    }
+    compiler->num_of_frames = first_frame;
+    return success;
+}
+
+/**
+ * \brief                               Compile variable declaration or definition
+ * \note                                The values are cleared first, so elements not covered by the right-hand side are
+ *                                      zero
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to variable declaration or definition node
+ * \return                              Whether the statement could be compiled
+ */
+static bool compile_definition(compiler_t *compiler, const node_t *node) {
+    const entry_t *entry = (node->node_type == VAR_DECL_NODE_T) ? ((const var_decl_node_t *) node)->entry
+                                                                : ((const var_def_node_t *) node)->entry;
+    const var_def_node_t *var_def_node_view = (node->node_type == VAR_DEF_NODE_T) ? (const var_def_node_t *) node
+                                                                                 : NULL;
+    const symbol_t *symbol = find_symbol(compiler, entry);
+    if (symbol == NULL || entry->is_function) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "%s is not a variable", entry->name);
+        return false;
+    } else if (entry->qualifier == QUANTUM_T) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Quantum variable %s cannot be compiled to bytecode",
+                 entry->name);
+        return false;
+    }
+
+    /* values are built in place for local variables and in temporaries for global ones */
+    bool is_global = symbol->owner == NULL;
+    unsigned first = is_global ? allocate_registers(compiler, entry->length) : symbol->offset;
+    unsigned covered = 0;
+    type_t kind = entry->type;
+    if (var_def_node_view != NULL && !var_def_node_view->is_init_list) {
+        covered = get_length_of_node(var_def_node_view->node);
+        if (!compile_expression(compiler, var_def_node_view->node, first, &kind)
+            || !emit_normalize(compiler, entry->type, kind, first, first, covered)) {
+            return false;
+        }
+    } else if (var_def_node_view != NULL) {
+        covered = var_def_node_view->length;
+        for (unsigned i = 0; i < covered; ++i) {
+            bool success;
+            if (var_def_node_view->q_types[i].qualifier == CONST_T) {
+                success = emit_constant(compiler, first + i,
+                                        normalize(entry->type, from_value(var_def_node_view->q_types[i].type,
+                                                                          var_def_node_view->values[i].const_value)));
+            } else {
+                success = compile_expression(compiler, var_def_node_view->values[i].node_value, first + i, &kind)
+                          && emit_normalize(compiler, entry->type, kind, first + i, first + i, 1);
+            }
+            if (!success) {
+                return false;
+            }
+        }
+    }
+    for (unsigned i = covered; i < entry->length; ++i) {
+        if (!emit_constant(compiler, first + i, 0)) {
+            return false;
+        }
+    }
+    for (unsigned i = 0; is_global && i < entry->length; ++i) {
+        if (!emit(compiler, STORE_GLOBAL_I, symbol->offset + i, first + i, 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Compile assignment
+ * \note                                The target is located before the right-hand side is evaluated, as in the
+ *                                      simulator; compound assignments treat booleans as unsigned integers
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to assignment node
+ * \return                              Whether the statement could be compiled
+ */
+static bool compile_assignment(compiler_t *compiler, const assign_node_t *node) {
+    if (node->left->node_type != REFERENCE_NODE_T) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Left-hand side of assignment is not a variable");
+        return false;
+    }
+
+    location_t location;
+    if (!locate(compiler, (const reference_node_t *) node->left, &location)) {
+        return false;
+    }
+    const entry_t *entry = location.symbol->entry;
+    bool is_in_place = !location.is_global && !location.is_indexed;
+    unsigned right_length = get_length_of_node(node->right);
+    type_t kind;
+
+    /* scalar assignments to local variables need no temporaries */
+    if (node->op == ASSIGN_OP && is_in_place && location.length == 1 && right_length == 1) {
+        return compile_expression(compiler, node->right, location.base, &kind)
+               && emit_normalize(compiler, entry->type, kind, location.base, location.base, 1);
+    }
+
+    unsigned right;
+    if (node->op == ASSIGN_OP || !is_in_place || location.length != 1) {
+        right = allocate_registers(compiler, right_length);
+        if (!compile_expression(compiler, node->right, right, &kind)) {
+            return false;
+        }
+    } else if (!compile_operand(compiler, node->right, &right, &kind)) {
+        return false;
+    }
+
+    if (node->op == ASSIGN_OP) {
+        if (!emit_normalize(compiler, entry->type, kind, right, right, right_length)) {
+            return false;
+        }
+        for (unsigned i = 0; i < location.length; ++i) {
+            if (!emit_store(compiler, &location, i, right + ((right_length == 1) ? 0 : i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    type_t left_type = (entry->type == BOOL_T) ? UNSIGNED_T : entry->type;
+    type_t right_type = (get_type_of_node(node->right) == BOOL_T) ? UNSIGNED_T : get_type_of_node(node->right);
+    bool is_signed = left_type == INT_T && right_type == INT_T;
+    opcode_t opcode = integer_opcodes[node->op - ASSIGN_OR_OP + OR_OP];
+    opcode = is_signed ? opcode : (opcode_t) (opcode + 1);
+    unsigned value = is_in_place ? location.base : allocate_registers(compiler, location.length);
+    if (!is_in_place && !emit_load(compiler, &location, value)) {
+        return false;
+    }
+    for (unsigned i = 0; i < location.length; ++i) {
+        if (!emit(compiler, opcode, value + i, value + i, right + ((right_length == 1) ? 0 : i))
+            || !emit_normalize(compiler, entry->type, is_signed ? INT_T : UNSIGNED_T, value + i, value + i, 1)
+            || !emit_store(compiler, &location, i, value + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Set target of a jump instruction
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           instruction: Index of jump instruction
+ * \param[in]                           target: Index of target instruction
+ */
+static void patch_jump(compiler_t *compiler, unsigned instruction, unsigned target) {
+    instruction_t *jump = &(compiler->program->instructions[instruction]);
+    if (jump->opcode == JUMP_I) {
+        jump->a = target;
+    } else if (jump->opcode == JUMP_IF_CASE_I) {
+        jump->c = target;
+    } else {
+        jump->b = target;
+    }
+}
+
+/**
+ * \brief                               Compile condition and conditional jump
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           condition: Pointer to condition
+ * \param[in]                           opcode: `JUMP_IF_ZERO_I` or `JUMP_IF_NOT_ZERO_I`
+ * \param[in]                           target: Index of target instruction (patched later if not yet known)
+ * \return                              Whether the condition could be compiled
+ */
+static bool compile_jump(compiler_t *compiler, const node_t *condition, opcode_t opcode, unsigned target) {
+    unsigned num_of_registers = compiler->num_of_registers;
+    unsigned value;
+    type_t kind;
+    bool success = compile_operand(compiler, condition, &value, &kind) && emit(compiler, opcode, value, target, 0);
+    compiler->num_of_registers = num_of_registers;
+    return success;
+}
+
+/**
+ * \brief                               Compile if-statement
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to if node
+ * \return                              Whether the statement could be compiled
+ */
+static bool compile_if(compiler_t *compiler, const if_node_t *node) {
+    unsigned num_of_branches = node->num_of_else_ifs + 1;
+    unsigned *exits = malloc(num_of_branches * sizeof (unsigned));
+    if (exits == NULL) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for if-statement failed");
+        return false;
+    }
+
+    bool success = true;
+    unsigned num_of_exits = 0;
+    for (unsigned i = 0; success && i < num_of_branches; ++i) {
+        const node_t *condition = node->condition;
+        const node_t *branch = node->if_branch;
+        if (i > 0) {
+            condition = ((const else_if_node_t *) node->else_ifs[i - 1])->condition;
+            branch = ((const else_if_node_t *) node->else_ifs[i - 1])->else_if_branch;
+        }
+        success = compile_jump(compiler, condition, JUMP_IF_ZERO_I, 0);
+        unsigned skip = compiler->program->num_of_instructions - 1;
+        success = success && compile_statement(compiler, branch);
+        if (success && (i + 1 < num_of_branches || node->else_branch != NULL)) {
+            exits[num_of_exits++] = compiler->program->num_of_instructions;
+            success = emit(compiler, JUMP_I, 0, 0, 0);
+        }
+        if (success) {
+            patch_jump(compiler, skip, compiler->program->num_of_instructions);
+        }
+    }
+    success = success && compile_statement(compiler, node->else_branch);
+    for (unsigned i = 0; success && i < num_of_exits; ++i) {
+        patch_jump(compiler, exits[i], compiler->program->num_of_instructions);
+    }
+    free(exits);
+    return success;
+}
+
+/**
+ * \brief                               Append jump of a break or continue to the pending jumps
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           is_continue: Whether the jump is a continue
+ * \return                              Whether the jump could be appended
+ */
+static bool push_jump(compiler_t *compiler, bool is_continue) {
+    if (!reserve((void **) &(compiler->jumps), &(compiler->jumps_capacity), compiler->num_of_jumps,
+                 sizeof (pending_jump_t))) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u pending jumps failed",
+                 compiler->num_of_jumps + 1);
+        return false;
+    }
+    compiler->jumps[compiler->num_of_jumps++] = (pending_jump_t) {compiler->program->num_of_instructions,
+                                                                  is_continue};
+    return emit(compiler, JUMP_I, 0, 0, 0);
+}
+
+/**
+ * \brief                               Compile switch-statement
+ * \note                                The value is compared with the cases in order, so the first case with matching
+ *                                      value is executed, or else the default case
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to switch node
+ * \return                              Whether the statement could be compiled
+ */
+static bool compile_switch(compiler_t *compiler, const switch_node_t *node) {
+    unsigned *jumps = malloc(2 * (node->num_of_cases + 1) * sizeof (unsigned));
+    if (jumps == NULL) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Allocating memory for switch-statement failed");
+        return false;
+    }
+
+    unsigned *exits = jumps + node->num_of_cases + 1;
+    unsigned num_of_registers = compiler->num_of_registers;
+    unsigned value;
+    type_t kind;
+    bool success = compile_operand(compiler, node->expression, &value, &kind);
+    const node_t *default_branch = NULL;
+    for (unsigned i = 0; success && i < node->num_of_cases; ++i) {
+        const case_node_t *case_node_view = (const case_node_t *) node->cases[i];
+        unsigned index;
+        if (case_node_view->case_const_type == VOID_T) {
+            default_branch = case_node_view->case_branch;
+            continue;
+        }
+        jumps[i] = compiler->program->num_of_instructions;
+        success = add_constant(compiler, from_value(case_node_view->case_const_type,
+                                                    case_node_view->case_const_value), &index)
+                  && emit(compiler, JUMP_IF_CASE_I, value, index, 0);
+    }
+    compiler->num_of_registers = num_of_registers;
+    unsigned default_jump = compiler->program->num_of_instructions;
+    success = success && emit(compiler, JUMP_I, 0, 0, 0);
+
+    unsigned num_of_exits = 0;
+    for (unsigned i = 0; success && i < node->num_of_cases; ++i) {
+        const case_node_t *case_node_view = (const case_node_t *) node->cases[i];
+        if (case_node_view->case_const_type == VOID_T) {
+            continue;
+        }
+        patch_jump(compiler, jumps[i], compiler->program->num_of_instructions);
+        success = compile_statement(compiler, case_node_view->case_branch);
+        exits[num_of_exits++] = compiler->program->num_of_instructions;
+        success = success && emit(compiler, JUMP_I, 0, 0, 0);
+    }
+    if (success) {
+        patch_jump(compiler, default_jump, compiler->program->num_of_instructions);
+        success = compile_statement(compiler, default_branch);
+    }
+    for (unsigned i = 0; success && i < num_of_exits; ++i) {
+        patch_jump(compiler, exits[i], compiler->program->num_of_instructions);
+    }
+    free(jumps);
+    return success;
+}
+
+/**
+ * \brief                               Compile loop
+ * \note                                The condition is placed after the body, so every iteration takes a single
+ *                                      conditional jump; for- and while-loops enter at the condition
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to for-, do-while- or while-loop node
+ * \return                              Whether the statement could be compiled
+ */
+static bool compile_loop(compiler_t *compiler, const node_t *node) {
+    const node_t *initialize = NULL;
+    const node_t *condition;
+    const node_t *increment = NULL;
+    const node_t *body;
+    bool is_checked_first = true;
+    if (node->node_type == FOR_NODE_T) {
+        const for_node_t *for_node_view = (const for_node_t *) node;
+        initialize = for_node_view->initialize;
+        condition = for_node_view->condition;
+        increment = for_node_view->increment;
+        body = for_node_view->for_branch;
+    } else if (node->node_type == DO_NODE_T) {
+        condition = ((const do_node_t *) node)->condition;
+        body = ((const do_node_t *) node)->do_branch;
+        is_checked_first = false;
+    } else {
+        condition = ((const while_node_t *) node)->condition;
+        body = ((const while_node_t *) node)->while_branch;
+    }
+
+    bytecode_program_t *program = compiler->program;
+    unsigned first_jump = compiler->num_of_jumps;
+    ++(compiler->loop_depth);
+    if (!compile_statement(compiler, initialize)) {
+        return false;
+    }
+    unsigned entry_jump = program->num_of_instructions;
+    if (is_checked_first && !emit(compiler, JUMP_I, 0, 0, 0)) {
+        return false;
+    }
+
+    unsigned body_start = program->num_of_instructions;
+    if (!compile_statement(compiler, body)) {
+        return false;
+    }
+    unsigned continue_target = program->num_of_instructions;
+    if (!compile_statement(compiler, increment)) {
+        return false;
+    }
+    if (is_checked_first) {
+        patch_jump(compiler, entry_jump, program->num_of_instructions);
+    }
+    if (!((condition != NULL) ? compile_jump(compiler, condition, JUMP_IF_NOT_ZERO_I, body_start)
+                              : emit(compiler, JUMP_I, body_start, 0, 0))) {
+        return false;
+    }
+
+    for (unsigned i = first_jump; i < compiler->num_of_jumps; ++i) {
+        patch_jump(compiler, compiler->jumps[i].instruction,
+                   compiler->jumps[i].is_continue ? continue_target : program->num_of_instructions);
+    }
+    compiler->num_of_jumps = first_jump;
+    --(compiler->loop_depth);
+    return true;
+}
+
+/**
+ * \brief                               Compile return statement
+ * \note                                Returned values are converted to the type of the function before the return
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           node: Pointer to return node
+ * \return                              Whether the statement could be compiled
+ */
+static bool compile_return(compiler_t *compiler, const return_node_t *node) {
+    if (compiler->function == NULL) {
+        snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Return outside of a function");
+        return false;
+    } else if (node->return_value == NULL) {
+        return emit(compiler, RETURN_ZERO_I, 0, 0, 0);
+    }
+
+    const entry_t *entry = compiler->function->entry;
+    unsigned length = get_length_of_node(node->return_value);
+    unsigned first;
+    type_t kind;
+    if (length == entry->length) {
+        if (!compile_operand(compiler, node->return_value, &first, &kind)) {
+            return false;
+        }
+    } else {
+        first = allocate_registers(compiler, (length > entry->length) ? length : entry->length);
+        if (!compile_expression(compiler, node->return_value, first, &kind)) {
+            return false;
+        }
+        for (unsigned i = length; i < entry->length; ++i) {
+            if (!emit_constant(compiler, first + i, 0)) {
+                return false;
+            }
+        }
+    }
+
+    unsigned returned = first;
+    bool is_normalized = (entry->type == BOOL_T) ? kind == BOOL_T
+                                                 : kind == BOOL_T || kind == ((entry->type == INT_T) ? INT_T
+                                                                                                     : UNSIGNED_T);
+    if (!is_normalized) {
+        returned = allocate_registers(compiler, entry->length);
+        if (!emit_normalize(compiler, entry->type, kind, returned, first, entry->length)) {
+            return false;
+        }
+    }
+    return emit(compiler, RETURN_I, returned, 0, 0);
+}
+
+/* See declaration for documentation */
+static bool compile_statement(compiler_t *compiler, const node_t *node) {
+    if (node == NULL) {
+        return true;
+    }
+
+    unsigned num_of_registers = compiler->num_of_registers;
+    bool success;
+    switch (node->node_type) {
+        case STMT_LIST_NODE_T: {
+            const stmt_list_node_t *stmt_list_node_view = (const stmt_list_node_t *) node;
+            success = true;
+            for (unsigned i = 0; success && i < stmt_list_node_view->num_of_stmts; ++i) {
+                success = compile_statement(compiler, stmt_list_node_view->stmt_list[i]);
+            }
+            break;
+        }
+        case VAR_DECL_NODE_T: case VAR_DEF_NODE_T: {
+            success = compile_definition(compiler, node);
+            break;
+        }
+        case FUNC_DEF_NODE_T: {
+            success = true;
+            break;
+        }
+        case FUNC_CALL_NODE_T: {
+            unsigned length = ((const func_call_node_t *) node)->entry->length;
+            success = compile_call(compiler, (const func_call_node_t *) node,
+                                   allocate_registers(compiler, (length > 0) ? length : 1));
+            break;
+        }
+        case IF_NODE_T: {
+            success = compile_if(compiler, (const if_node_t *) node);
+            break;
+        }
+        case SWITCH_NODE_T: {
+            success = compile_switch(compiler, (const switch_node_t *) node);
+            break;
+        }
+        case FOR_NODE_T: case DO_NODE_T: case WHILE_NODE_T: {
+            success = compile_loop(compiler, node);
+            break;
+        }
+        case ASSIGN_NODE_T: {
+            success = compile_assignment(compiler, (const assign_node_t *) node);
+            break;
+        }
+        case PHASE_NODE_T: {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Change of phase cannot be compiled to bytecode");
+            return false;
+        }
+        case MEASURE_NODE_T: {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Measurement cannot be compiled to bytecode");
+            return false;
+        }
+        case BREAK_NODE_T: case CONTINUE_NODE_T: {
+            /* leaving a function body by break or continue returns its zero-initialized values */
+            if (compiler->loop_depth > 0) {
+                success = push_jump(compiler, node->node_type == CONTINUE_NODE_T);
+            } else if (compiler->function != NULL) {
+                success = emit(compiler, RETURN_ZERO_I, 0, 0, 0);
+            } else {
+                snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Leaving a loop outside of a loop");
+                success = false;
+            }
+            break;
+        }
+        case RETURN_NODE_T: {
+            success = compile_return(compiler, (const return_node_t *) node);
+            break;
+        }
+        default: {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Node is not a statement");
+            return false;
+        }
+    }
+    compiler->num_of_registers = num_of_registers;
+    return success;
+}
+
+/**
+ * \brief                               Count loop entered by the constant pass
+ * \param[in]                           node: Pointer to loop node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to compiler
+ * \return                              `CONTINUE_W` to walk the loop
+ */
+static walk_result_t enter_loop(node_t *node, size_t depth, void *data) {
+    (void) node;
+    (void) depth;
+    ++(((compiler_t *) data)->num_of_walked_loops);
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Count loop left by the constant pass
+ * \param[in]                           node: Pointer to loop node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to compiler
+ * \return                              `CONTINUE_W`
+ */
+static walk_result_t leave_loop(node_t *node, size_t depth, void *data) {
+    (void) node;
+    (void) depth;
+    --(((compiler_t *) data)->num_of_walked_loops);
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Hoist scalar constant used inside a loop into a register
+ * \param[in]                           node: Pointer to constant node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to compiler
+ * \return                              `CONTINUE_W`
+ */
+static walk_result_t visit_constant(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    compiler_t *compiler = data;
+    const const_node_t *const_node_view = (const const_node_t *) node;
+    if (compiler->num_of_walked_loops == 0 || const_node_view->type_info.shape != NULL
+        || compiler->num_of_hoisted_values == MAX_NUM_OF_HOISTED_CONSTANTS) {
+        return CONTINUE_W;
+    }
+
+    type_t type = const_node_view->type_info.type;
+    long long value = normalize(type, from_value(type, const_node_view->values[0]));
+    for (unsigned i = 0; i < compiler->num_of_hoisted_values; ++i) {
+        if (compiler->hoisted_values[i] == value) {
+            return CONTINUE_W;
+        }
+    }
+    compiler->hoisted_values[compiler->num_of_hoisted_values++] = value;
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Skip function definition in the constant pass
+ * \param[in]                           node: Pointer to function definition node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to compiler
+ * \return                              `SKIP_CHILDREN_W`
+ */
+static walk_result_t skip_function(node_t *node, size_t depth, void *data) {
+    (void) node;
+    (void) depth;
+    (void) data;
+    return SKIP_CHILDREN_W;
+}
+
+/**
+ * \brief                               Tree pass collecting the constants used inside loops
+ */
+static const tree_pass_t constant_pass = {
+    .pre_visitors = {
+        [CONST_NODE_T] = visit_constant, [FUNC_DEF_NODE_T] = skip_function, [FOR_NODE_T] = enter_loop,
+        [DO_NODE_T] = enter_loop, [WHILE_NODE_T] = enter_loop,
+    },
+    .post_visitors = {
+        [FOR_NODE_T] = leave_loop, [DO_NODE_T] = leave_loop, [WHILE_NODE_T] = leave_loop,
+    },
+};
+
+/**
+ * \brief                               Compile function of the program
+ * \note                                Scalar constants used inside loops are loaded into registers of their own once
+ *                                      per call, so loop iterations do not reload them
+ * \param[in,out]                       compiler: Pointer to compiler
+ * \param[in]                           index: Index of function among the compiled functions
+ * \return                              Whether the function could be compiled
+ */
+static bool compile_function(compiler_t *compiler, unsigned index) {
+    bytecode_program_t *program = compiler->program;
+    const entry_t *entry = program->functions[index].entry;
+    const symbol_t *symbol = (entry != NULL) ? find_symbol(compiler, entry) : NULL;
+    for (const symbol_t *local = symbol + 1; symbol != NULL && local < compiler->symbols + compiler->num_of_symbols
+                                             && local->owner == symbol; ++local) {
+        if (local->entry->qualifier == QUANTUM_T) {
+            snprintf(compiler->error_msg, ERROR_MSG_LENGTH, "Quantum variable %s of %s cannot be compiled to bytecode",
+                     local->entry->name, entry->name);
+            return false;
+        }
+    }
+
+    compiler->num_of_hoisted_values = 0;
+    compiler->num_of_walked_loops = 0;
+    if (!run_tree_pass(&constant_pass, (node_t *) program->functions[index].func_tail, 0, compiler,
+                       compiler->error_msg)) {
+        return false;
+    }
+
+    compiler->function = symbol;
+    compiler->first_hoisted_register = (symbol != NULL) ? symbol->num_of_local_values : 0;
+    compiler->num_of_registers = compiler->first_hoisted_register + compiler->num_of_hoisted_values;
+    compiler->max_num_of_registers = compiler->num_of_registers;
+    compiler->loop_depth = 0;
+    program->functions[index].first_instruction = program->num_of_instructions;
+    for (unsigned i = 0; i < compiler->num_of_hoisted_values; ++i) {
+        if (!emit_constant(compiler, compiler->first_hoisted_register + i, compiler->hoisted_values[i])) {
+            return false;
+        }
+    }
+    if (!compile_statement(compiler, program->functions[index].func_tail)
+        || !emit(compiler, RETURN_ZERO_I, 0, 0, 0)) {
+        return false;
+    }
+    program->functions[index].num_of_registers = compiler->max_num_of_registers;
+    return true;
+}
+
+/* See header for documentation */
+bool compile_bytecode(bytecode_program_t *program, const node_t *root, const symbol_table_t *symbol_table,
+                      char error_msg[ERROR_MSG_LENGTH]) {
+    memset(program, 0, sizeof (bytecode_program_t));
+    compiler_t compiler;
+    memset(&compiler, 0, sizeof (compiler_t));
+    compiler.program = program;
+    compiler.error_msg = error_msg;
+    bool success = setup_compiler(&compiler, root, symbol_table);
+
+    /* function 0 runs the global definitions */
+    if (success && !reserve((void **) &(program->functions), &(program->functions_capacity), 0,
+                            sizeof (bytecode_function_t))) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for functions failed");
+        success = false;
+    } else if (success) {
+        program->functions[program->num_of_functions++] = (bytecode_function_t) {.func_tail = root};
+    }
+
+    const symbol_t *main_symbol = NULL;
+    for (unsigned i = 0; success && i < compiler.num_of_symbols; ++i) {
+        const entry_t *entry = compiler.symbols[i].entry;
+        if (entry->is_function && entry->scope == 0 && strcmp(entry->name, "main") == 0) {
+            main_symbol = &(compiler.symbols[i]);
+        }
+    }
+    if (main_symbol != NULL && main_symbol->entry->num_of_pars != 0) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Function main must not take parameters");
+        success = false;
+    } else if (main_symbol != NULL && main_symbol->func_tail == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Calling function main failed");
+        success = false;
+    } else if (main_symbol != NULL) {
+        success = queue_function(&compiler, main_symbol->entry, &(program->main_function));
+        program->has_main = success;
+    }
+
+    /* compiling a function queues the functions it calls */
+    for (unsigned i = 0; success && i < program->num_of_functions; ++i) {
+        success = compile_function(&compiler, i);
+    }
+
+    free(compiler.symbols);
+    free(compiler.symbol_map);
+    free(compiler.jumps);
+    free(compiler.frames);
+    if (!success) {
+        free_bytecode(program);
+    }
+    return success;
+}
+
+/**
+ * \brief                               Make room for more registers
+ * \param[in,out]                       machine: Pointer to machine
+ * \param[in]                           num_of_registers: Number of registers needed
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the registers could be allocated
+ */
+static bool grow_registers(machine_t *machine, size_t num_of_registers, char error_msg[ERROR_MSG_LENGTH]) {
+    if (num_of_registers <= machine->registers_capacity) {
+        return true;
+    }
+    size_t new_capacity = (machine->registers_capacity == 0) ? INITIAL_BYTECODE_SIZE : machine->registers_capacity;
+    while (new_capacity < num_of_registers) {
+        new_capacity *= 2;
+    }
+    long long *new_registers = realloc(machine->registers, new_capacity * sizeof (long long));
+    if (new_registers == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for %zu registers failed", new_capacity);
+        return false;
+    }
+    machine->registers = new_registers;
+    machine->registers_capacity = new_capacity;
+    return true;
+}
+
+/**
+ * \brief                               Make room for one more call frame
+ * \param[in,out]                       machine: Pointer to machine
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the call frame could be allocated
+ */
+static bool grow_frames(machine_t *machine, char error_msg[ERROR_MSG_LENGTH]) {
+    if (machine->num_of_frames < machine->frames_capacity) {
+        return true;
+    } else if (machine->frames_capacity >= MAX_CALL_DEPTH) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Call depth exceeds the limit of %u", MAX_CALL_DEPTH);
+        return false;
+    }
+    unsigned new_capacity = (machine->frames_capacity == 0) ? INITIAL_BYTECODE_SIZE : 2 * machine->frames_capacity;
+    new_capacity = (new_capacity < MAX_CALL_DEPTH) ? new_capacity : MAX_CALL_DEPTH;
+    call_frame_t *new_frames = realloc(machine->frames, new_capacity * sizeof (call_frame_t));
+    if (new_frames == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u call frames failed", new_capacity);
+        return false;
+    }
+    machine->frames = new_frames;
+    machine->frames_capacity = new_capacity;
+    return true;
+}
+
+/**
+ * \brief                               Run function until it returns
+ * \note                                The returned values are written to the first registers of the machine
+ * \param[in]                           program: Pointer to bytecode program
+ * \param[in,out]                       machine: Pointer to machine
+ * \param[in]                           function: Index of function
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the function ran without errors
+ */
+static bool execute_function(const bytecode_program_t *program, machine_t *machine, unsigned function,
+                             char error_msg[ERROR_MSG_LENGTH]) {
+    const bytecode_function_t *functions = program->functions;
+    const instruction_t *code = program->instructions;
+    const long long *constants = program->constants;
+    long long *globals = machine->globals;
+    unsigned base = functions[function].num_of_return_values;
+    if (!grow_registers(machine, (size_t) base + functions[function].num_of_registers, error_msg)
+        || !grow_frames(machine, error_msg)) {
+        return false;
+    }
+    memset(machine->registers, 0, base * sizeof (long long));
+    machine->frames[0] = (call_frame_t) {function, base, 0, 0};
+    machine->num_of_frames = 1;
+
+    call_frame_t *frame = machine->frames;
+    long long *r = machine->registers + base;
+    const instruction_t *ip = code + functions[function].first_instruction;
+    const instruction_t *instruction;
+    unsigned long long num_of_steps = 0;
+
+#define REG_A (r[instruction->a])
+#define REG_B (r[instruction->b])
+#define REG_C (r[instruction->c])
+#define LEFT_BITS ((uint32_t) REG_B)
+#define RIGHT_BITS ((uint32_t) REG_C)
+#define SIGNED(bits) ((long long) (int32_t) (uint32_t) (bits))
+#define UNSIGNED(bits) ((long long) (uint32_t) (bits))
+
+#ifdef THREADED_DISPATCH
+#define HANDLER(opcode) opcode##_H
+#define DISPATCH() do { instruction = ip++; ++num_of_steps; goto *handlers[instruction->opcode]; } while (0)
+    static const void *const handlers[NUM_OF_OPCODES] = {
+        [MOVE_I] = &&MOVE_I_H, [LOAD_CONST_I] = &&LOAD_CONST_I_H, [LOAD_GLOBAL_I] = &&LOAD_GLOBAL_I_H,
+        [STORE_GLOBAL_I] = &&STORE_GLOBAL_I_H, [LOAD_INDEXED_I] = &&LOAD_INDEXED_I_H,
+        [STORE_INDEXED_I] = &&STORE_INDEXED_I_H, [LOAD_GLOBAL_INDEXED_I] = &&LOAD_GLOBAL_INDEXED_I_H,
+        [STORE_GLOBAL_INDEXED_I] = &&STORE_GLOBAL_INDEXED_I_H, [SET_INDEX_I] = &&SET_INDEX_I_H,
+        [ADD_INDEX_I] = &&ADD_INDEX_I_H, [OR_SIGNED_I] = &&OR_SIGNED_I_H, [OR_UNSIGNED_I] = &&OR_UNSIGNED_I_H,
+        [XOR_SIGNED_I] = &&XOR_SIGNED_I_H, [XOR_UNSIGNED_I] = &&XOR_UNSIGNED_I_H, [AND_SIGNED_I] = &&AND_SIGNED_I_H,
+        [AND_UNSIGNED_I] = &&AND_UNSIGNED_I_H, [ADD_SIGNED_I] = &&ADD_SIGNED_I_H,
+        [ADD_UNSIGNED_I] = &&ADD_UNSIGNED_I_H, [SUB_SIGNED_I] = &&SUB_SIGNED_I_H,
+        [SUB_UNSIGNED_I] = &&SUB_UNSIGNED_I_H, [MUL_SIGNED_I] = &&MUL_SIGNED_I_H,
+        [MUL_UNSIGNED_I] = &&MUL_UNSIGNED_I_H, [DIV_SIGNED_I] = &&DIV_SIGNED_I_H,
+        [DIV_UNSIGNED_I] = &&DIV_UNSIGNED_I_H, [MOD_SIGNED_I] = &&MOD_SIGNED_I_H,
+        [MOD_UNSIGNED_I] = &&MOD_UNSIGNED_I_H, [LESS_SIGNED_I] = &&LESS_SIGNED_I_H,
+        [LESS_UNSIGNED_I] = &&LESS_UNSIGNED_I_H, [LESS_EQUAL_SIGNED_I] = &&LESS_EQUAL_SIGNED_I_H,
+        [LESS_EQUAL_UNSIGNED_I] = &&LESS_EQUAL_UNSIGNED_I_H, [EQUAL_SIGNED_I] = &&EQUAL_SIGNED_I_H,
+        [EQUAL_UNSIGNED_I] = &&EQUAL_UNSIGNED_I_H, [EQUAL_BOOL_I] = &&EQUAL_BOOL_I_H,
+        [NOT_EQUAL_SIGNED_I] = &&NOT_EQUAL_SIGNED_I_H, [NOT_EQUAL_UNSIGNED_I] = &&NOT_EQUAL_UNSIGNED_I_H,
+        [NOT_EQUAL_BOOL_I] = &&NOT_EQUAL_BOOL_I_H, [LAND_I] = &&LAND_I_H, [LOR_I] = &&LOR_I_H,
+        [LXOR_I] = &&LXOR_I_H, [NOT_I] = &&NOT_I_H, [INVERT_BOOL_I] = &&INVERT_BOOL_I_H,
+        [INVERT_SIGNED_I] = &&INVERT_SIGNED_I_H, [INVERT_UNSIGNED_I] = &&INVERT_UNSIGNED_I_H,
+        [NORMALIZE_BOOL_I] = &&NORMALIZE_BOOL_I_H, [NORMALIZE_SIGNED_I] = &&NORMALIZE_SIGNED_I_H,
+        [NORMALIZE_UNSIGNED_I] = &&NORMALIZE_UNSIGNED_I_H, [JUMP_I] = &&JUMP_I_H,
+        [JUMP_IF_ZERO_I] = &&JUMP_IF_ZERO_I_H, [JUMP_IF_NOT_ZERO_I] = &&JUMP_IF_NOT_ZERO_I_H,
+        [JUMP_IF_CASE_I] = &&JUMP_IF_CASE_I_H, [CALL_I] = &&CALL_I_H, [RETURN_I] = &&RETURN_I_H,
+        [RETURN_ZERO_I] = &&RETURN_ZERO_I_H,
+    };
+    DISPATCH();
+#else
+#define HANDLER(opcode) case opcode
+#define DISPATCH() continue
+    for (;;) {
+        instruction = ip++;
+        ++num_of_steps;
+        switch (instruction->opcode) {
+#endif /* THREADED_DISPATCH */
+            HANDLER(MOVE_I): {
+                REG_A = REG_B;
+                DISPATCH();
+            }
+            HANDLER(LOAD_CONST_I): {
+                REG_A = constants[instruction->b];
+                DISPATCH();
+            }
+            HANDLER(LOAD_GLOBAL_I): {
+                REG_A = globals[instruction->b];
+                DISPATCH();
+            }
+            HANDLER(STORE_GLOBAL_I): {
+                globals[instruction->a] = REG_B;
+                DISPATCH();
+            }
+            HANDLER(LOAD_INDEXED_I): {
+                REG_A = r[instruction->b + REG_C];
+                DISPATCH();
+            }
+            HANDLER(STORE_INDEXED_I): {
+                r[instruction->a + REG_B] = REG_C;
+                DISPATCH();
+            }
+            HANDLER(LOAD_GLOBAL_INDEXED_I): {
+                REG_A = globals[instruction->b + REG_C];
+                DISPATCH();
+            }
+            HANDLER(STORE_GLOBAL_INDEXED_I): {
+                globals[instruction->a + REG_B] = REG_C;
+                DISPATCH();
+            }
+            HANDLER(SET_INDEX_I): HANDLER(ADD_INDEX_I): {
+                const index_check_t *check = program->index_checks + instruction->c;
+                long long index = REG_B;
+                if (index < 0 || index >= check->size) {
+                    snprintf(error_msg, ERROR_MSG_LENGTH, "%u-th index (%lld) of array %s out of bounds (%u)",
+                             check->dimension, index, check->entry->name, check->size);
+                    goto failure;
+                }
+                REG_A = index * check->stride + ((instruction->opcode == ADD_INDEX_I) ? REG_A : 0);
+                DISPATCH();
+            }
+            HANDLER(OR_SIGNED_I): {
+                REG_A = SIGNED(LEFT_BITS | RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(OR_UNSIGNED_I): {
+                REG_A = UNSIGNED(LEFT_BITS | RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(XOR_SIGNED_I): {
+                REG_A = SIGNED(LEFT_BITS ^ RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(XOR_UNSIGNED_I): {
+                REG_A = UNSIGNED(LEFT_BITS ^ RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(AND_SIGNED_I): {
+                REG_A = SIGNED(LEFT_BITS & RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(AND_UNSIGNED_I): {
+                REG_A = UNSIGNED(LEFT_BITS & RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(ADD_SIGNED_I): {
+                REG_A = SIGNED(LEFT_BITS + RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(ADD_UNSIGNED_I): {
+                REG_A = UNSIGNED(LEFT_BITS + RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(SUB_SIGNED_I): {
+                REG_A = SIGNED(LEFT_BITS - RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(SUB_UNSIGNED_I): {
+                REG_A = UNSIGNED(LEFT_BITS - RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(MUL_SIGNED_I): {
+                REG_A = SIGNED(LEFT_BITS * RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(MUL_UNSIGNED_I): {
+                REG_A = UNSIGNED(LEFT_BITS * RIGHT_BITS);
+                DISPATCH();
+            }
+            HANDLER(DIV_SIGNED_I): HANDLER(MOD_SIGNED_I): {
+                bool is_division = instruction->opcode == DIV_SIGNED_I;
+                int32_t left = (int32_t) LEFT_BITS;
+                int32_t right = (int32_t) RIGHT_BITS;
+                if (right == 0) {
+                    snprintf(error_msg, ERROR_MSG_LENGTH, is_division ? "Division by zero" : "Modulo by zero");
+                    goto failure;
+                } else if (left == INT32_MIN && right == -1) {
+                    REG_A = is_division ? left : 0;
+                } else {
+                    REG_A = is_division ? left / right : left % right;
+                }
+                DISPATCH();
+            }
+            HANDLER(DIV_UNSIGNED_I): HANDLER(MOD_UNSIGNED_I): {
+                bool is_division = instruction->opcode == DIV_UNSIGNED_I;
+                if (RIGHT_BITS == 0) {
+                    snprintf(error_msg, ERROR_MSG_LENGTH, is_division ? "Division by zero" : "Modulo by zero");
+                    goto failure;
+                }
+                REG_A = is_division ? LEFT_BITS / RIGHT_BITS : LEFT_BITS % RIGHT_BITS;
+                DISPATCH();
+            }
+            HANDLER(LESS_SIGNED_I): {
+                REG_A = REG_B < REG_C;
+                DISPATCH();
+            }
+            HANDLER(LESS_UNSIGNED_I): {
+                REG_A = LEFT_BITS < RIGHT_BITS;
+                DISPATCH();
+            }
+            HANDLER(LESS_EQUAL_SIGNED_I): {
+                REG_A = REG_B <= REG_C;
+                DISPATCH();
+            }
+            HANDLER(LESS_EQUAL_UNSIGNED_I): {
+                REG_A = LEFT_BITS <= RIGHT_BITS;
+                DISPATCH();
+            }
+            HANDLER(EQUAL_SIGNED_I): {
+                REG_A = REG_B == REG_C;
+                DISPATCH();
+            }
+            HANDLER(EQUAL_UNSIGNED_I): {
+                REG_A = LEFT_BITS == RIGHT_BITS;
+                DISPATCH();
+            }
+            HANDLER(EQUAL_BOOL_I): {
+                REG_A = (REG_B != 0) == (REG_C != 0);
+                DISPATCH();
+            }
+            HANDLER(NOT_EQUAL_SIGNED_I): {
+                REG_A = REG_B != REG_C;
+                DISPATCH();
+            }
+            HANDLER(NOT_EQUAL_UNSIGNED_I): {
+                REG_A = LEFT_BITS != RIGHT_BITS;
+                DISPATCH();
+            }
+            HANDLER(NOT_EQUAL_BOOL_I): HANDLER(LXOR_I): {
+                REG_A = (REG_B != 0) != (REG_C != 0);
+                DISPATCH();
+            }
+            HANDLER(LAND_I): {
+                REG_A = REG_B && REG_C;
+                DISPATCH();
+            }
+            HANDLER(LOR_I): {
+                REG_A = REG_B || REG_C;
+                DISPATCH();
+            }
+            HANDLER(NOT_I): {
+                REG_A = !REG_B;
+                DISPATCH();
+            }
+            HANDLER(INVERT_BOOL_I): {
+                REG_A = ~REG_B != 0;
+                DISPATCH();
+            }
+            HANDLER(INVERT_SIGNED_I): {
+                REG_A = SIGNED(~REG_B);
+                DISPATCH();
+            }
+            HANDLER(INVERT_UNSIGNED_I): {
+                REG_A = UNSIGNED(~REG_B);
+                DISPATCH();
+            }
+            HANDLER(NORMALIZE_BOOL_I): {
+                REG_A = REG_B != 0;
+                DISPATCH();
+            }
+            HANDLER(NORMALIZE_SIGNED_I): {
+                REG_A = SIGNED(REG_B);
+                DISPATCH();
+            }
+            HANDLER(NORMALIZE_UNSIGNED_I): {
+                REG_A = UNSIGNED(REG_B);
+                DISPATCH();
+            }
+            HANDLER(JUMP_I): {
+                ip = code + instruction->a;
+                DISPATCH();
+            }
+            HANDLER(JUMP_IF_ZERO_I): {
+                if (REG_A == 0) {
+                    ip = code + instruction->b;
+                }
+                DISPATCH();
+            }
+            HANDLER(JUMP_IF_NOT_ZERO_I): {
+                if (REG_A != 0) {
+                    ip = code + instruction->b;
+                }
+                DISPATCH();
+            }
+            HANDLER(JUMP_IF_CASE_I): {
+                if ((uint32_t) REG_A == (uint32_t) constants[instruction->b]) {
+                    ip = code + instruction->c;
+                }
+                DISPATCH();
+            }
+            HANDLER(CALL_I): {
+                const bytecode_function_t *callee = functions + instruction->b;
+                unsigned callee_base = frame->base + functions[frame->function].num_of_registers;
+                unsigned caller_base = frame->base;
+                if (!grow_frames(machine, error_msg)
+                    || !grow_registers(machine, (size_t) callee_base + callee->num_of_registers, error_msg)) {
+                    goto failure;
+                }
+                r = machine->registers + caller_base;
+                memcpy(machine->registers + callee_base, r + instruction->c,
+                       callee->num_of_parameter_values * sizeof (long long));
+                frame = machine->frames + machine->num_of_frames++;
+                *frame = (call_frame_t) {instruction->b, callee_base, caller_base + instruction->a,
+                                         (unsigned) (ip - code)};
+                r = machine->registers + callee_base;
+                ip = code + callee->first_instruction;
+                DISPATCH();
+            }
+            HANDLER(RETURN_I): {
+                memcpy(machine->registers + frame->destination, r + instruction->a,
+                       functions[frame->function].num_of_return_values * sizeof (long long));
+                goto leave;
+            }
+            HANDLER(RETURN_ZERO_I): {
+                memset(machine->registers + frame->destination, 0,
+                       functions[frame->function].num_of_return_values * sizeof (long long));
+            }
+            leave: {
+                if (--(machine->num_of_frames) == 0) {
+                    goto finish;
+                }
+                ip = code + frame->return_instruction;
+                --frame;
+                r = machine->registers + frame->base;
+                DISPATCH();
+            }
+#ifndef THREADED_DISPATCH
+            default: {
+                snprintf(error_msg, ERROR_MSG_LENGTH, "Invalid opcode %u", (unsigned) instruction->opcode);
+                goto failure;
+            }
+        }
+    }
+#endif /* THREADED_DISPATCH */
+
+#undef REG_A
+#undef REG_B
+#undef REG_C
+#undef LEFT_BITS
+#undef RIGHT_BITS
+#undef SIGNED
+#undef UNSIGNED
+#undef HANDLER
+#undef DISPATCH
+
+finish:
+    machine->num_of_steps += num_of_steps;
+    return true;
+
+failure:
+    machine->num_of_steps += num_of_steps;
+    return false;
+}
+
+/* See header for documentation */
+bool run_bytecode(const bytecode_program_t *program, bytecode_result_t *result, char error_msg[ERROR_MSG_LENGTH]) {
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    machine_t machine;
+    memset(&machine, 0, sizeof (machine_t));
+    machine.globals = calloc(program->num_of_globals + 1, sizeof (long long));
+    bool success = machine.globals != NULL;
+    if (!success) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u global values failed",
+                 program->num_of_globals);
+    }
+
+    /* the registers always exist, so frames without any registers still point into them */
+    success = success && grow_registers(&machine, 1, error_msg) && execute_function(program, &machine, 0, error_msg);
+
+    result->has_return_value = false;
+    if (success && program->has_main) {
+        const entry_t *entry = program->functions[program->main_function].entry;
+        success = execute_function(program, &machine, program->main_function, error_msg);
+        result->has_return_value = success && entry->type != VOID_T && entry->depth == 0;
+        result->return_type = entry->type;
+        result->return_value = result->has_return_value ? machine.registers[0] : 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    result->num_of_steps = machine.num_of_steps;
+    result->seconds = (double) (end.tv_sec - start.tv_sec) + 1e-9 * (double) (end.tv_nsec - start.tv_nsec);
+    free(machine.registers);
+    free(machine.globals);
+    free(machine.frames);
+    return success;
+}
+
+/* See header for documentation */
+void fprint_bytecode(FILE *output_file, const bytecode_program_t *program) {
+    for (unsigned i = 0; i < program->num_of_functions; ++i) {
+        const bytecode_function_t *function = &(program->functions[i]);
+        unsigned end = (i + 1 < program->num_of_functions) ? program->functions[i + 1].first_instruction
+                                                           : program->num_of_instructions;
+        fprintf(output_file, "%s (%u registers, %u parameter values, %u returned values):\n",
+                (function->entry != NULL) ? function->entry->name : "<globals>", function->num_of_registers,
+                function->num_of_parameter_values, function->num_of_return_values);
+        for (unsigned j = function->first_instruction; j < end; ++j) {
+            const instruction_t *instruction = &(program->instructions[j]);
+            fprintf(output_file, "%8u  %-22s %u, %u, %u", j, opcode_names[instruction->opcode], instruction->a,
+                    instruction->b, instruction->c);
+            if (instruction->opcode == LOAD_CONST_I || instruction->opcode == JUMP_IF_CASE_I) {
+                fprintf(output_file, "  (%lld)", program->constants[instruction->b]);
+            } else if (instruction->opcode == CALL_I) {
+                fprintf(output_file, "  (%s)", program->functions[instruction->b].entry->name);
+            }
+            fprintf(output_file, "\n");
+        }
+    }
+}
+
+/* See header for documentation */
+void free_bytecode(bytecode_program_t *program) {
+    free(program->instructions);
+    free(program->constants);
+    free(program->functions);
+    free(program->index_checks);
+    memset(program, 0, sizeof (bytecode_program_t));
+}
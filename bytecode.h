@@ -0,0 +1,268 @@
+/**
+ * \file                                bytecode.h
+ * \brief                               Bytecode compiler and interpreter include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "ast.h"
+#include "rules.h"
+#include "symbol_table.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Opcode enumeration
+ * \note                                Operands a, b and c are registers of the current frame unless noted otherwise;
+ *                                      signed variants compute on 32-bit two's complement, unsigned variants on 32-bit
+ *                                      unsigned integers, and both wrap around like the simulator
+ */
+typedef enum opcode {
+    MOVE_I,                                 /*!< a = b */
+    LOAD_CONST_I,                           /*!< a = constant b */
+    LOAD_GLOBAL_I,                          /*!< a = global b */
+    STORE_GLOBAL_I,                         /*!< global a = b */
+    LOAD_INDEXED_I,                         /*!< a = register (b + c) */
+    STORE_INDEXED_I,                        /*!< register (a + b) = c */
+    LOAD_GLOBAL_INDEXED_I,                  /*!< a = global (b + c) */
+    STORE_GLOBAL_INDEXED_I,                 /*!< global (a + b) = c */
+    SET_INDEX_I,                            /*!< a = b * stride of index check c, after checking the bound of b */
+    ADD_INDEX_I,                            /*!< a += b * stride of index check c, after checking the bound of b */
+    OR_SIGNED_I,                            /*!< a = b | c */
+    OR_UNSIGNED_I,                          /*!< a = b | c */
+    XOR_SIGNED_I,                           /*!< a = b ^ c */
+    XOR_UNSIGNED_I,                         /*!< a = b ^ c */
+    AND_SIGNED_I,                           /*!< a = b & c */
+    AND_UNSIGNED_I,                         /*!< a = b & c */
+    ADD_SIGNED_I,                           /*!< a = b + c */
+    ADD_UNSIGNED_I,                         /*!< a = b + c */
+    SUB_SIGNED_I,                           /*!< a = b - c */
+    SUB_UNSIGNED_I,                         /*!< a = b - c */
+    MUL_SIGNED_I,                           /*!< a = b * c */
+    MUL_UNSIGNED_I,                         /*!< a = b * c */
+    DIV_SIGNED_I,                           /*!< a = b / c (fails for c = 0) */
+    DIV_UNSIGNED_I,                         /*!< a = b / c (fails for c = 0) */
+    MOD_SIGNED_I,                           /*!< a = b % c (fails for c = 0) */
+    MOD_UNSIGNED_I,                         /*!< a = b % c (fails for c = 0) */
+    LESS_SIGNED_I,                          /*!< a = b < c */
+    LESS_UNSIGNED_I,                        /*!< a = b < c */
+    LESS_EQUAL_SIGNED_I,                    /*!< a = b <= c */
+    LESS_EQUAL_UNSIGNED_I,                  /*!< a = b <= c */
+    EQUAL_SIGNED_I,                         /*!< a = b == c */
+    EQUAL_UNSIGNED_I,                       /*!< a = b == c */
+    EQUAL_BOOL_I,                           /*!< a = (b != 0) == (c != 0) */
+    NOT_EQUAL_SIGNED_I,                     /*!< a = b != c */
+    NOT_EQUAL_UNSIGNED_I,                   /*!< a = b != c */
+    NOT_EQUAL_BOOL_I,                       /*!< a = (b != 0) != (c != 0) */
+    LAND_I,                                 /*!< a = b && c (both operands evaluated) */
+    LOR_I,                                  /*!< a = b || c (both operands evaluated) */
+    LXOR_I,                                 /*!< a = (b != 0) != (c != 0) */
+    NOT_I,                                  /*!< a = !b */
+    INVERT_BOOL_I,                          /*!< a = ~b != 0 */
+    INVERT_SIGNED_I,                        /*!< a = ~b */
+    INVERT_UNSIGNED_I,                      /*!< a = ~b */
+    NORMALIZE_BOOL_I,                       /*!< a = b != 0 */
+    NORMALIZE_SIGNED_I,                     /*!< a = b wrapped to a 32-bit integer */
+    NORMALIZE_UNSIGNED_I,                   /*!< a = b wrapped to a 32-bit unsigned integer */
+    JUMP_I,                                 /*!< Continue at instruction a */
+    JUMP_IF_ZERO_I,                         /*!< Continue at instruction b if a == 0 */
+    JUMP_IF_NOT_ZERO_I,                     /*!< Continue at instruction b if a != 0 */
+    JUMP_IF_CASE_I,                         /*!< Continue at instruction c if a equals constant b as unsigned integer */
+    CALL_I,                                 /*!< Call function b with arguments from c on, its result going to a on */
+    RETURN_I,                               /*!< Return the values from a on */
+    RETURN_ZERO_I,                          /*!< Return zeros */
+    NUM_OF_OPCODES,                         /*!< Number of opcodes */
+} opcode_t;
+
+/**
+ * \brief                               Instruction struct
+ */
+typedef struct instruction {
+    opcode_t opcode;                        /*!< Opcode */
+    unsigned a;                             /*!< First operand */
+    unsigned b;                             /*!< Second operand */
+    unsigned c;                             /*!< Third operand */
+} instruction_t;
+
+/**
+ * \brief                               Bytecode function struct
+ * \note                                A frame holds the parameters first, then the other local variables in order of
+ *                                      declaration, then the temporaries of the function
+ */
+typedef struct bytecode_function {
+    const entry_t *entry;                   /*!< Pointer to entry of function (`NULL` for the global definitions) */
+    const node_t *func_tail;                /*!< Pointer to function body */
+    unsigned first_instruction;             /*!< Index of first instruction of function */
+    unsigned num_of_registers;              /*!< Number of registers of a frame */
+    unsigned num_of_parameter_values;       /*!< Number of registers the arguments are copied to */
+    unsigned num_of_return_values;          /*!< Number of returned values */
+} bytecode_function_t;
+
+/**
+ * \brief                               Index check struct
+ * \note                                This structure defines the bound and the stride of an array dimension indexed
+ *                                      by a value only known at runtime
+ */
+typedef struct index_check {
+    const entry_t *entry;                   /*!< Pointer to entry of indexed array */
+    unsigned dimension;                     /*!< Indexed dimension */
+    unsigned size;                          /*!< Size of dimension */
+    unsigned stride;                        /*!< Number of values per index of dimension */
+} index_check_t;
+
+/**
+ * \brief                               Bytecode program struct
+ * \note                                Function `0` runs the global definitions, the function main (if defined) is run
+ *                                      after it
+ */
+typedef struct bytecode_program {
+    instruction_t *instructions;            /*!< Array of instructions */
+    unsigned num_of_instructions;           /*!< Number of instructions */
+    unsigned instructions_capacity;         /*!< Number of instructions the array of instructions can hold */
+    long long *constants;                   /*!< Array of constants */
+    unsigned num_of_constants;              /*!< Number of constants */
+    unsigned constants_capacity;            /*!< Number of constants the array of constants can hold */
+    bytecode_function_t *functions;         /*!< Array of compiled functions */
+    unsigned num_of_functions;              /*!< Number of compiled functions */
+    unsigned functions_capacity;            /*!< Number of functions the array of functions can hold */
+    index_check_t *index_checks;            /*!< Array of index checks */
+    unsigned num_of_index_checks;           /*!< Number of index checks */
+    unsigned index_checks_capacity;         /*!< Number of index checks the array of index checks can hold */
+    unsigned num_of_globals;                /*!< Number of values of global variables */
+    bool has_main;                          /*!< Whether a function main has been compiled */
+    unsigned main_function;                 /*!< Index of function main */
+} bytecode_program_t;
+
+/**
+ * \brief                               Bytecode result struct
+ * \note                                This structure defines the outcome of running a bytecode program
+ */
+typedef struct bytecode_result {
+    unsigned long long num_of_steps;        /*!< Number of executed instructions */
+    double seconds;                         /*!< Wall time of the run in seconds */
+    bool has_return_value;                  /*!< Whether a non-void scalar main function has been run */
+    type_t return_type;                     /*!< Return type of main function */
+    long long return_value;                 /*!< Value returned by main function */
+} bytecode_result_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Compile the classical part of a program to register-based bytecode
+ * \note                                The global definitions, the function main and every function called from them
+ *                                      are compiled; quantum variables, measurements, changes of phase and
+ *                                      superpositions are rejected. Values are held as in the simulator, so running the
+ *                                      bytecode yields the results of simulate_program()
+ * \param[out]                          program: Pointer to bytecode program
+ * \param[in]                           root: Pointer to root node of the program
+ * \param[in]                           symbol_table: Pointer to symbol table of the program
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the program could be compiled
+ */
+bool compile_bytecode(bytecode_program_t *program, const node_t *root, const symbol_table_t *symbol_table,
+                      char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Run a bytecode program
+ * \note                                The interpreter dispatches by computed gotos (one indirect jump per instruction)
+ *                                      where the compiler supports them and by a switch otherwise
+ * \param[in]                           program: Pointer to bytecode program
+ * \param[out]                          result: Pointer to bytecode result
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the program ran without errors
+ */
+bool run_bytecode(const bytecode_program_t *program, bytecode_result_t *result, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Print the instructions of a bytecode program
+ * \param[in]                           output_file: Pointer to output file
+ * \param[in]                           program: Pointer to bytecode program
+ */
+void fprint_bytecode(FILE *output_file, const bytecode_program_t *program);
+
+/**
+ * \brief                               Free a bytecode program
+ * \param[in,out]                       program: Pointer to bytecode program
+ */
+void free_bytecode(bytecode_program_t *program);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* BYTECODE_H */
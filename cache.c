@@ -0,0 +1,196 @@
+/**
+ * \file                                cache.c
+ * \brief                               Parse result cache source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cache.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Compose name of a cache entry
+ * \param[out]                          path: Name of cache entry
+ * \param[in]                           cache_dir: Name of cache directory
+ * \param[in]                           key: Cache key
+ * \param[in]                           extension: Extension of cache entry (`.cqa` or `.cqd`)
+ * \return                              Whether the name fits into `PATH_MAX` characters
+ */
+static bool get_entry_path(char path[PATH_MAX], const char *cache_dir, const char key[CACHE_KEY_LENGTH],
+                           const char *extension) {
+    int length = snprintf(path, PATH_MAX, "%s/%s%s", cache_dir, key, extension);
+    return length >= 0 && length < PATH_MAX;
+}
+
+/**
+ * \brief                               Read diagnostics of a cached failed parse
+ * \note                                A diagnostics entry holds their number followed by one line per diagnostic with
+ *                                      line, column and message
+ * \param[in]                           input_file: Pointer to diagnostics entry
+ * \param[in,out]                       context: Pointer to parse context
+ * \return                              Whether the entry was well-formed
+ */
+static bool read_diagnostics(FILE *input_file, parse_context_t *context) {
+    unsigned num_of_diagnostics;
+    if (fscanf(input_file, "%u\n", &num_of_diagnostics) != 1 || num_of_diagnostics == 0
+        || num_of_diagnostics > MAX_NUM_OF_DIAGNOSTICS) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < num_of_diagnostics; ++i) {
+        unsigned line;
+        unsigned column;
+        char msg[ERROR_MSG_LENGTH];
+        if (fscanf(input_file, "%u %u ", &line, &column) != 2 || fgets(msg, ERROR_MSG_LENGTH, input_file) == NULL) {
+            return false;
+        }
+        msg[strcspn(msg, "\n")] = '\0';
+        add_diagnostic(context, line, column, msg);
+    }
+    return true;
+}
+
+/* See header for documentation */
+bool open_cache(const char *cache_dir, char error_msg[ERROR_MSG_LENGTH]) {
+    struct stat dir_stat;
+    if (mkdir(cache_dir, 0777) == -1 && (errno != EEXIST || stat(cache_dir, &dir_stat) == -1
+                                         || !S_ISDIR(dir_stat.st_mode))) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Could not create cache directory %s", cache_dir);
+        return false;
+    }
+    return true;
+}
+
+/* See header for documentation */
+void get_cache_key(char key[CACHE_KEY_LENGTH], const char *source, size_t size) {
+    uint64_t hash_value = 0xcbf29ce484222325u;
+    const char version[] = PARSER_VERSION;
+    for (size_t i = 0; i < sizeof (version); ++i) {
+        hash_value = (hash_value ^ (unsigned char) version[i]) * 0x100000001b3u;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        hash_value = (hash_value ^ (unsigned char) source[i]) * 0x100000001b3u;
+    }
+    snprintf(key, CACHE_KEY_LENGTH, "%016llx-%016llx", (unsigned long long) hash_value, (unsigned long long) size);
+}
+
+/* See header for documentation */
+bool load_from_cache(const char *cache_dir, const char key[CACHE_KEY_LENGTH], ast_image_t *image,
+                     parse_context_t *context, bool *success) {
+    char path[PATH_MAX];
+    char error_msg[ERROR_MSG_LENGTH];
+    if (get_entry_path(path, cache_dir, key, ".cqa") && load_ast_image(image, path, error_msg)) {
+        *success = true;
+        return true;
+    }
+
+    FILE *input_file = get_entry_path(path, cache_dir, key, ".cqd") ? fopen(path, "r") : NULL;
+    if (input_file == NULL) {
+        return false;
+    }
+    bool is_hit = read_diagnostics(input_file, context);
+    fclose(input_file);
+    if (!is_hit) {
+        context->num_of_diagnostics = 0;
+    }
+    *success = false;
+    return is_hit;
+}
+
+/* See header for documentation */
+bool store_in_cache(const char *cache_dir, const char key[CACHE_KEY_LENGTH], const parse_context_t *context,
+                    bool success, char error_msg[ERROR_MSG_LENGTH]) {
+    char path[PATH_MAX];
+    char temp_path[PATH_MAX];
+    if (!get_entry_path(path, cache_dir, key, success ? ".cqa" : ".cqd")
+        || !get_entry_path(temp_path, cache_dir, key, ".XXXXXX")) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Name of cache entry in %s is too long", cache_dir);
+        return false;
+    }
+
+    int fd = mkstemp(temp_path);
+    if (fd == -1) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Could not create cache entry in %s", cache_dir);
+        return false;
+    }
+
+    bool stored;
+    if (success) {
+        close(fd);
+        stored = write_ast_image(temp_path, context->root, &(context->symbol_table), error_msg);
+    } else {
+        FILE *output_file = fdopen(fd, "w");
+        if (output_file == NULL) {
+            close(fd);
+            stored = false;
+        } else {
+            fprintf(output_file, "%u\n", context->num_of_diagnostics);
+            for (unsigned i = 0; i < context->num_of_diagnostics; ++i) {
+                fprintf(output_file, "%u %u %s\n", context->diagnostics[i].line, context->diagnostics[i].column,
+                        context->diagnostics[i].msg);
+            }
+            stored = fclose(output_file) == 0;
+        }
+        if (!stored) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Writing cache entry %s in %s failed", key, cache_dir);
+        }
+    }
+
+    if (stored && rename(temp_path, path) == -1) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Renaming cache entry %s in %s failed", key, cache_dir);
+        stored = false;
+    }
+    if (!stored) {
+        unlink(temp_path);
+    }
+    return stored;
+}
@@ -0,0 +1,143 @@
+/**
+ * \file                                cache.h
+ * \brief                               Parse result cache include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "ast_image.h"
+#include "pars_utils.h"
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define CACHE_KEY_LENGTH 34
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Create cache directory unless it exists
+ * \param[in]                           cache_dir: Name of cache directory
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the cache directory exists
+ */
+bool open_cache(const char *cache_dir, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Calculate cache key of a source
+ * \note                                The key consists of a 64-bit FNV-1a hash value of parser version and source,
+ *                                      followed by the length of the source, both in hexadecimal
+ * \param[out]                          key: Null-terminated cache key
+ * \param[in]                           source: Source code (need not be null-terminated)
+ * \param[in]                           size: Number of bytes of source code
+ */
+void get_cache_key(char key[CACHE_KEY_LENGTH], const char *source, size_t size);
+
+/**
+ * \brief                               Load result of parsing a source from the cache
+ * \note                                A successful parse is loaded as AST image, the diagnostics of a failed parse are
+ *                                      recorded in the parse context; an unreadable entry counts as missing
+ * \param[in]                           cache_dir: Name of cache directory
+ * \param[in]                           key: Cache key of the source
+ * \param[out]                          image: Address of image to be set up (only if the cached parse was successful)
+ * \param[in,out]                       context: Pointer to freshly initialized parse context
+ * \param[out]                          success: Whether the cached parse was successful
+ * \return                              Whether the cache held the result (cache hit)
+ */
+bool load_from_cache(const char *cache_dir, const char key[CACHE_KEY_LENGTH], ast_image_t *image,
+                     parse_context_t *context, bool *success);
+
+/**
+ * \brief                               Store result of parsing a source in the cache
+ * \note                                The entry is written to a temporary file first and then renamed, so concurrent
+ *                                      readers and writers never see a partial entry
+ * \param[in]                           cache_dir: Name of cache directory
+ * \param[in]                           key: Cache key of the source
+ * \param[in]                           context: Pointer to parse context holding the result
+ * \param[in]                           success: Whether parsing was successful
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether storing the result was successful
+ */
+bool store_in_cache(const char *cache_dir, const char key[CACHE_KEY_LENGTH], const parse_context_t *context,
+                    bool success, char error_msg[ERROR_MSG_LENGTH]);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CACHE_H */
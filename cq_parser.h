@@ -0,0 +1,148 @@
+/**
+ * \file                                cq_parser.h
+ * \brief                               Parser include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef CQ_PARSER_H
+#define CQ_PARSER_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "ast_image.h"
+#include "pars_utils.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Parse input file into parse context
+ * \note                                The parse context must be freshly initialized; on success its root holds the AST,
+ *                                      on failure its diagnostics list every error found, in the order they were
+ *                                      reported and up to `MAX_NUM_OF_DIAGNOSTICS`
+ * \param[in,out]                       context: Pointer to parse context owning everything allocated while parsing
+ * \param[in]                           input_file: Pointer to input file
+ * \return                              Whether parsing was successful
+ */
+bool parse_file(parse_context_t *context, FILE *input_file);
+
+/**
+ * \brief                               Parse buffer in place into parse context
+ * \note                                The buffer is handed to the scanner without being copied; it must be writable, end
+ *                                      with `MAPPED_FILE_PADDING` null bytes and stay untouched until parsing returns;
+ *                                      positions are counted from the first line and column set in the parse context
+ * \param[in,out]                       context: Pointer to parse context owning everything allocated while parsing
+ * \param[in,out]                       buffer: Pointer to source code followed by the null bytes
+ * \param[in]                           size: Number of bytes of buffer including the null bytes
+ * \return                              Whether parsing was successful
+ */
+bool parse_buffer(parse_context_t *context, char *buffer, size_t size);
+
+/**
+ * \brief                               Map file into memory and parse it in place into parse context
+ * \note                                Avoids copying the file content through stdio and scanner buffers; the parse
+ *                                      context keeps no reference to the mapping, which is released before returning
+ * \param[in,out]                       context: Pointer to parse context owning everything allocated while parsing
+ * \param[in]                           file_name: Name of regular file to be parsed
+ * \return                              Whether parsing was successful
+ */
+bool parse_mapped_file(parse_context_t *context, const char *file_name);
+
+/**
+ * \brief                               Map file into memory and scan it into tokens without parsing them
+ * \note                                Measures the scanner on its own (see `--lex-only`); identifiers are interned into
+ *                                      the parse context as while parsing
+ * \param[in,out]                       context: Pointer to parse context owning everything allocated while scanning
+ * \param[in]                           file_name: Name of regular file to be scanned
+ * \param[out]                          num_of_tokens: Number of tokens scanned
+ * \param[out]                          num_of_bytes: Number of bytes scanned
+ * \return                              Whether scanning was successful
+ */
+bool lex_mapped_file(parse_context_t *context, const char *file_name, size_t *num_of_tokens, size_t *num_of_bytes);
+
+/**
+ * \brief                               Parse file into parse context unless its result is cached
+ * \note                                On a cache hit, a successful parse is returned as loaded image (the parse context
+ *                                      stays empty) and a failed parse by its diagnostics in the parse context; on a
+ *                                      cache miss, the file is parsed as by parse_mapped_file() and its result stored
+ * \param[in,out]                       context: Pointer to freshly initialized parse context
+ * \param[in]                           file_name: Name of regular file to be parsed
+ * \param[in]                           cache_dir: Name of cache directory (see open_cache())
+ * \param[out]                          image: Address of image to be set up (only on a cache hit of a successful parse)
+ * \param[out]                          is_cached: Whether the result was taken from the cache
+ * \return                              Whether parsing was successful
+ */
+bool parse_cached_file(parse_context_t *context, const char *file_name, const char *cache_dir, ast_image_t *image,
+                       bool *is_cached);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CQ_PARSER_H */
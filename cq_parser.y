@@ -1,41 +1,66 @@
+%code requires {
+#include "pars_utils.h"
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif /* YY_TYPEDEF_YY_SCANNER_T */
+}
+
 %{
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "ast.h"
+#include "ast_image.h"
+#include "batch.h"
+#include "bytecode.h"
+#include "cache.h"
+#include "cq_parser.h"
+#include "intern.h"
+#include "mapped_file.h"
 #include "pars_utils.h"
+#include "pool_stack.h"
 #include "rules.h"
+#include "server.h"
+#include "shape.h"
+#include "simulator.h"
+#include "state_vector.h"
 #include "symbol_table.h"
 
-extern int yylex(void);
-extern int yylineno;
-extern FILE *yyin;
-extern FILE *yyout;
-
-int yyerror(const char *message);
-static node_t *root;
-static char error_msg[ERROR_MSG_LENGTH];
-static unsigned stmt_list_counter;
-static stmt_list_t stmt_list_array[MAX_NUM_OF_STMT_LISTS];
-static unsigned type_info_counter;
-static type_info_t type_info_array[MAX_NUM_OF_TYPE_INFOS];
-static func_info_t func_info;
-static init_info_t init_info;
-static unsigned access_info_counter;
-static access_info_t access_info_array[MAX_NUM_OF_ARRAY_INFOS];
-static unsigned arg_list_counter;
-static arg_list_t arg_list_array[MAX_NUM_OF_ARG_LISTS];
-static unsigned else_if_list_counter;
-static else_if_list_t else_if_list_array[MAX_NUM_OF_ELSE_IF_LISTS];
-static unsigned case_list_counter;
-static case_list_t case_list_array[MAX_NUM_OF_CASE_LISTS];
-
+/* Deeply nested input needs a far larger parser stack than bison's default of 10000 entries */
+#define YYMAXDEPTH MAX_PARSE_STACK_DEPTH
 %}
 
+%code {
+extern int yylex(YYSTYPE *yylval_param, YYLTYPE *yylloc_param, yyscan_t scanner);
+extern int yylex_init_extra(parse_context_t *context, yyscan_t *scanner);
+extern int yylex_destroy(yyscan_t scanner);
+extern void yyset_in(FILE *input_file, yyscan_t scanner);
+extern int yyget_lineno(yyscan_t scanner);
+extern void yyset_lineno(int line_number, yyscan_t scanner);
+
+typedef struct yy_buffer_state *YY_BUFFER_STATE;
+extern YY_BUFFER_STATE yy_scan_buffer(char *base, size_t size, yyscan_t scanner);
+extern void yy_delete_buffer(YY_BUFFER_STATE buffer_state, yyscan_t scanner);
+
+void yyerror(YYLTYPE *location, yyscan_t scanner, parse_context_t *context, const char *message);
+
+/* Record the error message of the current action and recover at the next declaration or statement */
+#define PARSE_ERROR(location) \
+    do { \
+        if (!add_diagnostic(context, (location).first_line, (location).first_column, context->error_msg)) { \
+            YYABORT; \
+        } \
+        YYERROR; \
+    } while (0)
+}
+
 /* Union to define yylval's types */
 %union {
-    char *name;
+    const interned_str_t *name;
     value_t value;
     node_t *node;
     stmt_list_t *stmt_list;
@@ -52,6 +77,8 @@ static case_list_t case_list_array[MAX_NUM_OF_CASE_LISTS];
     comparison_op_t comparison_op;
     equality_op_t equality_op;
     assign_op_t assign_op;
+    bool func_scope;
+    bool loop_scope;
 }
 
 %token <name> ID
@@ -92,7 +119,7 @@ static case_list_t case_list_array[MAX_NUM_OF_CASE_LISTS];
 %type <node> lor_expr lxor_expr land_expr comparison_expr equality_expr or_expr xor_expr and_expr
 %type <node> ref_expr func_call assign_expr
 %type <node> assign_stmt phase_stmt measure_stmt func_call_stmt
-%type <node> if_stmt switch_stmt do_stmt while_stmt for_stmt for_first
+%type <node> if_stmt switch_stmt do_stmt do_body while_stmt for_stmt for_first
 %type <node> break_stmt continue_stmt return_stmt
 %type <node> optional_else case_stmt
 %type <stmt_list> decl_l stmt_l res_stmt_l
@@ -105,7 +132,25 @@ static case_list_t case_list_array[MAX_NUM_OF_CASE_LISTS];
 %type <else_if_list> else_if
 %type <case_list> case_stmt_l
 
+/* Give back pool slots and scopes of symbols discarded by error recovery */
+%destructor { pop_from_pool_stack(&(context->stmt_list_stack)); } <stmt_list>
+%destructor { pop_from_pool_stack(&(context->type_info_stack)); } <type_info>
+%destructor { pop_from_pool_stack(&(context->access_info_stack)); } <access_info>
+%destructor { pop_from_pool_stack(&(context->arg_list_stack)); } <arg_list>
+%destructor { pop_from_pool_stack(&(context->else_if_list_stack)); } <else_if_list>
+%destructor { pop_from_pool_stack(&(context->case_list_stack)); } <case_list>
+%destructor { if ($$) { hide_scope(&(context->symbol_table)); } } <func_scope>
+%destructor { if ($$) { decr_nested_loop_counter(context); hide_scope(&(context->symbol_table)); } } <loop_scope>
+
+%define api.pure full
 %define parse.error verbose
+%locations
+%param {yyscan_t scanner}
+%parse-param {parse_context_t *context}
+%initial-action {
+    @$.first_line = @$.last_line = (int) context->first_line;
+    @$.first_column = @$.last_column = (int) context->first_column;
+}
 %start program
 
 
@@ -113,29 +158,34 @@ static case_list_t case_list_array[MAX_NUM_OF_CASE_LISTS];
 
 program:
 	decl_l {
-	    $$ = new_stmt_list_node($1->is_quantizable, $1->is_unitary, $1->stmt_nodes, $1->num_of_stmts, error_msg);
+	    pop_from_pool_stack(&(context->stmt_list_stack));
+	    $$ = new_stmt_list_node(&(context->ast_arena), $1->is_quantizable, $1->is_unitary, $1->stmt_nodes,
+	                            $1->num_of_stmts, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
 
-	    root = $$;
-        --stmt_list_counter;
+	    context->root = $$;
 	}
 	;
 
 decl_l:
     decl {
-        $$ = stmt_list_array + stmt_list_counter;
-        if (!setup_stmt_list($$, $1, error_msg)) {
-            yyerror(error_msg);
+        $$ = push_to_pool_stack(&(context->stmt_list_stack), context->error_msg);
+        if ($$ == NULL) {
+            PARSE_ERROR(@$);
         }
 
-        ++stmt_list_counter;
+        if (!setup_stmt_list($$, $1, context->nested_loop_counter, context->error_msg)) {
+            pop_from_pool_stack(&(context->stmt_list_stack));
+            PARSE_ERROR(@$);
+        }
     }
 	| decl_l decl {
 	    $$ = $1;
-	    if (!append_to_stmt_list($$, $2, error_msg)) {
-	        yyerror(error_msg);
+	    if (!append_to_stmt_list($$, $2, context->nested_loop_counter, context->error_msg)) {
+	        pop_from_pool_stack(&(context->stmt_list_stack));
+	        PARSE_ERROR(@2);
 	    }
 	}
 	;
@@ -150,149 +200,174 @@ decl:
 	| func_def {
 	    $$ = $1;
 	}
+	| error decl_sync {
+	    if (context->num_of_diagnostics == MAX_NUM_OF_DIAGNOSTICS) {
+	        YYABORT;
+	    }
+
+	    context->has_dropped_stmts = true;
+	    $$ = NULL;
+	}
 	;
 
+/* Tokens that end a declaration dropped by error recovery, if they follow right away */
+decl_sync:
+    SEMICOLON
+    | RBRACE
+    | /* empty */
+    ;
+
 var_decl:
     QUANTUM type_specifier declarator SEMICOLON {
-        if (!set_type_info($3, QUANTUM_T, $2->type, $2->sizes, $2->depth, error_msg)) {
-            yyerror(error_msg);
+        pop_from_pool_stack(&(context->type_info_stack));
+        if (!set_type_info($3, QUANTUM_T, $2->type, $2->shape, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
 
-        $$ = new_var_decl_node($3, error_msg);
+        $$ = new_var_decl_node(&(context->ast_arena), $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-        --type_info_counter;
     }
     | type_specifier declarator SEMICOLON {
-        if (!set_type_info($2, NONE_T, $1->type, $1->sizes, $1->depth, error_msg)) {
-            yyerror(error_msg);
+        pop_from_pool_stack(&(context->type_info_stack));
+        if (!set_type_info($2, NONE_T, $1->type, $1->shape, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
 
-        $$ = new_var_decl_node($2, error_msg);
+        $$ = new_var_decl_node(&(context->ast_arena), $2, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-
-        --type_info_counter;
     }
     ;
 
 var_def:
     QUANTUM type_specifier declarator ASSIGN init SEMICOLON {
-	    if (!set_type_info($3, QUANTUM_T, $2->type, $2->sizes, $2->depth, error_msg)) {
-	        yyerror(error_msg);
+	    pop_from_pool_stack(&(context->type_info_stack));
+	    if (!set_type_info($3, QUANTUM_T, $2->type, $2->shape, context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    $$ = new_var_def_node($3, $5->is_init_list, $5->node, $5->qualified_types, $5->values, $5->length, error_msg);
+	    $$ = new_var_def_node(&(context->ast_arena), $3, $5->is_init_list, $5->node, $5->qualified_types, $5->values,
+	                          $5->length, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
-
-	    --type_info_counter;
 	}
 	| CONST type_specifier declarator ASSIGN init SEMICOLON {
-	    if (!set_type_info($3, CONST_T, $2->type, $2->sizes, $2->depth, error_msg)) {
-	        yyerror(error_msg);
+	    pop_from_pool_stack(&(context->type_info_stack));
+	    if (!set_type_info($3, CONST_T, $2->type, $2->shape, context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    $$ = new_var_def_node($3, $5->is_init_list, $5->node, $5->qualified_types, $5->values, $5->length, error_msg);
+	    $$ = new_var_def_node(&(context->ast_arena), $3, $5->is_init_list, $5->node, $5->qualified_types, $5->values,
+	                          $5->length, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-
-        --type_info_counter;
     }
 	| type_specifier declarator ASSIGN init SEMICOLON {
-	    if (!set_type_info($2, NONE_T, $1->type, $1->sizes, $1->depth, error_msg)) {
-	        yyerror(error_msg);
+	    pop_from_pool_stack(&(context->type_info_stack));
+	    if (!set_type_info($2, NONE_T, $1->type, $1->shape, context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
-        $$ = new_var_def_node($2, $4->is_init_list, $4->node, $4->qualified_types, $4->values, $4->length, error_msg);
+        $$ = new_var_def_node(&(context->ast_arena), $2, $4->is_init_list, $4->node, $4->qualified_types, $4->values,
+                              $4->length, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-
-        --type_info_counter;
     }
 	;
 
 func_def:
-	QUANTUM type_specifier declarator {
-	        incr_scope();
+	QUANTUM type_specifier declarator <func_scope>{
+	        incr_scope(&(context->symbol_table));
+	        context->has_dropped_stmts = false;
+	        $$ = true;
 	    } func_head func_tail {
-	    hide_scope();
-	    if (!set_type_info($3, QUANTUM_T, $2->type, $2->sizes, $2->depth, error_msg)) {
-	        yyerror(error_msg);
+	    hide_scope(&(context->symbol_table));
+	    $4 = false;
+	    pop_from_pool_stack(&(context->type_info_stack));
+	    if (!set_type_info($3, QUANTUM_T, $2->type, $2->shape, context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
 	    if (!set_func_info($3, false, $5->is_unitary && is_unitary($6), $5->pars_type_info, $5->num_of_pars,
-	                       error_msg)) {
-	        yyerror(error_msg);
+	                       context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    $$ = new_func_def_node($3, $6, error_msg);
+	    $$ = new_func_def_node(&(context->ast_arena), $3, $6, !(context->has_dropped_stmts), context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
 	}
-	| type_specifier declarator {
-	        incr_scope();
+	| type_specifier declarator <func_scope>{
+	        incr_scope(&(context->symbol_table));
+	        context->has_dropped_stmts = false;
+	        $$ = true;
 	    } func_head func_tail {
-	    hide_scope();
-	    if (!set_type_info($2, NONE_T, $1->type, $1->sizes, $1->depth, error_msg)) {
-	        yyerror(error_msg);
+	    hide_scope(&(context->symbol_table));
+	    $3 = false;
+	    pop_from_pool_stack(&(context->type_info_stack));
+	    if (!set_type_info($2, NONE_T, $1->type, $1->shape, context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
 	    if (!set_func_info($2, false, $4->is_quantizable && is_quantizable($5), $4->pars_type_info, $4->num_of_pars,
-	                       error_msg)) {
-	        yyerror(error_msg);
+	                       context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    $$ = new_func_def_node($2, $5, error_msg);
+	    $$ = new_func_def_node(&(context->ast_arena), $2, $5, !(context->has_dropped_stmts), context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
-	| VOID declarator {
-	        incr_scope();
+	| VOID declarator <func_scope>{
+	        incr_scope(&(context->symbol_table));
+	        context->has_dropped_stmts = false;
+	        $$ = true;
 	    } func_head func_tail {
-	    hide_scope();
-	    if (!set_type_info($2, NONE_T, VOID_T, NULL, 0, error_msg)) {
-	        yyerror(error_msg);
+	    hide_scope(&(context->symbol_table));
+	    $3 = false;
+	    if (!set_type_info($2, NONE_T, VOID_T, NULL, context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 	    if (!set_func_info($2, $4->is_quantizable && is_quantizable($5), $4->is_unitary && is_unitary($5),
-	                       $4->pars_type_info, $4->num_of_pars, error_msg)) {
-	        yyerror(error_msg);
+	                       $4->pars_type_info, $4->num_of_pars, context->error_msg)) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    $$ = new_func_def_node($2, $5, error_msg);
+	    $$ = new_func_def_node(&(context->ast_arena), $2, $5, !(context->has_dropped_stmts), context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
 
 init:
     lor_expr {
-        $$ = &init_info;
-        if (!setup_init_info($$, false, $1, error_msg)) {
-            yyerror(error_msg);
+        $$ = &(context->init_info);
+        if (!setup_init_info($$, false, $1, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
     }
     | LBRACKET ID RBRACKET {
-        entry_t *entry = insert($2, strlen($2), yylineno, false, error_msg);
+        entry_t *entry = insert(&(context->symbol_table), $2, yyget_lineno(scanner), false, context->error_msg);
         if (entry == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-        node_t *func_sp_node = new_func_sp_node(entry, error_msg);
+        node_t *func_sp_node = new_func_sp_node(&(context->ast_arena), entry, context->error_msg);
         if (func_sp_node == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 
-        $$ = &init_info;
-        if (!setup_init_info($$, false, func_sp_node, error_msg)) {
-            yyerror(error_msg);
+        $$ = &(context->init_info);
+        if (!setup_init_info($$, false, func_sp_node, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
     }
     | LBRACE init_elem_l RBRACE {
@@ -302,44 +377,44 @@ init:
 
 init_elem_l:
     lor_expr {
-        $$ = &init_info;
-        if (!setup_init_info($$, true, $1, error_msg)) {
-            yyerror(error_msg);
+        $$ = &(context->init_info);
+        if (!setup_init_info($$, true, $1, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
     }
     | LBRACKET ID RBRACKET {
-        entry_t *entry = insert($2, strlen($2), yylineno, false, error_msg);
+        entry_t *entry = insert(&(context->symbol_table), $2, yyget_lineno(scanner), false, context->error_msg);
         if (entry == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-        node_t *func_sp_node = new_func_sp_node(entry, error_msg);
+        node_t *func_sp_node = new_func_sp_node(&(context->ast_arena), entry, context->error_msg);
         if (func_sp_node == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 
-        $$ = &init_info;
-        if (!setup_init_info($$, true, func_sp_node, error_msg)) {
-            yyerror(error_msg);
+        $$ = &(context->init_info);
+        if (!setup_init_info($$, true, func_sp_node, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
     }
     | init_elem_l COMMA LBRACKET ID RBRACKET {
-        entry_t *entry = insert($4, strlen($4), yylineno, false, error_msg);
-        node_t *func_sp_node = new_func_sp_node(entry, error_msg);
+        entry_t *entry = insert(&(context->symbol_table), $4, yyget_lineno(scanner), false, context->error_msg);
         if (entry == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@4);
         }
+        node_t *func_sp_node = new_func_sp_node(&(context->ast_arena), entry, context->error_msg);
         if (func_sp_node == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@4);
         }
         $$ = $1;
-        if (!append_to_init_info($$, func_sp_node, error_msg)) {
-            yyerror(error_msg);
+        if (!append_to_init_info($$, func_sp_node, context->error_msg)) {
+            PARSE_ERROR(@4);
         }
     }
     | init_elem_l COMMA lor_expr {
         $$ = $1;
-        if (!append_to_init_info($$, $3, error_msg)) {
-            yyerror(error_msg);
+        if (!append_to_init_info($$, $3, context->error_msg)) {
+            PARSE_ERROR(@3);
         }
     }
     ;
@@ -349,44 +424,44 @@ func_head:
         $$ = $2;
     }
     | LPAREN RPAREN {
-        $$ = &func_info;
-        if (!setup_empty_func_info($$, error_msg)) {
-            yyerror(error_msg);
+        $$ = &(context->func_info);
+        if (!setup_empty_func_info($$, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
     }
     ;
 
 par_l:
 	par {
-	    $$ = &func_info;
-        if (!setup_func_info($$, *$1, error_msg)) {
-            yyerror(error_msg);
+	    pop_from_pool_stack(&(context->type_info_stack));
+	    $$ = &(context->func_info);
+        if (!setup_func_info($$, *$1, context->error_msg)) {
+            PARSE_ERROR(@$);
         }
-
-        --type_info_counter;
 	}
 	| par_l COMMA par {
+	    pop_from_pool_stack(&(context->type_info_stack));
 	    $$ = $1;
-	    if (!append_to_func_info($$, *$3, error_msg)) {
-	        yyerror(error_msg);
+	    if (!append_to_func_info($$, *$3, context->error_msg)) {
+	        PARSE_ERROR(@3);
 	    }
-
-	    --type_info_counter;
 	}
 	;
 
 par:
 	QUANTUM type_specifier declarator {
-	    if (!set_type_info($3, QUANTUM_T, $2->type, $2->sizes, $2->depth, error_msg)) {
-	        yyerror(error_msg);
+	    if (!set_type_info($3, QUANTUM_T, $2->type, $2->shape, context->error_msg)) {
+	        pop_from_pool_stack(&(context->type_info_stack));
+	        PARSE_ERROR(@$);
 	    }
 
 	    $$ = $2;
 	    $$->qualifier = QUANTUM_T;
 	}
 	| type_specifier declarator {
-        if (!set_type_info($2, NONE_T, $1->type, $1->sizes, $1->depth, error_msg)) {
-            yyerror(error_msg);
+        if (!set_type_info($2, NONE_T, $1->type, $1->shape, context->error_msg)) {
+            pop_from_pool_stack(&(context->type_info_stack));
+            PARSE_ERROR(@$);
         }
 
 	    $$ = $1;
@@ -402,70 +477,84 @@ func_tail:
 
 type_specifier:
 	BOOL {
-	    $$ = type_info_array + type_info_counter;
-	    if (!setup_type_info($$, BOOL_T, error_msg)) {
-	        yyerror(error_msg);
+	    $$ = push_to_pool_stack(&(context->type_info_stack), context->error_msg);
+	    if ($$ == NULL) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    ++type_info_counter;
+	    if (!setup_type_info($$, BOOL_T, context->error_msg)) {
+	        pop_from_pool_stack(&(context->type_info_stack));
+	        PARSE_ERROR(@$);
+	    }
 	}
 	| INT {
-	    $$ = type_info_array + type_info_counter;
-	    if (!setup_type_info($$, INT_T, error_msg)) {
-	        yyerror(error_msg);
+	    $$ = push_to_pool_stack(&(context->type_info_stack), context->error_msg);
+	    if ($$ == NULL) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    ++type_info_counter;
+	    if (!setup_type_info($$, INT_T, context->error_msg)) {
+	        pop_from_pool_stack(&(context->type_info_stack));
+	        PARSE_ERROR(@$);
+	    }
 	}
 	| UNSIGNED {
-	    $$ = type_info_array + type_info_counter;
-	    if (!setup_type_info($$, UNSIGNED_T, error_msg)) {
-	        yyerror(error_msg);
+	    $$ = push_to_pool_stack(&(context->type_info_stack), context->error_msg);
+	    if ($$ == NULL) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    ++type_info_counter;
+	    if (!setup_type_info($$, UNSIGNED_T, context->error_msg)) {
+	        pop_from_pool_stack(&(context->type_info_stack));
+	        PARSE_ERROR(@$);
+	    }
 	}
 	| type_specifier LBRACKET or_expr RBRACKET {
 	    $$ = $1;
-	    if (!append_to_type_info($$, $3, error_msg)) {
-	        yyerror(error_msg);
+	    if (!append_to_type_info($$, $3, &(context->shape_table), context->error_msg)) {
+	        pop_from_pool_stack(&(context->type_info_stack));
+	        PARSE_ERROR(@3);
 	    }
 	}
 	;
 
 declarator:
 	ID {
-	    $$ = insert($1, strlen($1), yylineno, true, error_msg);
+	    $$ = insert(&(context->symbol_table), $1, yyget_lineno(scanner), true, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
 	}
 	;
 
 sub_program:
     stmt_l {
-	    $$ = new_stmt_list_node($1->is_quantizable, $1->is_unitary, $1->stmt_nodes, $1->num_of_stmts, error_msg);
+	    pop_from_pool_stack(&(context->stmt_list_stack));
+	    $$ = new_stmt_list_node(&(context->ast_arena), $1->is_quantizable, $1->is_unitary, $1->stmt_nodes,
+	                            $1->num_of_stmts, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
-
-	    --stmt_list_counter;
     }
     ;
 
 stmt_l:
 	stmt {
-	    $$ = stmt_list_array + stmt_list_counter;
-	    if (!setup_stmt_list($$, $1, error_msg)) {
-	        yyerror(error_msg);
+	    $$ = push_to_pool_stack(&(context->stmt_list_stack), context->error_msg);
+	    if ($$ == NULL) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    ++stmt_list_counter;
+	    if (!setup_stmt_list($$, $1, context->nested_loop_counter, context->error_msg)) {
+	        pop_from_pool_stack(&(context->stmt_list_stack));
+	        PARSE_ERROR(@$);
+	    }
 	}
 	| stmt_l stmt {
 	    $$ = $1;
-	    if (!append_to_stmt_list($$, $2, error_msg)) {
-	        yyerror(error_msg);
+	    if (!append_to_stmt_list($$, $2, context->nested_loop_counter, context->error_msg)) {
+	        pop_from_pool_stack(&(context->stmt_list_stack));
+	        PARSE_ERROR(@2);
 	    }
 	}
 	;
@@ -490,28 +579,32 @@ decl_stmt:
 
 res_sub_program:
     res_stmt_l {
-	    $$ = new_stmt_list_node($1->is_quantizable, $1->is_unitary, $1->stmt_nodes, $1->num_of_stmts, error_msg);
+	    pop_from_pool_stack(&(context->stmt_list_stack));
+	    $$ = new_stmt_list_node(&(context->ast_arena), $1->is_quantizable, $1->is_unitary, $1->stmt_nodes,
+	                            $1->num_of_stmts, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
-
-	    --stmt_list_counter;
     }
     ;
 
 res_stmt_l:
 	res_stmt {
-	    $$ = stmt_list_array + stmt_list_counter;
-	    if (!setup_stmt_list($$, $1, error_msg)) {
-	        yyerror(error_msg);
+	    $$ = push_to_pool_stack(&(context->stmt_list_stack), context->error_msg);
+	    if ($$ == NULL) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    ++stmt_list_counter;
+	    if (!setup_stmt_list($$, $1, context->nested_loop_counter, context->error_msg)) {
+	        pop_from_pool_stack(&(context->stmt_list_stack));
+	        PARSE_ERROR(@$);
+	    }
 	}
 	| res_stmt_l res_stmt {
 	    $$ = $1;
-	    if (!append_to_stmt_list($$, $2, error_msg)) {
-	        yyerror(error_msg);
+	    if (!append_to_stmt_list($$, $2, context->nested_loop_counter, context->error_msg)) {
+	        pop_from_pool_stack(&(context->stmt_list_stack));
+	        PARSE_ERROR(@2);
 	    }
 	}
 	;
@@ -553,28 +646,42 @@ res_stmt:
 	| return_stmt {
 	    $$ = $1;
 	}
+	| error res_stmt_sync {
+	    if (context->num_of_diagnostics == MAX_NUM_OF_DIAGNOSTICS) {
+	        YYABORT;
+	    }
+
+	    context->has_dropped_stmts = true;
+	    $$ = NULL;
+	}
 	;
 
+/* Token that ends a statement dropped by error recovery, if it follows right away */
+res_stmt_sync:
+    SEMICOLON
+    | /* empty */
+    ;
+
 phase_stmt:
     PHASE LPAREN ref_expr RPAREN ASSIGN_ADD lor_expr SEMICOLON {
-	    $$ = new_phase_node($3, true, $6, error_msg);
+	    $$ = new_phase_node(&(context->ast_arena), $3, true, $6, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     | PHASE LPAREN ref_expr RPAREN ASSIGN_SUB lor_expr SEMICOLON {
-	    $$ = new_phase_node($3, false, $6, error_msg);
+	    $$ = new_phase_node(&(context->ast_arena), $3, false, $6, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     ;
 
 measure_stmt:
     MEASURE LPAREN ref_expr RPAREN SEMICOLON {
-        $$ = new_measure_node($3, error_msg);
+        $$ = new_measure_node(&(context->ast_arena), $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     ;
@@ -584,13 +691,14 @@ func_call_stmt:
         $$ = $2;
         func_call_node_t *func_call_node_view = (func_call_node_t *) $$;
         if (!is_unitary($2)) {
-            snprintf(error_msg, sizeof (error_msg), "Trying to invert non-unitary function %s",
+            snprintf(context->error_msg, sizeof (context->error_msg), "Trying to invert non-unitary function %s",
                      func_call_node_view->entry->name);
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         } else if (!func_call_node_view->sp && func_call_node_view->entry->type != VOID_T) {
-            snprintf(error_msg, sizeof (error_msg), "Trying to invert function %s with non-void return",
+            snprintf(context->error_msg, sizeof (context->error_msg),
+                     "Trying to invert function %s with non-void return",
                      func_call_node_view->entry->name);
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
         func_call_node_view->inverse = true;
     }
@@ -601,101 +709,108 @@ func_call_stmt:
 
 func_call:
 	ID LPAREN arg_expr_l RPAREN {
-        entry_t *entry = insert($1, strlen($1), yylineno, false, error_msg);
+        pop_from_pool_stack(&(context->arg_list_stack));
+        entry_t *entry = insert(&(context->symbol_table), $1, yyget_lineno(scanner), false, context->error_msg);
         if (entry == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 
-        $$ = new_func_call_node(false, entry, $3->args, $3->num_of_args, error_msg);
+        $$ = new_func_call_node(&(context->ast_arena), false, entry, $3->args, $3->num_of_args, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-
-        --arg_list_counter;
 	}
 	| ID LPAREN RPAREN {
-        entry_t *entry = insert($1, strlen($1), yylineno, false, error_msg);
+        entry_t *entry = insert(&(context->symbol_table), $1, yyget_lineno(scanner), false, context->error_msg);
         if (entry == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 
-	    $$ = new_func_call_node(false, entry, NULL, 0, error_msg);
+	    $$ = new_func_call_node(&(context->ast_arena), false, entry, NULL, 0, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| LBRACKET ID RBRACKET LPAREN arg_expr_l RPAREN {
-        entry_t *entry = insert($2, strlen($2), yylineno, false, error_msg);
+        pop_from_pool_stack(&(context->arg_list_stack));
+        entry_t *entry = insert(&(context->symbol_table), $2, yyget_lineno(scanner), false, context->error_msg);
         if (entry == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 
-	    $$ = new_func_call_node(true, entry, $5->args, $5->num_of_args, error_msg);
+	    $$ = new_func_call_node(&(context->ast_arena), true, entry, $5->args, $5->num_of_args, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
-
-	    --arg_list_counter;
 	}
 	;
 
 arg_expr_l:
 	lor_expr {
-	    $$ = arg_list_array + arg_list_counter;
-	    if (!setup_arg_list($$, $1, error_msg)) {
-	        yyerror(error_msg);
+	    $$ = push_to_pool_stack(&(context->arg_list_stack), context->error_msg);
+	    if ($$ == NULL) {
+	        PARSE_ERROR(@$);
 	    }
 
-	    ++arg_list_counter;
+	    if (!setup_arg_list($$, $1, context->error_msg)) {
+	        pop_from_pool_stack(&(context->arg_list_stack));
+	        PARSE_ERROR(@$);
+	    }
 	}
 	| arg_expr_l COMMA lor_expr {
 	    $$ = $1;
-	    if (!append_to_arg_list($$, $3, error_msg)) {
-	        yyerror(error_msg);
+	    if (!append_to_arg_list($$, $3, context->error_msg)) {
+	        pop_from_pool_stack(&(context->arg_list_stack));
+	        PARSE_ERROR(@3);
 	    }
 	}
 	;
 
 if_stmt:
 	IF LPAREN lor_expr RPAREN LBRACE res_sub_program RBRACE optional_else {
-	    $$ = new_if_node($3, $6, NULL, 0, $8, error_msg);
+	    $$ = new_if_node(&(context->ast_arena), $3, $6, NULL, 0, $8, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
 	}
 	| IF LPAREN lor_expr RPAREN LBRACE res_sub_program RBRACE else_if optional_else {
-	    $$ = new_if_node($3, $6, $8->else_if_nodes, $8->num_of_else_ifs, $9, error_msg);
+	    pop_from_pool_stack(&(context->else_if_list_stack));
+	    $$ = new_if_node(&(context->ast_arena), $3, $6, $8->else_if_nodes, $8->num_of_else_ifs, $9,
+	                     context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
-
-	    --else_if_list_counter;
 	}
 	;
 
 else_if:
     ELSE IF LPAREN lor_expr RPAREN LBRACE res_sub_program RBRACE {
-        node_t *else_if_node = new_else_if_node($4, $7, error_msg);
+        node_t *else_if_node = new_else_if_node(&(context->ast_arena), $4, $7, context->error_msg);
         if (else_if_node == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 
-        $$ = else_if_list_array + else_if_list_counter;
-        if (!setup_else_if_list($$, else_if_node, error_msg)) {
-            yyerror(error_msg);
+        $$ = push_to_pool_stack(&(context->else_if_list_stack), context->error_msg);
+        if ($$ == NULL) {
+            PARSE_ERROR(@$);
         }
 
-        ++else_if_list_counter;
+        if (!setup_else_if_list($$, else_if_node, context->error_msg)) {
+            pop_from_pool_stack(&(context->else_if_list_stack));
+            PARSE_ERROR(@$);
+        }
     }
     | else_if ELSE IF LPAREN lor_expr RPAREN LBRACE res_sub_program RBRACE {
-        node_t *else_if_node = new_else_if_node($5, $8, error_msg);
+        node_t *else_if_node = new_else_if_node(&(context->ast_arena), $5, $8, context->error_msg);
         if (else_if_node == NULL) {
-            yyerror(error_msg);
+            pop_from_pool_stack(&(context->else_if_list_stack));
+            PARSE_ERROR(@2);
         }
 
         $$ = $1;
-        if (!append_to_else_if_list($$, else_if_node, error_msg)) {
-            yyerror(error_msg);
+        if (!append_to_else_if_list($$, else_if_node, context->error_msg)) {
+            pop_from_pool_stack(&(context->else_if_list_stack));
+            PARSE_ERROR(@2);
         }
     }
     ;
@@ -711,88 +826,102 @@ optional_else:
 
 switch_stmt:
 	SWITCH LPAREN lor_expr RPAREN LBRACE case_stmt_l RBRACE {
-	    $$ = new_switch_node($3, $6->case_nodes, $6->num_of_cases, error_msg);
+	    pop_from_pool_stack(&(context->case_list_stack));
+	    $$ = new_switch_node(&(context->ast_arena), $3, $6->case_nodes, $6->num_of_cases, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
-
-	    --case_list_counter;
 	}
 	;
 
 case_stmt_l:
     case_stmt {
-        $$ = case_list_array + case_list_counter;
-        if (!setup_case_list($$, $1, error_msg)) {
-            yyerror(error_msg);
+        $$ = push_to_pool_stack(&(context->case_list_stack), context->error_msg);
+        if ($$ == NULL) {
+            PARSE_ERROR(@$);
         }
 
-        ++case_list_counter;
+        if (!setup_case_list($$, $1, context->error_msg)) {
+            pop_from_pool_stack(&(context->case_list_stack));
+            PARSE_ERROR(@$);
+        }
     }
     | case_stmt_l case_stmt {
         $$ = $1;
-        if (!append_to_case_list($$, $2, error_msg)) {
-            yyerror(error_msg);
+        if (!append_to_case_list($$, $2, context->error_msg)) {
+            pop_from_pool_stack(&(context->case_list_stack));
+            PARSE_ERROR(@2);
         }
     }
     ;
 
 case_stmt:
 	CASE const_val COLON res_sub_program {
-	    $$ = new_case_node($2, $4, error_msg);
+	    $$ = new_case_node(&(context->ast_arena), $2, $4, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
 	}
 	| DEFAULT COLON res_sub_program {
-	    $$ = new_case_node(NULL, $3, error_msg);
+	    $$ = new_case_node(&(context->ast_arena), NULL, $3, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
 	}
 	;
 
 do_stmt:
-	DO {
-	    incr_scope();
-	    incr_nested_loop_counter();
-	} LBRACE sub_program RBRACE {
-	    decr_nested_loop_counter();
-	    hide_scope();
-	} WHILE LPAREN lor_expr RPAREN SEMICOLON {
-	    $$ = new_do_node($4, $9, error_msg);
+	do_body WHILE LPAREN lor_expr RPAREN SEMICOLON {
+	    $$ = new_do_node(&(context->ast_arena), $1, $4, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
     ;
 
+/* The body is reduced on its own, so recovering from an error in the condition cannot reopen its scope */
+do_body:
+	DO <loop_scope>{
+	    incr_scope(&(context->symbol_table));
+	    incr_nested_loop_counter(context);
+	    $$ = true;
+	} LBRACE sub_program RBRACE {
+	    decr_nested_loop_counter(context);
+	    hide_scope(&(context->symbol_table));
+	    $2 = false;
+	    $$ = $4;
+	}
+    ;
+
 while_stmt:
-    WHILE LPAREN lor_expr RPAREN {
-        incr_scope();
-        incr_nested_loop_counter();
+    WHILE LPAREN lor_expr RPAREN <loop_scope>{
+        incr_scope(&(context->symbol_table));
+        incr_nested_loop_counter(context);
+        $$ = true;
     } LBRACE sub_program RBRACE {
-        decr_nested_loop_counter();
-        hide_scope();
-        $$ = new_while_node($3, $7, error_msg);
+        decr_nested_loop_counter(context);
+        hide_scope(&(context->symbol_table));
+        $5 = false;
+        $$ = new_while_node(&(context->ast_arena), $3, $7, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     ;
 
 for_stmt:
-    FOR {
-        incr_scope();
-        incr_nested_loop_counter();
+    FOR <loop_scope>{
+        incr_scope(&(context->symbol_table));
+        incr_nested_loop_counter(context);
+        $$ = true;
     } LPAREN for_first lor_expr SEMICOLON assign_expr RPAREN LBRACE sub_program RBRACE {
-        $$ = new_for_node($4, $5, $7, $10, error_msg);
+        decr_nested_loop_counter(context);
+        hide_scope(&(context->symbol_table));
+        $2 = false;
+        $$ = new_for_node(&(context->ast_arena), $4, $5, $7, $10, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-
-        decr_nested_loop_counter();
-        hide_scope();
     }
     ;
 
@@ -807,33 +936,33 @@ for_first:
 
 break_stmt:
     BREAK SEMICOLON {
-        $$ = new_break_node(error_msg);
+        $$ = new_break_node(&(context->ast_arena), context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     ;
 
 continue_stmt:
     CONTINUE SEMICOLON {
-        $$ = new_continue_node(error_msg);
+        $$ = new_continue_node(&(context->ast_arena), context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     ;
 
 return_stmt:
     RETURN SEMICOLON {
-        $$ = new_return_node(NULL, error_msg);
+        $$ = new_return_node(&(context->ast_arena), NULL, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     | RETURN lor_expr SEMICOLON {
-        $$ = new_return_node($2, error_msg);
+        $$ = new_return_node(&(context->ast_arena), $2, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     ;
@@ -846,57 +975,57 @@ assign_stmt:
 
 assign_expr:
 	ref_expr ASSIGN lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_OR lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_OR_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_OR_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_XOR lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_XOR_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_XOR_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_AND lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_AND_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_AND_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_ADD lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_ADD_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_ADD_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_SUB lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_SUB_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_SUB_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_MUL lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_MUL_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_MUL_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_DIV lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_DIV_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_DIV_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| ref_expr ASSIGN_MOD lor_expr {
-	    $$ = new_assign_node($1, ASSIGN_MOD_OP, $3, error_msg);
+	    $$ = new_assign_node(&(context->ast_arena), $1, ASSIGN_MOD_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -906,9 +1035,9 @@ lor_expr:
 	    $$ = $1;
 	}
 	| lor_expr LOR lxor_expr {
-	    $$ = new_logical_op_node($1, LOR_OP, $3, error_msg);
+	    $$ = new_logical_op_node(&(context->ast_arena), $1, LOR_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -918,9 +1047,9 @@ lxor_expr:
 	    $$ = $1;
 	}
 	| lxor_expr LXOR land_expr {
-	    $$ = new_logical_op_node($1, LXOR_OP, $3, error_msg);
+	    $$ = new_logical_op_node(&(context->ast_arena), $1, LXOR_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -930,9 +1059,9 @@ land_expr:
 	    $$ = $1;
 	}
 	| land_expr LAND comparison_expr {
-	    $$ = new_logical_op_node($1, LAND_OP, $3, error_msg);
+	    $$ = new_logical_op_node(&(context->ast_arena), $1, LAND_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -942,27 +1071,27 @@ comparison_expr:
 	    $$ = $1;
 	}
 	| comparison_expr GE equality_expr {
-	    $$ = new_comparison_op_node($1, GE_OP, $3, error_msg);
+	    $$ = new_comparison_op_node(&(context->ast_arena), $1, GE_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| comparison_expr GEQ equality_expr {
-	    $$ = new_comparison_op_node($1, GEQ_OP, $3, error_msg);
+	    $$ = new_comparison_op_node(&(context->ast_arena), $1, GEQ_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| comparison_expr LE equality_expr {
-	    $$ = new_comparison_op_node($1, LE_OP, $3, error_msg);
+	    $$ = new_comparison_op_node(&(context->ast_arena), $1, LE_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| comparison_expr LEQ equality_expr {
-	    $$ = new_comparison_op_node($1, LEQ_OP, $3, error_msg);
+	    $$ = new_comparison_op_node(&(context->ast_arena), $1, LEQ_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -972,15 +1101,15 @@ equality_expr:
 	    $$ = $1;
 	}
 	| equality_expr EQ or_expr {
-	    $$ = new_equality_op_node($1, EQ_OP, $3, error_msg);
+	    $$ = new_equality_op_node(&(context->ast_arena), $1, EQ_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| equality_expr NEQ or_expr {
-	    $$ = new_equality_op_node($1, NEQ_OP, $3, error_msg);
+	    $$ = new_equality_op_node(&(context->ast_arena), $1, NEQ_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -990,9 +1119,9 @@ or_expr:
         $$ = $1;
     }
 	| or_expr OR xor_expr {
-        $$ = new_integer_op_node($1, OR_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, OR_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -1002,9 +1131,9 @@ xor_expr:
 	    $$ = $1;
 	}
 	| xor_expr XOR and_expr {
-        $$ = new_integer_op_node($1, XOR_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, XOR_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -1014,9 +1143,9 @@ and_expr:
         $$ = $1;
     }
 	| and_expr AND add_expr {
-        $$ = new_integer_op_node($1, AND_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, AND_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -1026,15 +1155,15 @@ add_expr:
 	    $$ = $1;
 	}
 	| add_expr ADD mul_expr {
-        $$ = new_integer_op_node($1, ADD_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, ADD_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| add_expr SUB mul_expr {
-        $$ = new_integer_op_node($1, SUB_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, SUB_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -1044,21 +1173,21 @@ mul_expr:
 	    $$ = $1;
 	}
 	| mul_expr MUL unary_expr {
-        $$ = new_integer_op_node($1, MUL_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, MUL_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| mul_expr DIV unary_expr {
-        $$ = new_integer_op_node($1, DIV_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, DIV_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| mul_expr MOD unary_expr {
-        $$ = new_integer_op_node($1, MOD_OP, $3, error_msg);
+        $$ = new_integer_op_node(&(context->ast_arena), $1, MOD_OP, $3, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	;
@@ -1068,21 +1197,21 @@ unary_expr:
 	    $$ = $1;
 	}
 	| INV unary_expr {
-        $$ = new_invert_op_node($2, error_msg);
+        $$ = new_invert_op_node(&(context->ast_arena), $2, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| NOT unary_expr {
-	    $$ = new_not_op_node($2, error_msg);
+	    $$ = new_not_op_node(&(context->ast_arena), $2, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 	}
 	| MEASURE LPAREN unary_expr RPAREN {
-	    $$ = new_measure_node($3, error_msg);
+	    $$ = new_measure_node(&(context->ast_arena), $3, context->error_msg);
 	    if ($$ == NULL) {
-	        yyerror(error_msg);
+	        PARSE_ERROR(@$);
 	    }
 	}
 	;
@@ -1101,33 +1230,37 @@ postfix_expr:
 
 ref_expr:
 	ref {
-        $$ = new_reference_node($1->entry, $1->index_is_const, $1->indices, $1->index_depth, error_msg);
+        pop_from_pool_stack(&(context->access_info_stack));
+        $$ = new_reference_node(&(context->ast_arena), $1->entry, $1->index_is_const, $1->indices, $1->index_depth,
+                                context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
-
-        --access_info_counter;
 	}
 	;
 
 ref:
     ID {
-        entry_t *entry = insert($1, strlen($1), yylineno, false, error_msg);
+        entry_t *entry = insert(&(context->symbol_table), $1, yyget_lineno(scanner), false, context->error_msg);
         if (entry == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
 
-        $$ = access_info_array + access_info_counter;
-        if (!setup_access_info($$, entry, error_msg)) {
-            yyerror(error_msg);
+        $$ = push_to_pool_stack(&(context->access_info_stack), context->error_msg);
+        if ($$ == NULL) {
+            PARSE_ERROR(@$);
         }
 
-        ++access_info_counter;
+        if (!setup_access_info($$, entry, context->error_msg)) {
+            pop_from_pool_stack(&(context->access_info_stack));
+            PARSE_ERROR(@$);
+        }
     }
     | ref LBRACKET or_expr RBRACKET {
         $$ = $1;
-        if (!append_to_access_info($$, $3, error_msg)) {
-            yyerror(error_msg);
+        if (!append_to_access_info($$, $3, context->error_msg)) {
+            pop_from_pool_stack(&(context->access_info_stack));
+            PARSE_ERROR(@3);
         }
     }
     ;
@@ -1143,15 +1276,15 @@ primary_expr:
 
 const_val:
     BCONST {
-        $$ = new_const_node(BOOL_T, $1, error_msg);
+        $$ = new_const_node(&(context->ast_arena), BOOL_T, $1, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
     | ICONST {
-        $$ = new_const_node(INT_T, $1, error_msg);
+        $$ = new_const_node(&(context->ast_arena), INT_T, $1, context->error_msg);
         if ($$ == NULL) {
-            yyerror(error_msg);
+            PARSE_ERROR(@$);
         }
     }
 	;
@@ -1159,63 +1292,431 @@ const_val:
 
 %%
 
-int yyerror(const char *message) {
-    fprintf(stderr, "Parsing failed in line %d: %s\n", yylineno, message);
-    exit(1);
+void yyerror(YYLTYPE *location, yyscan_t scanner, parse_context_t *context, const char *message) {
+    (void) scanner;
+    add_diagnostic(context, (unsigned) location->first_line, (unsigned) location->first_column, message);
+}
+
+/* See header for documentation */
+bool parse_file(parse_context_t *context, FILE *input_file) {
+    yyscan_t scanner;
+    if (yylex_init_extra(context, &scanner) != 0) {
+        add_diagnostic(context, 0, 0, "Initializing scanner failed");
+        return false;
+    }
+
+    yyset_in(input_file, scanner);
+    int result = yyparse(scanner, context);
+    yylex_destroy(scanner);
+    return result == 0 && context->num_of_diagnostics == 0;
+}
+
+/* See header for documentation */
+bool parse_buffer(parse_context_t *context, char *buffer, size_t size) {
+    yyscan_t scanner;
+    if (yylex_init_extra(context, &scanner) != 0) {
+        add_diagnostic(context, 0, 0, "Initializing scanner failed");
+        return false;
+    }
+
+    YY_BUFFER_STATE buffer_state = yy_scan_buffer(buffer, size, scanner);
+    if (buffer_state == NULL) {
+        snprintf(context->error_msg, ERROR_MSG_LENGTH, "Input buffer does not end with %d null bytes",
+                 MAPPED_FILE_PADDING);
+        add_diagnostic(context, 0, 0, context->error_msg);
+        yylex_destroy(scanner);
+        return false;
+    }
+
+    yyset_lineno((int) context->first_line, scanner); /* yy_scan_buffer leaves the line number unset */
+    int result = yyparse(scanner, context);
+    yy_delete_buffer(buffer_state, scanner);
+    yylex_destroy(scanner);
+    return result == 0 && context->num_of_diagnostics == 0;
+}
+
+/* See header for documentation */
+bool parse_mapped_file(parse_context_t *context, const char *file_name) {
+    mapped_file_t mapped_file;
+    if (!map_file(&mapped_file, file_name, context->error_msg)) {
+        add_diagnostic(context, 0, 0, context->error_msg);
+        return false;
+    }
+
+    bool success = parse_buffer(context, mapped_file.buffer, mapped_file.size);
+    unmap_file(&mapped_file);
+    return success;
+}
+
+/* See header for documentation */
+bool lex_mapped_file(parse_context_t *context, const char *file_name, size_t *num_of_tokens, size_t *num_of_bytes) {
+    *num_of_tokens = 0;
+    *num_of_bytes = 0;
+    mapped_file_t mapped_file;
+    if (!map_file(&mapped_file, file_name, context->error_msg)) {
+        add_diagnostic(context, 0, 0, context->error_msg);
+        return false;
+    }
+    *num_of_bytes = mapped_file.size - MAPPED_FILE_PADDING;
+
+    yyscan_t scanner;
+    if (yylex_init_extra(context, &scanner) != 0) {
+        add_diagnostic(context, 0, 0, "Initializing scanner failed");
+        unmap_file(&mapped_file);
+        return false;
+    }
+
+    YY_BUFFER_STATE buffer_state = yy_scan_buffer(mapped_file.buffer, mapped_file.size, scanner);
+    if (buffer_state == NULL) {
+        snprintf(context->error_msg, ERROR_MSG_LENGTH, "Input buffer does not end with %d null bytes",
+                 MAPPED_FILE_PADDING);
+        add_diagnostic(context, 0, 0, context->error_msg);
+        yylex_destroy(scanner);
+        unmap_file(&mapped_file);
+        return false;
+    }
+
+    yyset_lineno(1, scanner);
+    YYSTYPE value;
+    YYLTYPE location = {1, 1, 1, 1};
+    while (yylex(&value, &location, scanner) != YYEOF) {
+        ++(*num_of_tokens);
+    }
+    yy_delete_buffer(buffer_state, scanner);
+    yylex_destroy(scanner);
+    unmap_file(&mapped_file);
+    return context->num_of_diagnostics == 0;
+}
+
+/* See header for documentation */
+bool parse_cached_file(parse_context_t *context, const char *file_name, const char *cache_dir, ast_image_t *image,
+                       bool *is_cached) {
+    *is_cached = false;
+    mapped_file_t mapped_file;
+    if (!map_file(&mapped_file, file_name, context->error_msg)) {
+        add_diagnostic(context, 0, 0, context->error_msg);
+        return false;
+    }
+
+    /* the key is taken before parsing, which scans the buffer in place */
+    char key[CACHE_KEY_LENGTH];
+    get_cache_key(key, mapped_file.buffer, mapped_file.size - MAPPED_FILE_PADDING);
+    bool success;
+    *is_cached = load_from_cache(cache_dir, key, image, context, &success);
+    if (!*is_cached) {
+        success = parse_buffer(context, mapped_file.buffer, mapped_file.size);
+
+        /* failures not tied to the input (e.g., out of memory) may not recur and are not cached */
+        if (success || context->diagnostics[0].line != 0) {
+            char error_msg[ERROR_MSG_LENGTH];
+            store_in_cache(cache_dir, key, context, success, error_msg); /* not storing only costs a later miss */
+        }
+    }
+    unmap_file(&mapped_file);
+    return success;
+}
+
+/**
+ * \brief                               Write symbol table and tree dumps
+ * \param[in]                           symbol_table: Pointer to symbol table
+ * \param[in]                           root: Pointer to root node of the tree
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether writing the dumps was successful
+ */
+static bool write_dumps(const symbol_table_t *symbol_table, const node_t *root, char error_msg[ERROR_MSG_LENGTH]) {
+    char symbol_table_dump_file[] = "symbol_table_dump.out";
+    FILE *output_file = fopen(symbol_table_dump_file, "w");
+    if (!output_file) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Could not open %s", symbol_table_dump_file);
+        return false;
+    }
+    fprint_symbol_table(output_file, symbol_table);
+    fclose(output_file);
+
+    char tree_dump_file[] = "tree_dump.out";
+    output_file = fopen(tree_dump_file, "w");
+    if (!output_file) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Could not open %s", tree_dump_file);
+        return false;
+    }
+    bool success = fprint_tree(output_file, root, 0, error_msg);
+    fclose(output_file);
+    return success;
 }
 
 int main(int argc, char **argv) {
-    if (argc > 1 && strncmp(argv[1], "--dump", 7) != 0 && strncmp(argv[1], "--version", 10) != 0) {
-        yyin = fopen(argv[1], "r");
-        if (!yyin) {
-            fprintf(stderr, "Could not open %s\n", argv[1]);
+    if (argc > 1 && strncmp(argv[1], "--jobs", 7) == 0) {
+        char *end_ptr = NULL;
+        unsigned long num_of_jobs = (argc > 2) ? strtoul(argv[2], &end_ptr, 10) : 0;
+        if (num_of_jobs == 0 || num_of_jobs > MAX_NUM_OF_JOBS || *end_ptr != '\0') {
+            fprintf(stderr, "--jobs expects a number of jobs between 1 and %u\n", MAX_NUM_OF_JOBS);
             return 1;
         }
+
+        int first_file = 3;
+        const char *cache_dir = NULL;
+        if (argc > 4 && strncmp(argv[3], "--cache-dir", 12) == 0) {
+            cache_dir = argv[4];
+            first_file = 5;
+        }
+        char error_msg[ERROR_MSG_LENGTH];
+        if (cache_dir != NULL && !open_cache(cache_dir, error_msg)) {
+            fprintf(stderr, "%s\n", error_msg);
+            return 1;
+        }
+
+        if (argc > first_file) {
+            return run_batch(stdout, argv + first_file, (unsigned) (argc - first_file), (unsigned) num_of_jobs,
+                             cache_dir) ? 0 : 1;
+        }
+
+        unsigned num_of_files;
+        char **file_names = read_file_list(stdin, &num_of_files);
+        if (file_names == NULL) {
+            fprintf(stderr, "Reading file list from standard input failed\n");
+            return 1;
+        }
+        bool success = run_batch(stdout, file_names, num_of_files, (unsigned) num_of_jobs, cache_dir);
+        free_file_list(file_names, num_of_files);
+        return success ? 0 : 1;
     }
 
-    if (argc == 2 && strncmp(argv[1], "--version", 10) == 0) {
-        printf("1.0.1\n");
-        return 0;
+    if (argc > 1 && strncmp(argv[1], "--serve", 8) == 0) {
+        if (argc > 3) {
+            fprintf(stderr, "Usage: %s --serve [socket]\n", argv[0]);
+            return 1;
+        }
+
+        char error_msg[ERROR_MSG_LENGTH];
+        bool success = (argc == 3) ? serve_socket(argv[2], error_msg)
+                                   : serve_stream(fileno(stdin), fileno(stdout), error_msg);
+        if (!success) {
+            fprintf(stderr, "%s\n", error_msg);
+        }
+        return success ? 0 : 1;
+    }
+
+    if (argc > 1 && strncmp(argv[1], "--lex-only", 11) == 0) {
+        if (argc != 3) {
+            fprintf(stderr, "Usage: %s --lex-only file\n", argv[0]);
+            return 1;
+        }
+
+        static parse_context_t context;
+        init_parse_context(&context);
+        size_t num_of_tokens;
+        size_t num_of_bytes;
+        struct timespec start;
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool success = lex_mapped_file(&context, argv[2], &num_of_tokens, &num_of_bytes);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double seconds = (double) (end.tv_sec - start.tv_sec) + 1e-9 * (double) (end.tv_nsec - start.tv_nsec);
+        if (success) {
+            printf("Scanned %zu tokens (%zu bytes) in %.3f s (%.1f tokens/s, %.1f MB/s)\n", num_of_tokens,
+                   num_of_bytes, seconds, (double) num_of_tokens / seconds, 1e-6 * (double) num_of_bytes / seconds);
+        } else {
+            fprint_diagnostics(stderr, &context);
+        }
+        free_parse_context(&context);
+        return success ? 0 : 1;
+    }
+
+    if (argc > 1 && strncmp(argv[1], "--simulate", 11) == 0) {
+        unsigned long long seed = 0;
+        unsigned long num_of_threads = 1;
+        bool is_sparse = false;
+        bool is_valid_usage = argc >= 3 && argc % 2 == 1;
+        for (int i = 3; i + 1 < argc && is_valid_usage; i += 2) {
+            char *end = NULL;
+            if (strncmp(argv[i], "--seed", 7) == 0) {
+                seed = strtoull(argv[i + 1], &end, 10);
+                is_valid_usage = *end == '\0';
+                continue;
+            } else if (strncmp(argv[i], "--threads", 10) == 0) {
+                num_of_threads = strtoul(argv[i + 1], &end, 10);
+                is_valid_usage = *end == '\0' && num_of_threads > 0 && num_of_threads <= MAX_NUM_OF_THREADS
+                                 && (num_of_threads & (num_of_threads - 1)) == 0;
+                continue;
+            } else if (strncmp(argv[i], "--representation", 17) == 0) {
+                is_sparse = strcmp(argv[i + 1], "sparse") == 0;
+                is_valid_usage = is_sparse || strcmp(argv[i + 1], "dense") == 0;
+                continue;
+            } else if (strncmp(argv[i], "--kernels", 10) != 0) {
+                is_valid_usage = false;
+                break;
+            }
+
+            kernel_level_t level = SCALAR_K;
+            while (level < NUM_OF_KERNEL_LEVELS && strcmp(argv[i + 1], get_kernel_level_name(level)) != 0) {
+                ++level;
+            }
+            if (level < NUM_OF_KERNEL_LEVELS && !select_kernel_level(level)) {
+                fprintf(stderr, "Kernel level %s is not supported by this processor\n", argv[i + 1]);
+                return 1;
+            }
+            is_valid_usage = level < NUM_OF_KERNEL_LEVELS;
+        }
+        if (!is_valid_usage) {
+            fprintf(stderr, "Usage: %s --simulate file [--seed n] [--kernels scalar|avx2|avx512] [--threads n] "
+                    "[--representation dense|sparse]\n(threads must be a power of two between 1 and %u; a sparse "
+                    "state vector turns dense once too many amplitudes are nonzero)\n", argv[0], MAX_NUM_OF_THREADS);
+            return 1;
+        }
+
+        static parse_context_t context;
+        init_parse_context(&context);
+        bool success = parse_mapped_file(&context, argv[2]);
+        if (!success) {
+            fprint_diagnostics(stderr, &context);
+            free_parse_context(&context);
+            return 1;
+        }
+
+        simulation_result_t result;
+        success = simulate_program(context.root, &(context.symbol_table), seed, (unsigned) num_of_threads, is_sparse,
+                                   &result, context.error_msg);
+        if (success) {
+            printf("Simulated %u qubits in %.3f s (%llu amplitude ops, %.1f amplitude ops/s, %s kernels, %u threads on "
+                   "%u NUMA nodes, %s representation", result.num_of_qubits, result.seconds,
+                   result.num_of_amplitude_ops, (double) result.num_of_amplitude_ops / result.seconds,
+                   get_kernel_level_name(get_kernel_level()), result.num_of_threads, result.num_of_numa_nodes,
+                   result.is_sparse ? "sparse" : "dense");
+            if (is_sparse) {
+                printf(", at most %zu sparse entries", result.max_num_of_entries);
+            }
+            printf(")\n");
+            if (result.has_return_value) {
+                printf("main returned %lld\n", result.return_value);
+            }
+        } else {
+            fprintf(stderr, "%s\n", context.error_msg);
+        }
+        free_parse_context(&context);
+        return success ? 0 : 1;
     }
 
-    bool dump = (argc == 2 && strncmp(argv[1], "--dump", 7) == 0) || (argc == 3 && strncmp(argv[2], "--dump", 7) == 0);
-    init_symbol_table();
-    root = NULL;
-    stmt_list_counter = 0;
-    type_info_counter = 0;
-    arg_list_counter = 0;
-    access_info_counter = 0;
-    else_if_list_counter = 0;
-    case_list_counter = 0;
+    if (argc > 1 && strncmp(argv[1], "--run", 6) == 0) {
+        bool disassemble = argc == 4 && strncmp(argv[3], "--disassemble", 14) == 0;
+        if (argc != 3 && !disassemble) {
+            fprintf(stderr, "Usage: %s --run file [--disassemble]\n(runs the classical part of a program as "
+                    "bytecode)\n", argv[0]);
+            return 1;
+        }
 
-    yyparse();
+        static parse_context_t context;
+        init_parse_context(&context);
+        bool success = parse_mapped_file(&context, argv[2]);
+        if (!success) {
+            fprint_diagnostics(stderr, &context);
+            free_parse_context(&context);
+            return 1;
+        }
 
+        bytecode_program_t program;
+        bytecode_result_t result;
+        success = compile_bytecode(&program, context.root, &(context.symbol_table), context.error_msg);
+        if (success && disassemble) {
+            fprint_bytecode(stdout, &program);
+        }
+        success = success && run_bytecode(&program, &result, context.error_msg);
+        if (success) {
+            printf("Ran %llu instructions in %.3f s (%.1f instructions/s, %u instructions in %u functions "
+                   "compiled)\n", result.num_of_steps, result.seconds, (double) result.num_of_steps / result.seconds,
+                   program.num_of_instructions, program.num_of_functions);
+            if (result.has_return_value) {
+                printf("main returned %lld\n", result.return_value);
+            }
+        } else {
+            fprintf(stderr, "%s\n", context.error_msg);
+        }
+        free_bytecode(&program);
+        free_parse_context(&context);
+        return success ? 0 : 1;
+    }
 
-    if (argc > 1) {
-        fclose(yyin);
+    if (argc == 2 && strncmp(argv[1], "--version", 10) == 0) {
+        printf("%s\n", PARSER_VERSION);
+        return 0;
     }
 
-    if (dump) {
-        char symbol_table_dump_file[] = "symbol_table_dump.out";
-        yyout = fopen(symbol_table_dump_file, "w");
-        if (!yyout) {
-            fprintf(stderr, "%s\n", symbol_table_dump_file);
+    const char *input_file_name = NULL;
+    const char *emit_ast_file_name = NULL;
+    const char *load_ast_file_name = NULL;
+    const char *cache_dir = NULL;
+    bool dump = false;
+    bool is_valid_usage = true;
+    for (int i = 1; i < argc && is_valid_usage; ++i) {
+        if (strncmp(argv[i], "--dump", 7) == 0) {
+            dump = true;
+        } else if (strncmp(argv[i], "--emit-ast", 11) == 0 && i + 1 < argc && emit_ast_file_name == NULL) {
+            emit_ast_file_name = argv[++i];
+        } else if (strncmp(argv[i], "--load-ast", 11) == 0 && i + 1 < argc && load_ast_file_name == NULL) {
+            load_ast_file_name = argv[++i];
+        } else if (strncmp(argv[i], "--cache-dir", 12) == 0 && i + 1 < argc && cache_dir == NULL) {
+            cache_dir = argv[++i];
+        } else if (input_file_name == NULL) {
+            input_file_name = argv[i];
+        } else {
+            is_valid_usage = false;
+        }
+    }
+    if (!is_valid_usage || (cache_dir != NULL && input_file_name == NULL)
+        || (load_ast_file_name != NULL && (input_file_name != NULL || emit_ast_file_name != NULL))) {
+        fprintf(stderr, "Usage: %s [file [--cache-dir directory]] [--dump] [--emit-ast image]\n"
+                        "       %s --load-ast image [--dump]\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    if (load_ast_file_name != NULL) {
+        ast_image_t image;
+        char error_msg[ERROR_MSG_LENGTH];
+        if (!load_ast_image(&image, load_ast_file_name, error_msg)) {
+            fprintf(stderr, "%s\n", error_msg);
             return 1;
         }
-        fprint_symbol_table(yyout);
-        fclose(yyout);
+        bool success = !dump || write_dumps(image.symbol_table, image.root, error_msg);
+        if (!success) {
+            fprintf(stderr, "%s\n", error_msg);
+        }
+        unload_ast_image(&image);
+        return success ? 0 : 1;
+    }
 
-        char tree_dump_file[] = "tree_dump.out";
-        yyout = fopen(tree_dump_file, "w");
-        if (!yyout) {
-            fprintf(stderr, "%s\n", tree_dump_file);
+    static parse_context_t context;
+    init_parse_context(&context);
+    ast_image_t image;
+    bool is_cached = false;
+    bool success;
+    if (cache_dir != NULL) {
+        if (!open_cache(cache_dir, context.error_msg)) {
+            fprintf(stderr, "%s\n", context.error_msg);
+            free_parse_context(&context);
             return 1;
         }
-        fprint_tree(yyout, root, 0);
-        fclose(yyout);
+        success = parse_cached_file(&context, input_file_name, cache_dir, &image, &is_cached);
+        printf("Cache: %u hits, %u misses\n", is_cached ? 1 : 0, is_cached ? 0 : 1);
+    } else {
+        success = (input_file_name != NULL) ? parse_mapped_file(&context, input_file_name)
+                                            : parse_file(&context, stdin);
     }
 
-    free_tree(root);
-    free_symbol_table();
-    return 0;
+    if (!success) {
+        fprint_diagnostics(stderr, &context);
+        free_parse_context(&context);
+        return 1;
+    }
+
+    const node_t *root = is_cached ? image.root : context.root;
+    const symbol_table_t *symbol_table = is_cached ? image.symbol_table : &(context.symbol_table);
+    success = (emit_ast_file_name == NULL || write_ast_image(emit_ast_file_name, root, symbol_table, context.error_msg))
+              && (!dump || write_dumps(symbol_table, root, context.error_msg));
+    if (!success) {
+        fprintf(stderr, "%s\n", context.error_msg);
+    }
+    if (is_cached) {
+        unload_ast_image(&image);
+    }
+    free_parse_context(&context);
+    return success ? 0 : 1;
 }
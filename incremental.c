@@ -0,0 +1,1043 @@
+/**
+ * \file                                incremental.c
+ * \brief                               Incremental parsing source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cq_parser.h"
+#include "incremental.h"
+#include "visitor.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Entry map struct
+ * \note                                This structure maps the entries a span has just declared to the retired entries
+ *                                      of the same symbols that take their place
+ */
+typedef struct entry_map {
+    entry_t *new_entries[MAX_NUM_OF_CHANGED_SYMBOLS];       /*!< Entries declared while reparsing */
+    entry_t *old_entries[MAX_NUM_OF_CHANGED_SYMBOLS];       /*!< Retired entries taking their place */
+    unsigned num_of_entries;                /*!< Number of mapped entries */
+} entry_map_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Make sure that an array can hold a number of elements
+ * \param[in,out]                       array: Address of array
+ * \param[in,out]                       capacity: Address of number of elements the array can hold
+ * \param[in]                           num_of_elements: Number of elements the array must hold
+ * \param[in]                           element_size: Size of an element
+ * \return                              Whether the array can hold the number of elements
+ */
+static bool reserve_array(void **array, size_t *capacity, size_t num_of_elements, size_t element_size) {
+    if (num_of_elements <= *capacity) {
+        return true;
+    }
+
+    size_t new_capacity = (*capacity == 0) ? INITIAL_LIST_CAPACITY : 2 * *capacity;
+    while (new_capacity < num_of_elements) {
+        new_capacity *= 2;
+    }
+    void *temp = realloc(*array, new_capacity * element_size);
+    if (temp == NULL) {
+        return false;
+    }
+
+    *array = temp;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * \brief                               Make sure that an array with an unsigned capacity can hold a number of elements
+ * \param[in,out]                       array: Address of array
+ * \param[in,out]                       capacity: Address of number of elements the array can hold
+ * \param[in]                           num_of_elements: Number of elements the array must hold
+ * \param[in]                           element_size: Size of an element
+ * \return                              Whether the array can hold the number of elements
+ */
+static bool reserve_small_array(void **array, unsigned *capacity, size_t num_of_elements, size_t element_size) {
+    size_t size_capacity = *capacity;
+    if (num_of_elements > UINT32_MAX || !reserve_array(array, &size_capacity, num_of_elements, element_size)) {
+        return false;
+    }
+
+    *capacity = (unsigned) size_capacity;
+    return true;
+}
+
+/**
+ * \brief                               Return whether character is ignored by the scanner as blank
+ * \param[in]                           c: Character
+ * \return                              Whether character is blank
+ */
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\n';
+}
+
+/**
+ * \brief                               Scan source code for the span starting at a given offset
+ * \note                                Only braces, semicolons and equal signs outside of comments are looked at: a
+ *                                      declaration ends with a semicolon outside of braces or, unless it has an
+ *                                      initializer (whose list is closed by a brace as well), with a brace closing its
+ *                                      outermost block
+ * \param[out]                          span: Pointer to span to be set up (not yet parsed)
+ * \param[in]                           source: Source code
+ * \param[in]                           start: Offset of first byte of span
+ * \param[in]                           size: Number of bytes of source code
+ */
+static void scan_span(span_t *span, const char *source, size_t start, size_t size) {
+    memset(span, 0, sizeof (span_t));
+    span->start = start;
+    unsigned depth = 0;
+    bool has_initializer = false;
+    size_t i = start;
+    while (i < size) {
+        if (source[i] == '/' && i + 1 < size && source[i + 1] == '*') {
+            i += 2;
+            while (i < size && !(source[i] == '*' && i + 1 < size && source[i + 1] == '/')) {
+                ++i;
+            }
+            i = (i < size) ? i + 2 : size;
+            continue;
+        } else if (source[i] == '/' && i + 1 < size && source[i + 1] == '/') {
+            const char *line_break = memchr(source + i, '\n', size - i);
+            if (line_break != NULL) {
+                i = (size_t) (line_break - source) + 1;
+                continue;
+            }
+            /* without a line break, the scanner does not take the slashes as comment */
+        } else if (is_blank(source[i])) {
+            ++i;
+            continue;
+        }
+
+        char c = source[i++];
+        span->has_tokens = true;
+        if (c == '{') {
+            ++depth;
+        } else if (c == '}') {
+            depth = (depth > 0) ? depth - 1 : 0;
+            if (depth == 0 && !has_initializer) {
+                break;
+            }
+        } else if (c == ';' && depth == 0) {
+            break;
+        } else if (c == '=' && depth == 0) {
+            has_initializer = true;
+        }
+    }
+    span->length = i - start;
+
+    const char *cursor = source + start;
+    const char *span_end = source + i;
+    const char *last_line_break = NULL;
+    while ((cursor = memchr(cursor, '\n', (size_t) (span_end - cursor))) != NULL) {
+        ++span->num_of_line_breaks;
+        last_line_break = cursor++;
+    }
+    span->last_line_length = (unsigned) ((last_line_break == NULL) ? span->length
+                                                                   : (size_t) (span_end - last_line_break - 1));
+}
+
+/**
+ * \brief                               Advance position from the first byte of a span to the byte behind it
+ * \param[in]                           span: Pointer to span
+ * \param[in,out]                       line: Address of line
+ * \param[in,out]                       column: Address of column
+ */
+static void advance_position(const span_t *span, unsigned *line, unsigned *column) {
+    *line += span->num_of_line_breaks;
+    *column = (span->num_of_line_breaks > 0) ? span->last_line_length + 1 : *column + span->last_line_length;
+}
+
+/**
+ * \brief                               Append span to array of spans
+ * \param[in,out]                       spans: Address of array of spans
+ * \param[in,out]                       num_of_spans: Address of number of spans
+ * \param[in,out]                       capacity: Address of number of spans the array can hold
+ * \param[in]                           span: Pointer to appended span
+ * \return                              Whether appending the span was successful
+ */
+static bool append_span(span_t **spans, unsigned *num_of_spans, unsigned *capacity, const span_t *span) {
+    if (!reserve_small_array((void **) spans, capacity, (size_t) *num_of_spans + 1, sizeof (span_t))) {
+        return false;
+    }
+
+    (*spans)[(*num_of_spans)++] = *span;
+    return true;
+}
+
+/**
+ * \brief                               Return index of the span holding a given offset
+ * \param[in]                           document: Pointer to document
+ * \param[in]                           offset: Offset (the end of the source code is held by the last span)
+ * \return                              Index of last span starting at or before offset
+ */
+static unsigned find_span(const document_t *document, size_t offset) {
+    unsigned low = 0;
+    unsigned high = document->num_of_spans - 1;
+    while (low < high) {
+        unsigned middle = low + (high - low + 1) / 2;
+        if (document->spans[middle].start <= offset) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+/**
+ * \brief                               Return next entry of the entries declared within a span
+ * \param[in]                           span: Pointer to span
+ * \param[in]                           entry: Pointer to current entry
+ * \return                              Pointer to next entry (`NULL` behind the last one)
+ */
+static entry_t *get_next_entry(const span_t *span, const entry_t *entry) {
+    return (entry == span->last_entry) ? NULL : entry->next_declared;
+}
+
+/**
+ * \brief                               Link the entries of all spans from a given one in order of declaration
+ * \param[in,out]                       document: Pointer to document
+ * \param[in]                           first: Index of first span whose entries are to be linked
+ */
+static void link_entries(document_t *document, unsigned first) {
+    symbol_table_t *symbol_table = &(document->context.symbol_table);
+    entry_t *last_entry = NULL;
+    entry_t *last_global = NULL;
+    for (unsigned i = first; i > 0 && (last_entry == NULL || last_global == NULL); --i) {
+        const span_t *span = document->spans + i - 1;
+        if (last_entry == NULL) {
+            last_entry = span->last_entry;
+        }
+        if (last_global == NULL) {
+            for (entry_t *entry = span->first_entry; entry != NULL; entry = get_next_entry(span, entry)) {
+                if (entry->scope == 0) {
+                    last_global = entry;
+                }
+            }
+        }
+    }
+    symbol_table->first_entry = NULL; /* overwritten while parsing spans */
+    for (unsigned i = 0; i < first && symbol_table->first_entry == NULL; ++i) {
+        symbol_table->first_entry = document->spans[i].first_entry;
+    }
+
+    for (unsigned i = first; i < document->num_of_spans; ++i) {
+        span_t *span = document->spans + i;
+        if (span->first_entry == NULL) {
+            continue;
+        }
+
+        if (last_entry == NULL) {
+            symbol_table->first_entry = span->first_entry;
+        } else {
+            last_entry->next_declared = span->first_entry;
+        }
+        last_entry = span->last_entry;
+        for (entry_t *entry = span->first_entry; entry != NULL; entry = get_next_entry(span, entry)) {
+            if (entry->scope == 0) {
+                entry->next_in_scope = last_global;
+                last_global = entry;
+            }
+        }
+    }
+    if (last_entry != NULL) {
+        last_entry->next_declared = NULL;
+    }
+    symbol_table->last_entry = last_entry;
+    if (symbol_table->scope_stack_capacity > 0) {
+        symbol_table->scope_stack[0] = last_global;
+    }
+}
+
+/**
+ * \brief                               Free the arrays owned by a span
+ * \param[in,out]                       span: Pointer to span
+ */
+static void free_span(span_t *span) {
+    free(span->lookup_log.lookups);
+    free(span->diagnostics);
+    span->lookup_log.lookups = NULL;
+    span->lookup_log.num_of_lookups = 0;
+    span->lookup_log.capacity = 0;
+    span->diagnostics = NULL;
+    span->num_of_diagnostics = 0;
+}
+
+/**
+ * \brief                               Free all retired entries that were not taken over
+ * \param[in,out]                       document: Pointer to document
+ */
+static void release_retired_entries(document_t *document) {
+    for (unsigned i = 0; i < document->num_of_retired_entries; ++i) {
+        free_entry(document->retired_entries[i]); /* entries that were taken over are NULL */
+    }
+    document->num_of_retired_entries = 0;
+    document->num_of_settled_entries = 0;
+    document->num_of_changed_names = 0;
+}
+
+/**
+ * \brief                               Record the name of a symbol whose declaration changed
+ * \param[in,out]                       document: Pointer to document
+ * \param[in]                           name: Interned name of symbol
+ * \return                              Whether the name could be recorded
+ */
+static bool add_changed_name(document_t *document, const char *name) {
+    for (unsigned i = 0; i < document->num_of_changed_names; ++i) {
+        if (document->changed_names[i] == name) {
+            return true;
+        }
+    }
+    if (document->num_of_changed_names == MAX_NUM_OF_CHANGED_SYMBOLS) {
+        return false;
+    }
+
+    document->changed_names[(document->num_of_changed_names)++] = name;
+    return true;
+}
+
+/**
+ * \brief                               Return whether a span looked up a symbol whose declaration changed
+ * \param[in]                           document: Pointer to document
+ * \param[in]                           span: Pointer to span
+ * \return                              Whether span depends on a changed symbol
+ */
+static bool depends_on_changed_names(const document_t *document, const span_t *span) {
+    for (unsigned i = 0; i < span->lookup_log.num_of_lookups; ++i) {
+        for (unsigned j = 0; j < document->num_of_changed_names; ++j) {
+            if (span->lookup_log.lookups[i].name == document->changed_names[j]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief                               Return whether a global symbol of a span is already declared in front of it
+ * \param[in]                           document: Pointer to document
+ * \param[in]                           span: Pointer to span whose entries are invisible
+ * \return                              Whether a global entry of span collides with a visible one
+ */
+static bool collides(const document_t *document, const span_t *span) {
+    for (entry_t *entry = span->first_entry; entry != NULL; entry = get_next_entry(span, entry)) {
+        if (entry->scope == 0 && find_entry(&(document->context.symbol_table), entry->name, entry->hash) != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief                               Retire the entries of a span that is to be reparsed
+ * \note                                Global entries are kept until the update ends, since other spans may point to
+ *                                      them and an unchanged symbol takes its entry over (see take_over_entries())
+ * \param[in,out]                       document: Pointer to document
+ * \param[in,out]                       span: Pointer to span
+ * \return                              Whether retiring the entries was successful
+ */
+static bool retire_span(document_t *document, span_t *span) {
+    symbol_table_t *symbol_table = &(document->context.symbol_table);
+    bool success = true;
+    entry_t *next_entry;
+    for (entry_t *entry = span->first_entry; entry != NULL; entry = next_entry) {
+        next_entry = get_next_entry(span, entry);
+        hide_entry(symbol_table, entry);
+        if (entry->scope == 0 && reserve_small_array((void **) &(document->retired_entries),
+                                                     &(document->retired_capacity),
+                                                     (size_t) document->num_of_retired_entries + 1,
+                                                     sizeof (entry_t *))) {
+            entry->next_declared = NULL;
+            document->retired_entries[(document->num_of_retired_entries)++] = entry;
+        } else {
+            success = success && entry->scope != 0;
+            free_entry(entry);
+        }
+    }
+    span->first_entry = NULL;
+    span->last_entry = NULL;
+    span->stmt_nodes = NULL;
+    span->num_of_stmts = 0;
+    span->lookup_log.num_of_lookups = 0;
+    free(span->diagnostics);
+    span->diagnostics = NULL;
+    span->num_of_diagnostics = 0;
+    if (!success) {
+        snprintf(document->context.error_msg, ERROR_MSG_LENGTH, "Allocating memory for retired entries failed");
+    }
+    return success;
+}
+
+/**
+ * \brief                               Return whether two entries of the same global symbol have the same interface
+ * \note                                Nodes created for an entry only depend on its interface, so those pointing to
+ *                                      one entry are valid for the other one
+ * \param[in]                           entry: Pointer to entry
+ * \param[in]                           other_entry: Pointer to other entry
+ * \return                              Whether the entries have the same interface
+ */
+static bool have_same_interface(const entry_t *entry, const entry_t *other_entry) {
+    if (entry->qualifier != other_entry->qualifier || entry->type != other_entry->type
+        || entry->shape != other_entry->shape || entry->depth != other_entry->depth
+        || entry->length != other_entry->length || entry->is_function != other_entry->is_function) {
+        return false;
+    } else if (entry->is_function) {
+        if (entry->is_unitary != other_entry->is_unitary || entry->is_quantizable != other_entry->is_quantizable
+            || entry->num_of_pars != other_entry->num_of_pars) {
+            return false;
+        }
+
+        for (unsigned i = 0; i < entry->num_of_pars; ++i) {
+            const type_info_t *par = entry->pars_type_info + i;
+            const type_info_t *other_par = other_entry->pars_type_info + i;
+            if (par->qualifier != other_par->qualifier || par->type != other_par->type
+                || par->depth != other_par->depth || par->shape != other_par->shape) {
+                return false;
+            }
+        }
+        return true;
+    } else if (entry->has_been_initialized != other_entry->has_been_initialized) {
+        return false;
+    } else if (entry->qualifier == CONST_T && (entry->values == NULL || other_entry->values == NULL)) {
+        return entry->values == other_entry->values;
+    }
+    return entry->qualifier != CONST_T
+           || memcmp(entry->values, other_entry->values, entry->length * sizeof (value_t)) == 0;
+}
+
+/**
+ * \brief                               Point node to the retired entry taking over its entry
+ * \param[in,out]                       node: Pointer to node holding an entry
+ * \param[in]                           depth: Layer depth of node (unused)
+ * \param[in]                           data: Pointer to entry map
+ * \return                              `CONTINUE_W`
+ */
+static walk_result_t take_over_entry(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    entry_t **entry;
+    switch (node->node_type) {
+        case VAR_DECL_NODE_T: {
+            entry = &(((var_decl_node_t *) node)->entry);
+            break;
+        }
+        case VAR_DEF_NODE_T: {
+            entry = &(((var_def_node_t *) node)->entry);
+            break;
+        }
+        case FUNC_DEF_NODE_T: {
+            entry = &(((func_def_node_t *) node)->entry);
+            break;
+        }
+        case REFERENCE_NODE_T: {
+            entry = &(((reference_node_t *) node)->entry);
+            break;
+        }
+        case FUNC_CALL_NODE_T: {
+            entry = &(((func_call_node_t *) node)->entry);
+            break;
+        }
+        case FUNC_SP_NODE_T: {
+            entry = &(((func_sp_node_t *) node)->entry);
+            break;
+        }
+        default: {
+            return CONTINUE_W;
+        }
+    }
+
+    const entry_map_t *entry_map = data;
+    for (unsigned i = 0; i < entry_map->num_of_entries; ++i) {
+        if (*entry == entry_map->new_entries[i]) {
+            *entry = entry_map->old_entries[i];
+            break;
+        }
+    }
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Let the retired entries of unchanged symbols take over the entries of a span
+ * \note                                Keeps the spans pointing to these entries valid; the names of all other symbols
+ *                                      declared by the span are recorded as changed
+ * \param[in,out]                       document: Pointer to document
+ * \param[in,out]                       span: Pointer to span that was just parsed
+ * \param[out]                          needs_full_parse: Address of flag set if too many symbols changed
+ * \return                              Whether taking over the entries was successful
+ */
+static bool take_over_entries(document_t *document, span_t *span, bool *needs_full_parse) {
+    parse_context_t *context = &(document->context);
+    entry_map_t entry_map;
+    entry_map.num_of_entries = 0;
+    for (entry_t *entry = span->first_entry; entry != NULL; entry = get_next_entry(span, entry)) {
+        if (entry->scope != 0) {
+            continue;
+        }
+
+        unsigned i = document->num_of_settled_entries;
+        while (i < document->num_of_retired_entries
+               && (document->retired_entries[i] == NULL || document->retired_entries[i]->name != entry->name)) {
+            ++i;
+        }
+        if (i < document->num_of_retired_entries && entry_map.num_of_entries < MAX_NUM_OF_CHANGED_SYMBOLS
+            && have_same_interface(document->retired_entries[i], entry)) {
+            entry_map.new_entries[entry_map.num_of_entries] = entry;
+            entry_map.old_entries[(entry_map.num_of_entries)++] = document->retired_entries[i];
+            document->retired_entries[i] = NULL;
+        } else if (!add_changed_name(document, entry->name)) {
+            *needs_full_parse = true;
+        }
+    }
+    if (entry_map.num_of_entries == 0) {
+        return true;
+    }
+
+    static const tree_pass_t take_over_pass = {
+        .pre_visitors = {
+            [VAR_DECL_NODE_T] = take_over_entry,
+            [VAR_DEF_NODE_T] = take_over_entry,
+            [FUNC_DEF_NODE_T] = take_over_entry,
+            [REFERENCE_NODE_T] = take_over_entry,
+            [FUNC_CALL_NODE_T] = take_over_entry,
+            [FUNC_SP_NODE_T] = take_over_entry,
+        },
+    };
+    for (unsigned i = 0; i < span->num_of_stmts; ++i) {
+        if (!run_tree_pass(&take_over_pass, span->stmt_nodes[i], 0, &entry_map, context->error_msg)) {
+            return false;
+        }
+    }
+    for (unsigned i = 0; i < span->lookup_log.num_of_lookups; ++i) {
+        for (unsigned j = 0; j < entry_map.num_of_entries; ++j) {
+            if (span->lookup_log.lookups[i].entry == entry_map.new_entries[j]) {
+                span->lookup_log.lookups[i].entry = entry_map.old_entries[j];
+                break;
+            }
+        }
+    }
+
+    bool success = true;
+    for (unsigned i = 0; i < entry_map.num_of_entries; ++i) {
+        entry_t *new_entry = entry_map.new_entries[i];
+        entry_t *old_entry = entry_map.old_entries[i];
+
+        /* the retired entry has no lines left (see edit_document()), it gets those counted while reparsing */
+        unsigned *lines = old_entry->lines;
+        unsigned lines_capacity = old_entry->lines_capacity;
+        old_entry->lines = new_entry->lines;
+        old_entry->num_of_lines = new_entry->num_of_lines;
+        old_entry->lines_capacity = new_entry->lines_capacity;
+        new_entry->lines = lines;
+        new_entry->num_of_lines = 0;
+        new_entry->lines_capacity = lines_capacity;
+
+        entry_t **link = &(span->first_entry);
+        while (*link != new_entry) {
+            link = &((*link)->next_declared);
+        }
+        old_entry->next_declared = new_entry->next_declared;
+        *link = old_entry;
+        if (span->last_entry == new_entry) {
+            span->last_entry = old_entry;
+        }
+        /* nor may the scope list of globals keep it until link_entries() rebuilds the list */
+        entry_t **scope_link = (context->symbol_table.scope_stack_capacity > 0) ? context->symbol_table.scope_stack
+                                                                                : NULL;
+        while (scope_link != NULL && *scope_link != NULL && *scope_link != new_entry) {
+            scope_link = &((*scope_link)->next_in_scope);
+        }
+        if (scope_link != NULL && *scope_link != NULL) {
+            *scope_link = new_entry->next_in_scope;
+        }
+        hide_entry(&(context->symbol_table), new_entry);
+        free_entry(new_entry);
+        success = success && show_entry(&(context->symbol_table), old_entry, context->error_msg);
+    }
+    return success;
+}
+
+/**
+ * \brief                               Parse a span on top of the symbols declared in front of it
+ * \note                                The span is copied to the scratch buffer and parsed as a program of its own,
+ *                                      starting at its position within the source code
+ * \param[in,out]                       document: Pointer to document
+ * \param[in,out]                       span: Pointer to span whose entries are retired
+ * \param[in]                           is_alone: Whether span is the only span of the document
+ * \param[in]                           is_incremental: Whether the document is updated after an edit
+ * \param[out]                          needs_full_parse: Address of flag set if a full parse is needed instead
+ * \return                              Whether parsing the span was successful (regardless of its diagnostics)
+ */
+static bool parse_span(document_t *document, span_t *span, bool is_alone, bool is_incremental,
+                       bool *needs_full_parse) {
+    parse_context_t *context = &(document->context);
+    symbol_table_t *symbol_table = &(context->symbol_table);
+    span->lookup_log.num_of_lookups = 0;
+
+    /* a program consists of at least one declaration, so blanks and comments are only parsed on their own */
+    span->is_parsed = span->has_tokens || is_alone;
+    if (!span->is_parsed) {
+        return true;
+    } else if (!reserve_array((void **) &(document->scratch), &(document->scratch_capacity),
+                              span->length + MAPPED_FILE_PADDING, sizeof (char))) {
+        snprintf(context->error_msg, ERROR_MSG_LENGTH, "Allocating memory for span of %zu bytes failed", span->length);
+        return false;
+    }
+
+    memcpy(document->scratch, document->source + span->start, span->length);
+    memset(document->scratch + span->length, 0, MAPPED_FILE_PADDING);
+    context->first_line = span->first_line;
+    context->first_column = span->first_column;
+    context->num_of_diagnostics = 0;
+    context->root = NULL;
+    symbol_table->first_entry = NULL;
+    symbol_table->last_entry = NULL;
+    symbol_table->lookup_log = &(span->lookup_log);
+    parse_buffer(context, document->scratch, span->length + MAPPED_FILE_PADDING);
+    symbol_table->lookup_log = NULL;
+    while (symbol_table->cur_scope > 0) { /* scopes left open by an aborted parse */
+        hide_scope(symbol_table);
+    }
+    span->first_entry = symbol_table->first_entry;
+    span->last_entry = symbol_table->last_entry;
+    document->num_of_reparsed_bytes += span->length;
+    if (context->root != NULL) {
+        span->stmt_nodes = ((stmt_list_node_t *) context->root)->stmt_list;
+        span->num_of_stmts = ((stmt_list_node_t *) context->root)->num_of_stmts;
+    }
+
+    if (context->num_of_diagnostics > 0) {
+        span->diagnostics = malloc(context->num_of_diagnostics * sizeof (diagnostic_t));
+        if (span->diagnostics == NULL) {
+            snprintf(context->error_msg, ERROR_MSG_LENGTH, "Allocating memory for diagnostics failed");
+            return false;
+        }
+
+        memcpy(span->diagnostics, context->diagnostics, context->num_of_diagnostics * sizeof (diagnostic_t));
+        span->num_of_diagnostics = context->num_of_diagnostics;
+    }
+
+    for (unsigned i = 0; i < span->lookup_log.num_of_lookups; ++i) {
+        lookup_t *lookup = span->lookup_log.lookups + i;
+        lookup->line -= span->first_line;
+
+        /* whether a quantum variable has been initialized depends on all spans referencing it in front */
+        if (is_incremental && !lookup->declaration && lookup->entry != NULL && lookup->entry->scope == 0
+            && !lookup->entry->is_function && lookup->entry->qualifier == QUANTUM_T) {
+            *needs_full_parse = true;
+        }
+    }
+    return !is_incremental || take_over_entries(document, span, needs_full_parse);
+}
+
+/**
+ * \brief                               Restore a span that is not reparsed at its possibly moved position
+ * \param[in,out]                       document: Pointer to document
+ * \param[in,out]                       span: Pointer to span whose entries are invisible
+ * \param[in]                           line: New first line of span
+ * \param[in]                           column: New first column of span
+ * \return                              Whether restoring the span was successful
+ */
+static bool restore_span(document_t *document, span_t *span, unsigned line, unsigned column) {
+    symbol_table_t *symbol_table = &(document->context.symbol_table);
+    unsigned line_shift = line - span->first_line; /* wraps around for spans moving up */
+    for (entry_t *entry = span->first_entry; entry != NULL; entry = get_next_entry(span, entry)) {
+        if (entry->scope == 0) {
+            if (!show_entry(symbol_table, entry, document->context.error_msg)) {
+                return false;
+            }
+        } else {
+            for (unsigned i = 0; i < entry->num_of_lines; ++i) {
+                entry->lines[i] += line_shift;
+            }
+        }
+    }
+    span->first_line = line;
+    span->first_column = column;
+
+    /* global entries get their lines in the order of the spans, as while parsing */
+    for (unsigned i = 0; i < span->lookup_log.num_of_lookups; ++i) {
+        const lookup_t *lookup = span->lookup_log.lookups + i;
+        if (lookup->entry != NULL && lookup->entry->scope == 0
+            && !append_line(lookup->entry, line + lookup->line, document->context.error_msg)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Record the names of retired entries that were not taken over as changed
+ * \param[in,out]                       document: Pointer to document
+ * \return                              Whether the names could be recorded
+ */
+static bool settle_retired_entries(document_t *document) {
+    for (unsigned i = document->num_of_settled_entries; i < document->num_of_retired_entries; ++i) {
+        if (document->retired_entries[i] != NULL && !add_changed_name(document, document->retired_entries[i]->name)) {
+            return false;
+        }
+    }
+    document->num_of_settled_entries = document->num_of_retired_entries;
+    return true;
+}
+
+/**
+ * \brief                               Update spans from a given one to the end of the document
+ * \note                                Dirty spans are reparsed; any other span is reparsed as well if it has errors,
+ *                                      depends on a changed symbol or declares a symbol declared in front of it by now,
+ *                                      and restored otherwise; the global entries of all spans from the given one on
+ *                                      must be invisible
+ * \param[in,out]                       document: Pointer to document
+ * \param[in]                           first: Index of first span to be updated
+ * \param[in]                           region_end: Index behind last span whose text changed
+ * \param[in]                           is_incremental: Whether the document is updated after an edit
+ * \return                              Whether updating the spans was successful (`false` if a full parse is needed)
+ */
+static bool update_spans(document_t *document, unsigned first, unsigned region_end, bool is_incremental) {
+    unsigned line = 1;
+    unsigned column = 1;
+    if (first > 0) {
+        line = document->spans[first - 1].first_line;
+        column = document->spans[first - 1].first_column;
+        advance_position(document->spans + first - 1, &line, &column);
+    }
+
+    bool needs_full_parse = false;
+    bool is_alone = document->num_of_spans == 1;
+    for (unsigned i = first; i < document->num_of_spans && !needs_full_parse; ++i) {
+        span_t *span = document->spans + i;
+        if (!span->is_dirty) {
+            span->is_dirty = span->num_of_diagnostics > 0 || (!span->has_tokens && span->is_parsed != is_alone)
+                             || depends_on_changed_names(document, span) || collides(document, span);
+            if (span->is_dirty && !retire_span(document, span)) {
+                return false;
+            }
+        }
+
+        if (span->is_dirty) {
+            span->first_line = line;
+            span->first_column = column;
+            if (!parse_span(document, span, is_alone, is_incremental, &needs_full_parse)) {
+                return false;
+            }
+            span->is_dirty = false;
+        } else if (!restore_span(document, span, line, column)) {
+            return false;
+        }
+
+        /* retired entries of spans whose text changed may be taken over by any of them */
+        if (is_incremental && i + 1 >= region_end && !settle_retired_entries(document)) {
+            needs_full_parse = true;
+        }
+        advance_position(span, &line, &column);
+    }
+    return !needs_full_parse;
+}
+
+/**
+ * \brief                               Splice the top-level nodes of all spans from a given one into the root node
+ * \param[in,out]                       document: Pointer to document
+ * \param[in]                           first: Index of first span whose nodes changed
+ * \return                              Whether splicing the nodes was successful
+ */
+static bool splice_root(document_t *document, unsigned first) {
+    size_t num_of_stmts = 0;
+    for (unsigned i = 0; i < first; ++i) {
+        num_of_stmts += document->spans[i].num_of_stmts;
+    }
+    size_t offset = num_of_stmts;
+    for (unsigned i = first; i < document->num_of_spans; ++i) {
+        num_of_stmts += document->spans[i].num_of_stmts;
+    }
+    if (!reserve_small_array((void **) &(document->root.stmt_list), &(document->stmts_capacity), num_of_stmts,
+                             sizeof (node_t *))) {
+        return false;
+    }
+
+    for (unsigned i = first; i < document->num_of_spans; ++i) {
+        if (document->spans[i].num_of_stmts > 0) {
+            memcpy(document->root.stmt_list + offset, document->spans[i].stmt_nodes,
+                   document->spans[i].num_of_stmts * sizeof (node_t *));
+            offset += document->spans[i].num_of_stmts;
+        }
+    }
+    document->root.num_of_stmts = (unsigned) num_of_stmts;
+    document->root.is_unitary = true;
+    document->root.is_quantizable = true;
+    for (unsigned i = 0; i < document->root.num_of_stmts; ++i) {
+        document->root.is_unitary = document->root.is_unitary && is_unitary(document->root.stmt_list[i]);
+        document->root.is_quantizable = document->root.is_quantizable && is_quantizable(document->root.stmt_list[i]);
+    }
+    return true;
+}
+
+/**
+ * \brief                               Finish updating the document from a given span on
+ * \note                                Links the entries in order of declaration, frees the retired entries, splices
+ *                                      the root node and collects the diagnostics of all spans in the parse context
+ * \param[in,out]                       document: Pointer to document
+ * \param[in]                           first: Index of first updated span
+ * \return                              Whether the document is free of errors
+ */
+static bool finish_update(document_t *document, unsigned first) {
+    parse_context_t *context = &(document->context);
+    link_entries(document, first);
+    release_retired_entries(document);
+    context->first_line = 1;
+    context->first_column = 1;
+    context->num_of_diagnostics = 0;
+    context->root = (node_t *) &(document->root);
+    if (!splice_root(document, first)) {
+        add_diagnostic(context, 0, 0, "Allocating memory for root node failed");
+        document->num_of_reparsed_bytes = SIZE_MAX; /* forces a full parse upon the next edit */
+    }
+
+    bool has_room = true;
+    for (unsigned i = 0; i < document->num_of_spans && has_room; ++i) {
+        const span_t *span = document->spans + i;
+        for (unsigned j = 0; j < span->num_of_diagnostics && has_room; ++j) {
+            has_room = add_diagnostic(context, span->diagnostics[j].line, span->diagnostics[j].column,
+                                      span->diagnostics[j].msg);
+        }
+    }
+    return context->num_of_diagnostics == 0;
+}
+
+/**
+ * \brief                               Parse the whole source code of document span by span
+ * \param[in,out]                       document: Pointer to document
+ * \return                              Whether parsing was successful
+ */
+static bool reparse_document(document_t *document) {
+    parse_context_t *context = &(document->context);
+    release_retired_entries(document);
+    link_entries(document, 0);
+    for (unsigned i = 0; i < document->num_of_spans; ++i) {
+        free_span(document->spans + i);
+    }
+    document->num_of_spans = 0;
+    free_parse_context(context);
+
+    size_t offset = 0;
+    do {
+        span_t span;
+        scan_span(&span, document->source, offset, document->size);
+        span.is_dirty = true;
+        if (!append_span(&(document->spans), &(document->num_of_spans), &(document->spans_capacity), &span)) {
+            add_diagnostic(context, 0, 0, "Allocating memory for spans failed");
+            document->num_of_spans = 0;
+            document->num_of_reparsed_bytes = SIZE_MAX;
+            return false;
+        }
+        offset += span.length;
+    } while (offset < document->size);
+
+    bool is_parsed = update_spans(document, 0, document->num_of_spans, false);
+    document->num_of_reparsed_bytes = 0;
+    if (!is_parsed) {
+        char error_msg[ERROR_MSG_LENGTH];
+        memcpy(error_msg, context->error_msg, ERROR_MSG_LENGTH);
+        finish_update(document, 0);
+        add_diagnostic(context, 0, 0, error_msg);
+        document->num_of_reparsed_bytes = SIZE_MAX;
+        return false;
+    }
+    return finish_update(document, 0);
+}
+
+/* See header for documentation */
+bool open_document(document_t *document, const char *source, size_t size) {
+    memset(document, 0, sizeof (document_t));
+    init_parse_context(&(document->context));
+    document->root.node_type = STMT_LIST_NODE_T;
+    document->root.return_style = NONE_ST;
+    if (!reserve_array((void **) &(document->source), &(document->capacity), size + MAPPED_FILE_PADDING,
+                       sizeof (char))) {
+        snprintf(document->context.error_msg, ERROR_MSG_LENGTH, "Allocating memory for source code of %zu bytes failed",
+                 size);
+        add_diagnostic(&(document->context), 0, 0, document->context.error_msg);
+        return false;
+    }
+
+    memcpy(document->source, source, size);
+    memset(document->source + size, 0, MAPPED_FILE_PADDING);
+    document->size = size;
+    return reparse_document(document);
+}
+
+/* See header for documentation */
+bool edit_document(document_t *document, size_t start, size_t end, const char *text, size_t length) {
+    parse_context_t *context = &(document->context);
+    if (start > end || end > document->size) {
+        snprintf(context->error_msg, ERROR_MSG_LENGTH, "Edit range from %zu to %zu exceeds source code of %zu bytes",
+                 start, end, document->size);
+        context->num_of_diagnostics = 0;
+        add_diagnostic(context, 0, 0, context->error_msg);
+        return false;
+    }
+
+    size_t size = document->size - (end - start) + length;
+    if (!reserve_array((void **) &(document->source), &(document->capacity), size + MAPPED_FILE_PADDING,
+                       sizeof (char))) {
+        snprintf(context->error_msg, ERROR_MSG_LENGTH, "Allocating memory for source code of %zu bytes failed", size);
+        context->num_of_diagnostics = 0;
+        add_diagnostic(context, 0, 0, context->error_msg);
+        return false;
+    }
+
+    memmove(document->source + start + length, document->source + end, document->size - end);
+    memcpy(document->source + start, text, length);
+    memset(document->source + size, 0, MAPPED_FILE_PADDING);
+    document->size = size;
+    if (document->num_of_spans == 0 || document->num_of_reparsed_bytes > size + ARENA_BLOCK_SIZE) {
+        return reparse_document(document);
+    }
+
+    /* rescan from the span holding the edit until a span ends where an old one ended behind the edit */
+    unsigned first = find_span(document, start);
+    unsigned last = document->num_of_spans - 1;
+    span_t *new_spans = NULL;
+    unsigned num_of_new_spans = 0;
+    unsigned new_spans_capacity = 0;
+    size_t offset = document->spans[first].start;
+    for (;;) {
+        span_t span;
+        scan_span(&span, document->source, offset, size);
+        if (span.length == 0 && (first > 0 || num_of_new_spans > 0)) {
+            break;
+        } else if (!append_span(&new_spans, &num_of_new_spans, &new_spans_capacity, &span)) {
+            free(new_spans);
+            return reparse_document(document);
+        }
+
+        offset += span.length;
+        if (offset >= size) {
+            break;
+        } else if (offset >= start + length) {
+            size_t old_offset = offset + (end - start) - length;
+            unsigned next = find_span(document, old_offset);
+            if (document->spans[next].start == old_offset && next > first) {
+                last = next - 1;
+                break;
+            }
+        }
+    }
+
+    /* the lines of global entries counted from the first rescanned span on are counted again while updating */
+    for (unsigned i = first; i < document->num_of_spans; ++i) {
+        span_t *span = document->spans + i;
+        for (unsigned j = 0; j < span->lookup_log.num_of_lookups; ++j) {
+            entry_t *entry = span->lookup_log.lookups[j].entry;
+            if (entry != NULL && entry->scope == 0) {
+                --entry->num_of_lines;
+            }
+        }
+        for (entry_t *entry = span->first_entry; entry != NULL; entry = get_next_entry(span, entry)) {
+            if (entry->scope == 0) {
+                hide_entry(&(context->symbol_table), entry);
+            }
+        }
+    }
+
+    unsigned num_of_old_spans = last - first + 1;
+    bool success = true;
+    for (unsigned i = first; i <= last; ++i) {
+        success = retire_span(document, document->spans + i) && success;
+        free_span(document->spans + i);
+    }
+    if (!success || !reserve_small_array((void **) &(document->spans), &(document->spans_capacity),
+                                         (size_t) document->num_of_spans - num_of_old_spans + num_of_new_spans,
+                                         sizeof (span_t))) {
+        free(new_spans);
+        return reparse_document(document);
+    }
+
+    memmove(document->spans + first + num_of_new_spans, document->spans + last + 1,
+            (document->num_of_spans - last - 1) * sizeof (span_t));
+    if (num_of_new_spans > 0) {
+        memcpy(document->spans + first, new_spans, num_of_new_spans * sizeof (span_t));
+    }
+    free(new_spans);
+    document->num_of_spans = document->num_of_spans - num_of_old_spans + num_of_new_spans;
+    for (unsigned i = first; i < first + num_of_new_spans; ++i) {
+        document->spans[i].is_dirty = true;
+    }
+    for (unsigned i = first + num_of_new_spans; i < document->num_of_spans; ++i) {
+        document->spans[i].start = document->spans[i].start + length - (end - start);
+    }
+
+    if (!update_spans(document, first, first + num_of_new_spans, true)) {
+        return reparse_document(document);
+    }
+    return finish_update(document, first);
+}
+
+/* See header for documentation */
+void free_document(document_t *document) {
+    release_retired_entries(document);
+    link_entries(document, 0);
+    for (unsigned i = 0; i < document->num_of_spans; ++i) {
+        free_span(document->spans + i);
+    }
+    free(document->spans);
+    free(document->root.stmt_list);
+    free(document->retired_entries);
+    free(document->scratch);
+    free(document->source);
+    free_parse_context(&(document->context));
+}
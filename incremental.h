@@ -0,0 +1,181 @@
+/**
+ * \file                                incremental.h
+ * \brief                               Incremental parsing include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "ast.h"
+#include "pars_utils.h"
+#include "rules.h"
+#include "symbol_table.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Span struct
+ * \note                                This structure defines the part of a document holding one top-level declaration
+ *                                      together with the blanks and comments in front of it; a span ends with the
+ *                                      semicolon or the closing brace of its declaration, the last one with the document
+ */
+typedef struct span {
+    size_t start;                           /*!< Offset of first byte of span */
+    size_t length;                          /*!< Number of bytes of span */
+    unsigned first_line;                    /*!< Line of first byte of span */
+    unsigned first_column;                  /*!< Column of first byte of span */
+    unsigned num_of_line_breaks;            /*!< Number of line breaks within span */
+    unsigned last_line_length;              /*!< Number of bytes behind last line break (or of span without one) */
+    bool has_tokens;                        /*!< Whether span holds more than blanks and comments */
+    bool is_parsed;                         /*!< Whether span was parsed (blank spans are only if they are alone) */
+    bool is_dirty;                          /*!< Whether span is to be reparsed */
+    node_t **stmt_nodes;                    /*!< Array of top-level nodes of span (owned by the AST arena) */
+    unsigned num_of_stmts;                  /*!< Number of top-level nodes of span */
+    entry_t *first_entry;                   /*!< First symbol table entry declared within span */
+    entry_t *last_entry;                    /*!< Last symbol table entry declared within span */
+    lookup_log_t lookup_log;                /*!< Appearances of global identifiers (lines relative to first line) */
+    diagnostic_t *diagnostics;              /*!< Array of errors reported while parsing span */
+    unsigned num_of_diagnostics;            /*!< Number of errors reported while parsing span */
+} span_t;
+
+/**
+ * \brief                               Document struct
+ * \note                                This structure defines a source code that is kept parsed across edits; an edit
+ *                                      reparses the spans it touches and those spans after it which depend on symbols
+ *                                      whose declaration changed, and splices their nodes into the root node
+ */
+typedef struct document {
+    parse_context_t context;                /*!< Parse context owning symbol table, AST and diagnostics */
+    stmt_list_node_t root;                  /*!< Root node of the AST (statement list owned by the document) */
+    unsigned stmts_capacity;                /*!< Number of top-level nodes the statement list can hold */
+    char *source;                           /*!< Source code followed by `MAPPED_FILE_PADDING` null bytes */
+    size_t size;                            /*!< Number of bytes of source code */
+    size_t capacity;                        /*!< Number of bytes the source buffer can hold */
+    char *scratch;                          /*!< Buffer a span is copied to for scanning it */
+    size_t scratch_capacity;                /*!< Number of bytes the scratch buffer can hold */
+    span_t *spans;                          /*!< Array of spans in source order */
+    unsigned num_of_spans;                  /*!< Number of spans */
+    unsigned spans_capacity;                /*!< Number of spans the array can hold */
+    entry_t **retired_entries;              /*!< Global entries of reparsed spans that may be taken over again */
+    unsigned num_of_retired_entries;        /*!< Number of retired entries */
+    unsigned num_of_settled_entries;        /*!< Number of retired entries that can no longer be taken over */
+    unsigned retired_capacity;              /*!< Number of retired entries the array can hold */
+    const char *changed_names[MAX_NUM_OF_CHANGED_SYMBOLS];  /*!< Names of symbols whose declaration changed */
+    unsigned num_of_changed_names;          /*!< Number of names of changed symbols */
+    size_t num_of_reparsed_bytes;           /*!< Number of bytes reparsed since the last full parse */
+} document_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Open document by parsing source code span by span
+ * \note                                The source code is copied; like after parse_buffer(), the diagnostics of the
+ *                                      parse context describe all errors and its root points to the AST, which also
+ *                                      holds the declarations that were parsed successfully if there are errors
+ * \param[out]                          document: Pointer to document
+ * \param[in]                           source: Source code
+ * \param[in]                           size: Number of bytes of source code
+ * \return                              Whether parsing was successful
+ */
+bool open_document(document_t *document, const char *source, size_t size);
+
+/**
+ * \brief                               Replace a byte range of the source code of document and reparse what it affects
+ * \note                                Falls back to a full parse if the edit changes a global quantum variable that is
+ *                                      referenced elsewhere, if more than `MAX_NUM_OF_CHANGED_SYMBOLS` symbols change or
+ *                                      once the bytes reparsed since the last full parse exceed the size of the source
+ *                                      code (which bounds the nodes left behind in the AST arena); an edit range out of
+ *                                      bounds leaves the document untouched and is reported as error
+ * \param[in,out]                       document: Pointer to opened document
+ * \param[in]                           start: Offset of first replaced byte
+ * \param[in]                           end: Offset behind last replaced byte
+ * \param[in]                           text: Replacement
+ * \param[in]                           length: Number of bytes of replacement
+ * \return                              Whether parsing the edited source code was successful
+ */
+bool edit_document(document_t *document, size_t start, size_t end, const char *text, size_t length);
+
+/**
+ * \brief                               Free everything owned by document
+ * \param[in,out]                       document: Pointer to opened document
+ */
+void free_document(document_t *document);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* INCREMENTAL_H */
@@ -0,0 +1,143 @@
+/**
+ * \file                                intern.c
+ * \brief                               Identifier interning source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "intern.h"
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/* See header for documentation */
+void init_intern_table(intern_table_t *intern_table) {
+    init_arena(&(intern_table->arena));
+    intern_table->buckets = NULL;
+    intern_table->capacity = 0;
+    intern_table->num_of_interned_strs = 0;
+}
+
+/* See header for documentation */
+void free_intern_table(intern_table_t *intern_table) {
+    free_arena(&(intern_table->arena));
+    free(intern_table->buckets);
+    init_intern_table(intern_table);
+}
+
+/* See header for documentation */
+unsigned hash_str(const char *str, unsigned length) {
+    unsigned hash_value = 2166136261u;
+    for (unsigned i = 0; i < length; ++i) {
+        hash_value ^= (unsigned char) str[i];
+        hash_value *= 16777619u;
+    }
+    return hash_value;
+}
+
+/**
+ * \brief                               Double number of buckets of intern table and redistribute interned strings
+ * \param[in,out]                       intern_table: Pointer to intern table
+ * \return                              Whether resizing the intern table was successful
+ */
+static bool resize_intern_table(intern_table_t *intern_table) {
+    unsigned new_capacity = (intern_table->capacity == 0) ? INITIAL_INTERN_TABLE_SIZE : 2 * intern_table->capacity;
+    interned_str_t **new_buckets = calloc(new_capacity, sizeof (interned_str_t *));
+    if (new_buckets == NULL) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < intern_table->capacity; ++i) {
+        interned_str_t *interned_str = intern_table->buckets[i];
+        while (interned_str != NULL) {
+            interned_str_t *next_interned_str = interned_str->next;
+            interned_str->next = new_buckets[interned_str->hash & (new_capacity - 1)];
+            new_buckets[interned_str->hash & (new_capacity - 1)] = interned_str;
+            interned_str = next_interned_str;
+        }
+    }
+    free(intern_table->buckets);
+    intern_table->buckets = new_buckets;
+    intern_table->capacity = new_capacity;
+    return true;
+}
+
+/* See header for documentation */
+const interned_str_t *intern(intern_table_t *intern_table, const char *str, unsigned length) {
+    unsigned hash_value = hash_str(str, length);
+    if (intern_table->capacity != 0) {
+        interned_str_t *interned_str = intern_table->buckets[hash_value & (intern_table->capacity - 1)];
+        while (interned_str != NULL) {
+            if (interned_str->hash == hash_value && interned_str->length == length
+                && memcmp(interned_str->str, str, length) == 0) {
+                return interned_str;
+            }
+            interned_str = interned_str->next;
+        }
+    }
+
+    if (4 * (intern_table->num_of_interned_strs + 1) > 3 * intern_table->capacity
+        && !resize_intern_table(intern_table)) {
+        return NULL;
+    }
+
+    interned_str_t *new_interned_str = alloc_from_arena(&(intern_table->arena), sizeof (interned_str_t) + length + 1);
+    if (new_interned_str == NULL) {
+        return NULL;
+    }
+
+    char *chars = (char *) (new_interned_str + 1);
+    memcpy(chars, str, length);
+    chars[length] = '\0';
+    new_interned_str->str = chars;
+    new_interned_str->length = length;
+    new_interned_str->hash = hash_value;
+    new_interned_str->next = intern_table->buckets[hash_value & (intern_table->capacity - 1)];
+    intern_table->buckets[hash_value & (intern_table->capacity - 1)] = new_interned_str;
+    ++(intern_table->num_of_interned_strs);
+    return new_interned_str;
+}
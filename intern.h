@@ -0,0 +1,144 @@
+/**
+ * \file                                intern.h
+ * \brief                               Identifier interning include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include "arena.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Interned string struct
+ * \note                                This structure defines the unique handle of a string; two handles are equal if and
+ *                                      only if their strings are equal, so handles may be compared by pointer
+ */
+typedef struct interned_str {
+    const char *str;                        /*!< Null-terminated characters of string */
+    unsigned length;                        /*!< Length of string */
+    unsigned hash;                          /*!< Full hash value of string */
+    struct interned_str *next;              /*!< Pointer to next interned string in the same bucket */
+} interned_str_t;
+
+/**
+ * \brief                               Intern table struct
+ * \note                                This structure defines a hash table of interned strings
+ */
+typedef struct intern_table {
+    arena_t arena;                          /*!< Arena owning all handles and characters of interned strings */
+    interned_str_t **buckets;               /*!< Bucket array */
+    unsigned capacity;                      /*!< Number of buckets (zero or a power of two) */
+    unsigned num_of_interned_strs;          /*!< Number of interned strings */
+} intern_table_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Initialize empty intern table at a given address
+ * \param[out]                          intern_table: Address of intern table to be initialized
+ */
+void init_intern_table(intern_table_t *intern_table);
+
+/**
+ * \brief                               Free intern table including all strings interned so far
+ * \note                                Every handle obtained from the intern table before the call becomes invalid
+ * \param[in,out]                       intern_table: Pointer to intern table to be freed
+ */
+void free_intern_table(intern_table_t *intern_table);
+
+/**
+ * \brief                               Calculate 32-bit FNV-1a hash value of string
+ * \param[in]                           str: String (need not be null-terminated)
+ * \param[in]                           length: Length of string
+ * \return                              Hash value of input string
+ */
+unsigned hash_str(const char *str, unsigned length);
+
+/**
+ * \brief                               Return the unique handle of a string, interning the string if necessary
+ * \param[in,out]                       intern_table: Pointer to intern table
+ * \param[in]                           str: String (need not be null-terminated)
+ * \param[in]                           length: Length of string
+ * \return                              Pointer to handle of string or `NULL` upon failure
+ */
+const interned_str_t *intern(intern_table_t *intern_table, const char *str, unsigned length);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* INTERN_H */
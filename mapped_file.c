@@ -0,0 +1,108 @@
+/**
+ * \file                                mapped_file.c
+ * \brief                               Memory-mapped file source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/* See header for documentation */
+bool map_file(mapped_file_t *mapped_file, const char *file_name, char error_msg[ERROR_MSG_LENGTH]) {
+    int fd = open(file_name, O_RDONLY);
+    if (fd == -1) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Could not open %s", file_name);
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1 || !S_ISREG(file_stat.st_mode)) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "%s is not a regular file", file_name);
+        close(fd);
+        return false;
+    }
+
+    /* reserve zero-filled pages covering content and padding, then place the file at their start */
+    size_t file_size = (size_t) file_stat.st_size;
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    size_t mapping_size = (file_size + MAPPED_FILE_PADDING + page_size - 1) / page_size * page_size;
+    char *mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Mapping %s failed: %s", file_name, strerror(errno));
+        close(fd);
+        return false;
+    }
+    if (file_size > 0
+        && mmap(mapping, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Mapping %s failed: %s", file_name, strerror(errno));
+        munmap(mapping, mapping_size);
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    /* bytes behind the end of file on its last page are zero, the reserved pages behind it are anyway */
+    mapped_file->buffer = mapping;
+    mapped_file->size = file_size + MAPPED_FILE_PADDING;
+    mapped_file->mapping_size = mapping_size;
+    return true;
+}
+
+/* See header for documentation */
+void unmap_file(mapped_file_t *mapped_file) {
+    if (mapped_file->buffer != NULL) {
+        munmap(mapped_file->buffer, mapped_file->mapping_size);
+    }
+    mapped_file->buffer = NULL;
+    mapped_file->size = 0;
+    mapped_file->mapping_size = 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * \file                                mapped_file.h
+ * \brief                               Memory-mapped file include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Mapped file struct
+ * \note                                This structure defines a private, writable mapping of a file that is followed by
+ *                                      `MAPPED_FILE_PADDING` null bytes, as required for scanning it in place
+ */
+typedef struct mapped_file {
+    char *buffer;                           /*!< Pointer to first byte of file content */
+    size_t size;                            /*!< Number of bytes of buffer including the padding */
+    size_t mapping_size;                    /*!< Number of bytes of the whole mapping */
+} mapped_file_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Map file into memory
+ * \note                                Changes to the buffer are private to the process and never reach the file
+ * \param[out]                          mapped_file: Address of mapped file to be set up
+ * \param[in]                           file_name: Name of file to be mapped
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether mapping the file was successful
+ */
+bool map_file(mapped_file_t *mapped_file, const char *file_name, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Unmap file from memory
+ * \param[in,out]                       mapped_file: Pointer to mapped file
+ */
+void unmap_file(mapped_file_t *mapped_file);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MAPPED_FILE_H */
@@ -45,21 +45,81 @@
 
 /*
  * =====================================================================================================================
- *                                                static variables
+ *                                                function definitions
  * =====================================================================================================================
  */
 
 /**
- * \brief                               Counter for loop depth (starts at `0`)
+ * \brief                               Resize a list array to a new capacity
+ * \note                                On failure, the list array is left untouched
+ * \param[in,out]                       array: Address of pointer to list array
+ * \param[in]                           capacity: New number of elements the list array can hold
+ * \param[in]                           element_size: Size of one element in bytes
+ * \return                              Whether resizing the list array was successful
  */
-static unsigned nested_loop_counter;
+static bool resize_list(void **array, unsigned capacity, size_t element_size) {
+    void *temp = realloc(*array, capacity * element_size);
+    if (temp == NULL) {
+        return false;
+    }
 
+    *array = temp;
+    return true;
+}
 
-/*
- * =====================================================================================================================
- *                                                function definitions
- * =====================================================================================================================
+/**
+ * \brief                               Make sure a list array can hold at least one element
+ * \note                                An array left behind by an earlier list at the same address is reused as is
+ * \param[in,out]                       array: Address of pointer to list array
+ * \param[in,out]                       capacity: Address of number of elements the list array can hold
+ * \param[in]                           element_size: Size of one element in bytes
+ * \return                              Whether the list array can hold at least one element
  */
+static bool reserve_list(void **array, unsigned *capacity, size_t element_size) {
+    if (*capacity > 0) {
+        return true;
+    }
+
+    *array = malloc(INITIAL_LIST_CAPACITY * element_size);
+    if (*array == NULL) {
+        return false;
+    }
+
+    *capacity = INITIAL_LIST_CAPACITY;
+    return true;
+}
+
+/**
+ * \brief                               Free the node array of a pooled statement list
+ * \param[in,out]                       element: Pointer to statement list
+ */
+static void free_stmt_list(void *element) {
+    free(((stmt_list_t *) element)->stmt_nodes);
+}
+
+/**
+ * \brief                               Free the node array of a pooled argument list
+ * \param[in,out]                       element: Pointer to argument list
+ */
+static void free_arg_list(void *element) {
+    free(((arg_list_t *) element)->args);
+}
+
+/**
+ * \brief                               Free the node array of a pooled else-if list
+ * \param[in,out]                       element: Pointer to else-if list
+ */
+static void free_else_if_list(void *element) {
+    free(((else_if_list_t *) element)->else_if_nodes);
+}
+
+/**
+ * \brief                               Free the node array of a pooled case list
+ * \param[in,out]                       element: Pointer to case list
+ */
+static void free_case_list(void *element) {
+    free(((case_list_t *) element)->case_nodes);
+}
 
 /* See header for documentation */
 bool setup_type_info(type_info_t *type_info, type_t type, char error_msg[ERROR_MSG_LENGTH]) {
@@ -70,12 +130,14 @@ bool setup_type_info(type_info_t *type_info, type_t type, char error_msg[ERROR_M
 
     type_info->qualifier = NONE_T;
     type_info->type = type;
+    type_info->shape = NULL;
     type_info->depth = 0;
     return true;
 }
 
 /* See header for documentation */
-bool append_to_type_info(type_info_t *type_info, node_t *node, char error_msg[ERROR_MSG_LENGTH]) {
+bool append_to_type_info(type_info_t *type_info, node_t *node, shape_table_t *shape_table,
+                         char error_msg[ERROR_MSG_LENGTH]) {
     if (type_info == NULL || node == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for type information failed");
         return false;
@@ -103,29 +165,48 @@ bool append_to_type_info(type_info_t *type_info, node_t *node, char error_msg[ER
         return false;
     }
 
-    type_info->sizes[(type_info->depth)++] = ((const_node_t *) node)->values[0].u_val;
+    unsigned sizes[MAX_ARRAY_DEPTH];
+    if (type_info->shape != NULL) {
+        memcpy(sizes, type_info->shape->sizes, type_info->depth * sizeof (unsigned));
+    }
+    sizes[type_info->depth] = ((const_node_t *) node)->values[0].u_val;
+    const shape_t *shape = intern_shape(shape_table, sizes, type_info->depth + 1);
+    if (shape == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Interning shape of type information failed");
+        return false;
+    }
+
+    type_info->shape = shape;
+    ++(type_info->depth);
     return true;
 }
 
 /* See header for documentation */
-bool setup_stmt_list(stmt_list_t *stmt_list, node_t *node, char error_msg[ERROR_MSG_LENGTH]) {
-    if (stmt_list == NULL || node == NULL) {
+bool setup_stmt_list(stmt_list_t *stmt_list, node_t *node, unsigned nested_loop_counter,
+                     char error_msg[ERROR_MSG_LENGTH]) {
+    if (stmt_list == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for statement list failed");
         return false;
-    } else if (nested_loop_counter == 0 && node->node_type == BREAK_NODE_T) {
+    } else if (node != NULL && nested_loop_counter == 0 && node->node_type == BREAK_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "There is no loop to break from");
         return false;
-    } else if (nested_loop_counter == 0 && node->node_type == CONTINUE_NODE_T) {
+    } else if (node != NULL && nested_loop_counter == 0 && node->node_type == CONTINUE_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "There is no loop to continue with");
         return false;
     }
 
-    stmt_list->stmt_nodes = malloc(sizeof (node_t *));
-    if (stmt_list->stmt_nodes == NULL) {
+    if (!reserve_list((void **) &(stmt_list->stmt_nodes), &(stmt_list->capacity), sizeof (node_t *))) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for statement list failed");
         return false;
     }
 
+    if (node == NULL) { /* statement dropped by error recovery */
+        stmt_list->is_unitary = true;
+        stmt_list->is_quantizable = true;
+        stmt_list->num_of_stmts = 0;
+        return true;
+    }
+
     stmt_list->stmt_nodes[0] = node;
     stmt_list->is_unitary = is_unitary(node);
     stmt_list->is_quantizable = is_quantizable(node);
@@ -134,10 +215,13 @@ bool setup_stmt_list(stmt_list_t *stmt_list, node_t *node, char error_msg[ERROR_
 }
 
 /* See header for documentation */
-bool append_to_stmt_list(stmt_list_t *stmt_list, node_t *node, char error_msg[ERROR_MSG_LENGTH]) {
-    if (stmt_list == NULL || node == NULL) {
+bool append_to_stmt_list(stmt_list_t *stmt_list, node_t *node, unsigned nested_loop_counter,
+                         char error_msg[ERROR_MSG_LENGTH]) {
+    if (stmt_list == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for statement list failed");
         return false;
+    } else if (node == NULL) { /* statement dropped by error recovery */
+        return true;
     } else if (nested_loop_counter == 0 && node->node_type == BREAK_NODE_T) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "There is no loop to break from");
         return false;
@@ -146,16 +230,16 @@ bool append_to_stmt_list(stmt_list_t *stmt_list, node_t *node, char error_msg[ER
         return false;
     }
 
-    unsigned current_num_of_stmt = (stmt_list->num_of_stmts)++;
-    node_t **temp = realloc(stmt_list->stmt_nodes, (current_num_of_stmt + 1) * sizeof (node_t *));
-    if (temp == NULL) {
-        free(stmt_list->stmt_nodes);
-        snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for statement list failed");
-        return false;
+    if (stmt_list->num_of_stmts == stmt_list->capacity) {
+        if (!resize_list((void **) &(stmt_list->stmt_nodes), 2 * stmt_list->capacity, sizeof (node_t *))) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for statement list failed");
+            return false;
+        }
+
+        stmt_list->capacity *= 2;
     }
 
-    stmt_list->stmt_nodes = temp;
-    stmt_list->stmt_nodes[current_num_of_stmt] = node;
+    stmt_list->stmt_nodes[(stmt_list->num_of_stmts)++] = node;
     stmt_list->is_unitary = stmt_list->is_unitary && is_unitary(node);
     stmt_list->is_quantizable = stmt_list->is_quantizable && is_quantizable(node);
     return true;
@@ -170,7 +254,6 @@ bool setup_empty_func_info(func_info_t *func_info, char error_msg[ERROR_MSG_LENG
 
     func_info->is_unitary = true;
     func_info->is_quantizable = true;
-    func_info->pars_type_info = NULL;
     func_info->num_of_pars = 0;
     return true;
 }
@@ -183,9 +266,8 @@ bool setup_func_info(func_info_t *func_info, type_info_t type_info, char error_m
     }
 
     func_info->is_unitary = true;
-    func_info->is_quantizable = type_info.qualifier != QUANTUM_T,
-    func_info->pars_type_info = malloc(sizeof (type_info_t));
-    if (func_info->pars_type_info == NULL) {
+    func_info->is_quantizable = type_info.qualifier != QUANTUM_T;
+    if (!reserve_list((void **) &(func_info->pars_type_info), &(func_info->capacity), sizeof (type_info_t))) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for function information failed");
         return false;
     }
@@ -202,16 +284,17 @@ bool append_to_func_info(func_info_t *func_info, type_info_t type_info, char err
         return false;
     }
 
-    unsigned current_num_of_pars = (func_info->num_of_pars)++;
-    type_info_t *temp = realloc(func_info->pars_type_info, (current_num_of_pars + 1) * sizeof (type_info_t));
-    if (temp == NULL) {
-        snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for function information failed");
-        free(func_info->pars_type_info);
-        return false;
+    if (func_info->num_of_pars == func_info->capacity) {
+        if (!resize_list((void **) &(func_info->pars_type_info), 2 * func_info->capacity, sizeof (type_info_t))) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for function information failed");
+            return false;
+        }
+
+        func_info->capacity *= 2;
     }
+
     func_info->is_quantizable = func_info->is_quantizable && type_info.qualifier != QUANTUM_T;
-    func_info->pars_type_info = temp;
-    func_info->pars_type_info[current_num_of_pars] = type_info;
+    func_info->pars_type_info[(func_info->num_of_pars)++] = type_info;
     return true;
 }
 
@@ -234,11 +317,14 @@ bool setup_init_info(init_info_t *init_info, bool is_init_list, node_t *node, ch
         }
 
         init_info->is_init_list = true;
-        init_info->qualified_types = malloc(sizeof (q_type_t));
-        init_info->values = malloc(sizeof (array_value_t));
-        if (init_info->qualified_types == NULL || init_info->values == NULL) {
-            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for initialization information failed");
-            return false;
+        if (init_info->capacity == 0) {
+            if (!resize_list((void **) &(init_info->qualified_types), INITIAL_LIST_CAPACITY, sizeof (q_type_t))
+                || !resize_list((void **) &(init_info->values), INITIAL_LIST_CAPACITY, sizeof (array_value_t))) {
+                snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for initialization information failed");
+                return false;
+            }
+
+            init_info->capacity = INITIAL_LIST_CAPACITY;
         }
 
         q_type_t qualified_type = { .qualifier=type_info.qualifier, .type=type_info.type };
@@ -280,21 +366,18 @@ bool append_to_init_info(init_info_t *init_info, node_t *node, char error_msg[ER
         value.node_value = node;
     }
     q_type_t qualified_type = { .qualifier=type_info.qualifier, .type=type_info.type };
-    unsigned current_length = (init_info->length)++;
-    q_type_t *temp_1 = realloc(init_info->qualified_types,
-                                     (current_length + 1) * sizeof (q_type_t));
-    array_value_t *temp_2 = realloc(init_info->values, (current_length + 1) * sizeof (array_value_t));
-    if (temp_1 == NULL || temp_2 == NULL) {
-        free(init_info->qualified_types);
-        free(init_info->values);
-        snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for initialization information failed");
-        return false;
+    if (init_info->length == init_info->capacity) {
+        if (!resize_list((void **) &(init_info->qualified_types), 2 * init_info->capacity, sizeof (q_type_t))
+            || !resize_list((void **) &(init_info->values), 2 * init_info->capacity, sizeof (array_value_t))) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for initialization information failed");
+            return false;
+        }
+
+        init_info->capacity *= 2;
     }
 
-    init_info->qualified_types = temp_1;
-    init_info->qualified_types[current_length] = qualified_type;
-    init_info->values = temp_2;
-    init_info->values[current_length] = value;
+    init_info->qualified_types[init_info->length] = qualified_type;
+    init_info->values[(init_info->length)++] = value;
     return true;
 }
 
@@ -362,8 +445,7 @@ bool setup_else_if_list(else_if_list_t *else_if_list, node_t *node, char error_m
         return false;
     }
 
-    else_if_list->else_if_nodes = malloc(sizeof (node_t *));
-    if (else_if_list->else_if_nodes == NULL) {
+    if (!reserve_list((void **) &(else_if_list->else_if_nodes), &(else_if_list->capacity), sizeof (node_t *))) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for else-if list failed");
         return false;
     }
@@ -380,16 +462,16 @@ bool append_to_else_if_list(else_if_list_t *else_if_list, node_t *node, char err
         return false;
     }
 
-    unsigned current_num_of_else_ifs = (else_if_list->num_of_else_ifs)++;
-    node_t **temp = realloc(else_if_list->else_if_nodes, (current_num_of_else_ifs + 1) * sizeof (type_info_t));
-    if (temp == NULL) {
-        snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for else-if list failed");
-        free(else_if_list->else_if_nodes);
-        return false;
+    if (else_if_list->num_of_else_ifs == else_if_list->capacity) {
+        if (!resize_list((void **) &(else_if_list->else_if_nodes), 2 * else_if_list->capacity, sizeof (node_t *))) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for else-if list failed");
+            return false;
+        }
+
+        else_if_list->capacity *= 2;
     }
 
-    else_if_list->else_if_nodes = temp;
-    else_if_list->else_if_nodes[current_num_of_else_ifs] = node;
+    else_if_list->else_if_nodes[(else_if_list->num_of_else_ifs)++] = node;
     return true;
 }
 
@@ -400,8 +482,7 @@ bool setup_case_list(case_list_t *case_list, node_t *node, char error_msg[ERROR_
         return false;
     }
 
-    case_list->case_nodes = malloc(sizeof (node_t *));
-    if (case_list->case_nodes == NULL) {
+    if (!reserve_list((void **) &(case_list->case_nodes), &(case_list->capacity), sizeof (node_t *))) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for case list failed");
         return false;
     }
@@ -418,16 +499,16 @@ bool append_to_case_list(case_list_t *case_list, node_t *node, char error_msg[ER
         return false;
     }
 
-    unsigned current_num_of_cases = (case_list->num_of_cases)++;
-    node_t **temp = realloc(case_list->case_nodes, (current_num_of_cases + 1) * sizeof (node_t *));
-    if (temp == NULL) {
-        free(case_list->case_nodes);
-        snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for case list failed");
-        return false;
+    if (case_list->num_of_cases == case_list->capacity) {
+        if (!resize_list((void **) &(case_list->case_nodes), 2 * case_list->capacity, sizeof (node_t *))) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for case list failed");
+            return false;
+        }
+
+        case_list->capacity *= 2;
     }
 
-    case_list->case_nodes = temp;
-    case_list->case_nodes[current_num_of_cases] = node;
+    case_list->case_nodes[(case_list->num_of_cases)++] = node;
     return true;
 }
 
@@ -438,8 +519,7 @@ bool setup_arg_list(arg_list_t *arg_list, node_t *node, char error_msg[ERROR_MSG
         return false;
     }
 
-    arg_list->args = malloc(sizeof (node_t *));
-    if (arg_list->args == NULL) {
+    if (!reserve_list((void **) &(arg_list->args), &(arg_list->capacity), sizeof (node_t *))) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for argument list failed");
         return false;
     }
@@ -456,27 +536,85 @@ bool append_to_arg_list(arg_list_t *arg_list, node_t *node, char error_msg[ERROR
         return false;
     }
 
-    unsigned current_num_of_args = (arg_list->num_of_args)++;
-    node_t **temp = realloc(arg_list->args, (current_num_of_args + 1) * sizeof (type_info_t));
-    if (temp == NULL) {
-        free(arg_list->args);
-        snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for argument list failed");
-        return false;
+    if (arg_list->num_of_args == arg_list->capacity) {
+        if (!resize_list((void **) &(arg_list->args), 2 * arg_list->capacity, sizeof (node_t *))) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for argument list failed");
+            return false;
+        }
+
+        arg_list->capacity *= 2;
     }
 
-    arg_list->args = temp;
-    arg_list->args[current_num_of_args] = node;
+    arg_list->args[(arg_list->num_of_args)++] = node;
     return true;
 }
 
 /* See header for documentation */
-void incr_nested_loop_counter() {
-    ++nested_loop_counter;
+void incr_nested_loop_counter(parse_context_t *context) {
+    ++(context->nested_loop_counter);
+}
+
+/* See header for documentation */
+void decr_nested_loop_counter(parse_context_t *context) {
+    --(context->nested_loop_counter);
+}
+
+/* See header for documentation */
+bool add_diagnostic(parse_context_t *context, unsigned line, unsigned column, const char *msg) {
+    if (context->num_of_diagnostics < MAX_NUM_OF_DIAGNOSTICS) {
+        diagnostic_t *diagnostic = context->diagnostics + (context->num_of_diagnostics)++;
+        diagnostic->line = line;
+        diagnostic->column = column;
+        snprintf(diagnostic->msg, ERROR_MSG_LENGTH, "%s", msg);
+    }
+
+    return context->num_of_diagnostics < MAX_NUM_OF_DIAGNOSTICS;
 }
 
 /* See header for documentation */
-void decr_nested_loop_counter() {
-    if (nested_loop_counter > 0) {
-        --nested_loop_counter;
+void fprint_diagnostics(FILE *output_file, const parse_context_t *context) {
+    for (unsigned i = 0; i < context->num_of_diagnostics; ++i) {
+        const diagnostic_t *diagnostic = context->diagnostics + i;
+        if (diagnostic->line == 0) {
+            fprintf(output_file, "%s\n", diagnostic->msg);
+        } else {
+            fprintf(output_file, "Parsing failed in line %u, column %u: %s\n", diagnostic->line, diagnostic->column,
+                    diagnostic->msg);
+        }
     }
 }
+
+/* See header for documentation */
+void init_parse_context(parse_context_t *context) {
+    memset(context, 0, sizeof (parse_context_t));
+    context->first_line = 1;
+    context->first_column = 1;
+    init_intern_table(&(context->intern_table));
+    init_shape_table(&(context->shape_table));
+    init_symbol_table(&(context->symbol_table));
+    init_arena(&(context->ast_arena));
+    init_pool_stack(&(context->stmt_list_stack), sizeof (stmt_list_t));
+    init_pool_stack(&(context->type_info_stack), sizeof (type_info_t));
+    init_pool_stack(&(context->access_info_stack), sizeof (access_info_t));
+    init_pool_stack(&(context->arg_list_stack), sizeof (arg_list_t));
+    init_pool_stack(&(context->else_if_list_stack), sizeof (else_if_list_t));
+    init_pool_stack(&(context->case_list_stack), sizeof (case_list_t));
+}
+
+/* See header for documentation */
+void free_parse_context(parse_context_t *context) {
+    free_pool_stack(&(context->stmt_list_stack), free_stmt_list);
+    free_pool_stack(&(context->type_info_stack), NULL);
+    free_pool_stack(&(context->access_info_stack), NULL);
+    free_pool_stack(&(context->arg_list_stack), free_arg_list);
+    free_pool_stack(&(context->else_if_list_stack), free_else_if_list);
+    free_pool_stack(&(context->case_list_stack), free_case_list);
+    free(context->func_info.pars_type_info);
+    free(context->init_info.qualified_types);
+    free(context->init_info.values);
+    free_symbol_table(&(context->symbol_table));
+    free_intern_table(&(context->intern_table));
+    free_shape_table(&(context->shape_table));
+    free_arena(&(context->ast_arena));
+    init_parse_context(context);
+}
@@ -49,7 +49,13 @@
  */
 
 #include <stdbool.h>
+#include <stdio.h>
 #include "ast.h"
+#include "arena.h"
+#include "intern.h"
+#include "pool_stack.h"
+#include "rules.h"
+#include "shape.h"
 #include "symbol_table.h"
 
 
@@ -75,6 +81,7 @@ typedef struct stmt_list {
     bool is_quantizable;
     node_t **stmt_nodes;
     unsigned num_of_stmts;
+    unsigned capacity;
 } stmt_list_t;
 
 /**
@@ -86,6 +93,7 @@ typedef struct func_info {
     bool is_quantizable;                    /*!< Whether function can be quantized */
     type_info_t *pars_type_info;            /*!< Type information of function parameters */
     unsigned num_of_pars;                   /*!< Number of function parameters */
+    unsigned capacity;                      /*!< Number of parameters the type information array can hold */
 } func_info_t;
 
 typedef struct access_info {
@@ -97,31 +105,69 @@ typedef struct access_info {
 
 typedef struct init_info {
     bool is_init_list;
-    union {
-        node_t *node;
-        struct {
-            q_type_t *qualified_types;
-            array_value_t *values;
-            unsigned length;
-        };
-    };
+    node_t *node;
+    q_type_t *qualified_types;
+    array_value_t *values;
+    unsigned length;
+    unsigned capacity;
 } init_info_t;
 
 typedef struct else_if_list {
     node_t **else_if_nodes;
     unsigned num_of_else_ifs;
+    unsigned capacity;
 } else_if_list_t;
 
 typedef struct case_list {
     node_t **case_nodes;
     unsigned num_of_cases;
+    unsigned capacity;
 } case_list_t;
 
 typedef struct arg_list {
     node_t **args;
     unsigned num_of_args;
+    unsigned capacity;
 } arg_list_t;
 
+/**
+ * \brief                               Diagnostic struct
+ * \note                                This structure records one error reported while parsing
+ */
+typedef struct diagnostic {
+    unsigned line;                          /*!< Line of the error (`0` if not tied to the input) */
+    unsigned column;                        /*!< Column of the error */
+    char msg[ERROR_MSG_LENGTH];             /*!< Error message */
+} diagnostic_t;
+
+/**
+ * \brief                               Parse context struct
+ * \note                                This structure owns everything a single parse allocates; independent contexts
+ *                                      may be used concurrently
+ */
+typedef struct parse_context {
+    intern_table_t intern_table;            /*!< Intern table of identifiers */
+    shape_table_t shape_table;              /*!< Shape table of array types */
+    symbol_table_t symbol_table;            /*!< Symbol table */
+    arena_t ast_arena;                      /*!< Arena owning all nodes and node arrays of the AST */
+    node_t *root;                           /*!< Root node of the AST (`NULL` until parsing succeeded) */
+    char error_msg[ERROR_MSG_LENGTH];       /*!< Message of the error currently being reported */
+    unsigned first_line;                    /*!< Line the input starts at (`1` unless a part of a file is parsed) */
+    unsigned first_column;                  /*!< Column the input starts at (`1` unless a part of a file is parsed) */
+    unsigned num_of_diagnostics;            /*!< Number of errors reported so far */
+    diagnostic_t diagnostics[MAX_NUM_OF_DIAGNOSTICS];               /*!< Errors in the order they were reported */
+    unsigned nested_loop_counter;           /*!< Counter for loop depth (starts at `0`) */
+    bool has_dropped_stmts;                 /*!< Whether error recovery dropped a statement of the defined function */
+    pool_stack_t stmt_list_stack;           /*!< Stack of statement lists under construction */
+    pool_stack_t type_info_stack;           /*!< Stack of type informations under construction */
+    pool_stack_t access_info_stack;         /*!< Stack of access informations under construction */
+    pool_stack_t arg_list_stack;            /*!< Stack of argument lists under construction */
+    pool_stack_t else_if_list_stack;        /*!< Stack of else-if lists under construction */
+    pool_stack_t case_list_stack;           /*!< Stack of case lists under construction */
+    func_info_t func_info;                  /*!< Function information of the function being defined */
+    init_info_t init_info;                  /*!< Initialization information of the variable being defined */
+} parse_context_t;
+
 
 /*
  * =====================================================================================================================
@@ -142,31 +188,39 @@ bool setup_type_info(type_info_t *type_info, type_t type, char error_msg[ERROR_M
  * \brief                               Append size to type information at a given address
  * \param[out]                          type_info: Address of type information
  * \param[in]                           node: Pointer to node carrying the appended size
+ * \param[in,out]                       shape_table: Pointer to shape table the extended shape is interned in
  * \param[out]                          error_msg: Message to be written in case of an error
  * \return                              Whether appending size to type information was successful
  */
-bool append_to_type_info(type_info_t *type_info, node_t *node, char error_msg[ERROR_MSG_LENGTH]);
+bool append_to_type_info(type_info_t *type_info, node_t *node, shape_table_t *shape_table,
+                         char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Setup statement list at a given address with node
  * \param[out]                          stmt_list: Address to setup the statement list at
- * \param[in]                           node: Pointer to initial statement node
+ * \note                                The array of an earlier statement list at this address is reused
+ * \param[in]                           node: Pointer to initial statement node (`NULL` for an empty list)
+ * \param[in]                           nested_loop_counter: Current loop depth
  * \param[out]                          error_msg: Message to be written in case of an error
  * \return                              Whether setting up the statement list was successful
  */
-bool setup_stmt_list(stmt_list_t *stmt_list, node_t *node, char error_msg[ERROR_MSG_LENGTH]);
+bool setup_stmt_list(stmt_list_t *stmt_list, node_t *node, unsigned nested_loop_counter,
+                     char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Append statement to statement list at a given address
  * \param[out]                          stmt_list: Address of statement list
- * \param[in]                           node: Pointer to appended statement node
+ * \param[in]                           node: Pointer to appended statement node (`NULL` to append nothing)
+ * \param[in]                           nested_loop_counter: Current loop depth
  * \param[out]                          error_msg: Message to be written in case of an error
  * \return                              Whether appending statement to statement list was successful
  */
-bool append_to_stmt_list(stmt_list_t *stmt_list, node_t *node, char error_msg[ERROR_MSG_LENGTH]);
+bool append_to_stmt_list(stmt_list_t *stmt_list, node_t *node, unsigned nested_loop_counter,
+                         char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Setup empty function information at a given address
+ * \note                                The array of an earlier function information at this address is reused
  * \param[out]                          func_info: Address to setup the empty function information at
  * \param[out]                          error_msg: Message to be written in case of an error
  * \return                              Whether setting up the empty function information was successful
@@ -175,6 +229,7 @@ bool setup_empty_func_info(func_info_t *func_info, char error_msg[ERROR_MSG_LENG
 
 /**
  * \brief                               Setup function information at a given address with return type information
+ * \note                                The array of an earlier function information at this address is reused
  * \param[out]                          func_info: Address to setup the function information at
  * \param[in]                           type_info: Return type information
  * \param[out]                          error_msg: Message to be written in case of an error
@@ -211,6 +266,7 @@ bool append_to_access_info(access_info_t *access_info, node_t *node, char error_
 
 /**
  * \brief                               Setup initialization information at a given address with node
+ * \note                                The arrays of an earlier initialization information at this address are reused
  * \param[out]                          init_info: Address to setup the initialization information at
  * \param[in]                           is_init_list: Whether initialization is given by an initializer list
  * \param[in]                           node: Pointer to node representing first value of initialization
@@ -230,6 +286,7 @@ bool append_to_init_info(init_info_t *init_info, node_t *node, char error_msg[ER
 
 /**
  * \brief                               Setup else-if list at a given address with node
+ * \note                                The array of an earlier else-if list at this address is reused
  * \param[out]                          else_if_list: Address to setup the else-if list at
  * \param[in]                           node: Pointer to node representing first else-if
  * \param[out]                          error_msg: Message to be written in case of an error
@@ -248,6 +305,7 @@ bool append_to_else_if_list(else_if_list_t *else_if_list, node_t *node, char err
 
 /**
  * \brief                               Setup case list at a given address with node
+ * \note                                The array of an earlier case list at this address is reused
  * \param[out]                          case_list: Address to setup the case list at
  * \param[in]                           node: Pointer to node representing first case
  * \param[out]                          error_msg: Message to be written in case of an error
@@ -266,6 +324,7 @@ bool append_to_case_list(case_list_t *case_list, node_t *node, char error_msg[ER
 
 /**
  * \brief                               Setup argument list at a given address with node
+ * \note                                The array of an earlier argument list at this address is reused
  * \param[out]                          arg_list: Address to setup the argument list at
  * \param[in]                           node: Pointer to node representing first argument
  * \param[out]                          error_msg: Message to be written in case of an error
@@ -284,13 +343,46 @@ bool append_to_arg_list(arg_list_t *arg_list, node_t *node, char error_msg[ERROR
 
 /**
  * \brief                               Increase nested-loop counter
+ * \param[in,out]                       context: Pointer to parse context
  */
-void incr_nested_loop_counter();
+void incr_nested_loop_counter(parse_context_t *context);
 
 /**
  * \brief                               Decrease nested-loop counter
+ * \param[in,out]                       context: Pointer to parse context
+ */
+void decr_nested_loop_counter(parse_context_t *context);
+
+/**
+ * \brief                               Record diagnostic in parse context
+ * \note                                Diagnostics beyond MAX_NUM_OF_DIAGNOSTICS are dropped
+ * \param[in,out]                       context: Pointer to parse context
+ * \param[in]                           line: Line of the error (`0` if not tied to the input)
+ * \param[in]                           column: Column of the error
+ * \param[in]                           msg: Error message
+ * \return                              Whether further diagnostics can be recorded
+ */
+bool add_diagnostic(parse_context_t *context, unsigned line, unsigned column, const char *msg);
+
+/**
+ * \brief                               Print all diagnostics of parse context, one per line
+ * \param[out]                          output_file: Pointer to output file
+ * \param[in]                           context: Pointer to parse context
+ */
+void fprint_diagnostics(FILE *output_file, const parse_context_t *context);
+
+/**
+ * \brief                               Initialize parse context
+ * \param[out]                          context: Pointer to parse context
+ */
+void init_parse_context(parse_context_t *context);
+
+/**
+ * \brief                               Free everything owned by parse context and reinitialize it
+ * \note                                Invalidates the AST and all symbol table entries and interned strings
+ * \param[in,out]                       context: Pointer to parse context
  */
-void decr_nested_loop_counter();
+void free_parse_context(parse_context_t *context);
 
 
 /*
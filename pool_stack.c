@@ -0,0 +1,114 @@
+/**
+ * \file                                pool_stack.c
+ * \brief                               Pool stack source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pool_stack.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/* See header for documentation */
+void init_pool_stack(pool_stack_t *stack, size_t element_size) {
+    stack->blocks = NULL;
+    stack->num_of_blocks = 0;
+    stack->capacity = 0;
+    stack->size = 0;
+    stack->element_size = element_size;
+}
+
+/* See header for documentation */
+void *push_to_pool_stack(pool_stack_t *stack, char error_msg[ERROR_MSG_LENGTH]) {
+    if (stack->size == MAX_POOL_STACK_SIZE) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Nesting exceeds the maximum of %u open lists", MAX_POOL_STACK_SIZE);
+        return NULL;
+    }
+
+    unsigned block_index = stack->size / POOL_STACK_BLOCK_SIZE;
+    if (block_index == stack->num_of_blocks) {
+        if (stack->num_of_blocks == stack->capacity) {
+            unsigned new_capacity = (stack->capacity == 0) ? INITIAL_LIST_CAPACITY : 2 * stack->capacity;
+            void **temp = realloc(stack->blocks, new_capacity * sizeof (void *));
+            if (temp == NULL) {
+                snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for pool stack failed");
+                return NULL;
+            }
+
+            stack->blocks = temp;
+            stack->capacity = new_capacity;
+        }
+
+        void *block = calloc(POOL_STACK_BLOCK_SIZE, stack->element_size);
+        if (block == NULL) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for pool stack block failed");
+            return NULL;
+        }
+
+        stack->blocks[(stack->num_of_blocks)++] = block;
+    }
+
+    unsigned element_index = (stack->size)++ % POOL_STACK_BLOCK_SIZE;
+    return (char *) stack->blocks[block_index] + element_index * stack->element_size;
+}
+
+/* See header for documentation */
+void pop_from_pool_stack(pool_stack_t *stack) {
+    --(stack->size);
+}
+
+/* See header for documentation */
+void free_pool_stack(pool_stack_t *stack, void (*free_element)(void *element)) {
+    for (unsigned i = 0; i < stack->num_of_blocks; ++i) {
+        if (free_element != NULL) {
+            for (unsigned j = 0; j < POOL_STACK_BLOCK_SIZE; ++j) {
+                free_element((char *) stack->blocks[i] + j * stack->element_size);
+            }
+        }
+        free(stack->blocks[i]);
+    }
+    free(stack->blocks);
+    init_pool_stack(stack, stack->element_size);
+}
@@ -0,0 +1,139 @@
+/**
+ * \file                                pool_stack.h
+ * \brief                               Pool stack include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef POOL_STACK_H
+#define POOL_STACK_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stddef.h>
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Pool stack struct
+ * \note                                This structure defines a stack of equally sized elements that are allocated in
+ *                                      blocks of POOL_STACK_BLOCK_SIZE elements; elements never move, so pointers to
+ *                                      them stay valid while the stack grows, and popped elements keep their contents
+ *                                      for reuse by the next push
+ */
+typedef struct pool_stack {
+    void **blocks;                          /*!< Array of pointers to blocks */
+    unsigned num_of_blocks;                 /*!< Number of allocated blocks */
+    unsigned capacity;                      /*!< Number of block pointers the block array can hold */
+    unsigned size;                          /*!< Number of elements in use */
+    size_t element_size;                    /*!< Size of one element in bytes */
+} pool_stack_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Initialize empty pool stack at a given address
+ * \param[out]                          stack: Address of pool stack to be initialized
+ * \param[in]                           element_size: Size of one element in bytes
+ */
+void init_pool_stack(pool_stack_t *stack, size_t element_size);
+
+/**
+ * \brief                               Push element onto pool stack and return pointer to it
+ * \note                                A new element is zero-initialized, a reused one keeps the contents it was
+ *                                      popped with
+ * \param[in,out]                       stack: Pointer to pool stack
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Pointer to pushed element or `NULL` if the stack would exceed
+ *                                      MAX_POOL_STACK_SIZE elements or allocating memory failed
+ */
+void *push_to_pool_stack(pool_stack_t *stack, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Pop topmost element from pool stack
+ * \param[in,out]                       stack: Pointer to non-empty pool stack
+ */
+void pop_from_pool_stack(pool_stack_t *stack);
+
+/**
+ * \brief                               Free all blocks of pool stack and reinitialize it
+ * \param[in,out]                       stack: Pointer to pool stack to be freed
+ * \param[in]                           free_element: Function releasing what an element owns, called for every element
+ *                                      ever pushed (may be `NULL`)
+ */
+void free_pool_stack(pool_stack_t *stack, void (*free_element)(void *element));
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* POOL_STACK_H */
@@ -59,16 +59,39 @@ extern "C" {
  * =====================================================================================================================
  */
 
+#define PARSER_VERSION "1.0.1"
 #define MAX_TOKEN_LENGTH 40
-#define MAX_ARRAY_DEPTH 3
+#define MAX_ARRAY_DEPTH 8
 #define ERROR_MSG_LENGTH 256
-#define SYMBOL_TABLE_SIZE 211
-#define MAX_NUM_OF_STMT_LISTS 128
-#define MAX_NUM_OF_TYPE_INFOS 128
-#define MAX_NUM_OF_ARRAY_INFOS 128
-#define MAX_NUM_OF_ARG_LISTS 128
-#define MAX_NUM_OF_ELSE_IF_LISTS 128
-#define MAX_NUM_OF_CASE_LISTS 128
+#define INITIAL_SYMBOL_TABLE_SIZE 256
+#define INITIAL_INTERN_TABLE_SIZE 256
+#define INITIAL_SHAPE_TABLE_SIZE 64
+#define POOL_STACK_BLOCK_SIZE 64
+#define MAX_POOL_STACK_SIZE 1000000
+#define MAX_PARSE_STACK_DEPTH 10000000
+#define ARENA_BLOCK_SIZE 65536
+#define ARENA_ALIGNMENT _Alignof(void *)
+#define INITIAL_LIST_CAPACITY 4
+#define INITIAL_WALK_STACK_SIZE 64
+#define INITIAL_AST_IMAGE_SIZE 65536
+#define INITIAL_OBJECT_MAP_SIZE 1024
+#define MAX_TREE_DUMP_INDENTATION 64
+#define MAX_NUM_OF_JOBS 256
+#define MAPPED_FILE_PADDING 2
+#define MAX_NUM_OF_DIAGNOSTICS 32
+#define MAX_REQUEST_SIZE 268435456
+#define MAX_NUM_OF_CHANGED_SYMBOLS 64
+#define MAX_NUM_OF_QUBITS 30
+#define QUANTUM_BOOL_WIDTH 1
+#define QUANTUM_INT_WIDTH 8
+#define MAX_NUM_OF_THREADS 64
+#define MIN_PARTITION_SIZE 4096
+#define INITIAL_SPARSE_MAP_SIZE 64
+#define SPARSE_TO_DENSE_RATIO 8
+#define MIN_SPARSE_PROBABILITY 1e-30
+#define INITIAL_BYTECODE_SIZE 256
+#define MAX_CALL_DEPTH 100000
+#define MAX_NUM_OF_HOISTED_CONSTANTS 32
 
 
 /*
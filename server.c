@@ -0,0 +1,402 @@
+/**
+ * \file                                server.c
+ * \brief                               Parse server source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "cq_parser.h"
+#include "incremental.h"
+#include "server.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Response struct
+ * \note                                This structure defines the text sections of a response under construction
+ */
+typedef struct response {
+    char *sections[NUM_OF_RESPONSE_SECTIONS];   /*!< Diagnostics, symbol table dump and tree dump */
+    size_t sizes[NUM_OF_RESPONSE_SECTIONS]; /*!< Lengths of sections */
+} response_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Decode little-endian 32-bit integer
+ * \param[in]                           bytes: Encoded integer
+ * \return                              Decoded integer
+ */
+static uint32_t decode_u32(const unsigned char bytes[4]) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+/**
+ * \brief                               Encode little-endian 32-bit integer
+ * \param[out]                          bytes: Encoded integer
+ * \param[in]                           value: Integer to be encoded
+ */
+static void encode_u32(unsigned char bytes[4], uint32_t value) {
+    bytes[0] = (unsigned char) value;
+    bytes[1] = (unsigned char) (value >> 8);
+    bytes[2] = (unsigned char) (value >> 16);
+    bytes[3] = (unsigned char) (value >> 24);
+}
+
+/**
+ * \brief                               Read exactly a number of bytes from a file descriptor
+ * \param[in]                           fd: File descriptor
+ * \param[out]                          buffer: Buffer to be filled
+ * \param[in]                           size: Number of bytes to be read
+ * \param[out]                          at_end: Whether the input ended before the first byte
+ * \return                              Whether all bytes were read
+ */
+static bool read_fully(int fd, void *buffer, size_t size, bool *at_end) {
+    size_t num_of_read = 0;
+    while (num_of_read < size) {
+        ssize_t result = read(fd, (char *) buffer + num_of_read, size - num_of_read);
+        if (result == -1 && errno == EINTR) {
+            continue;
+        } else if (result <= 0) {
+            *at_end = result == 0 && num_of_read == 0;
+            return false;
+        }
+        num_of_read += (size_t) result;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Write exactly a number of bytes to a file descriptor
+ * \param[in]                           fd: File descriptor
+ * \param[in]                           buffer: Bytes to be written
+ * \param[in]                           size: Number of bytes to be written
+ * \return                              Whether all bytes were written
+ */
+static bool write_fully(int fd, const void *buffer, size_t size) {
+    size_t num_of_written = 0;
+    while (num_of_written < size) {
+        ssize_t result = write(fd, (const char *) buffer + num_of_written, size - num_of_written);
+        if (result == -1 && errno == EINTR) {
+            continue;
+        } else if (result <= 0) {
+            return false;
+        }
+        num_of_written += (size_t) result;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Write response to a file descriptor
+ * \param[in]                           fd: File descriptor
+ * \param[in]                           status: Response status
+ * \param[in]                           response: Pointer to response
+ * \return                              Whether the response was written
+ */
+static bool write_response(int fd, response_status_t status, const response_t *response) {
+    /* the response size counts the status and all sections with their lengths */
+    size_t size = 4;
+    for (unsigned i = 0; i < NUM_OF_RESPONSE_SECTIONS; ++i) {
+        size += 4 + response->sizes[i];
+    }
+    if (size > UINT32_MAX) {
+        return false;
+    }
+
+    unsigned char header[RESPONSE_HEADER_SIZE];
+    encode_u32(header, (uint32_t) size);
+    encode_u32(header + 4, (uint32_t) status);
+    if (!write_fully(fd, header, RESPONSE_HEADER_SIZE)) {
+        return false;
+    }
+    for (unsigned i = 0; i < NUM_OF_RESPONSE_SECTIONS; ++i) {
+        unsigned char length[4];
+        encode_u32(length, (uint32_t) response->sizes[i]);
+        if (!write_fully(fd, length, 4) || !write_fully(fd, response->sections[i], response->sizes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Parse source code of one request into document and write the response
+ * \param[in,out]                       document: Pointer to document (replaced unless the request is an edit)
+ * \param[in,out]                       has_document: Address of flag whether document is open
+ * \param[in]                           body: Source code or, for edits, the edit range followed by the replacement
+ * \param[in]                           size: Number of bytes of body
+ * \param[in]                           options: Options of request
+ * \param[in]                           output_fd: File descriptor to write the response to
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the response was written
+ */
+static bool serve_request(document_t *document, bool *has_document, const char *body, size_t size, uint32_t options,
+                          int output_fd, char error_msg[ERROR_MSG_LENGTH]) {
+    bool success;
+    if (options & REQUEST_EDIT) {
+        success = edit_document(document, decode_u32((const unsigned char *) body),
+                                decode_u32((const unsigned char *) body + 4), body + 8, size - 8);
+    } else {
+        if (*has_document) {
+            free_document(document);
+        }
+        success = open_document(document, body, size);
+        *has_document = true;
+    }
+    parse_context_t *context = &(document->context);
+
+    response_t response = {{NULL}, {0}};
+    FILE *streams[NUM_OF_RESPONSE_SECTIONS];
+    bool has_streams = true;
+    for (unsigned i = 0; i < NUM_OF_RESPONSE_SECTIONS; ++i) {
+        streams[i] = open_memstream(response.sections + i, response.sizes + i);
+        has_streams = has_streams && streams[i] != NULL;
+    }
+    if (has_streams) {
+        if (success && !(options & REQUEST_DIAGNOSTICS_ONLY)) {
+            fprint_symbol_table(streams[1], &(context->symbol_table));
+            if ((options & REQUEST_TREE_DUMP) && !fprint_tree(streams[2], context->root, 0, context->error_msg)) {
+                fprintf(streams[0], "%s\n", context->error_msg);
+                success = false;
+            }
+        } else if (!success) {
+            fprint_diagnostics(streams[0], context);
+        }
+    }
+    for (unsigned i = 0; i < NUM_OF_RESPONSE_SECTIONS; ++i) {
+        if (streams[i] != NULL) {
+            fclose(streams[i]);
+        }
+    }
+
+    bool is_written = has_streams && write_response(output_fd, success ? PARSED_R : FAILED_R, &response);
+    for (unsigned i = 0; i < NUM_OF_RESPONSE_SECTIONS; ++i) {
+        free(response.sections[i]);
+    }
+    if (!is_written) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Writing response failed");
+    }
+    return is_written;
+}
+
+/**
+ * \brief                               Reject a malformed request with a diagnostic
+ * \param[in]                           output_fd: File descriptor to write the response to
+ * \param[in]                           msg: Diagnostic
+ */
+static void reject_request(int output_fd, const char *msg) {
+    char diagnostic[ERROR_MSG_LENGTH + 1];
+    snprintf(diagnostic, ERROR_MSG_LENGTH + 1, "%s\n", msg);
+    response_t response = {{diagnostic, "", ""}, {strlen(diagnostic), 0, 0}};
+    write_response(output_fd, REJECTED_R, &response);
+}
+
+/* See header for documentation */
+bool serve_stream(int input_fd, int output_fd, char error_msg[ERROR_MSG_LENGTH]) {
+    document_t *document = malloc(sizeof (document_t));
+    if (document == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for document failed");
+        return false;
+    }
+    bool has_document = false;
+
+    char *source = NULL;
+    size_t capacity = 0;
+    bool success = true;
+    while (success) {
+        /* the size is read on its own, since a malformed one need not be followed by options */
+        unsigned char header[REQUEST_HEADER_SIZE];
+        bool at_end = false;
+        if (!read_fully(input_fd, header, 4, &at_end)) {
+            if (!at_end) {
+                snprintf(error_msg, ERROR_MSG_LENGTH, "Request is truncated");
+                reject_request(output_fd, error_msg);
+            }
+            success = at_end;
+            break;
+        }
+
+        /* the request size counts the options and the source code (or the edit) */
+        uint32_t request_size = decode_u32(header);
+        if (request_size < 4 || request_size - 4 > MAX_REQUEST_SIZE) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Request of %u bytes is malformed", request_size);
+            reject_request(output_fd, error_msg);
+            success = false;
+            break;
+        } else if (!read_fully(input_fd, header + 4, REQUEST_HEADER_SIZE - 4, &at_end)) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Request of %u bytes is truncated", request_size);
+            reject_request(output_fd, error_msg);
+            success = false;
+            break;
+        }
+
+        uint32_t options = decode_u32(header + 4);
+        if ((options & REQUEST_EDIT) && request_size < 12) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Edit request of %u bytes is malformed", request_size);
+            reject_request(output_fd, error_msg);
+            success = false;
+            break;
+        } else if ((options & REQUEST_EDIT) && !has_document) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Edit request without a document");
+            reject_request(output_fd, error_msg);
+            success = false;
+            break;
+        }
+
+        size_t size = request_size - 4;
+        if (size + MAPPED_FILE_PADDING > capacity) {
+            size_t new_capacity = (capacity > 0) ? capacity : ARENA_BLOCK_SIZE;
+            while (size + MAPPED_FILE_PADDING > new_capacity) {
+                new_capacity *= 2;
+            }
+            char *new_source = realloc(source, new_capacity);
+            if (new_source == NULL) {
+                snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for request of %u bytes failed",
+                         request_size);
+                reject_request(output_fd, error_msg);
+                success = false;
+                break;
+            }
+            source = new_source;
+            capacity = new_capacity;
+        }
+        if (!read_fully(input_fd, source, size, &at_end)) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Request of %u bytes is truncated", request_size);
+            reject_request(output_fd, error_msg);
+            success = false;
+            break;
+        }
+        success = serve_request(document, &has_document, source, size, options, output_fd, error_msg);
+    }
+    if (has_document) {
+        free_document(document);
+    }
+    free(source);
+    free(document);
+    return success;
+}
+
+/**
+ * \brief                               Serve one connection and close it
+ * \param[in]                           arg: Socket of connection (cast to pointer)
+ * \return                              `NULL`
+ */
+static void *serve_connection(void *arg) {
+    int fd = (int) (intptr_t) arg;
+    char error_msg[ERROR_MSG_LENGTH];
+    if (!serve_stream(fd, fd, error_msg)) {
+        fprintf(stderr, "%s\n", error_msg);
+    }
+    close(fd);
+    return NULL;
+}
+
+/* See header for documentation */
+bool serve_socket(const char *socket_path, char error_msg[ERROR_MSG_LENGTH]) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof (address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof (address.sun_path)) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Socket path %s is too long", socket_path);
+        return false;
+    }
+    strcpy(address.sun_path, socket_path);
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd == -1) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Creating socket failed: %s", strerror(errno));
+        return false;
+    }
+    struct stat socket_stat;
+    if (lstat(socket_path, &socket_stat) == 0 && S_ISSOCK(socket_stat.st_mode)) {
+        unlink(socket_path);
+    }
+    if (bind(server_fd, (const struct sockaddr *) &address, sizeof (address)) == -1
+        || listen(server_fd, SOMAXCONN) == -1) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Listening on %s failed: %s", socket_path, strerror(errno));
+        close(server_fd);
+        return false;
+    }
+
+    /* a client closing its connection early must not terminate the server */
+    signal(SIGPIPE, SIG_IGN);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    for (;;) {
+        int client_fd = accept(server_fd, NULL, NULL);
+        if (client_fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Accepting connection on %s failed: %s", socket_path,
+                     strerror(errno));
+            break;
+        }
+
+        pthread_t thread;
+        if (pthread_create(&thread, &attr, serve_connection, (void *) (intptr_t) client_fd) != 0) {
+            serve_connection((void *) (intptr_t) client_fd);
+        }
+    }
+    pthread_attr_destroy(&attr);
+    close(server_fd);
+    return false;
+}
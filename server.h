@@ -0,0 +1,144 @@
+/**
+ * \file                                server.h
+ * \brief                               Parse server include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define REQUEST_TREE_DUMP 0x1u
+#define REQUEST_EDIT 0x2u
+#define REQUEST_DIAGNOSTICS_ONLY 0x4u
+#define REQUEST_HEADER_SIZE 8
+#define RESPONSE_HEADER_SIZE 8
+#define NUM_OF_RESPONSE_SECTIONS 3
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Response status enumeration
+ * \note                                Requests and responses are framed by little-endian 32-bit integers: a request is
+ *                                      its size (of everything behind the size), its options (`REQUEST_TREE_DUMP`,
+ *                                      `REQUEST_EDIT`, `REQUEST_DIAGNOSTICS_ONLY`) and the source code, or for edits
+ *                                      the start and end offset of the replaced range followed by the replacement; a
+ *                                      response is its size, its status and the diagnostics, the symbol table dump and
+ *                                      the tree dump, each preceded by its length (dumps are empty for requests of
+ *                                      diagnostics only, which spares editors the dumps on every keystroke)
+ */
+typedef enum response_status {
+    PARSED_R,                               /*!< Source code was parsed successfully */
+    FAILED_R,                               /*!< Source code was not parsed successfully (see diagnostics) */
+    REJECTED_R,                             /*!< Request was malformed or truncated; the server closes the connection */
+} response_status_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Serve parse requests read from one file descriptor until it is exhausted
+ * \note                                Every request but an edit replaces the document of the stream; an edit updates
+ *                                      it incrementally (see edit_document()) and is rejected if there is none yet
+ * \param[in]                           input_fd: File descriptor to read requests from
+ * \param[in]                           output_fd: File descriptor to write responses to
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether all requests were served until the end of input
+ */
+bool serve_stream(int input_fd, int output_fd, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Serve parse requests from clients of a Unix domain socket
+ * \note                                Every connection is served by its own thread (see serve_stream()); a stale
+ *                                      socket file of an earlier server is replaced; only returns if the server cannot
+ *                                      start or stops accepting connections
+ * \param[in]                           socket_path: Path of socket file
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              `false`
+ */
+bool serve_socket(const char *socket_path, char error_msg[ERROR_MSG_LENGTH]);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SERVER_H */
@@ -0,0 +1,167 @@
+/**
+ * \file                                shape.c
+ * \brief                               Array shape source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "intern.h"
+#include "rules.h"
+#include "shape.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/* See header for documentation */
+void init_shape_table(shape_table_t *shape_table) {
+    init_arena(&(shape_table->arena));
+    shape_table->buckets = NULL;
+    shape_table->capacity = 0;
+    shape_table->num_of_shapes = 0;
+}
+
+/* See header for documentation */
+void free_shape_table(shape_table_t *shape_table) {
+    free_arena(&(shape_table->arena));
+    free(shape_table->buckets);
+    init_shape_table(shape_table);
+}
+
+/**
+ * \brief                               Double number of buckets of shape table and redistribute shapes
+ * \param[in,out]                       shape_table: Pointer to shape table
+ * \return                              Whether resizing the shape table was successful
+ */
+static bool resize_shape_table(shape_table_t *shape_table) {
+    unsigned new_capacity = (shape_table->capacity == 0) ? INITIAL_SHAPE_TABLE_SIZE : 2 * shape_table->capacity;
+    shape_t **new_buckets = calloc(new_capacity, sizeof (shape_t *));
+    if (new_buckets == NULL) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < shape_table->capacity; ++i) {
+        shape_t *shape = shape_table->buckets[i];
+        while (shape != NULL) {
+            shape_t *next_shape = shape->next;
+            shape->next = new_buckets[shape->hash & (new_capacity - 1)];
+            new_buckets[shape->hash & (new_capacity - 1)] = shape;
+            shape = next_shape;
+        }
+    }
+    free(shape_table->buckets);
+    shape_table->buckets = new_buckets;
+    shape_table->capacity = new_capacity;
+    return true;
+}
+
+/* See header for documentation */
+const shape_t *intern_shape(shape_table_t *shape_table, const unsigned sizes[], unsigned depth) {
+    unsigned hash_value = hash_str((const char *) sizes, depth * sizeof (unsigned));
+    if (shape_table->capacity != 0) {
+        shape_t *shape = shape_table->buckets[hash_value & (shape_table->capacity - 1)];
+        while (shape != NULL) {
+            if (shape->hash == hash_value && shape->depth == depth
+                && memcmp(shape->sizes, sizes, depth * sizeof (unsigned)) == 0) {
+                return shape;
+            }
+            shape = shape->next;
+        }
+    }
+
+    const shape_t *inner = NULL;
+    if (depth > 1) {
+        inner = intern_shape(shape_table, sizes + 1, depth - 1);
+        if (inner == NULL) {
+            return NULL;
+        }
+    }
+
+    if (4 * (shape_table->num_of_shapes + 1) > 3 * shape_table->capacity && !resize_shape_table(shape_table)) {
+        return NULL;
+    }
+
+    shape_t *new_shape = alloc_from_arena(&(shape_table->arena), sizeof (shape_t) + depth * sizeof (unsigned));
+    if (new_shape == NULL) {
+        return NULL;
+    }
+
+    new_shape->depth = depth;
+    new_shape->hash = hash_value;
+    new_shape->inner = inner;
+    memcpy(new_shape->sizes, sizes, depth * sizeof (unsigned));
+    new_shape->next = shape_table->buckets[hash_value & (shape_table->capacity - 1)];
+    shape_table->buckets[hash_value & (shape_table->capacity - 1)] = new_shape;
+    ++(shape_table->num_of_shapes);
+    return new_shape;
+}
+
+/* See header for documentation */
+const shape_t *get_inner_shape(const shape_t *shape, unsigned num_of_indices) {
+    for (unsigned i = 0; i < num_of_indices; ++i) {
+        shape = shape->inner;
+    }
+    return shape;
+}
+
+/* See header for documentation */
+unsigned get_shape_length(const shape_t *shape) {
+    unsigned result = 1;
+    if (shape != NULL) {
+        for (unsigned i = 0; i < shape->depth; ++i) {
+            result *= shape->sizes[i];
+        }
+    }
+    return result;
+}
+
+/* See header for documentation */
+unsigned get_mismatching_dimension(const shape_t *shape_a, const shape_t *shape_b) {
+    unsigned i = 0;
+    while (shape_a->sizes[i] == shape_b->sizes[i]) {
+        ++i;
+    }
+    return i;
+}
@@ -0,0 +1,163 @@
+/**
+ * \file                                shape.h
+ * \brief                               Array shape include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef SHAPE_H
+#define SHAPE_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include "arena.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Shape struct
+ * \note                                This structure defines the sizes of a non-scalar array; shapes are interned, so
+ *                                      two shapes are equal if and only if they are the same pointer, and scalars have
+ *                                      no shape (`NULL`)
+ */
+typedef struct shape {
+    unsigned depth;                         /*!< Number of dimensions (at least `1`) */
+    unsigned hash;                          /*!< Full hash value of sizes */
+    const struct shape *inner;              /*!< Pointer to shape without the outermost dimension (`NULL` if depth is
+                                                 `1`) */
+    struct shape *next;                     /*!< Pointer to next shape in the same bucket */
+    unsigned sizes[];                       /*!< Sizes of dimensions (outermost first) */
+} shape_t;
+
+/**
+ * \brief                               Shape table struct
+ * \note                                This structure defines a hash table of interned shapes
+ */
+typedef struct shape_table {
+    arena_t arena;                          /*!< Arena owning all shapes */
+    shape_t **buckets;                      /*!< Bucket array */
+    unsigned capacity;                      /*!< Number of buckets (zero or a power of two) */
+    unsigned num_of_shapes;                 /*!< Number of interned shapes */
+} shape_table_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Initialize empty shape table at a given address
+ * \param[out]                          shape_table: Address of shape table to be initialized
+ */
+void init_shape_table(shape_table_t *shape_table);
+
+/**
+ * \brief                               Free shape table including all shapes interned so far
+ * \note                                Every shape obtained from the shape table before the call becomes invalid
+ * \param[in,out]                       shape_table: Pointer to shape table to be freed
+ */
+void free_shape_table(shape_table_t *shape_table);
+
+/**
+ * \brief                               Return the unique shape of the given sizes, interning it if necessary
+ * \note                                All inner shapes are interned as well
+ * \param[in,out]                       shape_table: Pointer to shape table
+ * \param[in]                           sizes: Array of sizes (outermost first)
+ * \param[in]                           depth: Number of sizes (at least `1`)
+ * \return                              Pointer to shape or `NULL` upon failure
+ */
+const shape_t *intern_shape(shape_table_t *shape_table, const unsigned sizes[], unsigned depth);
+
+/**
+ * \brief                               Return shape that remains after indexing the outermost dimensions
+ * \param[in]                           shape: Pointer to shape (`NULL` for scalars)
+ * \param[in]                           num_of_indices: Number of indexed dimensions (at most the depth of the shape)
+ * \return                              Pointer to remaining shape (`NULL` if nothing remains)
+ */
+const shape_t *get_inner_shape(const shape_t *shape, unsigned num_of_indices);
+
+/**
+ * \brief                               Calculate number of elements of an array of a given shape
+ * \param[in]                           shape: Pointer to shape (`NULL` for scalars)
+ * \return                              Product of all sizes (`1` for scalars)
+ */
+unsigned get_shape_length(const shape_t *shape);
+
+/**
+ * \brief                               Return first dimension in which two different shapes of equal depth differ
+ * \param[in]                           shape_a: Pointer to first shape
+ * \param[in]                           shape_b: Pointer to second shape
+ * \return                              Index of first mismatching dimension
+ */
+unsigned get_mismatching_dimension(const shape_t *shape_a, const shape_t *shape_b);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SHAPE_H */
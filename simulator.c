@@ -0,0 +1,2092 @@
+/**
+ * \file                                simulator.c
+ * \brief                               State vector simulator source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "shape.h"
+#include "simulator.h"
+#include "state_vector.h"
+#include "visitor.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Execution status enumeration
+ */
+typedef enum exec_status {
+    NORMAL_S,                               /*!< Statement completed normally */
+    BREAK_S,                                /*!< Statement executed a break */
+    CONTINUE_S,                             /*!< Statement executed a continue */
+    RETURN_S,                               /*!< Statement executed a return */
+    FAILURE_S,                              /*!< Statement could not be simulated */
+} exec_status_t;
+
+struct function_info;
+
+/**
+ * \brief                               Slot struct
+ * \note                                This structure defines the runtime storage of one symbol table entry; classical
+ *                                      values are stored in place, quantum values in the register starting at the
+ *                                      slot's first qubit
+ */
+typedef struct slot {
+    const entry_t *entry;                   /*!< Pointer to entry in the symbol table */
+    long long *values;                      /*!< Array of classical values (`NULL` for functions) */
+    unsigned first_qubit;                   /*!< First qubit of the register currently bound to a quantum variable */
+    unsigned own_first_qubit;               /*!< First qubit of the register allocated for a quantum variable */
+    bool is_parameter;                      /*!< Whether entry is a function parameter */
+    struct function_info *function;         /*!< Pointer to function information (`NULL` for variables) */
+} slot_t;
+
+/**
+ * \brief                               Function information struct
+ * \note                                This structure defines the frame of a function: its parameters followed by its
+ *                                      local variables in order of declaration
+ */
+typedef struct function_info {
+    const node_t *func_tail;                /*!< Pointer to function body (`NULL` until its definition is found) */
+    slot_t **locals;                        /*!< Array of slots of parameters and local variables */
+    unsigned num_of_locals;                 /*!< Number of parameters and local variables */
+    unsigned num_of_values;                 /*!< Number of classical values of parameters and local variables */
+    bool has_quantum_locals;                /*!< Whether a parameter or local variable is quantum */
+    unsigned num_of_activations;            /*!< Number of running calls of the function */
+    unsigned visit_mark;                    /*!< Mark of the last support computation visiting the function */
+} function_info_t;
+
+/**
+ * \brief                               Simulator struct
+ * \note                                Quantum-valued expressions are evaluated once per assignment of the qubits they
+ *                                      depend on (their support) while `is_tabulating` is set, with `basis` holding the
+ *                                      current assignment; quantum statements are executed under the control mask
+ */
+typedef struct simulator {
+    state_vector_t state;                   /*!< State vector */
+    slot_t *slots;                          /*!< Array of slots (one per symbol table entry) */
+    unsigned num_of_slots;                  /*!< Number of slots */
+    slot_t **slot_map;                      /*!< Open-addressing hash map from entries to slots */
+    unsigned slot_map_capacity;             /*!< Number of buckets of the slot map (a power of two) */
+    function_info_t *functions;             /*!< Array of function information */
+    slot_t **local_slots;                   /*!< Array backing the local slot arrays of all functions */
+    const control_mask_t *mask;             /*!< Current control mask (`NULL` outside of quantum control) */
+    unsigned control_call_depth;            /*!< Call depth at which the current control mask was entered */
+    unsigned control_scope;                 /*!< Scope at which the current control mask was entered */
+    unsigned control_loop_depth;            /*!< Loop depth at which the current control mask was entered */
+    unsigned call_depth;                    /*!< Number of running function calls */
+    unsigned scope;                         /*!< Scope of the executed statement */
+    unsigned loop_depth;                    /*!< Number of running loops of the current call */
+    bool is_tabulating;                     /*!< Whether an expression is evaluated for a single basis state */
+    size_t basis;                           /*!< Basis state quantum variables are read from while tabulating */
+    long long *return_values;               /*!< Array receiving the values returned by the current call */
+    const entry_t *function_entry;          /*!< Pointer to entry of the currently called function */
+    uint64_t random_state;                  /*!< State of the pseudo-random generator */
+    unsigned num_of_threads;                /*!< Number of worker threads requested for the state vector */
+    bool is_sparse;                         /*!< Whether the state vector starts sparse */
+    unsigned visit_mark;                    /*!< Mark of the current support computation */
+    char *error_msg;                        /*!< Message to be written in case of an error */
+} simulator_t;
+
+/**
+ * \brief                               Evaluation frame struct
+ * \note                                This structure defines an operator node whose operands are being evaluated
+ */
+typedef struct evaluation_frame {
+    const node_t *node;                     /*!< Pointer to operator node */
+    bool is_left_done;                      /*!< Whether the left operand has been evaluated (binary operators) */
+} evaluation_frame_t;
+
+/**
+ * \brief                               Support walk struct
+ * \note                                This structure defines the state of a support computation
+ */
+typedef struct support_walk {
+    simulator_t *sim;                       /*!< Pointer to simulator */
+    uint64_t support;                       /*!< Mask of qubits found so far */
+    bool is_in_callee;                      /*!< Whether the walk is inside the body of a called function */
+    bool has_failed;                        /*!< Whether walking a called function failed */
+} support_walk_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/* See header for documentation */
+unsigned get_type_width(type_t type) {
+    switch (type) {
+        case BOOL_T: {
+            return QUANTUM_BOOL_WIDTH;
+        }
+        case INT_T: case UNSIGNED_T: {
+            return QUANTUM_INT_WIDTH;
+        }
+        default: {
+            return 0;
+        }
+    }
+}
+
+static exec_status_t execute(simulator_t *sim, const node_t *node);
+static bool evaluate(simulator_t *sim, const node_t *node, long long *out);
+
+/**
+ * \brief                               Return next number of the pseudo-random generator (splitmix64)
+ * \param[in,out]                       sim: Pointer to simulator
+ * \return                              Uniformly distributed number in [0, 1)
+ */
+static double next_random(simulator_t *sim) {
+    uint64_t z = (sim->random_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return (double) (z >> 11) * 0x1.0p-53;
+}
+
+/**
+ * \brief                               Convert value to the representation of a type
+ * \note                                Booleans are `0` or `1`, integers and unsigned integers wrap around at 32 bits
+ * \param[in]                           type: Type of value
+ * \param[in]                           value: Value
+ * \return                              Converted value
+ */
+static long long normalize(type_t type, long long value) {
+    switch (type) {
+        case BOOL_T: {
+            return value != 0;
+        }
+        case INT_T: {
+            return (int32_t) (uint32_t) value;
+        }
+        default: {
+            return (uint32_t) value;
+        }
+    }
+}
+
+/**
+ * \brief                               Convert constant value of a type
+ * \param[in]                           type: Type of value
+ * \param[in]                           value: Constant value
+ * \return                              Converted value
+ */
+static long long from_value(type_t type, value_t value) {
+    switch (type) {
+        case BOOL_T: {
+            return value.b_val;
+        }
+        case INT_T: {
+            return value.i_val;
+        }
+        default: {
+            return value.u_val;
+        }
+    }
+}
+
+/**
+ * \brief                               Return number of flattened values of an expression
+ * \param[in]                           node: Pointer to expression node
+ * \return                              Number of values (`1` for scalars)
+ */
+static unsigned get_length_of_node(const node_t *node) {
+    type_info_t type_info;
+    if (!copy_type_info_of_node(&type_info, node)) {
+        return 1;
+    }
+    return get_shape_length(type_info.shape);
+}
+
+/**
+ * \brief                               Return type of an expression
+ * \param[in]                           node: Pointer to expression node
+ * \return                              Type of expression (`VOID_T` if the node is not an expression)
+ */
+static type_t get_type_of_node(const node_t *node) {
+    type_info_t type_info;
+    if (!copy_type_info_of_node(&type_info, node)) {
+        return VOID_T;
+    }
+    return type_info.type;
+}
+
+/**
+ * \brief                               Return mask of the qubits of a register
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \return                              Mask of qubits
+ */
+static uint64_t get_register_bits(unsigned first_qubit, unsigned width) {
+    return (((uint64_t) 1 << width) - 1) << first_qubit;
+}
+
+/**
+ * \brief                               Read register of given type from a basis state
+ * \param[in]                           basis: Basis state
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           type: Type of register
+ * \return                              Value of register (sign-extended for integers)
+ */
+static long long read_register(size_t basis, unsigned first_qubit, type_t type) {
+    unsigned width = get_type_width(type);
+    long long bits = (long long) ((basis >> first_qubit) & ((1ULL << width) - 1));
+    if (type == INT_T && (bits >> (width - 1) & 1) != 0) {
+        bits -= 1LL << width;
+    }
+    return bits;
+}
+
+/**
+ * \brief                               Find slot of symbol table entry
+ * \param[in]                           sim: Pointer to simulator
+ * \param[in]                           entry: Pointer to entry
+ * \return                              Pointer to slot or `NULL` if the entry is unknown
+ */
+static slot_t *find_slot(const simulator_t *sim, const entry_t *entry) {
+    unsigned bucket = (unsigned) (((uintptr_t) entry >> 4) * 0x9e3779b97f4a7c15ULL >> 32)
+                      & (sim->slot_map_capacity - 1);
+    while (sim->slot_map[bucket] != NULL) {
+        if (sim->slot_map[bucket]->entry == entry) {
+            return sim->slot_map[bucket];
+        }
+        bucket = (bucket + 1) & (sim->slot_map_capacity - 1);
+    }
+    return NULL;
+}
+
+/**
+ * \brief                               Insert slot into the slot map
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           slot: Pointer to slot
+ */
+static void insert_slot(simulator_t *sim, slot_t *slot) {
+    unsigned bucket = (unsigned) (((uintptr_t) slot->entry >> 4) * 0x9e3779b97f4a7c15ULL >> 32)
+                      & (sim->slot_map_capacity - 1);
+    while (sim->slot_map[bucket] != NULL) {
+        bucket = (bucket + 1) & (sim->slot_map_capacity - 1);
+    }
+    sim->slot_map[bucket] = slot;
+}
+
+/**
+ * \brief                               Create slots, function frames and registers for all symbol table entries
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           root: Pointer to root node of the program
+ * \param[in]                           symbol_table: Pointer to symbol table of the program
+ * \return                              Whether setting up the simulator was successful
+ */
+static bool setup_simulator(simulator_t *sim, const node_t *root, const symbol_table_t *symbol_table) {
+    unsigned num_of_entries = 0;
+    unsigned num_of_functions = 0;
+    for (const entry_t *entry = symbol_table->first_entry; entry != NULL; entry = entry->next_declared) {
+        ++num_of_entries;
+        num_of_functions += entry->is_function;
+    }
+
+    sim->slot_map_capacity = 1;
+    while (sim->slot_map_capacity < 2 * num_of_entries) {
+        sim->slot_map_capacity *= 2;
+    }
+    sim->slots = calloc(num_of_entries + 1, sizeof (slot_t));
+    sim->slot_map = calloc(sim->slot_map_capacity, sizeof (slot_t *));
+    sim->functions = calloc(num_of_functions + 1, sizeof (function_info_t));
+    sim->local_slots = calloc(num_of_entries + 1, sizeof (slot_t *));
+    if (sim->slots == NULL || sim->slot_map == NULL || sim->functions == NULL || sim->local_slots == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %u simulator slots failed", num_of_entries);
+        return false;
+    }
+
+    unsigned num_of_qubits = 0;
+    for (const entry_t *entry = symbol_table->first_entry; entry != NULL; entry = entry->next_declared) {
+        slot_t *slot = &(sim->slots[sim->num_of_slots++]);
+        slot->entry = entry;
+        insert_slot(sim, slot);
+        if (entry->is_function) {
+            continue;
+        }
+
+        slot->values = calloc(entry->length, sizeof (long long));
+        if (slot->values == NULL) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for values of %s failed", entry->name);
+            return false;
+        }
+        if (entry->qualifier == QUANTUM_T) {
+            unsigned num_of_entry_qubits = entry->length * get_type_width(entry->type);
+            if (num_of_qubits + num_of_entry_qubits > MAX_NUM_OF_QUBITS) {
+                snprintf(sim->error_msg, ERROR_MSG_LENGTH,
+                         "Quantum variable %s exceeds the limit of %u simulated qubits", entry->name,
+                         MAX_NUM_OF_QUBITS);
+                return false;
+            }
+            slot->own_first_qubit = num_of_qubits;
+            slot->first_qubit = num_of_qubits;
+            num_of_qubits += num_of_entry_qubits;
+        }
+    }
+
+    /* parameters and locals of a function are the entries declared after it up to the next global entry */
+    unsigned num_of_local_slots = 0;
+    function_info_t *function = sim->functions;
+    for (unsigned i = 0; i < sim->num_of_slots; ++i) {
+        if (!sim->slots[i].entry->is_function || sim->slots[i].entry->scope != 0) {
+            continue;
+        }
+
+        sim->slots[i].function = function;
+        function->locals = sim->local_slots + num_of_local_slots;
+        for (unsigned j = i + 1; j < sim->num_of_slots && sim->slots[j].entry->scope != 0; ++j) {
+            slot_t *local = &(sim->slots[j]);
+            local->is_parameter = function->num_of_locals < sim->slots[i].entry->num_of_pars;
+            function->locals[function->num_of_locals++] = local;
+            function->num_of_values += local->entry->length;
+            function->has_quantum_locals |= local->entry->qualifier == QUANTUM_T;
+        }
+        num_of_local_slots += function->num_of_locals;
+        ++function;
+    }
+
+    if (root != NULL && root->node_type == STMT_LIST_NODE_T) {
+        const stmt_list_node_t *stmt_list_node_view = (const stmt_list_node_t *) root;
+        for (unsigned i = 0; i < stmt_list_node_view->num_of_stmts; ++i) {
+            const node_t *stmt = stmt_list_node_view->stmt_list[i];
+            if (stmt != NULL && stmt->node_type == FUNC_DEF_NODE_T) {
+                const func_def_node_t *func_def_node_view = (const func_def_node_t *) stmt;
+                slot_t *slot = find_slot(sim, func_def_node_view->entry);
+                if (slot != NULL && slot->function != NULL) {
+                    slot->function->func_tail = func_def_node_view->func_tail;
+                }
+            }
+        }
+    }
+
+    return init_state_vector(&(sim->state), num_of_qubits, sim->num_of_threads, sim->is_sparse, sim->error_msg);
+}
+
+/**
+ * \brief                               Free slots, function frames and state vector of simulator
+ * \param[in,out]                       sim: Pointer to simulator
+ */
+static void free_simulator(simulator_t *sim) {
+    for (unsigned i = 0; i < sim->num_of_slots; ++i) {
+        free(sim->slots[i].values);
+    }
+    free(sim->slots);
+    free(sim->slot_map);
+    free(sim->functions);
+    free(sim->local_slots);
+    free_state_vector(&(sim->state));
+}
+
+/**
+ * \brief                               Add the qubits a reference reads to the support
+ * \param[in]                           node: Pointer to reference node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to support walk
+ * \return                              `CONTINUE_W` to walk the indices of the reference
+ */
+static walk_result_t visit_reference_for_support(node_t *node, size_t depth, void *data) {
+    (void) depth;
+    support_walk_t *walk = data;
+    const reference_node_t *reference_node_view = (const reference_node_t *) node;
+    const entry_t *entry = reference_node_view->entry;
+    slot_t *slot = find_slot(walk->sim, entry);
+    if (entry->qualifier != QUANTUM_T || slot == NULL || (walk->is_in_callee && slot->is_parameter)) {
+        return CONTINUE_W; /* parameters of callees are bound to the registers of the arguments */
+    }
+
+    unsigned index_depth = entry->depth - reference_node_view->type_info.depth;
+    unsigned offset = 0;
+    unsigned length = entry->length;
+    bool all_indices_const = true;
+    for (unsigned i = 0; i < index_depth; ++i) {
+        all_indices_const &= reference_node_view->index_is_const[i];
+        offset += reference_node_view->indices[i].const_index * get_shape_length(get_inner_shape(entry->shape, i + 1));
+    }
+    if (all_indices_const) {
+        length = get_shape_length(reference_node_view->type_info.shape);
+    } else {
+        offset = 0;
+    }
+
+    unsigned width = get_type_width(entry->type);
+    walk->support |= get_register_bits(slot->first_qubit + offset * width, length * width);
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Add the qubits read by the body of a called function to the support
+ * \param[in]                           node: Pointer to function call node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to support walk
+ * \return                              `CONTINUE_W` to walk the arguments, `SKIP_CHILDREN_W` for superposition calls
+ *                                      and `STOP_W` upon failure
+ */
+static walk_result_t visit_func_call_for_support(node_t *node, size_t depth, void *data);
+
+/**
+ * \brief                               Skip the children of a node in a support walk
+ * \note                                Measured quantities are classical afterwards, and the target of a phase change
+ *                                      or superposition is not read
+ * \param[in]                           node: Pointer to node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to support walk
+ * \return                              `SKIP_CHILDREN_W`
+ */
+static walk_result_t skip_for_support(node_t *node, size_t depth, void *data) {
+    (void) node;
+    (void) depth;
+    (void) data;
+    return SKIP_CHILDREN_W;
+}
+
+static const tree_pass_t support_pass = {
+    .pre_visitors = {
+        [REFERENCE_NODE_T] = visit_reference_for_support,
+        [FUNC_CALL_NODE_T] = visit_func_call_for_support,
+        [FUNC_SP_NODE_T] = skip_for_support,
+        [MEASURE_NODE_T] = skip_for_support,
+        [PHASE_NODE_T] = skip_for_support,
+    },
+};
+
+/* See declaration for documentation */
+static walk_result_t visit_func_call_for_support(node_t *node, size_t depth, void *data) {
+    support_walk_t *walk = data;
+    const func_call_node_t *func_call_node_view = (const func_call_node_t *) node;
+    if (func_call_node_view->sp) {
+        return SKIP_CHILDREN_W;
+    }
+
+    slot_t *slot = find_slot(walk->sim, func_call_node_view->entry);
+    function_info_t *function = (slot != NULL) ? slot->function : NULL;
+    if (function == NULL || function->func_tail == NULL || function->visit_mark == walk->sim->visit_mark) {
+        return CONTINUE_W;
+    }
+
+    function->visit_mark = walk->sim->visit_mark;
+    bool was_in_callee = walk->is_in_callee;
+    walk->is_in_callee = true;
+    if (!run_tree_pass(&support_pass, (node_t *) function->func_tail, depth + 1, walk, walk->sim->error_msg)) {
+        walk->has_failed = true;
+        return STOP_W;
+    }
+    walk->is_in_callee = was_in_callee;
+    return CONTINUE_W;
+}
+
+/**
+ * \brief                               Compute the qubits an expression depends on
+ * \note                                The bodies of called functions are included, except for reads of their
+ *                                      parameters, which are covered by the arguments
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to expression node
+ * \param[out]                          support: Mask of qubits the expression depends on
+ * \return                              Whether computing the support was successful
+ */
+static bool get_support(simulator_t *sim, const node_t *node, uint64_t *support) {
+    support_walk_t walk = {.sim = sim, .support = 0, .is_in_callee = false, .has_failed = false};
+    ++(sim->visit_mark);
+    if (!run_tree_pass(&support_pass, (node_t *) node, 0, &walk, sim->error_msg) || walk.has_failed) {
+        return false;
+    }
+    *support = walk.support;
+    return true;
+}
+
+/**
+ * \brief                               Evaluate expression for every assignment of the qubits of a domain
+ * \note                                The domain has to contain the support of the expression; the values for the
+ *                                      gathered assignment k are written to the k-th block of `length` values
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to expression node
+ * \param[in]                           domain: Mask of qubits the expression is evaluated for
+ * \param[in]                           length: Number of values of the expression
+ * \return                              Newly allocated table of values or `NULL` upon failure
+ */
+static long long *tabulate(simulator_t *sim, const node_t *node, uint64_t domain, unsigned length) {
+    size_t num_of_assignments = (size_t) 1 << __builtin_popcountll(domain);
+    long long *table = malloc(num_of_assignments * length * sizeof (long long));
+    if (table == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for %zu tabulated values failed",
+                 num_of_assignments * length);
+        return NULL;
+    }
+
+    sim->is_tabulating = true;
+    for (size_t k = 0; k < num_of_assignments; ++k) {
+        sim->basis = scatter_bits(k, domain);
+        if (!evaluate(sim, node, table + k * length)) {
+            sim->is_tabulating = false;
+            free(table);
+            return NULL;
+        }
+    }
+    sim->is_tabulating = false;
+    return table;
+}
+
+/**
+ * \brief                               Evaluate expression that must not depend on the quantum state
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to expression node
+ * \param[out]                          out: Array receiving the values of the expression
+ * \param[in]                           description: Description of the expression for error messages
+ * \return                              Whether evaluation was successful
+ */
+static bool evaluate_classical(simulator_t *sim, const node_t *node, long long *out, const char *description) {
+    if (!sim->is_tabulating) {
+        uint64_t support;
+        if (!get_support(sim, node, &support)) {
+            return false;
+        } else if (support != 0) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "%s depends on a quantum value", description);
+            return false;
+        }
+    }
+    return evaluate(sim, node, out);
+}
+
+/**
+ * \brief                               Apply integer operation with the wrap-around of the operands' types
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           op: Integer operator
+ * \param[in]                           left_type: Type of left operand
+ * \param[in]                           left: Value of left operand
+ * \param[in]                           right_type: Type of right operand
+ * \param[in]                           right: Value of right operand
+ * \param[out]                          out: Address receiving the result
+ * \return                              Whether the operation was defined
+ */
+static bool apply_integer_op(simulator_t *sim, integer_op_t op, type_t left_type, long long left, type_t right_type,
+                             long long right, long long *out) {
+    bool is_signed = left_type == INT_T && right_type == INT_T;
+    uint32_t left_bits = (uint32_t) left;
+    uint32_t right_bits = (uint32_t) right;
+    uint32_t result;
+    switch (op) {
+        case OR_OP: {
+            result = left_bits | right_bits;
+            break;
+        }
+        case XOR_OP: {
+            result = left_bits ^ right_bits;
+            break;
+        }
+        case AND_OP: {
+            result = left_bits & right_bits;
+            break;
+        }
+        case ADD_OP: {
+            result = left_bits + right_bits;
+            break;
+        }
+        case SUB_OP: {
+            result = left_bits - right_bits;
+            break;
+        }
+        case MUL_OP: {
+            result = left_bits * right_bits;
+            break;
+        }
+        case DIV_OP: case MOD_OP: {
+            if (right_bits == 0) {
+                snprintf(sim->error_msg, ERROR_MSG_LENGTH, (op == DIV_OP) ? "Division by zero" : "Modulo by zero");
+                return false;
+            }
+            if (!is_signed) {
+                result = (op == DIV_OP) ? left_bits / right_bits : left_bits % right_bits;
+            } else if ((int32_t) left_bits == INT32_MIN && (int32_t) right_bits == -1) {
+                result = (op == DIV_OP) ? left_bits : 0;
+            } else {
+                result = (uint32_t) ((op == DIV_OP) ? (int32_t) left_bits / (int32_t) right_bits
+                                                    : (int32_t) left_bits % (int32_t) right_bits);
+            }
+            break;
+        }
+        default: {
+            result = 0;
+            break;
+        }
+    }
+    *out = is_signed ? (long long) (int32_t) result : (long long) result;
+    return true;
+}
+
+/**
+ * \brief                               Apply binary operation of an operator node elementwise
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to logical, comparison, equality or integer operator node
+ * \param[in,out]                       left: Array of values of left operand, receiving the result
+ * \param[in]                           right: Array of values of right operand
+ * \param[in]                           length: Number of values
+ * \return                              Whether the operation was defined
+ */
+static bool apply_binary_op(simulator_t *sim, const node_t *node, long long *left, const long long *right,
+                            unsigned length) {
+    const node_t *left_node;
+    const node_t *right_node;
+    switch (node->node_type) {
+        case LOGICAL_OP_NODE_T: {
+            left_node = ((const logical_op_node_t *) node)->left;
+            right_node = ((const logical_op_node_t *) node)->right;
+            break;
+        }
+        case COMPARISON_OP_NODE_T: {
+            left_node = ((const comparison_op_node_t *) node)->left;
+            right_node = ((const comparison_op_node_t *) node)->right;
+            break;
+        }
+        case EQUALITY_OP_NODE_T: {
+            left_node = ((const equality_op_node_t *) node)->left;
+            right_node = ((const equality_op_node_t *) node)->right;
+            break;
+        }
+        default: {
+            left_node = ((const integer_op_node_t *) node)->left;
+            right_node = ((const integer_op_node_t *) node)->right;
+            break;
+        }
+    }
+    type_t left_type = get_type_of_node(left_node);
+    type_t right_type = get_type_of_node(right_node);
+    bool is_signed = left_type == INT_T && right_type == INT_T;
+
+    for (unsigned i = 0; i < length; ++i) {
+        long long l = left[i];
+        long long r = right[i];
+        long long signed_l = is_signed ? l : (long long) (uint32_t) l;
+        long long signed_r = is_signed ? r : (long long) (uint32_t) r;
+        switch (node->node_type) {
+            case LOGICAL_OP_NODE_T: {
+                switch (((const logical_op_node_t *) node)->op) {
+                    case LOR_OP: {
+                        left[i] = l || r;
+                        break;
+                    }
+                    case LXOR_OP: {
+                        left[i] = (l != 0) != (r != 0);
+                        break;
+                    }
+                    case LAND_OP: {
+                        left[i] = l && r;
+                        break;
+                    }
+                }
+                break;
+            }
+            case COMPARISON_OP_NODE_T: {
+                switch (((const comparison_op_node_t *) node)->op) {
+                    case GE_OP: {
+                        left[i] = signed_l > signed_r;
+                        break;
+                    }
+                    case GEQ_OP: {
+                        left[i] = signed_l >= signed_r;
+                        break;
+                    }
+                    case LE_OP: {
+                        left[i] = signed_l < signed_r;
+                        break;
+                    }
+                    case LEQ_OP: {
+                        left[i] = signed_l <= signed_r;
+                        break;
+                    }
+                }
+                break;
+            }
+            case EQUALITY_OP_NODE_T: {
+                bool is_equal = (left_type == BOOL_T) ? (l != 0) == (r != 0) : signed_l == signed_r;
+                left[i] = (((const equality_op_node_t *) node)->op == EQ_OP) ? is_equal : !is_equal;
+                break;
+            }
+            default: {
+                if (!apply_integer_op(sim, ((const integer_op_node_t *) node)->op, left_type, l, right_type, r,
+                                      left + i)) {
+                    return false;
+                }
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Locate the values referenced by a reference node
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to reference node
+ * \param[out]                          slot: Address receiving the slot of the referenced variable
+ * \param[out]                          offset: Address receiving the index of the first referenced value
+ * \param[out]                          length: Address receiving the number of referenced values
+ * \return                              Whether the indices are valid
+ */
+static bool resolve_reference(simulator_t *sim, const reference_node_t *node, slot_t **slot, unsigned *offset,
+                              unsigned *length) {
+    const entry_t *entry = node->entry;
+    *slot = find_slot(sim, entry);
+    if (*slot == NULL || (*slot)->values == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "%s is not a variable", entry->name);
+        return false;
+    }
+
+    *offset = 0;
+    unsigned index_depth = entry->depth - node->type_info.depth;
+    for (unsigned i = 0; i < index_depth; ++i) {
+        long long index = node->indices[i].const_index;
+        if (!node->index_is_const[i] && !evaluate_classical(sim, node->indices[i].node_index, &index, "Index")) {
+            return false;
+        } else if (index < 0 || index >= entry->shape->sizes[i]) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "%u-th index (%lld) of array %s out of bounds (%u)", i, index,
+                     entry->name, entry->shape->sizes[i]);
+            return false;
+        }
+        *offset += (unsigned) index * get_shape_length(get_inner_shape(entry->shape, i + 1));
+    }
+    *length = get_shape_length(node->type_info.shape);
+    return true;
+}
+
+/**
+ * \brief                               Measure register and collapse the state to the measured value
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \return                              Whether measuring was successful
+ */
+static bool measure_register(simulator_t *sim, unsigned first_qubit, unsigned width) {
+    uint64_t domain = get_register_bits(first_qubit, width);
+    size_t value = gather_bits(sample_basis_state(&(sim->state), next_random(sim)), domain);
+    bool *keep = calloc((size_t) 1 << width, sizeof (bool));
+    if (keep == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for measurement failed");
+        return false;
+    }
+    keep[value] = true;
+    collapse_state(&(sim->state), domain, keep);
+    free(keep);
+    return true;
+}
+
+/**
+ * \brief                               Apply a register map, measuring the register first if the map is irreversible
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           domain: Mask of qubits the new value of the register depends on
+ * \param[in]                           values: Array of new register values indexed by the gathered bits of the domain
+ * \param[in]                           name: Name of the variable for error messages
+ * \return                              Whether the map could be applied
+ */
+static bool map_register(simulator_t *sim, unsigned first_qubit, unsigned width, uint64_t domain,
+                         const size_t *values, const char *name) {
+    bool is_injective;
+    if (!check_register_map(&(sim->state), first_qubit, width, domain, values, sim->mask, &is_injective,
+                            sim->error_msg)) {
+        return false;
+    } else if (!is_injective) {
+        if (sim->mask != NULL) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH,
+                     "Irreversible change of quantum variable %s under quantum control", name);
+            return false;
+        } else if (!measure_register(sim, first_qubit, width)) {
+            return false;
+        }
+    }
+    return apply_register_map(&(sim->state), first_qubit, width, domain, values, sim->mask, is_injective,
+                              sim->error_msg);
+}
+
+/**
+ * \brief                               Reset register to zero, measuring it first unless it is already zero
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           name: Name of the variable for error messages
+ * \return                              Whether the register could be reset
+ */
+static bool reset_register(simulator_t *sim, unsigned first_qubit, unsigned width, const char *name) {
+    if (is_register_clear(&(sim->state), first_qubit, width)) {
+        return true;
+    } else if (sim->mask != NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Resetting quantum variable %s under quantum control", name);
+        return false;
+    }
+
+    size_t zero = 0;
+    return measure_register(sim, first_qubit, width)
+           && apply_register_map(&(sim->state), first_qubit, width, 0, &zero, NULL, false, sim->error_msg);
+}
+
+/**
+ * \brief                               Update register by an assignment operator and one value of an expression
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           type: Type of register
+ * \param[in]                           op: Assignment operator
+ * \param[in]                           node: Pointer to right-hand side (`NULL` for a constant)
+ * \param[in]                           element: Index of the used value of the right-hand side
+ * \param[in]                           constant: Right-hand side if no node is given
+ * \param[in]                           name: Name of the variable for error messages
+ * \return                              Whether the register could be updated
+ */
+static bool update_register(simulator_t *sim, unsigned first_qubit, type_t type, assign_op_t op, const node_t *node,
+                            unsigned element, long long constant, const char *name) {
+    uint64_t support = 0;
+    unsigned length = 1;
+    long long *right = &constant;
+    type_t right_type = INT_T;
+    if (node != NULL) {
+        length = get_length_of_node(node);
+        right_type = get_type_of_node(node);
+        if (!get_support(sim, node, &support) || (right = tabulate(sim, node, support, length)) == NULL) {
+            return false;
+        }
+    }
+
+    unsigned width = get_type_width(type);
+    uint64_t domain = support | get_register_bits(first_qubit, width);
+    size_t num_of_assignments = (size_t) 1 << __builtin_popcountll(domain);
+    size_t *values = malloc(num_of_assignments * sizeof (size_t));
+    bool success = values != NULL;
+    if (!success) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for register map failed");
+    }
+
+    for (size_t k = 0; success && k < num_of_assignments; ++k) {
+        size_t basis = scatter_bits(k, domain);
+        long long old_value = read_register(basis, first_qubit, type);
+        long long right_value = right[gather_bits(basis, support) * length + ((length == 1) ? 0 : element)];
+        long long new_value = right_value;
+        if (op != ASSIGN_OP) {
+            integer_op_t integer_op = (integer_op_t) (op - ASSIGN_OR_OP + OR_OP);
+            success = apply_integer_op(sim, integer_op, (type == BOOL_T) ? UNSIGNED_T : type, old_value,
+                                       (right_type == BOOL_T) ? UNSIGNED_T : right_type, right_value, &new_value);
+        }
+        values[k] = (size_t) normalize(type, new_value) & ((1ULL << width) - 1);
+    }
+
+    success = success && map_register(sim, first_qubit, width, domain, values, name);
+    free(values);
+    if (right != &constant) {
+        free(right);
+    }
+    return success;
+}
+
+/**
+ * \brief                               Map register between its zero state and the uniform superposition of the
+ *                                      values a function holds for
+ * \note                                The map is the reflection about (|0> - |s>) / || |0> - |s> ||, hence it is its
+ *                                      own inverse
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           type: Type of register
+ * \param[in]                           function_entry: Pointer to entry of the superposition-creating function
+ * \param[in]                           name: Name of the variable for error messages
+ * \return                              Whether the superposition could be created
+ */
+static bool superpose(simulator_t *sim, unsigned first_qubit, type_t type, const entry_t *function_entry,
+                      const char *name);
+
+/**
+ * \brief                               Call function with given arguments
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           function_slot: Pointer to slot of function
+ * \param[in]                           arguments: Array of values of classical parameters (concatenated)
+ * \param[in]                           registers: Array of first qubits bound to parameters (used for quantum ones)
+ * \param[out]                          out: Array receiving the returned values
+ * \return                              Whether the call was successful
+ */
+static bool invoke_function(simulator_t *sim, const slot_t *function_slot, const long long *arguments,
+                            const unsigned *registers, long long *out) {
+    function_info_t *function = function_slot->function;
+    const entry_t *entry = function_slot->entry;
+    if (function->has_quantum_locals && function->num_of_activations > 0) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Recursive call of function %s with quantum variables", entry->name);
+        return false;
+    }
+
+    long long *saved_values = NULL;
+    if (function->num_of_activations > 0 && function->num_of_values > 0) {
+        saved_values = malloc(function->num_of_values * sizeof (long long));
+        if (saved_values == NULL) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for frame of %s failed", entry->name);
+            return false;
+        }
+        unsigned position = 0;
+        for (unsigned i = 0; i < function->num_of_locals; ++i) {
+            memcpy(saved_values + position, function->locals[i]->values,
+                   function->locals[i]->entry->length * sizeof (long long));
+            position += function->locals[i]->entry->length;
+        }
+    }
+
+    unsigned position = 0;
+    for (unsigned i = 0; i < entry->num_of_pars; ++i) {
+        slot_t *parameter = function->locals[i];
+        if (parameter->entry->qualifier == QUANTUM_T) {
+            parameter->first_qubit = registers[i];
+            continue;
+        }
+        for (unsigned j = 0; j < parameter->entry->length; ++j) {
+            parameter->values[j] = normalize(parameter->entry->type, arguments[position++]);
+        }
+    }
+
+    long long *saved_return_values = sim->return_values;
+    const entry_t *saved_function_entry = sim->function_entry;
+    unsigned saved_scope = sim->scope;
+    unsigned saved_loop_depth = sim->loop_depth;
+    sim->return_values = out;
+    sim->function_entry = entry;
+    sim->scope = entry->scope + 1;
+    sim->loop_depth = 0;
+    ++(sim->call_depth);
+    ++(function->num_of_activations);
+    memset(out, 0, entry->length * sizeof (long long));
+
+    exec_status_t status = execute(sim, function->func_tail);
+
+    --(function->num_of_activations);
+    --(sim->call_depth);
+    sim->loop_depth = saved_loop_depth;
+    sim->scope = saved_scope;
+    sim->function_entry = saved_function_entry;
+    sim->return_values = saved_return_values;
+    for (unsigned i = 0; i < entry->num_of_pars; ++i) {
+        function->locals[i]->first_qubit = function->locals[i]->own_first_qubit;
+    }
+    if (saved_values != NULL) {
+        position = 0;
+        for (unsigned i = 0; i < function->num_of_locals; ++i) {
+            memcpy(function->locals[i]->values, saved_values + position,
+                   function->locals[i]->entry->length * sizeof (long long));
+            position += function->locals[i]->entry->length;
+        }
+        free(saved_values);
+    }
+    return status != FAILURE_S;
+}
+
+/**
+ * \brief                               Evaluate arguments of a function call and call the function
+ * \note                                Quantum parameters are bound to the registers of variables passed to them; other
+ *                                      arguments are copied into the parameter's own register
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to function call node
+ * \param[out]                          out: Array receiving the returned values
+ * \return                              Whether the call was successful
+ */
+static bool call_function(simulator_t *sim, const func_call_node_t *node, long long *out) {
+    const slot_t *function_slot = find_slot(sim, node->entry);
+    if (function_slot == NULL || function_slot->function == NULL || function_slot->function->func_tail == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Function %s is not defined", node->entry->name);
+        return false;
+    }
+
+    const function_info_t *function = function_slot->function;
+    long long argument_buffer[MAX_ARRAY_DEPTH];
+    unsigned register_buffer[MAX_ARRAY_DEPTH];
+    unsigned num_of_arguments = 0;
+    for (unsigned i = 0; i < node->num_of_pars; ++i) {
+        num_of_arguments += function->locals[i]->entry->length;
+    }
+    long long *arguments = (num_of_arguments <= MAX_ARRAY_DEPTH) ? argument_buffer
+                                                                : malloc(num_of_arguments * sizeof (long long));
+    unsigned *registers = (node->num_of_pars <= MAX_ARRAY_DEPTH) ? register_buffer
+                                                                 : malloc(node->num_of_pars * sizeof (unsigned));
+    bool success = arguments != NULL && registers != NULL;
+    if (!success) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for arguments of %s failed", node->entry->name);
+    }
+
+    unsigned position = 0;
+    for (unsigned i = 0; success && i < node->num_of_pars; ++i) {
+        const slot_t *parameter = function->locals[i];
+        const node_t *argument = node->pars[i];
+        if (parameter->entry->qualifier != QUANTUM_T) {
+            success = evaluate(sim, argument, arguments + position);
+            position += parameter->entry->length;
+            continue;
+        }
+
+        unsigned width = get_type_width(parameter->entry->type);
+        if (argument->node_type == REFERENCE_NODE_T
+            && ((const reference_node_t *) argument)->entry->qualifier == QUANTUM_T) {
+            slot_t *argument_slot;
+            unsigned offset;
+            unsigned length;
+            success = resolve_reference(sim, (const reference_node_t *) argument, &argument_slot, &offset, &length);
+            registers[i] = argument_slot->first_qubit + offset * width;
+        } else if (sim->is_tabulating) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH,
+                     "Passing a value to quantum parameter %s of %s inside a quantum expression",
+                     parameter->entry->name, node->entry->name);
+            success = false;
+        } else {
+            registers[i] = parameter->own_first_qubit;
+            for (unsigned j = 0; success && j < parameter->entry->length; ++j) {
+                success = reset_register(sim, registers[i] + j * width, width, parameter->entry->name)
+                          && update_register(sim, registers[i] + j * width, parameter->entry->type, ASSIGN_XOR_OP,
+                                             argument, j, 0, parameter->entry->name);
+            }
+        }
+    }
+
+    success = success && invoke_function(sim, function_slot, arguments, registers, out);
+    if (arguments != argument_buffer) {
+        free(arguments);
+    }
+    if (registers != register_buffer) {
+        free(registers);
+    }
+    return success;
+}
+
+/* See declaration for documentation */
+static bool superpose(simulator_t *sim, unsigned first_qubit, type_t type, const entry_t *function_entry,
+                      const char *name) {
+    const slot_t *function_slot = find_slot(sim, function_entry);
+    if (function_slot == NULL || function_slot->function == NULL || function_slot->function->func_tail == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Function %s is not defined", function_entry->name);
+        return false;
+    } else if (sim->is_tabulating) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Creating a superposition of %s inside a quantum expression", name);
+        return false;
+    }
+
+    unsigned width = get_type_width(type);
+    size_t num_of_values = (size_t) 1 << width;
+    double *axis = calloc(num_of_values, sizeof (double));
+    if (axis == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for superposition of %s failed", name);
+        return false;
+    }
+
+    size_t num_of_holding_values = 0;
+    for (size_t value = 0; value < num_of_values; ++value) {
+        long long argument = read_register(value, 0, type);
+        long long holds;
+        if (!invoke_function(sim, function_slot, &argument, NULL, &holds)) {
+            free(axis);
+            return false;
+        }
+        axis[value] = (holds != 0) ? 1.0 : 0.0;
+        num_of_holding_values += holds != 0;
+    }
+    if (num_of_holding_values == 0) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Function %s does not hold for any value of %s",
+                 function_entry->name, name);
+        free(axis);
+        return false;
+    } else if (num_of_holding_values == 1 && axis[0] != 0.0) {
+        free(axis);
+        return true; /* the uniform superposition is the zero state itself */
+    }
+
+    double norm = 0.0;
+    for (size_t value = 0; value < num_of_values; ++value) {
+        axis[value] = ((value == 0) ? 1.0 : 0.0) - axis[value] / sqrt((double) num_of_holding_values);
+        norm += axis[value] * axis[value];
+    }
+    for (size_t value = 0; value < num_of_values; ++value) {
+        axis[value] /= sqrt(norm);
+    }
+
+    bool is_independent;
+    bool success = apply_reflection(&(sim->state), first_qubit, width, axis, sim->mask, &is_independent,
+                                    sim->error_msg);
+    if (success && !is_independent) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Superposition of %s is controlled by %s itself", name, name);
+        success = false;
+    }
+    free(axis);
+    return success;
+}
+
+/**
+ * \brief                               Measure expression and collapse the state to the measured value
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to measured expression
+ * \param[out]                          out: Array receiving the measured values
+ * \return                              Whether measuring was successful
+ */
+static bool measure(simulator_t *sim, const node_t *node, long long *out) {
+    uint64_t support;
+    if (!get_support(sim, node, &support)) {
+        return false;
+    } else if (support == 0) {
+        return evaluate(sim, node, out);
+    } else if (sim->is_tabulating) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Measurement inside a quantum expression");
+        return false;
+    } else if (sim->mask != NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Measurement under quantum control");
+        return false;
+    }
+
+    unsigned length = get_length_of_node(node);
+    long long *table = tabulate(sim, node, support, length);
+    size_t num_of_assignments = (size_t) 1 << __builtin_popcountll(support);
+    bool *keep = calloc(num_of_assignments, sizeof (bool));
+    if (table == NULL || keep == NULL) {
+        if (table != NULL) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for measurement failed");
+        }
+        free(table);
+        free(keep);
+        return false;
+    }
+
+    size_t outcome = gather_bits(sample_basis_state(&(sim->state), next_random(sim)), support);
+    memcpy(out, table + outcome * length, length * sizeof (long long));
+    for (size_t k = 0; k < num_of_assignments; ++k) {
+        keep[k] = memcmp(table + k * length, out, length * sizeof (long long)) == 0;
+    }
+    collapse_state(&(sim->state), support, keep);
+    free(table);
+    free(keep);
+    return true;
+}
+
+/**
+ * \brief                               Evaluate expression that is not an operator
+ * \note                                Quantum variables can only be read while tabulating
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to expression node
+ * \param[out]                          out: Array receiving the (flattened) values of the expression
+ * \return                              Whether evaluation was successful
+ */
+static bool evaluate_operand(simulator_t *sim, const node_t *node, long long *out) {
+    switch (node->node_type) {
+        case CONST_NODE_T: {
+            const const_node_t *const_node_view = (const const_node_t *) node;
+            unsigned length = get_shape_length(const_node_view->type_info.shape);
+            for (unsigned i = 0; i < length; ++i) {
+                out[i] = normalize(const_node_view->type_info.type,
+                                   from_value(const_node_view->type_info.type, const_node_view->values[i]));
+            }
+            return true;
+        }
+        case REFERENCE_NODE_T: {
+            const reference_node_t *reference_node_view = (const reference_node_t *) node;
+            slot_t *slot;
+            unsigned offset;
+            unsigned length;
+            if (!resolve_reference(sim, reference_node_view, &slot, &offset, &length)) {
+                return false;
+            } else if (slot->entry->qualifier != QUANTUM_T) {
+                memcpy(out, slot->values + offset, length * sizeof (long long));
+                return true;
+            } else if (!sim->is_tabulating) {
+                snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Reading quantum variable %s outside a quantum expression",
+                         slot->entry->name);
+                return false;
+            }
+
+            unsigned width = get_type_width(slot->entry->type);
+            for (unsigned i = 0; i < length; ++i) {
+                out[i] = read_register(sim->basis, slot->first_qubit + (offset + i) * width, slot->entry->type);
+            }
+            return true;
+        }
+        case FUNC_CALL_NODE_T: {
+            return call_function(sim, (const func_call_node_t *) node, out);
+        }
+        case MEASURE_NODE_T: {
+            return measure(sim, ((const measure_node_t *) node)->child, out);
+        }
+        default: {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Node is not an expression");
+            return false;
+        }
+    }
+}
+
+/**
+ * \brief                               Return operands of an operator node
+ * \param[in]                           node: Pointer to expression node
+ * \param[out]                          left: Address receiving the left (or only) operand
+ * \param[out]                          right: Address receiving the right operand (`NULL` for unary operators)
+ * \return                              Whether the node is an operator
+ */
+static bool get_operands(const node_t *node, const node_t **left, const node_t **right) {
+    switch (node->node_type) {
+        case LOGICAL_OP_NODE_T: {
+            *left = ((const logical_op_node_t *) node)->left;
+            *right = ((const logical_op_node_t *) node)->right;
+            return true;
+        }
+        case COMPARISON_OP_NODE_T: {
+            *left = ((const comparison_op_node_t *) node)->left;
+            *right = ((const comparison_op_node_t *) node)->right;
+            return true;
+        }
+        case EQUALITY_OP_NODE_T: {
+            *left = ((const equality_op_node_t *) node)->left;
+            *right = ((const equality_op_node_t *) node)->right;
+            return true;
+        }
+        case INTEGER_OP_NODE_T: {
+            *left = ((const integer_op_node_t *) node)->left;
+            *right = ((const integer_op_node_t *) node)->right;
+            return true;
+        }
+        case NOT_OP_NODE_T: {
+            *left = ((const not_op_node_t *) node)->child;
+            *right = NULL;
+            return true;
+        }
+        case INVERT_OP_NODE_T: {
+            *left = ((const invert_op_node_t *) node)->child;
+            *right = NULL;
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+/**
+ * \brief                               Make sure that a stack of evaluate() can hold a number of elements
+ * \note                                Stacks start out in a buffer of the caller and move to the heap once they
+ *                                      outgrow it, so that short expressions are evaluated without allocation
+ * \param[in,out]                       stack: Address of stack
+ * \param[in,out]                       capacity: Address of number of elements the stack can hold
+ * \param[in]                           num_of_elements: Number of elements the stack must hold
+ * \param[in]                           element_size: Size of an element
+ * \param[in]                           buffer: Buffer the stack starts out in
+ * \return                              Whether the stack can hold the number of elements
+ */
+static bool reserve_stack(void **stack, size_t *capacity, size_t num_of_elements, size_t element_size,
+                          const void *buffer) {
+    if (num_of_elements <= *capacity) {
+        return true;
+    }
+
+    size_t new_capacity = 2 * *capacity;
+    while (new_capacity < num_of_elements) {
+        new_capacity *= 2;
+    }
+    void *temp = (*stack == buffer) ? malloc(new_capacity * element_size)
+                                    : realloc(*stack, new_capacity * element_size);
+    if (temp == NULL) {
+        return false;
+    }
+
+    if (*stack == buffer) {
+        memcpy(temp, buffer, *capacity * element_size);
+    }
+    *stack = temp;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * \brief                               Evaluate expression
+ * \note                                Operators are evaluated in post-order with an explicit stack of operator nodes
+ *                                      and one of operand values, so long chains of operators cannot overflow the call
+ *                                      stack; quantum variables can only be read while tabulating
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to expression node
+ * \param[out]                          out: Array receiving the (flattened) values of the expression
+ * \return                              Whether evaluation was successful
+ */
+static bool evaluate(simulator_t *sim, const node_t *node, long long *out) {
+    const node_t *left;
+    const node_t *right;
+    if (!get_operands(node, &left, &right)) {
+        return evaluate_operand(sim, node, out);
+    }
+
+    evaluation_frame_t frame_buffer[INITIAL_WALK_STACK_SIZE];
+    long long value_buffer[INITIAL_WALK_STACK_SIZE];
+    evaluation_frame_t *frames = frame_buffer;
+    long long *values = value_buffer;
+    size_t frames_capacity = INITIAL_WALK_STACK_SIZE;
+    size_t values_capacity = INITIAL_WALK_STACK_SIZE;
+    size_t num_of_frames = 0;
+    size_t num_of_values = 0;
+    bool success = true;
+    const node_t *operand = node;
+    while (success && operand != NULL) {
+        /* descend along left operands to the next operand that is not an operator */
+        while (success && get_operands(operand, &left, &right)) {
+            success = reserve_stack((void **) &frames, &frames_capacity, num_of_frames + 1,
+                                    sizeof (evaluation_frame_t), frame_buffer);
+            if (success) {
+                frames[num_of_frames].node = operand;
+                frames[(num_of_frames)++].is_left_done = false;
+                operand = left;
+            }
+        }
+
+        unsigned length = get_length_of_node(operand);
+        success = success && reserve_stack((void **) &values, &values_capacity, num_of_values + length,
+                                           sizeof (long long), value_buffer);
+        if (!success) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for operand failed");
+            break;
+        }
+        success = evaluate_operand(sim, operand, values + num_of_values);
+        num_of_values += length;
+
+        /* apply the operators whose operands are complete, up to the first one whose right operand is pending */
+        operand = NULL;
+        while (success && operand == NULL && num_of_frames > 0) {
+            evaluation_frame_t *frame = frames + num_of_frames - 1;
+            get_operands(frame->node, &left, &right);
+            length = get_length_of_node(left);
+            if (right != NULL && !frame->is_left_done) {
+                frame->is_left_done = true;
+                operand = right;
+                continue;
+            }
+
+            long long *operand_values = values + num_of_values - ((right != NULL) ? 2 * length : length);
+            if (frame->node->node_type == NOT_OP_NODE_T) {
+                for (unsigned i = 0; i < length; ++i) {
+                    operand_values[i] = !operand_values[i];
+                }
+            } else if (frame->node->node_type == INVERT_OP_NODE_T) {
+                type_t type = ((const invert_op_node_t *) frame->node)->type_info.type;
+                for (unsigned i = 0; i < length; ++i) {
+                    operand_values[i] = normalize(type, ~operand_values[i]);
+                }
+            } else {
+                success = apply_binary_op(sim, frame->node, operand_values, operand_values + length, length);
+                num_of_values -= length;
+            }
+            --num_of_frames;
+        }
+    }
+
+    if (success) {
+        memcpy(out, values, num_of_values * sizeof (long long));
+    }
+    if (frames != frame_buffer) {
+        free(frames);
+    }
+    if (values != value_buffer) {
+        free(values);
+    }
+    return success;
+}
+
+/**
+ * \brief                               Check whether a classical variable may be written
+ * \note                                Under quantum control only variables declared inside the controlled block may be
+ *                                      written, and global variables are never written inside quantum expressions
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           entry: Pointer to entry of written variable
+ * \return                              Whether the variable may be written
+ */
+static bool check_classical_write(simulator_t *sim, const entry_t *entry) {
+    if (entry->scope == 0 && sim->is_tabulating) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Writing global variable %s inside a quantum expression",
+                 entry->name);
+        return false;
+    } else if (sim->mask != NULL && (entry->scope == 0 || (sim->call_depth == sim->control_call_depth
+                                                           && entry->scope <= sim->control_scope))) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Writing classical variable %s under quantum control", entry->name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Execute variable declaration or definition
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to variable declaration or definition node
+ * \return                              Whether execution was successful
+ */
+static bool define_variable(simulator_t *sim, const node_t *node) {
+    const entry_t *entry = (node->node_type == VAR_DECL_NODE_T) ? ((const var_decl_node_t *) node)->entry
+                                                                : ((const var_def_node_t *) node)->entry;
+    const var_def_node_t *var_def_node_view = (node->node_type == VAR_DEF_NODE_T) ? (const var_def_node_t *) node
+                                                                                 : NULL;
+    slot_t *slot = find_slot(sim, entry);
+    if (slot == NULL || slot->values == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "%s is not a variable", entry->name);
+        return false;
+    }
+
+    if (entry->qualifier == QUANTUM_T) {
+        if (sim->is_tabulating) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Defining quantum variable %s inside a quantum expression",
+                     entry->name);
+            return false;
+        }
+
+        unsigned width = get_type_width(entry->type);
+        for (unsigned i = 0; i < entry->length; ++i) {
+            unsigned first_qubit = slot->first_qubit + i * width;
+            if (!reset_register(sim, first_qubit, width, entry->name)) {
+                return false;
+            } else if (var_def_node_view == NULL
+                       || (var_def_node_view->is_init_list && i >= var_def_node_view->length)) {
+                continue;
+            }
+
+            const node_t *value = var_def_node_view->is_init_list ? NULL : var_def_node_view->node;
+            long long constant = 0;
+            if (var_def_node_view->is_init_list && var_def_node_view->q_types[i].qualifier == CONST_T) {
+                constant = from_value(var_def_node_view->q_types[i].type, var_def_node_view->values[i].const_value);
+            } else if (var_def_node_view->is_init_list) {
+                value = var_def_node_view->values[i].node_value;
+            }
+
+            bool success;
+            if (value != NULL && value->node_type == FUNC_SP_NODE_T) {
+                success = superpose(sim, first_qubit, entry->type, ((const func_sp_node_t *) value)->entry,
+                                    entry->name);
+            } else {
+                success = update_register(sim, first_qubit, entry->type, ASSIGN_XOR_OP, value,
+                                          var_def_node_view->is_init_list ? 0 : i, constant, entry->name);
+            }
+            if (!success) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (!check_classical_write(sim, entry)) {
+        return false;
+    }
+    memset(slot->values, 0, entry->length * sizeof (long long));
+    if (var_def_node_view == NULL) {
+        return true;
+    } else if (!var_def_node_view->is_init_list) {
+        if (!evaluate_classical(sim, var_def_node_view->node, slot->values, "Initialization")) {
+            return false;
+        }
+    } else {
+        for (unsigned i = 0; i < var_def_node_view->length; ++i) {
+            if (var_def_node_view->q_types[i].qualifier == CONST_T) {
+                slot->values[i] = from_value(var_def_node_view->q_types[i].type,
+                                             var_def_node_view->values[i].const_value);
+            } else if (!evaluate_classical(sim, var_def_node_view->values[i].node_value, slot->values + i,
+                                           "Initialization")) {
+                return false;
+            }
+        }
+    }
+    for (unsigned i = 0; i < entry->length; ++i) {
+        slot->values[i] = normalize(entry->type, slot->values[i]);
+    }
+    return true;
+}
+
+/**
+ * \brief                               Execute assignment
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to assignment node
+ * \return                              Whether execution was successful
+ */
+static bool assign(simulator_t *sim, const assign_node_t *node) {
+    if (node->left->node_type != REFERENCE_NODE_T) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Left-hand side of assignment is not a variable");
+        return false;
+    }
+
+    slot_t *slot;
+    unsigned offset;
+    unsigned length;
+    if (!resolve_reference(sim, (const reference_node_t *) node->left, &slot, &offset, &length)) {
+        return false;
+    }
+
+    const entry_t *entry = slot->entry;
+    unsigned right_length = get_length_of_node(node->right);
+    if (entry->qualifier == QUANTUM_T) {
+        if (sim->is_tabulating) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Assigning quantum variable %s inside a quantum expression",
+                     entry->name);
+            return false;
+        }
+
+        unsigned width = get_type_width(entry->type);
+        for (unsigned i = 0; i < length; ++i) {
+            if (!update_register(sim, slot->first_qubit + (offset + i) * width, entry->type, node->op, node->right,
+                                 (right_length == 1) ? 0 : i, 0, entry->name)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (!check_classical_write(sim, entry)) {
+        return false;
+    }
+    long long right_buffer[1];
+    long long *right = (right_length == 1) ? right_buffer : malloc(right_length * sizeof (long long));
+    if (right == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for assignment to %s failed", entry->name);
+        return false;
+    }
+
+    bool success = evaluate_classical(sim, node->right, right, "Right-hand side of assignment");
+    type_t right_type = get_type_of_node(node->right);
+    for (unsigned i = 0; success && i < length; ++i) {
+        long long *value = slot->values + offset + i;
+        long long right_value = right[(right_length == 1) ? 0 : i];
+        if (node->op == ASSIGN_OP) {
+            *value = right_value;
+        } else {
+            integer_op_t integer_op = (integer_op_t) (node->op - ASSIGN_OR_OP + OR_OP);
+            success = apply_integer_op(sim, integer_op, (entry->type == BOOL_T) ? UNSIGNED_T : entry->type, *value,
+                                       (right_type == BOOL_T) ? UNSIGNED_T : right_type, right_value, value);
+        }
+        *value = normalize(entry->type, *value);
+    }
+    if (right != right_buffer) {
+        free(right);
+    }
+    return success;
+}
+
+/**
+ * \brief                               Execute branch under a control mask
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           branch: Pointer to branch
+ * \param[in]                           mask: Control mask of the branch
+ * \return                              Execution status of the branch
+ */
+static exec_status_t execute_controlled(simulator_t *sim, const node_t *branch, const control_mask_t *mask) {
+    if (mask == sim->mask) {
+        return execute(sim, branch);
+    }
+
+    const control_mask_t *saved_mask = sim->mask;
+    unsigned saved_control_call_depth = sim->control_call_depth;
+    unsigned saved_control_scope = sim->control_scope;
+    unsigned saved_control_loop_depth = sim->control_loop_depth;
+    sim->mask = mask;
+    sim->control_call_depth = sim->call_depth;
+    sim->control_scope = sim->scope;
+    sim->control_loop_depth = sim->loop_depth;
+    exec_status_t status = execute(sim, branch);
+    sim->control_loop_depth = saved_control_loop_depth;
+    sim->control_scope = saved_control_scope;
+    sim->control_call_depth = saved_control_call_depth;
+    sim->mask = saved_mask;
+    return status;
+}
+
+/**
+ * \brief                               Execute chain of conditional branches
+ * \note                                Classical conditions select a branch as usual; a quantum-valued condition
+ *                                      splits the current control mask into the part fulfilling it, under which its
+ *                                      branch is executed, and the remaining part passed on to the following branches
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           num_of_branches: Number of conditional branches
+ * \param[in]                           expression: Pointer to expression compared to the case values (`NULL` for
+ *                                      boolean conditions)
+ * \param[in]                           conditions: Array of conditions or case values (`NULL` for the default case)
+ * \param[in]                           branches: Array of branches
+ * \param[in]                           else_branch: Pointer to branch executed if no condition holds (or `NULL`)
+ * \return                              Execution status
+ */
+static exec_status_t execute_branches(simulator_t *sim, unsigned num_of_branches, const node_t *expression,
+                                      const long long *case_values, const node_t *const *conditions,
+                                      const node_t *const *branches, const node_t *else_branch) {
+    const control_mask_t *remaining = sim->mask;
+    control_mask_t *owned_remaining = NULL;
+    uint64_t support = 0;
+    long long *table = NULL;
+    exec_status_t status = NORMAL_S;
+    bool is_done = false;
+
+    long long expression_value = 0;
+    if (expression != NULL && !sim->is_tabulating && !get_support(sim, expression, &support)) {
+        return FAILURE_S;
+    } else if (expression != NULL && support == 0 && !evaluate(sim, expression, &expression_value)) {
+        return FAILURE_S;
+    } else if (expression != NULL && support != 0 && (table = tabulate(sim, expression, support, 1)) == NULL) {
+        return FAILURE_S;
+    }
+
+    for (unsigned i = 0; i < num_of_branches && !is_done && status == NORMAL_S; ++i) {
+        long long *condition_table = table;
+        uint64_t condition_support = support;
+        if (expression == NULL) {
+            condition_support = 0;
+            if (!sim->is_tabulating && !get_support(sim, conditions[i], &condition_support)) {
+                status = FAILURE_S;
+                break;
+            } else if (condition_support != 0
+                       && (condition_table = tabulate(sim, conditions[i], condition_support, 1)) == NULL) {
+                status = FAILURE_S;
+                break;
+            }
+        }
+
+        if (condition_support == 0) {
+            long long holds;
+            if (expression != NULL) {
+                holds = (uint32_t) expression_value == (uint32_t) case_values[i];
+            } else if (!evaluate(sim, conditions[i], &holds)) {
+                status = FAILURE_S;
+                break;
+            }
+            if (holds) {
+                status = execute_controlled(sim, branches[i], remaining);
+                is_done = true;
+            }
+            continue;
+        }
+
+        size_t num_of_assignments = (size_t) 1 << __builtin_popcountll(condition_support);
+        bool *holds = malloc(2 * num_of_assignments * sizeof (bool));
+        control_mask_t *next_remaining = calloc(1, sizeof (control_mask_t));
+        if (holds == NULL || next_remaining == NULL) {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for control masks failed");
+            free(holds);
+            free(next_remaining);
+            if (condition_table != table) {
+                free(condition_table);
+            }
+            status = FAILURE_S;
+            break;
+        }
+        for (size_t k = 0; k < num_of_assignments; ++k) {
+            holds[k] = (expression != NULL) ? (uint32_t) condition_table[k] == (uint32_t) case_values[i]
+                                            : condition_table[k] != 0;
+            holds[num_of_assignments + k] = !holds[k];
+        }
+        if (condition_table != table) {
+            free(condition_table);
+        }
+
+        control_mask_t branch_mask;
+        if (!build_mask(&(sim->state), condition_support, holds, remaining, &branch_mask, sim->error_msg)) {
+            status = FAILURE_S;
+        } else if (branch_mask.is_any) {
+            status = execute_controlled(sim, branches[i], &branch_mask);
+        }
+        free_mask(&branch_mask);
+        /* the basis states left for later branches are only needed if there are any */
+        is_done = i + 1 == num_of_branches && else_branch == NULL;
+        if (!is_done && status == NORMAL_S) {
+            if (!build_mask(&(sim->state), condition_support, holds + num_of_assignments, remaining, next_remaining,
+                            sim->error_msg)) {
+                status = FAILURE_S;
+            }
+            is_done = !next_remaining->is_any;
+        }
+        free(holds);
+        if (owned_remaining != NULL) {
+            free_mask(owned_remaining);
+        }
+        free(owned_remaining);
+        owned_remaining = next_remaining;
+        remaining = next_remaining;
+    }
+
+    if (!is_done && status == NORMAL_S && else_branch != NULL) {
+        status = execute_controlled(sim, else_branch, remaining);
+    }
+    if (owned_remaining != NULL) {
+        free_mask(owned_remaining);
+    }
+    free(owned_remaining);
+    free(table);
+    return status;
+}
+
+/**
+ * \brief                               Execute if-statement
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to if node
+ * \return                              Execution status
+ */
+static exec_status_t execute_if(simulator_t *sim, const if_node_t *node) {
+    unsigned num_of_branches = node->num_of_else_ifs + 1;
+    const node_t **conditions = malloc(2 * num_of_branches * sizeof (node_t *));
+    if (conditions == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for if-statement failed");
+        return FAILURE_S;
+    }
+
+    const node_t **branches = conditions + num_of_branches;
+    conditions[0] = node->condition;
+    branches[0] = node->if_branch;
+    for (unsigned i = 0; i < node->num_of_else_ifs; ++i) {
+        const else_if_node_t *else_if_node_view = (const else_if_node_t *) node->else_ifs[i];
+        conditions[i + 1] = else_if_node_view->condition;
+        branches[i + 1] = else_if_node_view->else_if_branch;
+    }
+    exec_status_t status = execute_branches(sim, num_of_branches, NULL, NULL, conditions, branches,
+                                            node->else_branch);
+    free(conditions);
+    return status;
+}
+
+/**
+ * \brief                               Execute switch-statement
+ * \note                                The first case with matching value is executed, or else the default case
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to switch node
+ * \return                              Execution status
+ */
+static exec_status_t execute_switch(simulator_t *sim, const switch_node_t *node) {
+    long long *case_values = malloc(node->num_of_cases * (sizeof (long long) + sizeof (node_t *)));
+    if (case_values == NULL) {
+        snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for switch-statement failed");
+        return FAILURE_S;
+    }
+
+    const node_t **branches = (const node_t **) (case_values + node->num_of_cases);
+    const node_t *default_branch = NULL;
+    unsigned num_of_branches = 0;
+    for (unsigned i = 0; i < node->num_of_cases; ++i) {
+        const case_node_t *case_node_view = (const case_node_t *) node->cases[i];
+        if (case_node_view->case_const_type == VOID_T) {
+            default_branch = case_node_view->case_branch;
+            continue;
+        }
+        case_values[num_of_branches] = from_value(case_node_view->case_const_type, case_node_view->case_const_value);
+        branches[num_of_branches++] = case_node_view->case_branch;
+    }
+    exec_status_t status = execute_branches(sim, num_of_branches, node->expression, case_values, NULL, branches,
+                                            default_branch);
+    free(case_values);
+    return status;
+}
+
+/**
+ * \brief                               Check whether the loop condition holds
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           condition: Pointer to loop condition
+ * \param[out]                          holds: Address receiving whether the condition holds
+ * \return                              Whether evaluating the condition was successful
+ */
+static bool check_loop_condition(simulator_t *sim, const node_t *condition, bool *holds) {
+    long long value;
+    if (!evaluate_classical(sim, condition, &value, "Loop condition")) {
+        return false;
+    }
+    *holds = value != 0;
+    return true;
+}
+
+/**
+ * \brief                               Execute loop
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to for-, do-while- or while-loop node
+ * \return                              Execution status
+ */
+static exec_status_t execute_loop(simulator_t *sim, const node_t *node) {
+    const node_t *initialize = NULL;
+    const node_t *condition;
+    const node_t *increment = NULL;
+    const node_t *body;
+    bool is_checked_first = true;
+    if (node->node_type == FOR_NODE_T) {
+        const for_node_t *for_node_view = (const for_node_t *) node;
+        initialize = for_node_view->initialize;
+        condition = for_node_view->condition;
+        increment = for_node_view->increment;
+        body = for_node_view->for_branch;
+    } else if (node->node_type == DO_NODE_T) {
+        condition = ((const do_node_t *) node)->condition;
+        body = ((const do_node_t *) node)->do_branch;
+        is_checked_first = false;
+    } else {
+        condition = ((const while_node_t *) node)->condition;
+        body = ((const while_node_t *) node)->while_branch;
+    }
+
+    ++(sim->scope);
+    ++(sim->loop_depth);
+    exec_status_t status = (initialize != NULL) ? execute(sim, initialize) : NORMAL_S;
+    bool holds = true;
+    while (status == NORMAL_S) {
+        if (is_checked_first && !check_loop_condition(sim, condition, &holds)) {
+            status = FAILURE_S;
+            break;
+        } else if (!holds) {
+            break;
+        }
+
+        status = execute(sim, body);
+        if (status == BREAK_S) {
+            status = NORMAL_S;
+            break;
+        } else if (status == CONTINUE_S) {
+            status = NORMAL_S;
+        }
+
+        if (status == NORMAL_S && increment != NULL) {
+            status = execute(sim, increment);
+        }
+        if (status == NORMAL_S && !is_checked_first && !check_loop_condition(sim, condition, &holds)) {
+            status = FAILURE_S;
+        }
+    }
+    --(sim->loop_depth);
+    --(sim->scope);
+    return status;
+}
+
+/**
+ * \brief                               Check whether control may leave the current block
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           is_return: Whether the block is left by a return (instead of break or continue)
+ * \return                              Whether control may leave the block
+ */
+static bool check_jump(simulator_t *sim, bool is_return) {
+    if (sim->mask == NULL || sim->call_depth > sim->control_call_depth
+        || (!is_return && sim->loop_depth > sim->control_loop_depth)) {
+        return true;
+    }
+    snprintf(sim->error_msg, ERROR_MSG_LENGTH, "%s under quantum control", is_return ? "Return" : "Leaving a loop");
+    return false;
+}
+
+/**
+ * \brief                               Execute statement
+ * \param[in,out]                       sim: Pointer to simulator
+ * \param[in]                           node: Pointer to statement node
+ * \return                              Execution status
+ */
+static exec_status_t execute(simulator_t *sim, const node_t *node) {
+    if (node == NULL) {
+        return NORMAL_S;
+    }
+
+    switch (node->node_type) {
+        case STMT_LIST_NODE_T: {
+            const stmt_list_node_t *stmt_list_node_view = (const stmt_list_node_t *) node;
+            for (unsigned i = 0; i < stmt_list_node_view->num_of_stmts; ++i) {
+                exec_status_t status = execute(sim, stmt_list_node_view->stmt_list[i]);
+                if (status != NORMAL_S) {
+                    return status;
+                }
+            }
+            return NORMAL_S;
+        }
+        case VAR_DECL_NODE_T: case VAR_DEF_NODE_T: {
+            return define_variable(sim, node) ? NORMAL_S : FAILURE_S;
+        }
+        case FUNC_DEF_NODE_T: {
+            return NORMAL_S;
+        }
+        case FUNC_CALL_NODE_T: {
+            const func_call_node_t *func_call_node_view = (const func_call_node_t *) node;
+            if (func_call_node_view->sp) {
+                slot_t *slot;
+                unsigned offset;
+                unsigned length;
+                const reference_node_t *target = (const reference_node_t *) func_call_node_view->pars[0];
+                if (!resolve_reference(sim, target, &slot, &offset, &length)) {
+                    return FAILURE_S;
+                }
+                unsigned first_qubit = slot->first_qubit + offset * get_type_width(slot->entry->type);
+                return superpose(sim, first_qubit, slot->entry->type, func_call_node_view->entry, slot->entry->name)
+                       ? NORMAL_S : FAILURE_S;
+            }
+
+            /* calls passing quantum values to classical parameters are evaluated like expressions */
+            uint64_t support = 0;
+            const slot_t *function_slot = find_slot(sim, func_call_node_view->entry);
+            for (unsigned i = 0; !sim->is_tabulating && function_slot != NULL && function_slot->function != NULL
+                                 && i < func_call_node_view->num_of_pars; ++i) {
+                uint64_t argument_support;
+                if (function_slot->function->locals[i]->entry->qualifier == QUANTUM_T) {
+                    continue;
+                } else if (!get_support(sim, func_call_node_view->pars[i], &argument_support)) {
+                    return FAILURE_S;
+                }
+                support |= argument_support;
+            }
+
+            unsigned length = func_call_node_view->entry->length;
+            long long *values = malloc(length * sizeof (long long));
+            if (values == NULL) {
+                snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for result of %s failed",
+                         func_call_node_view->entry->name);
+                return FAILURE_S;
+            }
+            bool success;
+            if (support != 0) {
+                long long *table = get_support(sim, node, &support) ? tabulate(sim, node, support, length) : NULL;
+                success = table != NULL;
+                free(table);
+            } else {
+                success = call_function(sim, func_call_node_view, values);
+            }
+            free(values);
+            return success ? NORMAL_S : FAILURE_S;
+        }
+        case IF_NODE_T: {
+            return execute_if(sim, (const if_node_t *) node);
+        }
+        case SWITCH_NODE_T: {
+            return execute_switch(sim, (const switch_node_t *) node);
+        }
+        case FOR_NODE_T: case DO_NODE_T: case WHILE_NODE_T: {
+            return execute_loop(sim, node);
+        }
+        case ASSIGN_NODE_T: {
+            return assign(sim, (const assign_node_t *) node) ? NORMAL_S : FAILURE_S;
+        }
+        case PHASE_NODE_T: {
+            const phase_node_t *phase_node_view = (const phase_node_t *) node;
+            long long value;
+            if (sim->is_tabulating) {
+                snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Changing a phase inside a quantum expression");
+                return FAILURE_S;
+            } else if (!evaluate_classical(sim, phase_node_view->right, &value, "Change of phase")) {
+                return FAILURE_S;
+            }
+
+            /* phases are counted in multiples of pi, so integral changes are signs */
+            double complex factor = ((value & 1) == 0) ? 1.0 : -1.0;
+            if (factor != 1.0) {
+                apply_phase(&(sim->state), 0, &factor, sim->mask);
+            }
+            return NORMAL_S;
+        }
+        case MEASURE_NODE_T: {
+            const node_t *child = ((const measure_node_t *) node)->child;
+            unsigned length = get_length_of_node(child);
+            long long *values = malloc(length * sizeof (long long));
+            if (values == NULL) {
+                snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Allocating memory for measurement failed");
+                return FAILURE_S;
+            }
+            bool success = measure(sim, child, values);
+            free(values);
+            return success ? NORMAL_S : FAILURE_S;
+        }
+        case BREAK_NODE_T: {
+            return check_jump(sim, false) ? BREAK_S : FAILURE_S;
+        }
+        case CONTINUE_NODE_T: {
+            return check_jump(sim, false) ? CONTINUE_S : FAILURE_S;
+        }
+        case RETURN_NODE_T: {
+            const return_node_t *return_node_view = (const return_node_t *) node;
+            if (!check_jump(sim, true)) {
+                return FAILURE_S;
+            } else if (return_node_view->return_value == NULL || sim->return_values == NULL) {
+                return RETURN_S;
+            } else if (!evaluate_classical(sim, return_node_view->return_value, sim->return_values, "Return value")) {
+                return FAILURE_S;
+            }
+            for (unsigned i = 0; i < sim->function_entry->length; ++i) {
+                sim->return_values[i] = normalize(sim->function_entry->type, sim->return_values[i]);
+            }
+            return RETURN_S;
+        }
+        default: {
+            snprintf(sim->error_msg, ERROR_MSG_LENGTH, "Node is not a statement");
+            return FAILURE_S;
+        }
+    }
+}
+
+/* See header for documentation */
+bool simulate_program(const node_t *root, const symbol_table_t *symbol_table, unsigned long long seed,
+                      unsigned num_of_threads, bool is_sparse, simulation_result_t *result,
+                      char error_msg[ERROR_MSG_LENGTH]) {
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    simulator_t sim;
+    memset(&sim, 0, sizeof (simulator_t));
+    sim.random_state = seed;
+    sim.num_of_threads = num_of_threads;
+    sim.is_sparse = is_sparse;
+    sim.error_msg = error_msg;
+    bool success = setup_simulator(&sim, root, symbol_table) && execute(&sim, root) == NORMAL_S;
+
+    const slot_t *main_slot = NULL;
+    for (unsigned i = 0; success && i < sim.num_of_slots; ++i) {
+        if (sim.slots[i].function != NULL && strcmp(sim.slots[i].entry->name, "main") == 0) {
+            main_slot = &(sim.slots[i]);
+        }
+    }
+
+    result->has_return_value = false;
+    if (main_slot != NULL && main_slot->entry->num_of_pars != 0) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Function main must not take parameters");
+        success = false;
+    } else if (main_slot != NULL) {
+        long long *values = calloc(main_slot->entry->length, sizeof (long long));
+        success = values != NULL && main_slot->function->func_tail != NULL
+                  && invoke_function(&sim, main_slot, NULL, NULL, values);
+        if (values == NULL || main_slot->function->func_tail == NULL) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Calling function main failed");
+        }
+        result->has_return_value = success && main_slot->entry->type != VOID_T && main_slot->entry->depth == 0;
+        result->return_type = main_slot->entry->type;
+        result->return_value = (values != NULL) ? values[0] : 0;
+        free(values);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    result->num_of_qubits = sim.state.num_of_qubits;
+    result->num_of_amplitude_ops = sim.state.num_of_amplitude_ops;
+    result->num_of_threads = (sim.state.pool != NULL) ? sim.state.pool->num_of_threads : 1;
+    result->num_of_numa_nodes = (sim.state.pool != NULL) ? sim.state.pool->num_of_nodes : 1;
+    result->is_sparse = sim.state.is_sparse;
+    result->max_num_of_entries = sim.state.max_num_of_entries;
+    result->seconds = (double) (end.tv_sec - start.tv_sec) + 1e-9 * (double) (end.tv_nsec - start.tv_nsec);
+    free_simulator(&sim);
+    return success;
+}
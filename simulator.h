@@ -0,0 +1,145 @@
+/**
+ * \file                                simulator.h
+ * \brief                               State vector simulator include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include "ast.h"
+#include "rules.h"
+#include "symbol_table.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Simulation result struct
+ * \note                                This structure defines the outcome of simulating a program
+ */
+typedef struct simulation_result {
+    unsigned num_of_qubits;                 /*!< Number of simulated qubits */
+    unsigned long long num_of_amplitude_ops;    /*!< Number of amplitudes read or written by kernels */
+    unsigned num_of_threads;                /*!< Number of worker threads the state vector was split over */
+    unsigned num_of_numa_nodes;             /*!< Number of NUMA nodes the worker threads ran on */
+    bool is_sparse;                         /*!< Whether the state vector ended up sparse */
+    size_t max_num_of_entries;              /*!< Largest number of basis states held by the sparse representation */
+    double seconds;                         /*!< Wall time of the simulation in seconds */
+    bool has_return_value;                  /*!< Whether a non-void scalar main function has been run */
+    type_t return_type;                     /*!< Return type of main function */
+    long long return_value;                 /*!< Value returned by main function */
+} simulation_result_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return number of qubits of a quantum register of given type
+ * \note                                Booleans take `QUANTUM_BOOL_WIDTH` qubits, integers take `QUANTUM_INT_WIDTH`
+ *                                      qubits in two's complement
+ * \param[in]                           type: Type of register
+ * \return                              Number of qubits
+ */
+unsigned get_type_width(type_t type);
+
+/**
+ * \brief                               Simulate a program on a state vector
+ * \note                                Every quantum variable gets a register of its own; global definitions are run in
+ *                                      order, then the function main (if defined) is called. Quantum-valued conditions
+ *                                      of if- and switch-statements control their branches, phase(x) += k multiplies
+ *                                      by exp(i pi k), [f] maps the zero state to the uniform superposition of the
+ *                                      values f holds for (and back, being a reflection), and irreversible assignments
+ *                                      measure their target register first. Measurements draw from a pseudo-random
+ *                                      generator seeded by the given seed. The state vector is split over the given
+ *                                      number of worker threads and may start sparse, turning dense once too many basis
+ *                                      states have nonzero amplitudes (see init_state_vector())
+ * \param[in]                           root: Pointer to root node of the program
+ * \param[in]                           symbol_table: Pointer to symbol table of the program
+ * \param[in]                           seed: Seed of the pseudo-random generator
+ * \param[in]                           num_of_threads: Number of worker threads (a power of two, at most
+ *                                      `MAX_NUM_OF_THREADS`)
+ * \param[in]                           is_sparse: Whether to start with the sparse representation
+ * \param[out]                          result: Pointer to simulation result
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the program could be simulated
+ */
+bool simulate_program(const node_t *root, const symbol_table_t *symbol_table, unsigned long long seed,
+                      unsigned num_of_threads, bool is_sparse, simulation_result_t *result,
+                      char error_msg[ERROR_MSG_LENGTH]);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SIMULATOR_H */
@@ -0,0 +1,2152 @@
+/**
+ * \file                                state_vector.c
+ * \brief                               State vector source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif /* __x86_64__ */
+#include "state_vector.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+/* Basis states are processed in blocks covered by one word of a control mask */
+#define BLOCK_SIZE 64
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HAS_X86_KERNELS
+#endif /* __x86_64__ */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Block map struct
+ * \note                                This structure defines a register map prepared for blockwise application: the
+ *                                      gathered bits of basis state `base + j` of a block are `gather_bits(base)` or-ed
+ *                                      with `low[j]`, as the domain bits inside and above a block are gathered apart
+ */
+typedef struct block_map {
+    unsigned first_qubit;                   /*!< First qubit of register */
+    size_t register_bits;                   /*!< Mask of the qubits of the register */
+    uint64_t domain;                        /*!< Mask of qubits the new value of the register depends on */
+    const size_t *values;                   /*!< Array of new register values indexed by gathered bits of the domain */
+    size_t low[BLOCK_SIZE];                 /*!< Array of gathered bits of the offsets within a block */
+} block_map_t;
+
+/**
+ * \brief                               Kernel table struct
+ * \note                                This structure defines the vectorizable kernels of one kernel level
+ */
+typedef struct kernel_table {
+    void (*scale)(double complex *amplitudes, size_t num_of_amplitudes, double complex factor,
+                  const uint64_t *mask);    /*!< Multiply the selected amplitudes by a factor */
+    void (*permute)(const double complex *amplitudes, double complex *images, size_t begin, size_t end,
+                    const block_map_t *map, const uint64_t *mask);  /*!< Move amplitudes to their images */
+    void (*reflect)(double complex *amplitudes, size_t stride, size_t num_of_values, const double *axis,
+                    size_t num_of_lanes, uint64_t selection);   /*!< Reflect the selected lanes of a register */
+} kernel_table_t;
+
+/**
+ * \brief                               Partition job struct
+ * \note                                This structure defines the arguments of an operation run by every worker on its
+ *                                      own partition; a worker writes only its own entry of the result array
+ */
+typedef struct partition_job {
+    const state_vector_t *state;            /*!< Pointer to state vector (whose arrays the workers write to) */
+    const kernel_table_t *kernels;          /*!< Pointer to kernels in use */
+    double complex *target;                 /*!< Array of amplitudes to be cleared */
+    uint64_t domain;                        /*!< Mask of qubits the lookup table is indexed by */
+    const void *table;                      /*!< Array of factors or predicate values indexed by gathered bits */
+    const uint64_t *mask;                   /*!< Control mask of the basis states to be changed (`NULL` for all) */
+    uint64_t *new_mask;                     /*!< Control mask to be built */
+    uint64_t *is_hit;                       /*!< Bit set of the images hit by a register map */
+    const block_map_t *map;                 /*!< Pointer to block map of a register map */
+    double complex factor;                  /*!< Factor of a phase or normalization */
+    const double *axis;                     /*!< Array of components of the axis of a reflection */
+    unsigned first_qubit;                   /*!< First qubit of register */
+    unsigned width;                         /*!< Number of qubits of register */
+    bool results[MAX_NUM_OF_THREADS];       /*!< Array of results, one per partition */
+} partition_job_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return whether a control mask selects a basis state
+ * \param[in]                           mask: Control mask (`NULL` selects every basis state)
+ * \param[in]                           index: Basis state
+ * \return                              Whether the basis state is selected
+ */
+static inline bool is_selected(const uint64_t *mask, size_t index) {
+    return mask == NULL || (mask[index >> 6] >> (index & 63) & 1) != 0;
+}
+
+/**
+ * \brief                               Return the word of a control mask covering a block
+ * \param[in]                           mask: Control mask (`NULL` selects every basis state)
+ * \param[in]                           base: First basis state of block
+ * \return                              Word of control mask
+ */
+static inline uint64_t get_mask_word(const uint64_t *mask, size_t base) {
+    return (mask == NULL) ? ~(uint64_t) 0 : mask[base / BLOCK_SIZE];
+}
+
+/**
+ * \brief                               Return number of words of the control masks of a dense state vector
+ * \param[in]                           state: Pointer to state vector
+ * \return                              Number of words (one bit per basis state)
+ */
+static inline size_t get_mask_size(const state_vector_t *state) {
+    return (state->num_of_amplitudes + 63) / 64;
+}
+
+/**
+ * \brief                               Gather the bits of all offsets within a block
+ * \param[in]                           domain: Mask of selected qubits
+ * \param[out]                          low: Array of gathered bits (one per offset)
+ */
+static void gather_block_offsets(uint64_t domain, size_t low[BLOCK_SIZE]) {
+    for (size_t j = 0; j < BLOCK_SIZE; ++j) {
+        low[j] = gather_bits(j, domain);
+    }
+}
+
+/**
+ * \brief                               Prepare register map for blockwise application
+ * \param[out]                          map: Pointer to block map
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           domain: Mask of qubits the new value of the register depends on
+ * \param[in]                           values: Array of new register values indexed by the gathered bits of the domain
+ */
+static void init_block_map(block_map_t *map, unsigned first_qubit, unsigned width, uint64_t domain,
+                           const size_t *values) {
+    map->first_qubit = first_qubit;
+    map->register_bits = (((size_t) 1 << width) - 1) << first_qubit;
+    map->domain = domain;
+    map->values = values;
+    gather_block_offsets(domain, map->low);
+}
+
+/**
+ * \brief                               Return image of a basis state under a register map
+ * \param[in]                           map: Pointer to block map
+ * \param[in]                           index: Basis state
+ * \param[in]                           gathered: Gathered bits of the basis state
+ * \param[in]                           is_changed: Whether the basis state is selected by the control mask
+ * \return                              Image of the basis state
+ */
+static inline size_t get_image(const block_map_t *map, size_t index, size_t gathered, bool is_changed) {
+    if (!is_changed) {
+        return index;
+    }
+    return (index & ~map->register_bits) | ((map->values[gathered] << map->first_qubit) & map->register_bits);
+}
+
+/**
+ * \brief                               Multiply the selected amplitudes by a factor (scalar kernel)
+ * \param[in,out]                       amplitudes: Array of amplitudes
+ * \param[in]                           num_of_amplitudes: Number of amplitudes
+ * \param[in]                           factor: Factor
+ * \param[in]                           mask: Control mask of the amplitudes to be changed (`NULL` for all)
+ */
+static void scale_scalar(double complex *amplitudes, size_t num_of_amplitudes, double complex factor,
+                         const uint64_t *mask) {
+    for (size_t base = 0; base < num_of_amplitudes; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        size_t end = (num_of_amplitudes - base < BLOCK_SIZE) ? num_of_amplitudes - base : BLOCK_SIZE;
+        for (size_t j = 0; j < end; ++j) {
+            if ((word >> j & 1) != 0) {
+                amplitudes[base + j] *= factor;
+            }
+        }
+    }
+}
+
+/**
+ * \brief                               Move every amplitude to its image under a permutation (scalar kernel)
+ * \param[in]                           amplitudes: Array of amplitudes
+ * \param[out]                          images: Array receiving the permuted amplitudes
+ * \param[in]                           begin: First basis state to be moved (a multiple of `BLOCK_SIZE`)
+ * \param[in]                           end: One past the last basis state to be moved
+ * \param[in]                           map: Pointer to block map of an injective register map
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ */
+static void permute_scalar(const double complex *amplitudes, double complex *images, size_t begin, size_t end,
+                           const block_map_t *map, const uint64_t *mask) {
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        size_t high = gather_bits(base, map->domain);
+        size_t block_end = (end - base < BLOCK_SIZE) ? end - base : BLOCK_SIZE;
+        for (size_t j = 0; j < block_end; ++j) {
+            images[get_image(map, base + j, high | map->low[j], (word >> j & 1) != 0)] = amplitudes[base + j];
+        }
+    }
+}
+
+/**
+ * \brief                               Reflect the selected lanes of a register about a real unit vector (scalar
+ *                                      kernel)
+ * \note                                Lane l of register value v is amplitude `v * stride + l`; the projections onto
+ *                                      the axis are computed for all lanes, and those of unselected lanes are zeroed
+ *                                      before the update so that these lanes keep their amplitudes
+ * \param[in,out]                       amplitudes: Array of amplitudes starting at lane 0 of register value 0
+ * \param[in]                           stride: Distance between the amplitudes of consecutive register values
+ * \param[in]                           num_of_values: Number of register values
+ * \param[in]                           axis: Array of components of the unit vector (one per register value)
+ * \param[in]                           num_of_lanes: Number of lanes (at most `BLOCK_SIZE` and at most the stride)
+ * \param[in]                           selection: Mask of the selected lanes
+ */
+static void reflect_scalar(double complex *amplitudes, size_t stride, size_t num_of_values, const double *axis,
+                           size_t num_of_lanes, uint64_t selection) {
+    /* the axis is real, so real and imaginary parts are reflected independently */
+    double *values = (double *) amplitudes;
+    size_t num_of_parts = 2 * num_of_lanes;
+    double projections[2 * BLOCK_SIZE];
+    for (size_t k = 0; k < num_of_parts; ++k) {
+        projections[k] = 0.0;
+    }
+    for (size_t v = 0; v < num_of_values; ++v) {
+        const double *run = values + 2 * v * stride;
+        for (size_t k = 0; k < num_of_parts; ++k) {
+            projections[k] += axis[v] * run[k];
+        }
+    }
+    for (size_t k = 0; k < num_of_parts; ++k) {
+        projections[k] = ((selection >> (k / 2) & 1) != 0) ? 2.0 * projections[k] : 0.0;
+    }
+    for (size_t v = 0; v < num_of_values; ++v) {
+        double *run = values + 2 * v * stride;
+        for (size_t k = 0; k < num_of_parts; ++k) {
+            run[k] -= axis[v] * projections[k];
+        }
+    }
+}
+
+#ifdef HAS_X86_KERNELS
+/**
+ * \brief                               Multiply the selected amplitudes by a factor (AVX2 kernel)
+ * \note                                Two amplitudes are multiplied per vector and blended by their mask bits
+ * \param[in,out]                       amplitudes: Array of amplitudes
+ * \param[in]                           num_of_amplitudes: Number of amplitudes
+ * \param[in]                           factor: Factor
+ * \param[in]                           mask: Control mask of the amplitudes to be changed (`NULL` for all)
+ */
+__attribute__((target("avx2")))
+static void scale_avx2(double complex *amplitudes, size_t num_of_amplitudes, double complex factor,
+                       const uint64_t *mask) {
+    if (num_of_amplitudes < BLOCK_SIZE) {
+        scale_scalar(amplitudes, num_of_amplitudes, factor, mask);
+        return;
+    }
+
+    const __m256d real = _mm256_set1_pd(creal(factor));
+    const __m256d imag = _mm256_set1_pd(cimag(factor));
+    const __m256i lane_bits = _mm256_set_epi64x(2, 2, 1, 1);
+    double *values = (double *) amplitudes;
+    for (size_t base = 0; base < num_of_amplitudes; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        if (word == 0) {
+            continue;
+        }
+        for (size_t j = 0; j < BLOCK_SIZE; j += 2) {
+            unsigned bits = (unsigned) (word >> j) & 3;
+            if (bits == 0) {
+                continue;
+            }
+            double *address = values + 2 * (base + j);
+            __m256d amplitude = _mm256_loadu_pd(address);
+            __m256d swapped = _mm256_permute_pd(amplitude, 0x5);
+            __m256d product = _mm256_addsub_pd(_mm256_mul_pd(amplitude, real), _mm256_mul_pd(swapped, imag));
+            if (bits != 3) {
+                __m256i selected = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), lane_bits),
+                                                      lane_bits);
+                product = _mm256_blendv_pd(amplitude, product, _mm256_castsi256_pd(selected));
+            }
+            _mm256_storeu_pd(address, product);
+        }
+    }
+}
+
+/**
+ * \brief                               Move every amplitude to its image under a permutation (AVX2 kernel)
+ * \note                                Images are computed for four basis states per vector, gathering the new register
+ *                                      values; the amplitudes are moved one by one
+ * \param[in]                           amplitudes: Array of amplitudes
+ * \param[out]                          images: Array receiving the permuted amplitudes
+ * \param[in]                           begin: First basis state to be moved (a multiple of `BLOCK_SIZE`)
+ * \param[in]                           end: One past the last basis state to be moved
+ * \param[in]                           map: Pointer to block map of an injective register map
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ */
+__attribute__((target("avx2")))
+static void permute_avx2(const double complex *amplitudes, double complex *images, size_t begin, size_t end,
+                         const block_map_t *map, const uint64_t *mask) {
+    if (end - begin < BLOCK_SIZE) {
+        permute_scalar(amplitudes, images, begin, end, map, mask);
+        return;
+    }
+
+    const __m256i offsets = _mm256_set_epi64x(3, 2, 1, 0);
+    const __m256i lane_bits = _mm256_set_epi64x(8, 4, 2, 1);
+    const __m256i register_bits = _mm256_set1_epi64x((long long) map->register_bits);
+    const __m128i shift = _mm_cvtsi32_si128((int) map->first_qubit);
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        __m256i high = _mm256_set1_epi64x((long long) gather_bits(base, map->domain));
+        for (size_t j = 0; j < BLOCK_SIZE; j += 4) {
+            __m256i index = _mm256_add_epi64(_mm256_set1_epi64x((long long) (base + j)), offsets);
+            __m256i gathered = _mm256_or_si256(high, _mm256_loadu_si256((const __m256i *) (map->low + j)));
+            __m256i values = _mm256_i64gather_epi64((const long long *) map->values, gathered, sizeof (size_t));
+            __m256i image = _mm256_or_si256(_mm256_andnot_si256(register_bits, index),
+                                            _mm256_and_si256(_mm256_sll_epi64(values, shift), register_bits));
+            __m256i selected = _mm256_cmpeq_epi64(
+                    _mm256_and_si256(_mm256_set1_epi64x((long long) (word >> j)), lane_bits), lane_bits);
+            size_t targets[4];
+            _mm256_storeu_si256((__m256i *) targets, _mm256_blendv_epi8(index, image, selected));
+            for (size_t k = 0; k < 4; ++k) {
+                __m128d amplitude = _mm_loadu_pd((const double *) (amplitudes + base + j + k));
+                _mm_storeu_pd((double *) (images + targets[k]), amplitude);
+            }
+        }
+    }
+}
+
+/**
+ * \brief                               Reflect the selected lanes of a register about a real unit vector (AVX2 kernel)
+ * \note                                Lanes are vectorized two by two if there are at least two; a register starting
+ *                                      at qubit 0 is vectorized over two register values at a time instead, folding
+ *                                      the partial projections at the end (see reflect_scalar())
+ * \param[in,out]                       amplitudes: Array of amplitudes starting at lane 0 of register value 0
+ * \param[in]                           stride: Distance between the amplitudes of consecutive register values
+ * \param[in]                           num_of_values: Number of register values
+ * \param[in]                           axis: Array of components of the unit vector (one per register value)
+ * \param[in]                           num_of_lanes: Number of lanes (at most `BLOCK_SIZE` and at most the stride)
+ * \param[in]                           selection: Mask of the selected lanes
+ */
+__attribute__((target("avx2")))
+static void reflect_avx2(double complex *amplitudes, size_t stride, size_t num_of_values, const double *axis,
+                         size_t num_of_lanes, uint64_t selection) {
+    double *values = (double *) amplitudes;
+    const __m256i lane_bits = _mm256_set_epi64x(2, 2, 1, 1);
+    if (num_of_lanes == 1 && stride == 1 && num_of_values >= 2) {
+        if ((selection & 1) == 0) {
+            return;
+        }
+        __m256d sum = _mm256_setzero_pd();
+        for (size_t v = 0; v < num_of_values; v += 2) {
+            __m256d components = _mm256_permute4x64_pd(_mm256_castpd128_pd256(_mm_loadu_pd(axis + v)), 0x50);
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(components, _mm256_loadu_pd(values + 2 * v)));
+        }
+        __m128d projection = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+        __m256d scaled = _mm256_mul_pd(_mm256_set_m128d(projection, projection), _mm256_set1_pd(2.0));
+        for (size_t v = 0; v < num_of_values; v += 2) {
+            __m256d components = _mm256_permute4x64_pd(_mm256_castpd128_pd256(_mm_loadu_pd(axis + v)), 0x50);
+            __m256d amplitude = _mm256_loadu_pd(values + 2 * v);
+            _mm256_storeu_pd(values + 2 * v, _mm256_sub_pd(amplitude, _mm256_mul_pd(components, scaled)));
+        }
+        return;
+    } else if (num_of_lanes % 2 != 0) {
+        reflect_scalar(amplitudes, stride, num_of_values, axis, num_of_lanes, selection);
+        return;
+    }
+
+    __m256d projections[BLOCK_SIZE / 2];
+    for (size_t k = 0; k < num_of_lanes / 2; ++k) {
+        projections[k] = _mm256_setzero_pd();
+    }
+    for (size_t v = 0; v < num_of_values; ++v) {
+        __m256d component = _mm256_set1_pd(axis[v]);
+        const double *run = values + 2 * v * stride;
+        for (size_t k = 0; k < num_of_lanes / 2; ++k) {
+            __m256d amplitude = _mm256_loadu_pd(run + 4 * k);
+            projections[k] = _mm256_add_pd(projections[k], _mm256_mul_pd(component, amplitude));
+        }
+    }
+    for (size_t k = 0; k < num_of_lanes / 2; ++k) {
+        __m256i selected = _mm256_cmpeq_epi64(
+                _mm256_and_si256(_mm256_set1_epi64x((long long) (selection >> (2 * k))), lane_bits), lane_bits);
+        projections[k] = _mm256_and_pd(_mm256_mul_pd(projections[k], _mm256_set1_pd(2.0)),
+                                       _mm256_castsi256_pd(selected));
+    }
+    for (size_t v = 0; v < num_of_values; ++v) {
+        __m256d component = _mm256_set1_pd(axis[v]);
+        double *run = values + 2 * v * stride;
+        for (size_t k = 0; k < num_of_lanes / 2; ++k) {
+            __m256d amplitude = _mm256_loadu_pd(run + 4 * k);
+            _mm256_storeu_pd(run + 4 * k, _mm256_sub_pd(amplitude, _mm256_mul_pd(component, projections[k])));
+        }
+    }
+}
+
+/**
+ * \brief                               Multiply the selected amplitudes by a factor (AVX-512 kernel)
+ * \note                                Four amplitudes are multiplied per vector and stored under their mask bits
+ * \param[in,out]                       amplitudes: Array of amplitudes
+ * \param[in]                           num_of_amplitudes: Number of amplitudes
+ * \param[in]                           factor: Factor
+ * \param[in]                           mask: Control mask of the amplitudes to be changed (`NULL` for all)
+ */
+__attribute__((target("avx512f")))
+static void scale_avx512(double complex *amplitudes, size_t num_of_amplitudes, double complex factor,
+                         const uint64_t *mask) {
+    if (num_of_amplitudes < BLOCK_SIZE) {
+        scale_scalar(amplitudes, num_of_amplitudes, factor, mask);
+        return;
+    }
+
+    /* every mask bit covers the real and the imaginary part of its amplitude */
+    static const __mmask8 lane_masks[16] = {
+        0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff,
+    };
+    const __m512d real = _mm512_set1_pd(creal(factor));
+    const __m512d imag = _mm512_set1_pd(cimag(factor));
+    double *values = (double *) amplitudes;
+    for (size_t base = 0; base < num_of_amplitudes; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        if (word == 0) {
+            continue;
+        }
+        for (size_t j = 0; j < BLOCK_SIZE; j += 4) {
+            __mmask8 lanes = lane_masks[(word >> j) & 15];
+            if (lanes == 0) {
+                continue;
+            }
+            double *address = values + 2 * (base + j);
+            __m512d amplitude = _mm512_loadu_pd(address);
+            __m512d swapped = _mm512_permute_pd(amplitude, 0x55);
+            __m512d product = _mm512_fmaddsub_pd(amplitude, real, _mm512_mul_pd(swapped, imag));
+            _mm512_mask_storeu_pd(address, lanes, product);
+        }
+    }
+}
+
+/**
+ * \brief                               Move every amplitude to its image under a permutation (AVX-512 kernel)
+ * \note                                Images are computed for eight basis states per vector, gathering the new
+ *                                      register values, and the amplitudes are scattered to them
+ * \param[in]                           amplitudes: Array of amplitudes
+ * \param[out]                          images: Array receiving the permuted amplitudes
+ * \param[in]                           begin: First basis state to be moved (a multiple of `BLOCK_SIZE`)
+ * \param[in]                           end: One past the last basis state to be moved
+ * \param[in]                           map: Pointer to block map of an injective register map
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ */
+__attribute__((target("avx512f")))
+static void permute_avx512(const double complex *amplitudes, double complex *images, size_t begin, size_t end,
+                           const block_map_t *map, const uint64_t *mask) {
+    if (end - begin < BLOCK_SIZE) {
+        permute_scalar(amplitudes, images, begin, end, map, mask);
+        return;
+    }
+
+    const __m512i offsets = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i register_bits = _mm512_set1_epi64((long long) map->register_bits);
+    const __m128i shift = _mm_cvtsi32_si128((int) map->first_qubit);
+    const __m512i lower_half = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+    const __m512i upper_half = _mm512_set_epi64(7, 7, 6, 6, 5, 5, 4, 4);
+    const __m512i parts = _mm512_set_epi64(1, 0, 1, 0, 1, 0, 1, 0);
+    const double *values = (const double *) amplitudes;
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        __m512i high = _mm512_set1_epi64((long long) gather_bits(base, map->domain));
+        for (size_t j = 0; j < BLOCK_SIZE; j += 8) {
+            __m512i index = _mm512_add_epi64(_mm512_set1_epi64((long long) (base + j)), offsets);
+            __m512i gathered = _mm512_or_si512(high, _mm512_loadu_si512((const void *) (map->low + j)));
+            __m512i new_values = _mm512_i64gather_epi64(gathered, (const void *) map->values, sizeof (size_t));
+            __m512i image = _mm512_or_si512(_mm512_andnot_si512(register_bits, index),
+                                            _mm512_and_si512(_mm512_sll_epi64(new_values, shift), register_bits));
+            image = _mm512_mask_blend_epi64((__mmask8) (word >> j), index, image);
+
+            /* amplitude k of the vector goes to the real and imaginary part of its image */
+            __m512i lower_targets = _mm512_add_epi64(_mm512_slli_epi64(_mm512_permutexvar_epi64(lower_half, image), 1),
+                                                     parts);
+            __m512i upper_targets = _mm512_add_epi64(_mm512_slli_epi64(_mm512_permutexvar_epi64(upper_half, image), 1),
+                                                     parts);
+            _mm512_i64scatter_pd((void *) images, lower_targets, _mm512_loadu_pd(values + 2 * (base + j)),
+                                 sizeof (double));
+            _mm512_i64scatter_pd((void *) images, upper_targets, _mm512_loadu_pd(values + 2 * (base + j) + 8),
+                                 sizeof (double));
+        }
+    }
+}
+/**
+ * \brief                               Reflect the selected lanes of a register about a real unit vector (AVX-512
+ *                                      kernel)
+ * \note                                Lanes are vectorized four by four if there are at least four; a register
+ *                                      starting at qubit 0 is vectorized over four register values at a time instead,
+ *                                      folding the partial projections at the end; other registers are left to
+ *                                      reflect_avx2()
+ * \param[in,out]                       amplitudes: Array of amplitudes starting at lane 0 of register value 0
+ * \param[in]                           stride: Distance between the amplitudes of consecutive register values
+ * \param[in]                           num_of_values: Number of register values
+ * \param[in]                           axis: Array of components of the unit vector (one per register value)
+ * \param[in]                           num_of_lanes: Number of lanes (at most `BLOCK_SIZE` and at most the stride)
+ * \param[in]                           selection: Mask of the selected lanes
+ */
+__attribute__((target("avx512f")))
+static void reflect_avx512(double complex *amplitudes, size_t stride, size_t num_of_values, const double *axis,
+                           size_t num_of_lanes, uint64_t selection) {
+    static const __mmask8 lane_masks[16] = {
+        0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff,
+    };
+    double *values = (double *) amplitudes;
+    if (num_of_lanes == 1 && stride == 1 && num_of_values >= 4) {
+        if ((selection & 1) == 0) {
+            return;
+        }
+        const __m512i spread = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+        __m512d sum = _mm512_setzero_pd();
+        for (size_t v = 0; v < num_of_values; v += 4) {
+            __m512d components = _mm512_permutexvar_pd(spread, _mm512_castpd256_pd512(_mm256_loadu_pd(axis + v)));
+            sum = _mm512_fmadd_pd(components, _mm512_loadu_pd(values + 2 * v), sum);
+        }
+        __m256d half = _mm256_add_pd(_mm512_castpd512_pd256(sum), _mm512_extractf64x4_pd(sum, 1));
+        __m128d projection = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+        __m512d scaled = _mm512_mul_pd(_mm512_permutexvar_pd(_mm512_set_epi64(1, 0, 1, 0, 1, 0, 1, 0),
+                                                              _mm512_castpd128_pd512(projection)),
+                                       _mm512_set1_pd(2.0));
+        for (size_t v = 0; v < num_of_values; v += 4) {
+            __m512d components = _mm512_permutexvar_pd(spread, _mm512_castpd256_pd512(_mm256_loadu_pd(axis + v)));
+            _mm512_storeu_pd(values + 2 * v, _mm512_fnmadd_pd(components, scaled, _mm512_loadu_pd(values + 2 * v)));
+        }
+        return;
+    } else if (num_of_lanes < 4) {
+        reflect_avx2(amplitudes, stride, num_of_values, axis, num_of_lanes, selection);
+        return;
+    }
+
+    __m512d projections[BLOCK_SIZE / 4];
+    for (size_t k = 0; k < num_of_lanes / 4; ++k) {
+        projections[k] = _mm512_setzero_pd();
+    }
+    for (size_t v = 0; v < num_of_values; ++v) {
+        __m512d component = _mm512_set1_pd(axis[v]);
+        const double *run = values + 2 * v * stride;
+        for (size_t k = 0; k < num_of_lanes / 4; ++k) {
+            projections[k] = _mm512_fmadd_pd(component, _mm512_loadu_pd(run + 8 * k), projections[k]);
+        }
+    }
+    for (size_t k = 0; k < num_of_lanes / 4; ++k) {
+        projections[k] = _mm512_maskz_mul_pd(lane_masks[(selection >> (4 * k)) & 15], projections[k],
+                                             _mm512_set1_pd(2.0));
+    }
+    for (size_t v = 0; v < num_of_values; ++v) {
+        __m512d component = _mm512_set1_pd(axis[v]);
+        double *run = values + 2 * v * stride;
+        for (size_t k = 0; k < num_of_lanes / 4; ++k) {
+            __m512d amplitude = _mm512_loadu_pd(run + 8 * k);
+            _mm512_storeu_pd(run + 8 * k, _mm512_fnmadd_pd(component, projections[k], amplitude));
+        }
+    }
+}
+#endif /* HAS_X86_KERNELS */
+
+/**
+ * \brief                               Kernels of all kernel levels
+ */
+static const kernel_table_t kernel_tables[NUM_OF_KERNEL_LEVELS] = {
+    [SCALAR_K] = {.scale = scale_scalar, .permute = permute_scalar, .reflect = reflect_scalar},
+#ifdef HAS_X86_KERNELS
+    [AVX2_K] = {.scale = scale_avx2, .permute = permute_avx2, .reflect = reflect_avx2},
+    [AVX512_K] = {.scale = scale_avx512, .permute = permute_avx512, .reflect = reflect_avx512},
+#endif /* HAS_X86_KERNELS */
+};
+
+/**
+ * \brief                               Kernel level in use (`NUM_OF_KERNEL_LEVELS` until it is first needed)
+ */
+static kernel_level_t kernel_level = NUM_OF_KERNEL_LEVELS;
+
+/**
+ * \brief                               Return kernels of the kernel level in use
+ * \return                              Pointer to kernel table
+ */
+static const kernel_table_t *get_kernels(void) {
+    return &(kernel_tables[get_kernel_level()]);
+}
+
+/**
+ * \brief                               Return number of amplitudes of a partition
+ * \param[in]                           state: Pointer to state vector
+ * \return                              Number of amplitudes per partition
+ */
+static inline size_t get_partition_size(const state_vector_t *state) {
+    return (size_t) 1 << state->num_of_local_qubits;
+}
+
+/**
+ * \brief                               Run a job on every partition, each by its own worker
+ * \param[in]                           state: Pointer to state vector
+ * \param[in]                           job: Job to be run
+ * \param[in,out]                       context: Pointer to partition job
+ */
+static void run_partitions(const state_vector_t *state, pool_job_t job, partition_job_t *context) {
+    context->state = state;
+    context->kernels = get_kernels();
+    if (state->pool == NULL) {
+        job(context, 0);
+    } else {
+        run_thread_pool(state->pool, job, context);
+    }
+}
+
+/**
+ * \brief                               Return whether a partition job succeeded on every partition
+ * \param[in]                           context: Pointer to partition job
+ * \return                              Whether all results are true
+ */
+static bool are_all_results(const partition_job_t *context) {
+    bool all = true;
+    for (unsigned i = 0; i < context->state->num_of_partitions; ++i) {
+        all = all && context->results[i];
+    }
+    return all;
+}
+
+/**
+ * \brief                               Return whether a partition job succeeded on any partition
+ * \param[in]                           context: Pointer to partition job
+ * \return                              Whether any result is true
+ */
+static bool is_any_result(const partition_job_t *context) {
+    bool any = false;
+    for (unsigned i = 0; i < context->state->num_of_partitions; ++i) {
+        any = any || context->results[i];
+    }
+    return any;
+}
+
+/**
+ * \brief                               Return whether a register lies on the qubits below the partition-selecting ones
+ * \note                                Register maps and reflections of such a register never cross partitions
+ * \param[in]                           state: Pointer to state vector
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \return                              Whether the register is local
+ */
+static inline bool is_local_register(const state_vector_t *state, unsigned first_qubit, unsigned width) {
+    return first_qubit + width <= state->num_of_local_qubits;
+}
+
+/**
+ * \brief                               Compute the norms of the chunks of a range of amplitudes
+ * \note                                Norms are summed chunk by chunk, so that they do not depend on the number of
+ *                                      partitions
+ * \param[in]                           state: Pointer to state vector
+ * \param[in]                           begin: First amplitude (a multiple of `MIN_PARTITION_SIZE`)
+ * \param[in]                           end: One past the last amplitude
+ */
+static void compute_chunk_norms(const state_vector_t *state, size_t begin, size_t end) {
+    for (size_t chunk = begin; chunk < end; chunk += MIN_PARTITION_SIZE) {
+        size_t chunk_end = (end - chunk < MIN_PARTITION_SIZE) ? end : chunk + MIN_PARTITION_SIZE;
+        double norm = 0.0;
+        for (size_t i = chunk; i < chunk_end; ++i) {
+            norm += creal(state->amplitudes[i] * conj(state->amplitudes[i]));
+        }
+        state->chunk_norms[chunk / MIN_PARTITION_SIZE] = norm;
+    }
+}
+
+/**
+ * \brief                               Return the norm of the state vector from its chunk norms
+ * \param[in]                           state: Pointer to state vector
+ * \return                              Squared norm
+ */
+static double sum_chunk_norms(const state_vector_t *state) {
+    double norm = 0.0;
+    for (size_t chunk = 0; chunk * MIN_PARTITION_SIZE < state->num_of_amplitudes; ++chunk) {
+        norm += state->chunk_norms[chunk];
+    }
+    return norm;
+}
+
+/**
+ * \brief                               Zero the own partition of an array of amplitudes (partition job)
+ * \note                                Being the first write to the partition, this places its pages on the worker's
+ *                                      NUMA node
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void clear_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t size = get_partition_size(job->state);
+    memset(job->target + id * size, 0, size * sizeof (double complex));
+}
+
+/**
+ * \brief                               Build the own partition of a control mask (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void build_mask_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    const bool *table = job->table;
+    size_t begin = id * get_partition_size(job->state);
+    size_t end = begin + get_partition_size(job->state);
+    size_t low[BLOCK_SIZE];
+    gather_block_offsets(job->domain, low);
+    uint64_t any = 0;
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        const bool *block_table = table + gather_bits(base, job->domain);
+        size_t block_end = (end - base < BLOCK_SIZE) ? end - base : BLOCK_SIZE;
+        uint64_t word = 0;
+        for (size_t j = 0; j < block_end; ++j) {
+            word |= (uint64_t) block_table[low[j]] << j;
+        }
+        word &= get_mask_word(job->mask, base);
+        job->new_mask[base / BLOCK_SIZE] = word;
+        any |= word;
+    }
+    job->results[id] = any != 0;
+}
+
+/**
+ * \brief                               Multiply the amplitudes of the own partition by their factors (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void phase_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    double complex *amplitudes = job->state->amplitudes;
+    size_t begin = id * get_partition_size(job->state);
+    size_t end = begin + get_partition_size(job->state);
+    if (job->domain == 0) {
+        job->kernels->scale(amplitudes + begin, end - begin, job->factor,
+                            (job->mask == NULL) ? NULL : job->mask + begin / BLOCK_SIZE);
+        return;
+    }
+
+    const double complex *factors = job->table;
+    size_t low[BLOCK_SIZE];
+    gather_block_offsets(job->domain, low);
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(job->mask, base);
+        const double complex *block_factors = factors + gather_bits(base, job->domain);
+        size_t block_end = (end - base < BLOCK_SIZE) ? end - base : BLOCK_SIZE;
+        for (size_t j = 0; j < block_end; ++j) {
+            if ((word >> j & 1) != 0) {
+                amplitudes[base + j] *= block_factors[low[j]];
+            }
+        }
+    }
+}
+
+/**
+ * \brief                               Mark the images of a range of basis states and check that none is hit twice
+ * \param[in]                           map: Pointer to block map
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ * \param[in,out]                       is_hit: Bit set of the images hit so far
+ * \param[in]                           begin: First basis state (a multiple of `BLOCK_SIZE`)
+ * \param[in]                           end: One past the last basis state
+ * \return                              Whether no image was hit twice
+ */
+static bool mark_images(const block_map_t *map, const uint64_t *mask, uint64_t *is_hit, size_t begin, size_t end) {
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        size_t high = gather_bits(base, map->domain);
+        size_t block_end = (end - base < BLOCK_SIZE) ? end - base : BLOCK_SIZE;
+        for (size_t j = 0; j < block_end; ++j) {
+            size_t image = get_image(map, base + j, high | map->low[j], (word >> j & 1) != 0);
+            if ((is_hit[image >> 6] >> (image & 63) & 1) != 0) {
+                return false;
+            }
+            is_hit[image >> 6] |= (uint64_t) 1 << (image & 63);
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Check a register map on the own partition (partition job)
+ * \note                                The register must be local, so that images stay in the partition
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void check_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t begin = id * get_partition_size(job->state);
+    job->results[id] = mark_images(job->map, job->mask, job->is_hit, begin, begin + get_partition_size(job->state));
+}
+
+/**
+ * \brief                               Move the amplitudes of the own partition to their images (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void permute_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t begin = id * get_partition_size(job->state);
+    job->kernels->permute(job->state->amplitudes, job->state->scratch, begin, begin + get_partition_size(job->state),
+                          job->map, job->mask);
+}
+
+/**
+ * \brief                               Add the amplitudes of a range of basis states to those of their images
+ * \note                                The images must lie in the range, which is cleared in the scratch array first
+ * \param[in]                           state: Pointer to state vector
+ * \param[in]                           map: Pointer to block map
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ * \param[in]                           begin: First basis state (a multiple of `BLOCK_SIZE`)
+ * \param[in]                           end: One past the last basis state
+ */
+static void sum_images(const state_vector_t *state, const block_map_t *map, const uint64_t *mask, size_t begin,
+                       size_t end) {
+    memset(state->scratch + begin, 0, (end - begin) * sizeof (double complex));
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        uint64_t word = get_mask_word(mask, base);
+        size_t high = gather_bits(base, map->domain);
+        size_t block_end = (end - base < BLOCK_SIZE) ? end - base : BLOCK_SIZE;
+        for (size_t j = 0; j < block_end; ++j) {
+            if (state->amplitudes[base + j] != 0.0) {
+                state->scratch[get_image(map, base + j, high | map->low[j], (word >> j & 1) != 0)]
+                        += state->amplitudes[base + j];
+            }
+        }
+    }
+}
+
+/**
+ * \brief                               Add the amplitudes of the own partition to those of their images (partition
+ *                                      job)
+ * \note                                The register must be local, so that images stay in the partition
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void sum_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t begin = id * get_partition_size(job->state);
+    sum_images(job->state, job->map, job->mask, begin, begin + get_partition_size(job->state));
+}
+
+/**
+ * \brief                               Reflect a group of lanes of a register
+ * \param[in]                           job: Pointer to partition job of a reflection
+ * \param[in]                           base: Basis state of lane 0 of register value 0
+ * \param[in]                           num_of_lanes: Number of lanes (at most `BLOCK_SIZE`, a power of two)
+ * \return                              Whether the control mask is equal for all register values of every lane
+ */
+static bool reflect_lanes(const partition_job_t *job, size_t base, size_t num_of_lanes) {
+    const uint64_t *mask = job->mask;
+    size_t num_of_values = (size_t) 1 << job->width;
+    size_t stride = (size_t) 1 << job->first_qubit;
+    uint64_t all_lanes = (num_of_lanes == BLOCK_SIZE) ? ~(uint64_t) 0 : ((uint64_t) 1 << num_of_lanes) - 1;
+    uint64_t selection = all_lanes;
+    if (mask != NULL) {
+        selection = (mask[base >> 6] >> (base & 63)) & all_lanes;
+        for (size_t v = 1; v < num_of_values; ++v) {
+            size_t index = base + v * stride;
+            if (((mask[index >> 6] >> (index & 63)) & all_lanes) != selection) {
+                return false;
+            }
+        }
+    }
+    if (selection != 0) {
+        job->kernels->reflect(job->state->amplitudes + base, stride, num_of_values, job->axis, num_of_lanes,
+                              selection);
+    }
+    return true;
+}
+
+/**
+ * \brief                               Reflect a local register in every group of the own partition (partition job)
+ * \note                                The lanes of a register value lie next to each other and the values `stride`
+ *                                      apart, so a group of up to `BLOCK_SIZE` lanes is reflected at once; the result
+ *                                      is false if the control mask differs between the values of a lane
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void reflect_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t num_of_values = (size_t) 1 << job->width;
+    size_t stride = (size_t) 1 << job->first_qubit;
+    size_t num_of_lanes = (stride < BLOCK_SIZE) ? stride : BLOCK_SIZE;
+    size_t begin = id * get_partition_size(job->state);
+    size_t end = begin + get_partition_size(job->state);
+    job->results[id] = true;
+    for (size_t high = begin; high < end && job->results[id]; high += stride * num_of_values) {
+        for (size_t low = 0; low < stride && job->results[id]; low += num_of_lanes) {
+            job->results[id] = reflect_lanes(job, high + low, num_of_lanes);
+        }
+    }
+}
+
+/**
+ * \brief                               Return the partition of a group of partitions holding a register value share
+ * \note                                The partitions of a group differ only in the partition-selecting qubits of a
+ *                                      non-local register; their rank is the value of these qubits
+ * \param[in]                           job: Pointer to partition job of a non-local reflection
+ * \param[in]                           id: Index of any partition of the group
+ * \param[in]                           rank: Rank of the wanted partition within the group
+ * \return                              Index of partition
+ */
+static unsigned get_group_member(const partition_job_t *job, unsigned id, unsigned rank) {
+    unsigned num_of_local_qubits = job->state->num_of_local_qubits;
+    unsigned low_bit = ((job->first_qubit > num_of_local_qubits) ? job->first_qubit : num_of_local_qubits)
+                       - num_of_local_qubits;
+    unsigned group_bits = ((1U << (job->first_qubit + job->width - num_of_local_qubits - low_bit)) - 1) << low_bit;
+    return (id & ~group_bits) | (rank << low_bit);
+}
+
+/**
+ * \brief                               Return the rank of a partition within its group
+ * \param[in]                           job: Pointer to partition job of a non-local reflection
+ * \param[in]                           id: Index of partition
+ * \param[out]                          num_of_members: Number of partitions of the group
+ * \return                              Rank of partition
+ */
+static unsigned get_group_rank(const partition_job_t *job, unsigned id, unsigned *num_of_members) {
+    unsigned num_of_local_qubits = job->state->num_of_local_qubits;
+    unsigned low_bit = ((job->first_qubit > num_of_local_qubits) ? job->first_qubit : num_of_local_qubits)
+                       - num_of_local_qubits;
+    *num_of_members = 1U << (job->first_qubit + job->width - num_of_local_qubits - low_bit);
+    return (id >> low_bit) & (*num_of_members - 1);
+}
+
+/**
+ * \brief                               Return the number of lanes of a non-local register within one partition
+ * \param[in]                           job: Pointer to partition job of a non-local reflection
+ * \return                              Number of lanes (the lanes of a register value lie next to each other)
+ */
+static size_t get_partition_lanes(const partition_job_t *job) {
+    size_t stride = (size_t) 1 << job->first_qubit;
+    return (stride < get_partition_size(job->state)) ? stride : get_partition_size(job->state);
+}
+
+/**
+ * \brief                               Return whether the partitions of every group of a non-local register share
+ *                                      one NUMA node
+ * \param[in]                           job: Pointer to partition job of a non-local reflection
+ * \return                              Whether no group spans several nodes
+ */
+static bool is_group_on_one_node(const partition_job_t *job) {
+    const thread_pool_t *pool = job->state->pool;
+    for (unsigned id = 0; id < job->state->num_of_partitions; ++id) {
+        if (pool->workers[id].node != pool->workers[get_group_member(job, id, 0)].node) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Reflect the own share of the lanes of a non-local register (partition job)
+ * \note                                The share of rank r are lanes [n r / m, n (r + 1) / m) of the n lanes of a
+ *                                      group of m partitions; each worker reads and writes these lanes in all
+ *                                      partitions of its group
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void exchange_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t num_of_lanes = get_partition_lanes(job);
+    unsigned num_of_members;
+    unsigned rank = get_group_rank(job, id, &num_of_members);
+    size_t share = num_of_lanes / num_of_members;
+    size_t group_size = (share < BLOCK_SIZE) ? share : BLOCK_SIZE;
+    size_t base = get_group_member(job, id, 0) * get_partition_size(job->state) + share * rank;
+    job->results[id] = true;
+    for (size_t lane = 0; lane < share && job->results[id]; lane += group_size) {
+        job->results[id] = reflect_lanes(job, base + lane, group_size);
+    }
+}
+
+/**
+ * \brief                               Project the own partition of a non-local register onto the axis (partition
+ *                                      job)
+ * \note                                The partial projections of all lanes are written to the scratch array at the
+ *                                      start of the partition; the result is false if the control mask of a lane
+ *                                      differs from that of register value 0
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void project_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t size = get_partition_size(job->state);
+    size_t num_of_lanes = get_partition_lanes(job);
+    size_t num_of_parts = 2 * num_of_lanes;
+    size_t first_value = ((id * size) >> job->first_qubit) & (((size_t) 1 << job->width) - 1);
+    const double *values = (const double *) (job->state->amplitudes + id * size);
+    double *projections = (double *) (job->state->scratch + id * size);
+    size_t tile_size = (num_of_parts < 2 * BLOCK_SIZE) ? num_of_parts : 2 * BLOCK_SIZE;
+    for (size_t first_part = 0; first_part < num_of_parts; first_part += tile_size) {
+        /* a tile of lanes is summed up over all register values while it stays in cache */
+        double tile[2 * BLOCK_SIZE];
+        for (size_t k = 0; k < tile_size; ++k) {
+            tile[k] = 0.0;
+        }
+        for (size_t v = 0; v < size / num_of_lanes; ++v) {
+            double component = job->axis[first_value | v];
+            const double *run = values + 2 * v * num_of_lanes + first_part;
+            for (size_t k = 0; k < tile_size; ++k) {
+                tile[k] += component * run[k];
+            }
+        }
+        memcpy(projections + first_part, tile, tile_size * sizeof (double));
+    }
+
+    job->results[id] = true;
+    if (job->mask != NULL) {
+        size_t reference = get_group_member(job, id, 0) * size;
+        size_t run_length = (num_of_lanes < BLOCK_SIZE) ? num_of_lanes : BLOCK_SIZE;
+        uint64_t all_lanes = (run_length == BLOCK_SIZE) ? ~(uint64_t) 0 : ((uint64_t) 1 << run_length) - 1;
+        for (size_t offset = 0; offset < size && job->results[id]; offset += run_length) {
+            size_t index = id * size + offset;
+            size_t reference_index = reference + offset % num_of_lanes;
+            job->results[id] = ((job->mask[index >> 6] >> (index & 63)) & all_lanes)
+                               == ((job->mask[reference_index >> 6] >> (reference_index & 63)) & all_lanes);
+        }
+    }
+}
+
+/**
+ * \brief                               Sum up the own share of the partial projections of a group (partition job)
+ * \note                                The share of rank r are parts [2 n r / m, 2 n (r + 1) / m) of the n lanes of a
+ *                                      group of m partitions; each worker reads only its own share from the others
+ *                                      and writes it to its own scratch array. Sums of unselected lanes are zeroed,
+ *                                      the others doubled
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void reduce_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t size = get_partition_size(job->state);
+    size_t num_of_parts = 2 * get_partition_lanes(job);
+    unsigned num_of_members;
+    unsigned rank = get_group_rank(job, id, &num_of_members);
+    size_t first_part = num_of_parts * rank / num_of_members;
+    size_t end_part = num_of_parts * (rank + 1) / num_of_members;
+    double *projections = (double *) (job->state->scratch + id * size);
+    for (unsigned member = 0; member < num_of_members; ++member) {
+        if (member == rank) {
+            continue;
+        }
+        const double *partial = (const double *) (job->state->scratch + get_group_member(job, id, member) * size);
+        for (size_t k = first_part; k < end_part; ++k) {
+            projections[k] += partial[k];
+        }
+    }
+
+    size_t reference = get_group_member(job, id, 0) * size;
+    for (size_t k = first_part; k < end_part; ++k) {
+        projections[k] = is_selected(job->mask, reference + k / 2) ? 2.0 * projections[k] : 0.0;
+    }
+}
+
+/**
+ * \brief                               Update the own partition of a non-local register by the summed projections
+ *                                      (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void update_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t size = get_partition_size(job->state);
+    size_t num_of_lanes = get_partition_lanes(job);
+    size_t num_of_parts = 2 * num_of_lanes;
+    size_t first_value = ((id * size) >> job->first_qubit) & (((size_t) 1 << job->width) - 1);
+    unsigned num_of_members;
+    get_group_rank(job, id, &num_of_members);
+    double *values = (double *) (job->state->amplitudes + id * size);
+    size_t tile_size = (num_of_parts < 2 * BLOCK_SIZE) ? num_of_parts : 2 * BLOCK_SIZE;
+    for (unsigned member = 0; member < num_of_members; ++member) {
+        const double *projections = (const double *) (job->state->scratch + get_group_member(job, id, member) * size);
+        size_t end_part = num_of_parts * (member + 1) / num_of_members;
+        for (size_t first_part = num_of_parts * member / num_of_members; first_part < end_part;
+             first_part += tile_size) {
+            double tile[2 * BLOCK_SIZE];
+            size_t tile_end = (end_part - first_part < tile_size) ? end_part - first_part : tile_size;
+            memcpy(tile, projections + first_part, tile_end * sizeof (double));
+            for (size_t v = 0; v < size / num_of_lanes; ++v) {
+                double component = job->axis[first_value | v];
+                double *run = values + 2 * v * num_of_lanes + first_part;
+                for (size_t k = 0; k < tile_end; ++k) {
+                    run[k] -= component * tile[k];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * \brief                               Check that a register is zero in the own partition (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void check_clear_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t register_bits = (((size_t) 1 << job->width) - 1) << job->first_qubit;
+    size_t begin = id * get_partition_size(job->state);
+    size_t end = begin + get_partition_size(job->state);
+    job->results[id] = true;
+    for (size_t i = begin; i < end && job->results[id]; ++i) {
+        job->results[id] = (i & register_bits) == 0 || job->state->amplitudes[i] == 0.0;
+    }
+}
+
+/**
+ * \brief                               Compute the chunk norms of the own partition (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void norm_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t begin = id * get_partition_size(job->state);
+    compute_chunk_norms(job->state, begin, begin + get_partition_size(job->state));
+}
+
+/**
+ * \brief                               Zero the amplitudes of the own partition not kept by a predicate and compute
+ *                                      the chunk norms (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void project_out_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    const bool *keep = job->table;
+    double complex *amplitudes = job->state->amplitudes;
+    size_t begin = id * get_partition_size(job->state);
+    size_t end = begin + get_partition_size(job->state);
+    size_t low[BLOCK_SIZE];
+    gather_block_offsets(job->domain, low);
+    for (size_t base = begin; base < end; base += BLOCK_SIZE) {
+        const bool *block_keep = keep + gather_bits(base, job->domain);
+        size_t block_end = (end - base < BLOCK_SIZE) ? end - base : BLOCK_SIZE;
+        for (size_t j = 0; j < block_end; ++j) {
+            if (!block_keep[low[j]]) {
+                amplitudes[base + j] = 0.0;
+            }
+        }
+    }
+    compute_chunk_norms(job->state, begin, end);
+}
+
+/**
+ * \brief                               Multiply all amplitudes of the own partition by a factor (partition job)
+ * \param[in,out]                       context: Pointer to partition job
+ * \param[in]                           id: Index of partition
+ */
+static void rescale_partition(void *context, unsigned id) {
+    partition_job_t *job = context;
+    size_t begin = id * get_partition_size(job->state);
+    size_t end = begin + get_partition_size(job->state);
+    for (size_t i = begin; i < end; ++i) {
+        job->state->amplitudes[i] *= job->factor;
+    }
+}
+
+/**
+ * \brief                               Allocate the scratch array of a state vector unless done before
+ * \note                                Like the amplitudes, every partition of the scratch array is first touched by
+ *                                      its own worker
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the scratch array is allocated
+ */
+static bool allocate_scratch(state_vector_t *state, char error_msg[ERROR_MSG_LENGTH]) {
+    if (state->scratch != NULL) {
+        return true;
+    }
+
+    state->scratch = malloc(state->num_of_amplitudes * sizeof (double complex));
+    if (state->scratch == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for %zu scratch amplitudes failed",
+                 state->num_of_amplitudes);
+        return false;
+    }
+    partition_job_t job;
+    job.target = state->scratch;
+    run_partitions(state, clear_partition, &job);
+    return true;
+}
+
+/**
+ * \brief                               Return the first slot probed for a basis state
+ * \note                                The Fibonacci hash spreads the consecutive basis states of a register over the
+ *                                      slots
+ * \param[in]                           map: Pointer to sparse map
+ * \param[in]                           basis_state: Basis state
+ * \return                              Index of slot
+ */
+static inline size_t hash_basis_state(const sparse_map_t *map, size_t basis_state) {
+    return (size_t) (((uint64_t) basis_state * 0x9E3779B97F4A7C15ULL) >> (64 - map->num_of_slot_bits));
+}
+
+/**
+ * \brief                               Return the slot of a basis state, or the empty slot it would be stored in
+ * \param[in]                           map: Pointer to sparse map
+ * \param[in]                           basis_state: Basis state
+ * \return                              Pointer to slot
+ */
+static size_t *find_slot(const sparse_map_t *map, size_t basis_state) {
+    size_t last_slot = ((size_t) 1 << map->num_of_slot_bits) - 1;
+    size_t slot = hash_basis_state(map, basis_state);
+    while (map->slots[slot] != 0 && map->entries[map->slots[slot] - 1].basis_state != basis_state) {
+        slot = (slot + 1) & last_slot;
+    }
+    return map->slots + slot;
+}
+
+/**
+ * \brief                               Rebuild the hash table of a sparse map from its entries
+ * \param[in,out]                       map: Pointer to sparse map
+ */
+static void index_sparse_map(sparse_map_t *map) {
+    memset(map->slots, 0, ((size_t) 1 << map->num_of_slot_bits) * sizeof (size_t));
+    for (size_t i = 0; i < map->num_of_entries; ++i) {
+        *find_slot(map, map->entries[i].basis_state) = i + 1;
+    }
+}
+
+/**
+ * \brief                               Initialize sparse map without entries
+ * \param[out]                          map: Pointer to sparse map
+ * \param[in]                           num_of_entries: Number of entries to make room for
+ * \return                              Whether initialization was successful
+ */
+static bool init_sparse_map(sparse_map_t *map, size_t num_of_entries) {
+    map->capacity = INITIAL_SPARSE_MAP_SIZE;
+    map->num_of_slot_bits = 1;
+    while ((size_t) 1 << map->num_of_slot_bits < 2 * map->capacity) {
+        ++(map->num_of_slot_bits);
+    }
+    while (map->capacity < num_of_entries) {
+        map->capacity *= 2;
+        ++(map->num_of_slot_bits);
+    }
+    map->num_of_entries = 0;
+    map->entries = malloc(map->capacity * sizeof (sparse_entry_t));
+    map->slots = calloc((size_t) 1 << map->num_of_slot_bits, sizeof (size_t));
+    if (map->entries == NULL || map->slots == NULL) {
+        free(map->entries);
+        free(map->slots);
+        map->entries = NULL;
+        map->slots = NULL;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief                               Free entries and hash table of sparse map
+ * \param[in,out]                       map: Pointer to sparse map
+ */
+static void free_sparse_map(sparse_map_t *map) {
+    free(map->entries);
+    free(map->slots);
+    map->entries = NULL;
+    map->slots = NULL;
+    map->num_of_entries = 0;
+}
+
+/**
+ * \brief                               Add an amplitude to the entry of a basis state, creating the entry if needed
+ * \param[in,out]                       map: Pointer to sparse map
+ * \param[in]                           basis_state: Basis state
+ * \param[in]                           amplitude: Amplitude to be added
+ * \return                              Whether the entry could be created
+ */
+static bool add_amplitude(sparse_map_t *map, size_t basis_state, double complex amplitude) {
+    size_t *slot = find_slot(map, basis_state);
+    if (*slot != 0) {
+        map->entries[*slot - 1].amplitude += amplitude;
+        return true;
+    }
+
+    if (map->num_of_entries == map->capacity) {
+        sparse_entry_t *entries = realloc(map->entries, 2 * map->capacity * sizeof (sparse_entry_t));
+        if (entries == NULL) {
+            return false;
+        }
+        map->entries = entries;
+        size_t *slots = realloc(map->slots, ((size_t) 2 << map->num_of_slot_bits) * sizeof (size_t));
+        if (slots == NULL) {
+            return false;
+        }
+        map->slots = slots;
+        map->capacity *= 2;
+        ++(map->num_of_slot_bits);
+        index_sparse_map(map);
+        slot = find_slot(map, basis_state);
+    }
+    map->entries[map->num_of_entries].basis_state = basis_state;
+    map->entries[map->num_of_entries].amplitude = amplitude;
+    *slot = ++(map->num_of_entries);
+    return true;
+}
+
+/**
+ * \brief                               Remove the entries of negligible probability from a sparse map
+ * \note                                Reflections leave rounding errors where amplitudes cancel; dropping them keeps
+ *                                      the map as small as the state it stands for
+ * \param[in,out]                       map: Pointer to sparse map
+ */
+static void prune_sparse_map(sparse_map_t *map) {
+    size_t num_of_kept = 0;
+    for (size_t i = 0; i < map->num_of_entries; ++i) {
+        double complex amplitude = map->entries[i].amplitude;
+        if (creal(amplitude * conj(amplitude)) >= MIN_SPARSE_PROBABILITY) {
+            map->entries[num_of_kept++] = map->entries[i];
+        }
+    }
+    if (num_of_kept != map->num_of_entries) {
+        map->num_of_entries = num_of_kept;
+        index_sparse_map(map);
+    }
+}
+
+/**
+ * \brief                               Compare the basis states of two sparse entries (for qsort())
+ * \param[in]                           a: Pointer to first entry
+ * \param[in]                           b: Pointer to second entry
+ * \return                              Negative, zero or positive if the first basis state is lower, equal or higher
+ */
+static int compare_entries(const void *a, const void *b) {
+    size_t left = ((const sparse_entry_t *) a)->basis_state;
+    size_t right = ((const sparse_entry_t *) b)->basis_state;
+    return (left > right) - (left < right);
+}
+
+/**
+ * \brief                               Return whether the predicates of a control mask select a basis state
+ * \note                                Only predicates on qubits of the given domain are evaluated, so that a basis
+ *                                      state whose other qubits are arbitrary can be tested
+ * \param[in]                           mask: Control mask (`NULL` selects every basis state)
+ * \param[in]                           index: Basis state
+ * \param[in]                           domain: Mask of the qubits of the predicates to be evaluated
+ * \return                              Whether the basis state fulfills every evaluated predicate
+ */
+static bool is_selected_by_terms(const control_mask_t *mask, size_t index, uint64_t domain) {
+    if (mask == NULL) {
+        return true;
+    }
+    for (unsigned i = 0; i < mask->num_of_terms; ++i) {
+        const control_term_t *term = mask->terms + i;
+        if ((term->domain & domain) != 0 && !term->table[gather_bits(index, term->domain)]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Extend a domain by the qubits of all predicates linked to it
+ * \note                                A predicate is linked if it shares a qubit with the domain or with a linked
+ *                                      predicate. The other predicates do not depend on the extended domain, so a
+ *                                      property of the mask on it holds for every basis state once it holds for all
+ *                                      assignments of the extended domain (given that the mask selects any basis state)
+ * \param[in]                           mask: Control mask (`NULL` for none)
+ * \param[in]                           domain: Mask of qubits
+ * \return                              Mask of the qubits of the domain and of the linked predicates
+ */
+static uint64_t get_linked_domain(const control_mask_t *mask, uint64_t domain) {
+    bool is_grown = mask != NULL;
+    while (is_grown) {
+        is_grown = false;
+        for (unsigned i = 0; i < mask->num_of_terms; ++i) {
+            uint64_t term_domain = mask->terms[i].domain;
+            if ((term_domain & domain) != 0 && (term_domain & ~domain) != 0) {
+                domain |= term_domain;
+                is_grown = true;
+            }
+        }
+    }
+    return domain;
+}
+
+/**
+ * \brief                               Copy the predicates of a parent mask and add one more
+ * \param[out]                          mask: Pointer to control mask
+ * \param[in]                           parent_mask: Control mask whose predicates are copied (`NULL` for none)
+ * \param[in]                           domain: Mask of qubits the added predicate depends on
+ * \param[in]                           table: Array of values of the added predicate
+ * \return                              Whether the predicates could be copied
+ */
+static bool copy_terms(control_mask_t *mask, const control_mask_t *parent_mask, uint64_t domain, const bool *table) {
+    unsigned num_of_terms = ((parent_mask == NULL) ? 0 : parent_mask->num_of_terms) + 1;
+    mask->terms = calloc(num_of_terms, sizeof (control_term_t));
+    if (mask->terms == NULL) {
+        return false;
+    }
+    for (unsigned i = 0; i < num_of_terms; ++i) {
+        const control_term_t *source = (i + 1 < num_of_terms) ? parent_mask->terms + i : NULL;
+        uint64_t term_domain = (source == NULL) ? domain : source->domain;
+        size_t table_size = (size_t) 1 << __builtin_popcountll(term_domain);
+        mask->terms[i].domain = term_domain;
+        mask->terms[i].table = malloc(table_size * sizeof (bool));
+        ++(mask->num_of_terms);
+        if (mask->terms[i].table == NULL) {
+            return false;
+        }
+        memcpy(mask->terms[i].table, (source == NULL) ? table : source->table, table_size * sizeof (bool));
+    }
+    return true;
+}
+
+/**
+ * \brief                               Replace the dense amplitudes by a sparse map of the nonzero ones
+ * \note                                The state vector stays dense if the map would be too large or could not be
+ *                                      allocated
+ * \param[in,out]                       state: Pointer to state vector
+ */
+static void make_sparse(state_vector_t *state) {
+    size_t num_of_entries = 0;
+    for (size_t i = 0; i < state->num_of_amplitudes; ++i) {
+        num_of_entries += state->amplitudes[i] != 0.0;
+    }
+    if (num_of_entries * 2 * SPARSE_TO_DENSE_RATIO > state->num_of_amplitudes
+        || !init_sparse_map(&(state->sparse), num_of_entries)) {
+        return;
+    }
+
+    for (size_t i = 0; i < state->num_of_amplitudes; ++i) {
+        if (state->amplitudes[i] != 0.0) {
+            add_amplitude(&(state->sparse), i, state->amplitudes[i]);
+        }
+    }
+    free(state->amplitudes);
+    free(state->scratch);
+    state->amplitudes = NULL;
+    state->scratch = NULL;
+    state->is_sparse = true;
+    if (num_of_entries > state->max_num_of_entries) {
+        state->max_num_of_entries = num_of_entries;
+    }
+    state->num_of_amplitude_ops += state->num_of_amplitudes;
+}
+
+/**
+ * \brief                               Replace the sparse map by dense amplitudes if it would hold too many entries
+ * \note                                Only operations without control mask change the representation, as control masks
+ *                                      are built for one representation; the state vector stays sparse if the dense
+ *                                      amplitudes could not be allocated
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           mask: Control mask of the operation (`NULL` for none)
+ * \param[in]                           num_of_entries: Number of entries the operation may produce
+ */
+static void update_representation(state_vector_t *state, const control_mask_t *mask, size_t num_of_entries) {
+    if (!state->is_sparse || mask != NULL || num_of_entries * SPARSE_TO_DENSE_RATIO <= state->num_of_amplitudes) {
+        return;
+    }
+
+    state->amplitudes = malloc(state->num_of_amplitudes * sizeof (double complex));
+    if (state->amplitudes == NULL) {
+        return;
+    }
+    partition_job_t job;
+    job.target = state->amplitudes;
+    run_partitions(state, clear_partition, &job);
+    for (size_t i = 0; i < state->sparse.num_of_entries; ++i) {
+        state->amplitudes[state->sparse.entries[i].basis_state] = state->sparse.entries[i].amplitude;
+    }
+    free_sparse_map(&(state->sparse));
+    state->is_sparse = false;
+    state->num_of_amplitude_ops += state->num_of_amplitudes;
+}
+
+/**
+ * \brief                               Check whether a register map permutes the basis states of a sparse state vector
+ * \note                                The map only depends on the register, its domain and the linked predicates of
+ *                                      the control mask, so it is checked on the assignments of these qubits
+ * \param[in]                           map: Pointer to block map
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ * \param[out]                          is_injective: Whether the map of basis states is a permutation
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the check was successful
+ */
+static bool check_sparse_map(const block_map_t *map, const control_mask_t *mask, bool *is_injective,
+                             char error_msg[ERROR_MSG_LENGTH]) {
+    uint64_t domain = get_linked_domain(mask, map->register_bits | map->domain);
+    size_t num_of_assignments = (size_t) 1 << __builtin_popcountll(domain);
+    uint64_t *is_hit = calloc((num_of_assignments + 63) / 64, sizeof (uint64_t));
+    if (is_hit == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for checking a register map failed");
+        return false;
+    }
+
+    *is_injective = true;
+    for (size_t k = 0; k < num_of_assignments && *is_injective; ++k) {
+        size_t index = scatter_bits(k, domain);
+        size_t image = gather_bits(get_image(map, index, gather_bits(index, map->domain),
+                                             is_selected_by_terms(mask, index, domain)), domain);
+        *is_injective = (is_hit[image >> 6] >> (image & 63) & 1) == 0;
+        is_hit[image >> 6] |= (uint64_t) 1 << (image & 63);
+    }
+    free(is_hit);
+    return true;
+}
+
+/**
+ * \brief                               Check whether the control mask of a sparse state vector is equal for all values
+ *                                      of a register
+ * \param[in]                           mask: Control mask (`NULL` for none)
+ * \param[in]                           register_bits: Mask of the qubits of the register
+ * \param[in]                           first_qubit: First qubit of register
+ * \return                              Whether the control mask is independent of the register
+ */
+static bool is_sparse_mask_independent(const control_mask_t *mask, size_t register_bits, unsigned first_qubit) {
+    bool is_linked = false;
+    for (unsigned i = 0; mask != NULL && i < mask->num_of_terms && !is_linked; ++i) {
+        is_linked = (mask->terms[i].domain & register_bits) != 0;
+    }
+    if (!is_linked) {
+        return true; /* no predicate depends on the register */
+    }
+
+    /* a predicate may depend on the register alone, so the linked domain may be the register itself */
+    uint64_t domain = get_linked_domain(mask, register_bits);
+
+    uint64_t lane_domain = domain & ~(uint64_t) register_bits;
+    size_t num_of_lanes = (size_t) 1 << __builtin_popcountll(lane_domain);
+    size_t num_of_values = (register_bits >> first_qubit) + 1;
+    for (size_t k = 0; k < num_of_lanes; ++k) {
+        size_t lane = scatter_bits(k, lane_domain);
+        bool is_selected = is_selected_by_terms(mask, lane, domain);
+        for (size_t v = 1; v < num_of_values; ++v) {
+            if (is_selected_by_terms(mask, lane | v << first_qubit, domain) != is_selected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief                               Sum up the projections of the lanes of a sparse state vector onto an axis
+ * \note                                A lane is a basis state with the register cleared; only selected lanes are
+ *                                      projected, the control mask being independent of the register
+ * \param[in]                           state: Pointer to state vector
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           axis: Array of components of the unit vector (one per register value)
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ * \param[out]                          lanes: Pointer to sparse map receiving the projection of every lane
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the projections could be summed up
+ */
+static bool project_sparse_lanes(const state_vector_t *state, unsigned first_qubit, unsigned width,
+                                 const double *axis, const control_mask_t *mask, sparse_map_t *lanes,
+                                 char error_msg[ERROR_MSG_LENGTH]) {
+    size_t register_bits = (((size_t) 1 << width) - 1) << first_qubit;
+    bool success = init_sparse_map(lanes, state->sparse.num_of_entries);
+    for (size_t i = 0; i < state->sparse.num_of_entries && success; ++i) {
+        const sparse_entry_t *entry = state->sparse.entries + i;
+        double component = axis[(entry->basis_state & register_bits) >> first_qubit];
+        if (component != 0.0 && is_selected_by_terms(mask, entry->basis_state, ~(uint64_t) 0)) {
+            success = add_amplitude(lanes, entry->basis_state & ~register_bits, component * entry->amplitude);
+        }
+    }
+    if (!success) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for a sparse reflection failed");
+        free_sparse_map(lanes);
+    }
+    return success;
+}
+
+/**
+ * \brief                               Reflect a register of a sparse state vector given the projections of its lanes
+ * \note                                Every lane of nonzero projection gets an entry for every value of nonzero axis
+ *                                      component
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           axis: Array of components of the unit vector (one per register value)
+ * \param[in]                           lanes: Pointer to sparse map of the projections of the lanes
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the reflection could be applied
+ */
+static bool reflect_sparse_lanes(state_vector_t *state, unsigned first_qubit, unsigned width, const double *axis,
+                                 const sparse_map_t *lanes, char error_msg[ERROR_MSG_LENGTH]) {
+    size_t num_of_values = (size_t) 1 << width;
+    bool success = true;
+    for (size_t i = 0; i < lanes->num_of_entries && success; ++i) {
+        double complex projection = 2.0 * lanes->entries[i].amplitude;
+        for (size_t v = 0; v < num_of_values && success && projection != 0.0; ++v) {
+            if (axis[v] != 0.0) {
+                success = add_amplitude(&(state->sparse), lanes->entries[i].basis_state | v << first_qubit,
+                                        -axis[v] * projection);
+            }
+        }
+    }
+    state->num_of_amplitude_ops += 2 * state->sparse.num_of_entries;
+    if (!success) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for %zu sparse amplitudes failed",
+                 2 * state->sparse.capacity);
+        return false;
+    }
+    prune_sparse_map(&(state->sparse));
+    if (state->sparse.num_of_entries > state->max_num_of_entries) {
+        state->max_num_of_entries = state->sparse.num_of_entries;
+    }
+    return true;
+}
+
+/* See header for documentation */
+kernel_level_t get_supported_kernel_level(void) {
+#ifdef HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return AVX512_K;
+    } else if (__builtin_cpu_supports("avx2")) {
+        return AVX2_K;
+    }
+#endif /* HAS_X86_KERNELS */
+    return SCALAR_K;
+}
+
+/* See header for documentation */
+kernel_level_t get_kernel_level(void) {
+    if (kernel_level == NUM_OF_KERNEL_LEVELS) {
+        kernel_level = get_supported_kernel_level();
+    }
+    return kernel_level;
+}
+
+/* See header for documentation */
+bool select_kernel_level(kernel_level_t level) {
+    if (level >= NUM_OF_KERNEL_LEVELS || level > get_supported_kernel_level()) {
+        return false;
+    }
+    kernel_level = level;
+    return true;
+}
+
+/* See header for documentation */
+const char *get_kernel_level_name(kernel_level_t level) {
+    switch (level) {
+        case SCALAR_K: {
+            return "scalar";
+        }
+        case AVX2_K: {
+            return "avx2";
+        }
+        case AVX512_K: {
+            return "avx512";
+        }
+        default: {
+            return NULL;
+        }
+    }
+}
+
+/* See header for documentation */
+bool init_state_vector(state_vector_t *state, unsigned num_of_qubits, unsigned num_of_threads, bool is_sparse,
+                       char error_msg[ERROR_MSG_LENGTH]) {
+    if (num_of_qubits > MAX_NUM_OF_QUBITS) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Simulating %u qubits exceeds the limit of %u qubits", num_of_qubits,
+                 MAX_NUM_OF_QUBITS);
+        return false;
+    } else if (num_of_threads == 0 || num_of_threads > MAX_NUM_OF_THREADS
+               || (num_of_threads & (num_of_threads - 1)) != 0) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Number of threads must be a power of two between 1 and %u",
+                 MAX_NUM_OF_THREADS);
+        return false;
+    }
+
+    state->num_of_qubits = num_of_qubits;
+    state->num_of_amplitudes = (size_t) 1 << num_of_qubits;
+    state->num_of_amplitude_ops = 0;
+    state->num_of_partitions = 1;
+    state->num_of_local_qubits = num_of_qubits;
+    while (state->num_of_partitions < num_of_threads
+           && (state->num_of_amplitudes >> state->num_of_local_qubits) * 2 * MIN_PARTITION_SIZE
+              <= state->num_of_amplitudes) {
+        state->num_of_partitions *= 2;
+        --(state->num_of_local_qubits);
+    }
+    state->pool = NULL;
+    state->scratch = NULL;
+    state->sparse.entries = NULL;
+    state->sparse.slots = NULL;
+    state->sparse.num_of_entries = 0;
+    state->is_sparse = is_sparse;
+    state->is_sparse_allowed = is_sparse;
+    state->max_num_of_entries = is_sparse;
+    state->chunk_norms = malloc(((state->num_of_amplitudes + MIN_PARTITION_SIZE - 1) / MIN_PARTITION_SIZE)
+                                * sizeof (double));
+    /* left untouched by the allocation, the pages of large arrays are placed by the first worker writing them */
+    state->amplitudes = is_sparse ? NULL : malloc(state->num_of_amplitudes * sizeof (double complex));
+    if ((!is_sparse && state->amplitudes == NULL) || state->chunk_norms == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for %zu amplitudes failed", state->num_of_amplitudes);
+        free_state_vector(state);
+        return false;
+    } else if (is_sparse && !init_sparse_map(&(state->sparse), 1)) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for a sparse map failed");
+        free_state_vector(state);
+        return false;
+    }
+    if (state->num_of_partitions > 1) {
+        state->pool = malloc(sizeof (thread_pool_t));
+        if (state->pool == NULL) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for a thread pool failed");
+            free_state_vector(state);
+            return false;
+        } else if (!init_thread_pool(state->pool, state->num_of_partitions, error_msg)) {
+            free(state->pool);
+            state->pool = NULL;
+            free_state_vector(state);
+            return false;
+        }
+    }
+
+    if (is_sparse) {
+        add_amplitude(&(state->sparse), 0, 1.0);
+        return true;
+    }
+    partition_job_t job;
+    job.target = state->amplitudes;
+    run_partitions(state, clear_partition, &job);
+    state->amplitudes[0] = 1.0;
+    return true;
+}
+
+/* See header for documentation */
+void free_state_vector(state_vector_t *state) {
+    if (state->pool != NULL) {
+        free_thread_pool(state->pool);
+        free(state->pool);
+    }
+    free(state->amplitudes);
+    free(state->scratch);
+    free(state->chunk_norms);
+    free_sparse_map(&(state->sparse));
+    state->pool = NULL;
+    state->amplitudes = NULL;
+    state->scratch = NULL;
+    state->chunk_norms = NULL;
+}
+
+/* See header for documentation */
+size_t gather_bits(size_t index, uint64_t domain) {
+    size_t result = 0;
+    unsigned position = 0;
+    for (uint64_t rest = domain; rest != 0; rest &= rest - 1) {
+        if ((index & (size_t) (rest & -rest)) != 0) {
+            result |= (size_t) 1 << position;
+        }
+        ++position;
+    }
+    return result;
+}
+
+/* See header for documentation */
+size_t scatter_bits(size_t value, uint64_t domain) {
+    size_t result = 0;
+    unsigned position = 0;
+    for (uint64_t rest = domain; rest != 0; rest &= rest - 1) {
+        if ((value >> position & 1) != 0) {
+            result |= (size_t) (rest & -rest);
+        }
+        ++position;
+    }
+    return result;
+}
+
+/* See header for documentation */
+bool build_mask(const state_vector_t *state, uint64_t domain, const bool *table, const control_mask_t *parent_mask,
+                control_mask_t *mask, char error_msg[ERROR_MSG_LENGTH]) {
+    mask->words = NULL;
+    mask->terms = NULL;
+    mask->num_of_terms = 0;
+    mask->is_any = false;
+    if (state->is_sparse) {
+        if (!copy_terms(mask, parent_mask, domain, table)) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for control predicates failed");
+            return false;
+        }
+        /* the parent selects some basis state, and the predicates not linked to the new one are independent of it */
+        uint64_t linked_domain = get_linked_domain(mask, domain);
+        size_t num_of_assignments = (size_t) 1 << __builtin_popcountll(linked_domain);
+        bool is_parent_any = parent_mask == NULL || parent_mask->is_any;
+        for (size_t k = 0; k < num_of_assignments && is_parent_any && !mask->is_any; ++k) {
+            mask->is_any = is_selected_by_terms(mask, scatter_bits(k, linked_domain), linked_domain);
+        }
+        return true;
+    }
+
+    mask->words = malloc(get_mask_size(state) * sizeof (uint64_t));
+    if (mask->words == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for control masks failed");
+        return false;
+    }
+    partition_job_t job;
+    job.domain = domain;
+    job.table = table;
+    job.mask = (parent_mask == NULL) ? NULL : parent_mask->words;
+    job.new_mask = mask->words;
+    run_partitions(state, build_mask_partition, &job);
+    mask->is_any = is_any_result(&job);
+    return true;
+}
+
+/* See header for documentation */
+void free_mask(control_mask_t *mask) {
+    for (unsigned i = 0; i < mask->num_of_terms; ++i) {
+        free(mask->terms[i].table);
+    }
+    free(mask->terms);
+    free(mask->words);
+    mask->terms = NULL;
+    mask->words = NULL;
+    mask->num_of_terms = 0;
+}
+
+/* See header for documentation */
+void apply_phase(state_vector_t *state, uint64_t domain, const double complex *factors, const control_mask_t *mask) {
+    update_representation(state, mask, state->sparse.num_of_entries);
+    if (state->is_sparse) {
+        for (size_t i = 0; i < state->sparse.num_of_entries; ++i) {
+            sparse_entry_t *entry = state->sparse.entries + i;
+            if (is_selected_by_terms(mask, entry->basis_state, ~(uint64_t) 0)) {
+                entry->amplitude *= factors[gather_bits(entry->basis_state, domain)];
+            }
+        }
+        state->num_of_amplitude_ops += state->sparse.num_of_entries;
+        return;
+    }
+
+    partition_job_t job;
+    job.domain = domain;
+    job.table = factors;
+    job.factor = factors[0];
+    job.mask = (mask == NULL) ? NULL : mask->words;
+    run_partitions(state, phase_partition, &job);
+    state->num_of_amplitude_ops += state->num_of_amplitudes;
+}
+
+/* See header for documentation */
+bool check_register_map(const state_vector_t *state, unsigned first_qubit, unsigned width, uint64_t domain,
+                        const size_t *values, const control_mask_t *mask, bool *is_injective,
+                        char error_msg[ERROR_MSG_LENGTH]) {
+    uint64_t *is_hit = state->is_sparse ? NULL : calloc(get_mask_size(state), sizeof (uint64_t));
+    block_map_t *map = malloc(sizeof (block_map_t));
+    if ((!state->is_sparse && is_hit == NULL) || map == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for checking a register map failed");
+        free(is_hit);
+        free(map);
+        return false;
+    }
+
+    init_block_map(map, first_qubit, width, domain, values);
+    bool success = true;
+    if (state->is_sparse) {
+        success = check_sparse_map(map, mask, is_injective, error_msg);
+    } else if (is_local_register(state, first_qubit, width)) {
+        /* images stay in their partition, so every worker marks its own words of the bit set */
+        partition_job_t job;
+        job.map = map;
+        job.mask = (mask == NULL) ? NULL : mask->words;
+        job.is_hit = is_hit;
+        run_partitions(state, check_partition, &job);
+        *is_injective = are_all_results(&job);
+    } else {
+        *is_injective = mark_images(map, (mask == NULL) ? NULL : mask->words, is_hit, 0, state->num_of_amplitudes);
+    }
+    free(is_hit);
+    free(map);
+    return success;
+}
+
+/* See header for documentation */
+bool apply_register_map(state_vector_t *state, unsigned first_qubit, unsigned width, uint64_t domain,
+                        const size_t *values, const control_mask_t *mask, bool is_injective,
+                        char error_msg[ERROR_MSG_LENGTH]) {
+    update_representation(state, mask, state->sparse.num_of_entries);
+    if (!state->is_sparse && !allocate_scratch(state, error_msg)) {
+        return false;
+    }
+    block_map_t *map = malloc(sizeof (block_map_t));
+    if (map == NULL) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for a register map failed");
+        return false;
+    }
+
+    init_block_map(map, first_qubit, width, domain, values);
+    if (state->is_sparse) {
+        /* images of equal basis states are summed up either way, so permutations need no special treatment */
+        sparse_map_t images;
+        bool success = init_sparse_map(&images, state->sparse.num_of_entries);
+        for (size_t i = 0; i < state->sparse.num_of_entries && success; ++i) {
+            const sparse_entry_t *entry = state->sparse.entries + i;
+            size_t image = get_image(map, entry->basis_state, gather_bits(entry->basis_state, domain),
+                                     is_selected_by_terms(mask, entry->basis_state, ~(uint64_t) 0));
+            success = add_amplitude(&images, image, entry->amplitude);
+        }
+        free(map);
+        if (!success) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for %zu sparse amplitudes failed",
+                     state->sparse.num_of_entries);
+            free_sparse_map(&images);
+            return false;
+        }
+        state->num_of_amplitude_ops += 2 * state->sparse.num_of_entries;
+        free_sparse_map(&(state->sparse));
+        state->sparse = images;
+        prune_sparse_map(&(state->sparse));
+        return true;
+    }
+
+    partition_job_t job;
+    job.map = map;
+    job.mask = (mask == NULL) ? NULL : mask->words;
+    if (is_injective) {
+        /* a permutation writes every image exactly once, wherever its partition */
+        run_partitions(state, permute_partition, &job);
+    } else if (is_local_register(state, first_qubit, width)) {
+        run_partitions(state, sum_partition, &job);
+    } else { /* images of different partitions may collide */
+        sum_images(state, map, job.mask, 0, state->num_of_amplitudes);
+    }
+    free(map);
+
+    double complex *swap = state->amplitudes;
+    state->amplitudes = state->scratch;
+    state->scratch = swap;
+    state->num_of_amplitude_ops += 2 * state->num_of_amplitudes;
+    return true;
+}
+
+/* See header for documentation */
+bool apply_reflection(state_vector_t *state, unsigned first_qubit, unsigned width, const double *axis,
+                      const control_mask_t *mask, bool *is_independent, char error_msg[ERROR_MSG_LENGTH]) {
+    size_t num_of_values = (size_t) 1 << width;
+    size_t num_of_components = 0;
+    for (size_t v = 0; v < num_of_values; ++v) {
+        num_of_components += axis[v] != 0.0;
+    }
+    if (state->is_sparse) {
+        sparse_map_t lanes;
+        *is_independent = is_sparse_mask_independent(mask, (num_of_values - 1) << first_qubit, first_qubit);
+        if (!*is_independent) {
+            return true;
+        } else if (!project_sparse_lanes(state, first_qubit, width, axis, mask, &lanes, error_msg)) {
+            return false;
+        }
+        /* every lane may spread over all values of nonzero axis component */
+        update_representation(state, mask, state->sparse.num_of_entries + lanes.num_of_entries * num_of_components);
+        bool success = !state->is_sparse || reflect_sparse_lanes(state, first_qubit, width, axis, &lanes, error_msg);
+        free_sparse_map(&lanes);
+        if (state->is_sparse) {
+            return success;
+        }
+    }
+
+    partition_job_t job;
+    job.state = state;
+    job.mask = (mask == NULL) ? NULL : mask->words;
+    job.axis = axis;
+    job.first_qubit = first_qubit;
+    job.width = width;
+    state->num_of_amplitude_ops += 2 * state->num_of_amplitudes;
+    *is_independent = true;
+    if (is_local_register(state, first_qubit, width)) {
+        run_partitions(state, reflect_partition, &job);
+        *is_independent = are_all_results(&job);
+        return true;
+    }
+
+    unsigned num_of_members;
+    get_group_rank(&job, 0, &num_of_members);
+    if (get_partition_lanes(&job) >= num_of_members
+        && (2 * get_partition_lanes(&job) >= get_partition_size(state) || is_group_on_one_node(&job))) {
+        /* within a node, or with at most two values per partition, moving amplitudes costs no more than moving
+         * projections; every worker needs a lane of its own, though */
+        run_partitions(state, exchange_partition, &job);
+        *is_independent = are_all_results(&job);
+        return true;
+    }
+
+    /* the scratch array holds the projections of every partition, so it must not be swapped in between */
+    if (!allocate_scratch(state, error_msg)) {
+        return false;
+    }
+    run_partitions(state, project_partition, &job);
+    *is_independent = are_all_results(&job);
+    if (!*is_independent) {
+        return true;
+    }
+    run_partitions(state, reduce_partition, &job);
+    run_partitions(state, update_partition, &job);
+    return true;
+}
+
+/* See header for documentation */
+bool is_register_clear(state_vector_t *state, unsigned first_qubit, unsigned width) {
+    if (state->is_sparse) {
+        size_t register_bits = (((size_t) 1 << width) - 1) << first_qubit;
+        state->num_of_amplitude_ops += state->sparse.num_of_entries;
+        for (size_t i = 0; i < state->sparse.num_of_entries; ++i) {
+            if ((state->sparse.entries[i].basis_state & register_bits) != 0
+                && state->sparse.entries[i].amplitude != 0.0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    partition_job_t job;
+    job.first_qubit = first_qubit;
+    job.width = width;
+    run_partitions(state, check_clear_partition, &job);
+    state->num_of_amplitude_ops += state->num_of_amplitudes;
+    return are_all_results(&job);
+}
+
+/* See header for documentation */
+size_t sample_basis_state(state_vector_t *state, double random) {
+    if (state->is_sparse) {
+        /* sorted entries are drawn in the order of the dense amplitudes */
+        sparse_map_t *map = &(state->sparse);
+        qsort(map->entries, map->num_of_entries, sizeof (sparse_entry_t), compare_entries);
+        index_sparse_map(map);
+        double norm = 0.0;
+        for (size_t i = 0; i < map->num_of_entries; ++i) {
+            norm += creal(map->entries[i].amplitude * conj(map->entries[i].amplitude));
+        }
+        double threshold = random * norm;
+        double cumulated = 0.0;
+        size_t last_nonzero = 0;
+        state->num_of_amplitude_ops += 2 * map->num_of_entries;
+        for (size_t i = 0; i < map->num_of_entries; ++i) {
+            double probability = creal(map->entries[i].amplitude * conj(map->entries[i].amplitude));
+            if (probability == 0.0) {
+                continue;
+            }
+            cumulated += probability;
+            last_nonzero = map->entries[i].basis_state;
+            if (cumulated > threshold) {
+                break;
+            }
+        }
+        return last_nonzero;
+    }
+
+    partition_job_t job;
+    run_partitions(state, norm_partition, &job);
+    double threshold = random * sum_chunk_norms(state);
+    state->num_of_amplitude_ops += 2 * state->num_of_amplitudes;
+
+    /* whole chunks are skipped until the one reaching the threshold; rounding may leave it unreached, so the last
+     * chunk of nonzero norm is always searched */
+    size_t num_of_chunks = (state->num_of_amplitudes + MIN_PARTITION_SIZE - 1) / MIN_PARTITION_SIZE;
+    size_t last_chunk = num_of_chunks - 1;
+    while (last_chunk > 0 && state->chunk_norms[last_chunk] == 0.0) {
+        --last_chunk;
+    }
+    double cumulated = 0.0;
+    size_t last_nonzero = 0;
+    for (size_t chunk = 0; chunk <= last_chunk; ++chunk) {
+        double chunk_norm = state->chunk_norms[chunk];
+        if (chunk_norm == 0.0 || (cumulated + chunk_norm <= threshold && chunk < last_chunk)) {
+            cumulated += chunk_norm;
+            continue;
+        }
+
+        size_t begin = chunk * MIN_PARTITION_SIZE;
+        size_t end = (state->num_of_amplitudes - begin < MIN_PARTITION_SIZE) ? state->num_of_amplitudes
+                                                                             : begin + MIN_PARTITION_SIZE;
+        for (size_t i = begin; i < end; ++i) {
+            double probability = creal(state->amplitudes[i] * conj(state->amplitudes[i]));
+            if (probability == 0.0) {
+                continue;
+            }
+            cumulated += probability;
+            last_nonzero = i;
+            if (cumulated > threshold) {
+                return last_nonzero;
+            }
+        }
+    }
+    return last_nonzero;
+}
+
+/* See header for documentation */
+void collapse_state(state_vector_t *state, uint64_t domain, const bool *keep) {
+    if (state->is_sparse) {
+        sparse_map_t *map = &(state->sparse);
+        size_t num_of_kept = 0;
+        double norm = 0.0;
+        for (size_t i = 0; i < map->num_of_entries; ++i) {
+            if (keep[gather_bits(map->entries[i].basis_state, domain)]) {
+                norm += creal(map->entries[i].amplitude * conj(map->entries[i].amplitude));
+                map->entries[num_of_kept++] = map->entries[i];
+            }
+        }
+        state->num_of_amplitude_ops += map->num_of_entries + num_of_kept;
+        map->num_of_entries = num_of_kept;
+        double factor = (norm > 0.0) ? 1.0 / sqrt(norm) : 0.0;
+        for (size_t i = 0; i < map->num_of_entries; ++i) {
+            map->entries[i].amplitude *= factor;
+        }
+        index_sparse_map(map);
+        return;
+    }
+
+    partition_job_t job;
+    job.domain = domain;
+    job.table = keep;
+    run_partitions(state, project_out_partition, &job);
+    double norm = sum_chunk_norms(state);
+    job.factor = (norm > 0.0) ? 1.0 / sqrt(norm) : 0.0;
+    run_partitions(state, rescale_partition, &job);
+    state->num_of_amplitude_ops += 2 * state->num_of_amplitudes;
+    if (state->is_sparse_allowed) {
+        make_sparse(state);
+    }
+}
@@ -0,0 +1,379 @@
+/**
+ * \file                                state_vector.h
+ * \brief                               State vector include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef STATE_VECTOR_H
+#define STATE_VECTOR_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <complex.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rules.h"
+#include "thread_pool.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Kernel level enumeration
+ * \note                                Kernels of every level compute the same results (up to rounding); higher levels
+ *                                      use wider vector instructions and are only selectable if the processor has them
+ */
+typedef enum kernel_level {
+    SCALAR_K,                               /*!< Portable scalar kernels */
+    AVX2_K,                                 /*!< Kernels using AVX2 (two amplitudes per vector) */
+    AVX512_K,                               /*!< Kernels using AVX-512F (four amplitudes per vector) */
+    NUM_OF_KERNEL_LEVELS,                   /*!< Number of kernel levels */
+} kernel_level_t;
+
+/**
+ * \brief                               Sparse entry struct
+ * \note                                This structure defines the amplitude of one basis state of a sparse map
+ */
+typedef struct sparse_entry {
+    size_t basis_state;                     /*!< Basis state */
+    double complex amplitude;               /*!< Amplitude of basis state */
+} sparse_entry_t;
+
+/**
+ * \brief                               Sparse map struct
+ * \note                                This structure defines a hash map from basis states to amplitudes: the entries
+ *                                      lie next to each other in an array, and an open-addressing hash table with at
+ *                                      least twice as many slots as entries finds the entry of a basis state
+ */
+typedef struct sparse_map {
+    sparse_entry_t *entries;                /*!< Array of entries */
+    size_t num_of_entries;                  /*!< Number of entries */
+    size_t capacity;                        /*!< Number of entries the array has room for (a power of two) */
+    size_t *slots;                          /*!< Array of entry indices plus one (zero for empty slots) */
+    unsigned num_of_slot_bits;              /*!< Binary logarithm of the number of slots (twice the capacity) */
+} sparse_map_t;
+
+/**
+ * \brief                               Control term struct
+ * \note                                This structure defines a predicate on the qubits of a domain
+ */
+typedef struct control_term {
+    uint64_t domain;                        /*!< Mask of qubits the predicate depends on */
+    bool *table;                            /*!< Array of predicate values indexed by the gathered bits of the domain */
+} control_term_t;
+
+/**
+ * \brief                               Control mask struct
+ * \note                                This structure defines the set of basis states a controlled operation changes;
+ *                                      a dense state vector holds it as one bit per basis state, a sparse one as the
+ *                                      conjunction of the predicates it was built from. `NULL` stands for the mask
+ *                                      selecting every basis state
+ */
+typedef struct control_mask {
+    uint64_t *words;                        /*!< Array of bits, one per basis state (`NULL` for sparse state vectors) */
+    control_term_t *terms;                  /*!< Array of predicates (`NULL` for dense state vectors) */
+    unsigned num_of_terms;                  /*!< Number of predicates */
+    bool is_any;                            /*!< Whether the mask selects any basis state */
+} control_mask_t;
+
+/**
+ * \brief                               State vector struct
+ * \note                                This structure defines a pure state of `num_of_qubits` qubits by its amplitudes
+ *                                      in the computational basis; qubit q of basis state i is bit q of i. The
+ *                                      amplitudes of a dense state vector are split into equal contiguous partitions,
+ *                                      one per worker thread, so that the topmost qubits select the partition of a
+ *                                      basis state. A sparse state vector holds its nonzero amplitudes in a sparse map
+ *                                      instead and turns dense once more than one in `SPARSE_TO_DENSE_RATIO` basis
+ *                                      states has an entry
+ */
+typedef struct state_vector {
+    double complex *amplitudes;             /*!< Array of amplitudes (one per basis state, `NULL` while sparse) */
+    double complex *scratch;                /*!< Array of amplitudes permutations are written to (`NULL` until the
+                                                 first permutation) */
+    double *chunk_norms;                    /*!< Array of partial norms, one per `MIN_PARTITION_SIZE` amplitudes */
+    unsigned num_of_qubits;                 /*!< Number of qubits */
+    size_t num_of_amplitudes;               /*!< Number of amplitudes (two to the power of the number of qubits) */
+    unsigned num_of_partitions;             /*!< Number of partitions (a power of two) */
+    unsigned num_of_local_qubits;           /*!< Number of qubits below the qubits selecting the partition */
+    thread_pool_t *pool;                    /*!< Pointer to pool with one worker per partition (`NULL` for a single
+                                                 partition) */
+    sparse_map_t sparse;                    /*!< Map of nonzero amplitudes (used while sparse) */
+    bool is_sparse;                         /*!< Whether the amplitudes are held by the sparse map */
+    bool is_sparse_allowed;                 /*!< Whether a dense state vector may turn sparse again */
+    size_t max_num_of_entries;              /*!< Largest number of entries of the sparse map so far */
+    unsigned long long num_of_amplitude_ops;    /*!< Number of amplitudes read or written by kernels so far */
+} state_vector_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return highest kernel level supported by the processor
+ * \return                              Highest supported kernel level
+ */
+kernel_level_t get_supported_kernel_level(void);
+
+/**
+ * \brief                               Return kernel level used by all state vectors
+ * \note                                Unless selected otherwise, the highest supported kernel level is used
+ * \return                              Kernel level in use
+ */
+kernel_level_t get_kernel_level(void);
+
+/**
+ * \brief                               Select kernel level used by all state vectors
+ * \param[in]                           level: Kernel level
+ * \return                              Whether the processor supports the kernel level
+ */
+bool select_kernel_level(kernel_level_t level);
+
+/**
+ * \brief                               Return name of a kernel level
+ * \param[in]                           level: Kernel level
+ * \return                              Name of kernel level (`NULL` for invalid levels)
+ */
+const char *get_kernel_level_name(kernel_level_t level);
+
+/**
+ * \brief                               Initialize state vector to the all-zero basis state
+ * \note                                Partitions smaller than `MIN_PARTITION_SIZE` amplitudes are merged, so small
+ *                                      states use fewer threads than requested. Every worker zeroes its own partition,
+ *                                      which places the partition on the worker's NUMA node by first touch. A sparse
+ *                                      state vector allocates its amplitudes only when it turns dense, and turns
+ *                                      sparse again when a collapse leaves few enough nonzero amplitudes
+ * \param[out]                          state: Pointer to state vector
+ * \param[in]                           num_of_qubits: Number of qubits (at most `MAX_NUM_OF_QUBITS`)
+ * \param[in]                           num_of_threads: Number of worker threads (a power of two, at most
+ *                                      `MAX_NUM_OF_THREADS`)
+ * \param[in]                           is_sparse: Whether to start with the sparse representation
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether initialization was successful
+ */
+bool init_state_vector(state_vector_t *state, unsigned num_of_qubits, unsigned num_of_threads, bool is_sparse,
+                       char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Free amplitudes of state vector and stop its worker threads
+ * \param[in,out]                       state: Pointer to state vector
+ */
+void free_state_vector(state_vector_t *state);
+
+/**
+ * \brief                               Gather the bits of a basis state selected by a domain into the low bits
+ * \note                                The lowest selected bit becomes bit 0 of the result; domains select the qubits
+ *                                      a lookup table of a kernel is indexed by
+ * \param[in]                           index: Basis state
+ * \param[in]                           domain: Mask of selected qubits
+ * \return                              Gathered bits
+ */
+size_t gather_bits(size_t index, uint64_t domain);
+
+/**
+ * \brief                               Scatter the low bits of a value onto the bits selected by a domain
+ * \note                                This is the inverse of gather_bits() on the selected bits; all other bits are
+ *                                      zero
+ * \param[in]                           value: Value whose low bits are scattered
+ * \param[in]                           domain: Mask of selected qubits
+ * \return                              Basis state with the scattered bits
+ */
+size_t scatter_bits(size_t value, uint64_t domain);
+
+/**
+ * \brief                               Build control mask from a predicate on the qubits of a domain
+ * \note                                The representation of a state vector only changes in operations without control
+ *                                      mask, so a control mask must be freed before the state vector is changed
+ *                                      without one. Whether the mask selects any basis state is known from its flag
+ *                                      `is_any`
+ * \param[in]                           state: Pointer to state vector
+ * \param[in]                           domain: Mask of qubits the predicate depends on
+ * \param[in]                           table: Array of predicate values indexed by the gathered bits of the domain
+ * \param[in]                           parent_mask: Control mask the result is restricted to (`NULL` for none)
+ * \param[out]                          mask: Control mask of basis states in the parent mask fulfilling the predicate
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the mask could be built (it is left freeable either way)
+ */
+bool build_mask(const state_vector_t *state, uint64_t domain, const bool *table, const control_mask_t *parent_mask,
+                control_mask_t *mask, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Free bits and predicates of control mask
+ * \param[in,out]                       mask: Pointer to control mask
+ */
+void free_mask(control_mask_t *mask);
+
+/**
+ * \brief                               Multiply amplitudes by a factor depending on the qubits of a domain
+ * \note                                Factors independent of every qubit (empty domain) are applied by the vector
+ *                                      kernels, table lookups by a scalar loop
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           domain: Mask of qubits the factor depends on
+ * \param[in]                           factors: Array of factors indexed by the gathered bits of the domain
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ */
+void apply_phase(state_vector_t *state, uint64_t domain, const double complex *factors, const control_mask_t *mask);
+
+/**
+ * \brief                               Check whether replacing the bits of a register permutes the basis states
+ * \note                                Basis state i is mapped to itself outside the control mask and otherwise to i
+ *                                      with the register replaced by the value looked up for i
+ * \param[in]                           state: Pointer to state vector
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           domain: Mask of qubits the new value of the register depends on
+ * \param[in]                           values: Array of new register values indexed by the gathered bits of the domain
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ * \param[out]                          is_injective: Whether the map of basis states is a permutation
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the check was successful
+ */
+bool check_register_map(const state_vector_t *state, unsigned first_qubit, unsigned width, uint64_t domain,
+                        const size_t *values, const control_mask_t *mask, bool *is_injective,
+                        char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Replace the bits of a register in every basis state
+ * \note                                The amplitude of every basis state is added to the amplitude of its image (see
+ *                                      check_register_map()); this is unitary for permutations and for states all of
+ *                                      whose nonzero amplitudes have a common register value. Permutations are moved by
+ *                                      the vector kernels, other maps are summed up by a scalar loop. Every worker
+ *                                      moves the amplitudes of its own partition, so only amplitudes whose register
+ *                                      value changes a partition-selecting qubit cross partitions; other maps of such
+ *                                      registers are summed up by a single thread. Sparse state vectors sum up every
+ *                                      map entry by entry
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           domain: Mask of qubits the new value of the register depends on
+ * \param[in]                           values: Array of new register values indexed by the gathered bits of the domain
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ * \param[in]                           is_injective: Whether the map is known to permute the basis states
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the map could be applied
+ */
+bool apply_register_map(state_vector_t *state, unsigned first_qubit, unsigned width, uint64_t domain,
+                        const size_t *values, const control_mask_t *mask, bool is_injective,
+                        char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Apply the reflection about a real unit vector to a register
+ * \note                                The register is mapped by I - 2|u><u| for every value of the other qubits whose
+ *                                      basis states are selected by the control mask; the mask must not depend on the
+ *                                      register itself. If the register reaches the partition-selecting qubits, every
+ *                                      worker reflects one share of the lanes across the partitions involved; if these
+ *                                      lie on different NUMA nodes and hold several values of the register each, the
+ *                                      workers exchange the projections onto u instead of amplitudes, summing up one
+ *                                      share of the lanes each, and update their own partitions in place. A sparse
+ *                                      state vector without control mask turns dense first if the lanes it holds would
+ *                                      fill too many basis states
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \param[in]                           axis: Array of components of unit vector u (one per register value)
+ * \param[in]                           mask: Control mask of the basis states to be changed (`NULL` for all)
+ * \param[out]                          is_independent: Whether the control mask is independent of the register
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether the reflection could be applied or rejected
+ */
+bool apply_reflection(state_vector_t *state, unsigned first_qubit, unsigned width, const double *axis,
+                      const control_mask_t *mask, bool *is_independent, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Check whether a register is zero in every basis state of nonzero amplitude
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           first_qubit: First qubit of register
+ * \param[in]                           width: Number of qubits of register
+ * \return                              Whether the register is in its zero state
+ */
+bool is_register_clear(state_vector_t *state, unsigned first_qubit, unsigned width);
+
+/**
+ * \brief                               Sample a basis state from the distribution of the state vector
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           random: Uniformly distributed number in [0, 1)
+ * \return                              Sampled basis state
+ */
+size_t sample_basis_state(state_vector_t *state, double random);
+
+/**
+ * \brief                               Project state vector onto the basis states kept by a predicate and renormalize
+ * \note                                A dense state vector initialized as sparse turns sparse again if at most one in
+ *                                      `2 * SPARSE_TO_DENSE_RATIO` basis states keeps a nonzero amplitude
+ * \param[in,out]                       state: Pointer to state vector
+ * \param[in]                           domain: Mask of qubits the predicate depends on
+ * \param[in]                           keep: Array of predicate values indexed by the gathered bits of the domain
+ */
+void collapse_state(state_vector_t *state, uint64_t domain, const bool *keep);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* STATE_VECTOR_H */
@@ -45,28 +45,6 @@
 #include "symbol_table.h"
 
 
-/*
- * =====================================================================================================================
- *                                                static variables
- * =====================================================================================================================
- */
-
-/**
- * \brief                               Pointer to symbol table
- */
-static struct entry *symbol_table[SYMBOL_TABLE_SIZE];
-
-/**
- * \brief                               Pointer to shadow symbol table
- */
-static struct entry *shadow_symbol_table[SYMBOL_TABLE_SIZE];
-
-/**
- * \brief                               Counter for the current scope (starts at `0`)
- */
-static unsigned cur_scope;
-
-
 /*
  * =====================================================================================================================
  *                                                function definitions
@@ -107,10 +85,16 @@ char *type_to_str(type_t type) {
 }
 
 /* See header for documentation */
-void init_symbol_table() {
-    memset(symbol_table, 0, sizeof (symbol_table));
-    memset(shadow_symbol_table, 0, sizeof (shadow_symbol_table));
-    cur_scope = 0;
+void init_symbol_table(symbol_table_t *symbol_table) {
+    symbol_table->buckets = NULL;
+    symbol_table->capacity = 0;
+    symbol_table->num_of_visible_entries = 0;
+    symbol_table->first_entry = NULL;
+    symbol_table->last_entry = NULL;
+    symbol_table->scope_stack = NULL;
+    symbol_table->scope_stack_capacity = 0;
+    symbol_table->cur_scope = 0;
+    symbol_table->lookup_log = NULL;
 }
 
 /**
@@ -123,14 +107,7 @@ static void free_entry_content(entry_t *entry) {
         return;
     }
 
-    ref_list_t *current_ref = entry->lines;
-    ref_list_t *next_ref;
-    while (current_ref != NULL) {
-        next_ref = current_ref->next;
-        free(current_ref);
-        current_ref = next_ref;
-    }
-
+    free(entry->lines);
     if (entry->is_function) {
         free(entry->pars_type_info);
     } else if (entry->qualifier == CONST_T) {
@@ -139,139 +116,293 @@ static void free_entry_content(entry_t *entry) {
 }
 
 /* See header for documentation */
-void free_symbol_table() {
-    for (unsigned i = 0; i < SYMBOL_TABLE_SIZE; ++i) {
-        if (shadow_symbol_table[i] != NULL) {
-            entry_t *current_entry = shadow_symbol_table[i];
-            entry_t *next_entry;
-            while (current_entry != NULL) {
-                free_entry_content(current_entry);
-                next_entry = current_entry->next;
-                free(current_entry);
-                current_entry = next_entry;
-            }
+void free_symbol_table(symbol_table_t *symbol_table) {
+    entry_t *current_entry = symbol_table->first_entry;
+    entry_t *next_entry;
+    while (current_entry != NULL) {
+        free_entry_content(current_entry);
+        next_entry = current_entry->next_declared;
+        free(current_entry);
+        current_entry = next_entry;
+    }
+    free(symbol_table->buckets);
+    free(symbol_table->scope_stack);
+    init_symbol_table(symbol_table);
+}
+
+/**
+ * \brief                               Double number of buckets of symbol table and redistribute visible entries
+ * \note                                Within each bucket, entries stay ordered from innermost to outermost scope
+ * \param[in,out]                       symbol_table: Pointer to symbol table
+ * \return                              Whether resizing the symbol table was successful
+ */
+static bool resize_symbol_table(symbol_table_t *symbol_table) {
+    unsigned new_capacity = (symbol_table->capacity == 0) ? INITIAL_SYMBOL_TABLE_SIZE : 2 * symbol_table->capacity;
+    entry_t **new_buckets = calloc(new_capacity, sizeof (entry_t *));
+    if (new_buckets == NULL) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < symbol_table->capacity; ++i) {
+        /* entries of bucket i are split between buckets i and i + capacity of the new table */
+        entry_t **tails[2] = { new_buckets + i, new_buckets + i + symbol_table->capacity };
+        entry_t *entry = symbol_table->buckets[i];
+        while (entry != NULL) {
+            entry_t *next_entry = entry->next;
+            unsigned target = (entry->hash & symbol_table->capacity) ? 1 : 0;
+            entry->next = NULL;
+            *(tails[target]) = entry;
+            tails[target] = &(entry->next);
+            entry = next_entry;
         }
     }
+    free(symbol_table->buckets);
+    symbol_table->buckets = new_buckets;
+    symbol_table->capacity = new_capacity;
+    return true;
 }
 
 /**
- * \brief                               Calculate hash value of key
- * \param[in]                           key: Key as string
- * \return                              Hash value of input key
+ * \brief                               Make sure that the scope stack has a slot for the current scope
+ * \param[in,out]                       symbol_table: Pointer to symbol table
+ * \return                              Whether the scope stack has a slot for the current scope
  */
-static unsigned hash(const char *key) {
-    if (key == NULL) {
-        return -1;
-    }
-    char first_char = key[0];
-    unsigned hash_value = 0;
-    while (*key != '\0') {
-        hash_value += *key;
-        ++key;
-    }
-    hash_value += first_char % 11 + (first_char << 3) - first_char;
-    return hash_value % SYMBOL_TABLE_SIZE;
+static bool reserve_scope_stack(symbol_table_t *symbol_table) {
+    if (symbol_table->cur_scope < symbol_table->scope_stack_capacity) {
+        return true;
+    }
+
+    unsigned new_capacity = (symbol_table->scope_stack_capacity == 0) ? INITIAL_LIST_CAPACITY : 2 * symbol_table->scope_stack_capacity;
+    while (new_capacity <= symbol_table->cur_scope) {
+        new_capacity *= 2;
+    }
+    entry_t **temp = realloc(symbol_table->scope_stack, new_capacity * sizeof (entry_t *));
+    if (temp == NULL) {
+        return false;
+    }
+
+    memset(temp + symbol_table->scope_stack_capacity, 0, (new_capacity - symbol_table->scope_stack_capacity) * sizeof (entry_t *));
+    symbol_table->scope_stack = temp;
+    symbol_table->scope_stack_capacity = new_capacity;
+    return true;
 }
 
-/* See header for documentation */
-entry_t *insert(const char *name, unsigned length, unsigned line_num, bool declaration,
-                char error_msg[ERROR_MSG_LENGTH]) {
-    unsigned hash_value = hash(name);
-    entry_t *entry = symbol_table[hash_value];
-    bool first_value = true;
-    while ((entry != NULL) && (strcmp(name, entry->name) != 0)) {
-        first_value = false;
+/**
+ * \brief                               Append lookup to lookup log
+ * \param[in,out]                       lookup_log: Pointer to lookup log
+ * \param[in]                           name: Interned name of identifier
+ * \param[in]                           entry: Pointer to entry the appearance was recorded in (`NULL` upon error)
+ * \param[in]                           line_num: Line number of appearance
+ * \param[in]                           declaration: Whether appearance is declaration
+ * \return                              Whether appending the lookup was successful
+ */
+static bool log_lookup(lookup_log_t *lookup_log, const char *name, entry_t *entry, unsigned line_num,
+                       bool declaration) {
+    if (lookup_log->num_of_lookups == lookup_log->capacity) {
+        unsigned new_capacity = (lookup_log->capacity == 0) ? INITIAL_LIST_CAPACITY : 2 * lookup_log->capacity;
+        lookup_t *temp = realloc(lookup_log->lookups, new_capacity * sizeof (lookup_t));
+        if (temp == NULL) {
+            return false;
+        }
+
+        lookup_log->lookups = temp;
+        lookup_log->capacity = new_capacity;
+    }
+
+    lookup_t *lookup = lookup_log->lookups + (lookup_log->num_of_lookups)++;
+    lookup->name = name;
+    lookup->entry = entry;
+    lookup->line = line_num;
+    lookup->declaration = declaration;
+    return true;
+}
+
+/**
+ * \brief                               Insert entry in symbol table without logging the appearance
+ * \param[in,out]                       symbol_table: Pointer to symbol table
+ * \param[in]                           name: Interned name of entry
+ * \param[in]                           line_num: Line number of appearance
+ * \param[in]                           declaration: Whether appearance is declaration
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Pointer to new symbol table entry
+ */
+static entry_t *insert_entry(symbol_table_t *symbol_table, const interned_str_t *name, unsigned line_num,
+                             bool declaration, char error_msg[ERROR_MSG_LENGTH]) {
+    unsigned hash_value = name->hash;
+    entry_t *entry = (symbol_table->capacity == 0) ? NULL : symbol_table->buckets[hash_value & (symbol_table->capacity - 1)];
+    while ((entry != NULL) && (entry->name != name->str)) {
         entry = entry->next;
     }
     if (entry == NULL) {
         if (declaration == false) {
-            snprintf(error_msg, ERROR_MSG_LENGTH, "Undeclared identifier %s at line %u", name, line_num);
-            free_symbol_table();
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Undeclared identifier %s at line %u", name->str, line_num);
+            return NULL;
+        } else if (4 * (symbol_table->num_of_visible_entries + 1) > 3 * symbol_table->capacity && !resize_symbol_table(symbol_table)) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Resizing symbol table for %s failed", name->str);
+            return NULL;
+        } else if (!reserve_scope_stack(symbol_table)) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for scope of %s failed", name->str);
             return NULL;
         }
-        entry = malloc(sizeof (entry_t));
+
+        entry = calloc(1, sizeof (entry_t));
         if (entry == NULL) {
-            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for symbol table entry for %s failed", name);
-            free_symbol_table();
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for symbol table entry for %s failed",
+                     name->str);
             return NULL;
         }
 
-        strncpy(entry->name, name, length);
-        entry->scope = cur_scope;
-        entry->lines = malloc(sizeof (ref_list_t));
+        entry->name = name->str;
+        entry->hash = hash_value;
+        entry->scope = symbol_table->cur_scope;
+        entry->lines = malloc(INITIAL_LIST_CAPACITY * sizeof (unsigned));
         if (entry->lines == NULL) {
-            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for reference list for %s failed", name);
-            free_symbol_table();
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for reference list for %s failed", name->str);
+            free(entry);
             return NULL;
         }
 
-        entry->lines->line_num = line_num;
-        entry->lines->next = NULL;
+        entry->lines[0] = line_num;
+        entry->num_of_lines = 1;
+        entry->lines_capacity = INITIAL_LIST_CAPACITY;
         entry->qualifier = NONE_T;
         entry->type = VOID_T;
-        entry->next = symbol_table[hash_value];
-        symbol_table[hash_value] = entry;
-        if (first_value) {
-            shadow_symbol_table[hash_value] = entry;
+        if (symbol_table->last_entry == NULL) {
+            symbol_table->first_entry = entry;
+        } else {
+            symbol_table->last_entry->next_declared = entry;
         }
+        symbol_table->last_entry = entry;
+        entry->next_in_scope = symbol_table->scope_stack[symbol_table->cur_scope];
+        symbol_table->scope_stack[symbol_table->cur_scope] = entry;
+        entry->next = symbol_table->buckets[hash_value & (symbol_table->capacity - 1)];
+        symbol_table->buckets[hash_value & (symbol_table->capacity - 1)] = entry;
+        ++symbol_table->num_of_visible_entries;
     } else {
         if (declaration == true) {
-            if (entry->scope == cur_scope) {
+            if (entry->scope == symbol_table->cur_scope) {
                 snprintf(error_msg, ERROR_MSG_LENGTH,
                          "Multiple declaration of identifier %s at line %u (previous declaration at line %u)",
-                         name, line_num, entry->lines->line_num);
-                free_symbol_table();
+                         name->str, line_num, entry->lines[0]);
                 return NULL;
             } else {
                 snprintf(error_msg, ERROR_MSG_LENGTH,
                          "Declaration of identifier %s at line %u shadows declaration at line %u",
-                         name, line_num, entry->lines->line_num);
-                free_symbol_table();
+                         name->str, line_num, entry->lines[0]);
                 return NULL;
             }
-        } else {
-            ref_list_t *references = entry->lines;
-            while (references->next != NULL) {
-                references = references->next;
-            }
-            references->next = malloc(sizeof (ref_list_t));
-            if (references->next == NULL) {
-                snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for reference list for %s failed", name);
-                free_symbol_table();
-                return NULL;
-            }
-
-            references->next->line_num = line_num;
-            references->next->next = NULL;
+        } else if (!append_line(entry, line_num, error_msg)) {
+            return NULL;
         }
     }
     return entry;
 }
 
 /* See header for documentation */
-void hide_scope() {
-    for (unsigned i = 0; i < SYMBOL_TABLE_SIZE; ++i) {
-        if (symbol_table[i] != NULL) {
-            entry_t *entry = symbol_table[i];
-            while (entry != NULL && entry->scope == cur_scope) {
-                entry = entry->next;
-            }
-            symbol_table[i] = entry;
+entry_t *insert(symbol_table_t *symbol_table, const interned_str_t *name, unsigned line_num, bool declaration,
+                char error_msg[ERROR_MSG_LENGTH]) {
+    entry_t *entry = insert_entry(symbol_table, name, line_num, declaration, error_msg);
+
+    /* local references are not logged, local declarations are since they may shadow global identifiers */
+    if (symbol_table->lookup_log != NULL && (entry == NULL || entry->scope == 0 || declaration)
+        && !log_lookup(symbol_table->lookup_log, name->str, entry, line_num, declaration)) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Logging appearance of %s failed", name->str);
+        return NULL;
+    }
+    return entry;
+}
+
+/* See header for documentation */
+entry_t *find_entry(const symbol_table_t *symbol_table, const char *name, unsigned hash) {
+    entry_t *entry = (symbol_table->capacity == 0) ? NULL : symbol_table->buckets[hash & (symbol_table->capacity - 1)];
+    while ((entry != NULL) && (entry->name != name)) {
+        entry = entry->next;
+    }
+    return entry;
+}
+
+/* See header for documentation */
+bool append_line(entry_t *entry, unsigned line_num, char error_msg[ERROR_MSG_LENGTH]) {
+    if (entry->num_of_lines == entry->lines_capacity) {
+        unsigned new_capacity = (entry->lines_capacity == 0) ? INITIAL_LIST_CAPACITY : 2 * entry->lines_capacity;
+        unsigned *temp = realloc(entry->lines, new_capacity * sizeof (unsigned));
+        if (temp == NULL) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Reallocating memory for reference list for %s failed",
+                     entry->name);
+            return false;
         }
+
+        entry->lines = temp;
+        entry->lines_capacity = new_capacity;
     }
-    if (cur_scope > 0) {
-        --cur_scope;
+
+    entry->lines[(entry->num_of_lines)++] = line_num;
+    return true;
+}
+
+/* See header for documentation */
+void hide_entry(symbol_table_t *symbol_table, entry_t *entry) {
+    entry_t **link = symbol_table->buckets + (entry->hash & (symbol_table->capacity - 1));
+    while (*link != NULL && *link != entry) {
+        link = &((*link)->next);
+    }
+    if (*link != NULL) {
+        *link = entry->next;
+        entry->next = NULL;
+        --symbol_table->num_of_visible_entries;
+    }
+}
+
+/* See header for documentation */
+bool show_entry(symbol_table_t *symbol_table, entry_t *entry, char error_msg[ERROR_MSG_LENGTH]) {
+    if (4 * (symbol_table->num_of_visible_entries + 1) > 3 * symbol_table->capacity
+        && !resize_symbol_table(symbol_table)) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Resizing symbol table for %s failed", entry->name);
+        return false;
     }
+
+    /* global entries are the outermost ones, so they go to the end of their bucket */
+    entry_t **link = symbol_table->buckets + (entry->hash & (symbol_table->capacity - 1));
+    while (*link != NULL) {
+        link = &((*link)->next);
+    }
+    entry->next = NULL;
+    *link = entry;
+    ++symbol_table->num_of_visible_entries;
+    return true;
 }
 
 /* See header for documentation */
-void incr_scope() {
-    ++cur_scope;
+void free_entry(entry_t *entry) {
+    free_entry_content(entry);
+    free(entry);
 }
 
 /* See header for documentation */
-bool set_type_info(entry_t *entry, qualifier_t qualifier, type_t type, const unsigned sizes[MAX_ARRAY_DEPTH],
-                   unsigned depth, char error_msg[ERROR_MSG_LENGTH]) {
+void hide_scope(symbol_table_t *symbol_table) {
+    if (symbol_table->cur_scope == 0) { /* the global scope is never closed */
+        return;
+    }
+
+    if (symbol_table->cur_scope < symbol_table->scope_stack_capacity) {
+        /* newest entries first: each one is at the head of its bucket when it is reached */
+        for (entry_t *entry = symbol_table->scope_stack[symbol_table->cur_scope]; entry != NULL; entry = entry->next_in_scope) {
+            symbol_table->buckets[entry->hash & (symbol_table->capacity - 1)] = entry->next;
+            --symbol_table->num_of_visible_entries;
+        }
+        symbol_table->scope_stack[symbol_table->cur_scope] = NULL;
+    }
+    --symbol_table->cur_scope;
+}
+
+/* See header for documentation */
+void incr_scope(symbol_table_t *symbol_table) {
+    ++symbol_table->cur_scope;
+}
+
+/* See header for documentation */
+bool set_type_info(entry_t *entry, qualifier_t qualifier, type_t type, const shape_t *shape,
+                   char error_msg[ERROR_MSG_LENGTH]) {
     if (entry == NULL) {
         snprintf(error_msg, ERROR_MSG_LENGTH, "An error occurred setting type information in the symbol table");
         return false;
@@ -279,16 +410,16 @@ bool set_type_info(entry_t *entry, qualifier_t qualifier, type_t type, const uns
 
     entry->qualifier = qualifier;
     entry->type = type;
-    memcpy(entry->sizes, sizes, depth * sizeof (unsigned));
-    entry->depth = depth;
-    unsigned length = 1;
-    for (unsigned i = 0; i < depth; ++i) {
-        entry->sizes[i] = sizes[i];
-        length *= sizes[i];
-    }
+    entry->shape = shape;
+    entry->depth = (shape == NULL) ? 0 : shape->depth;
+    unsigned length = get_shape_length(shape);
     entry->length = length;
     if (qualifier == CONST_T) {
         entry->values = calloc(length, sizeof (value_t));
+        if (entry->values == NULL) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for values of %s failed", entry->name);
+            return false;
+        }
     }
     return true;
 }
@@ -300,16 +431,26 @@ bool set_func_info(entry_t *entry, bool is_unitary, bool is_quantizable, type_in
         snprintf(error_msg, ERROR_MSG_LENGTH, "An error occurred setting function information in the symbol table");
         return false;
     }
+    type_info_t *pars_type_info_copy = NULL;
+    if (num_of_pars > 0) {
+        pars_type_info_copy = malloc(num_of_pars * sizeof (type_info_t));
+        if (pars_type_info_copy == NULL) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for parameters of %s failed", entry->name);
+            return false;
+        }
+
+        memcpy(pars_type_info_copy, pars_type_info, num_of_pars * sizeof (type_info_t));
+    }
     entry->is_function = true;
     entry->is_unitary = is_unitary;
     entry->is_quantizable = is_quantizable;
-    entry->pars_type_info = pars_type_info;
+    entry->pars_type_info = pars_type_info_copy;
     entry->num_of_pars = num_of_pars;
     return true;
 }
 
 /* See header for documentation */
-void fprint_symbol_table(FILE *output_file) {
+void fprint_symbol_table(FILE *output_file, const symbol_table_t *symbol_table) {
     for (unsigned i = 0; i < MAX_TOKEN_LENGTH; ++i) {
         fputc('-', output_file);
     }
@@ -343,68 +484,62 @@ void fprint_symbol_table(FILE *output_file) {
     }
     fputc(' ', output_file);
     fprintf(output_file, "------ -------------\n");
-    for (unsigned i = 0; i < SYMBOL_TABLE_SIZE; ++i) {
-        if (shadow_symbol_table[i] != NULL) {
-            entry_t *entry = shadow_symbol_table[i];
-            while (entry != NULL) {
-                ref_list_t *t = entry->lines;
-                fprintf(output_file, "%-*s", MAX_TOKEN_LENGTH + 1, entry->name);
-                switch (entry->qualifier) {
-                    case NONE_T: {
-                        fprintf(output_file, "%-11s", "");
-                        break;
-                    }
-                    case CONST_T: {
-                        fprintf(output_file, "%-11s", "const");
-                        break;
-                    }
-                    case QUANTUM_T: {
-                        fprintf(output_file, "%-11s", "quantum");
-                        break;
-                    }
-                }
-                unsigned type_str_length = 0;
-                if (entry->is_function) {
-                    fprintf(output_file, "-> ");
-                    type_str_length += 3;
-                }
-                switch (entry->type) {
-                    case VOID_T: {
-                        fprintf(output_file, "void");
-                        type_str_length += 4;
-                        break;
-                    }
-                    case BOOL_T: {
-                        fprintf(output_file, "bool");
-                        type_str_length += 4;
-                        break;
-                    }
-                    case INT_T: {
-                        fprintf(output_file, "int");
-                        type_str_length += 3;
-                        break;
-                    }
-                    case UNSIGNED_T: {
-                        fprintf(output_file, "unsigned");
-                        type_str_length += 8;
-                        break;
-                    }
-                }
-                for (unsigned j = 0; j < entry->depth; ++j) {
-                    fprintf(output_file, "[]");
-                    type_str_length += 2;
-                }
-                for (unsigned k = type_str_length; k < 12 + MAX_ARRAY_DEPTH * 2; ++k) {
-                    fprintf(output_file, " ");
-                }
-                fprintf(output_file, "%-7u", entry->scope);
-                while (t != NULL) {
-                    fprintf(output_file, "%-4u ", t->line_num);
-                    t = t->next;
-                }
-                fprintf(output_file, "\n");
-                entry = entry->next;
-	        }
+    entry_t *entry = symbol_table->first_entry;
+    while (entry != NULL) {
+        fprintf(output_file, "%-*s", MAX_TOKEN_LENGTH + 1, entry->name);
+        switch (entry->qualifier) {
+            case NONE_T: {
+                fprintf(output_file, "%-11s", "");
+                break;
+            }
+            case CONST_T: {
+                fprintf(output_file, "%-11s", "const");
+                break;
+            }
+            case QUANTUM_T: {
+                fprintf(output_file, "%-11s", "quantum");
+                break;
+            }
+        }
+        unsigned type_str_length = 0;
+        if (entry->is_function) {
+            fprintf(output_file, "-> ");
+            type_str_length += 3;
+        }
+        switch (entry->type) {
+            case VOID_T: {
+                fprintf(output_file, "void");
+                type_str_length += 4;
+                break;
+            }
+            case BOOL_T: {
+                fprintf(output_file, "bool");
+                type_str_length += 4;
+                break;
+            }
+            case INT_T: {
+                fprintf(output_file, "int");
+                type_str_length += 3;
+                break;
+            }
+            case UNSIGNED_T: {
+                fprintf(output_file, "unsigned");
+                type_str_length += 8;
+                break;
+            }
+        }
+        for (unsigned j = 0; j < entry->depth; ++j) {
+            fprintf(output_file, "[]");
+            type_str_length += 2;
+        }
+        for (unsigned k = type_str_length; k < 12 + MAX_ARRAY_DEPTH * 2; ++k) {
+            fprintf(output_file, " ");
+        }
+        fprintf(output_file, "%-7u", entry->scope);
+        for (unsigned j = 0; j < entry->num_of_lines; ++j) {
+            fprintf(output_file, "%-4u ", entry->lines[j]);
         }
+        fprintf(output_file, "\n");
+        entry = entry->next_declared;
     }
 }
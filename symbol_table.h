@@ -50,7 +50,9 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include "intern.h"
 #include "rules.h"
+#include "shape.h"
 
 
 /*
@@ -112,33 +114,29 @@ typedef struct q_type {
  * \note                                This structure defines the full type information of a variable
  */
 typedef struct type_info {
-    qualifier_t qualifier;                  /*!< Qualifier of type information */
-    type_t type;                            /*!< Type of type information */
-    unsigned sizes[MAX_ARRAY_DEPTH];        /*!< Arry of sizes of type information */
-    unsigned depth;                         /*!< Depth of type information */
+    qualifier_t qualifier : 2;              /*!< Qualifier of type information */
+    type_t type : 2;                        /*!< Type of type information */
+    unsigned depth : 4;                     /*!< Depth of type information (`0` for scalars) */
+    const shape_t *shape;                   /*!< Shape of type information (`NULL` for scalars) */
 } type_info_t;
 
-/**
- * \brief                               Reference entry struct
- * \note                                This structure defines a linked entry of references (line numbers) to a variable
- */
-typedef struct ref_list { 
-    unsigned line_num;                      /*!< Line number */
-    struct ref_list *next;                  /*!< Pointer to next reference list entry */
-} ref_list_t;
+_Static_assert(MAX_ARRAY_DEPTH < 16, "Depth of type information must fit into its four-bit field");
 
 /**
  * \brief                               Symbol table entry struct
- * \note                                This structure defines the symbol table as a linked list of entries
+ * \note                                This structure defines the symbol table as a hash table of chained entries
  */
 typedef struct entry {
-    char name[MAX_TOKEN_LENGTH];            /*!< Name of entry */
+    const char *name;                       /*!< Name of entry (owned by the intern table) */
+    unsigned hash;                          /*!< Full hash value of name of entry */
     unsigned scope;                         /*!< Scope of entry */
-    ref_list_t *lines;                      /*!< Linked list of references of entry */
+    unsigned *lines;                        /*!< Array of references (line numbers) of entry */
+    unsigned num_of_lines;                  /*!< Number of references of entry */
+    unsigned lines_capacity;                /*!< Number of references the array of references can hold */
     qualifier_t qualifier;                  /*!< Qualifier of entry */
     type_t type;                            /*!< Type of entry */
-    unsigned sizes[MAX_ARRAY_DEPTH];        /*!< Sizes of entry */
-    unsigned depth;                         /*!< Depth of entry */
+    const shape_t *shape;                   /*!< Shape of entry (`NULL` for scalars) */
+    unsigned depth;                         /*!< Depth of entry (`0` for scalars) */
     unsigned length;                        /*!< Length of flattened array of entry's values */
     bool is_function;                       /*!< Whether entry is a function */
     union {
@@ -153,9 +151,50 @@ typedef struct entry {
             unsigned num_of_pars;           /*!< Number of function parameters */
         };
     };
-    struct entry *next;                     /*!< Pointer to next symbol table entry */
+    struct entry *next;                     /*!< Pointer to next visible symbol table entry in the same bucket */
+    struct entry *next_declared;            /*!< Pointer to next symbol table entry in order of declaration */
+    struct entry *next_in_scope;            /*!< Pointer to previously declared entry of the same scope */
 } entry_t;
 
+/**
+ * \brief                               Lookup struct
+ * \note                                This structure records one appearance of an identifier that is global or could
+ *                                      not be resolved
+ */
+typedef struct lookup {
+    const char *name;                       /*!< Interned name of identifier */
+    entry_t *entry;                         /*!< Pointer to entry the appearance was recorded in (`NULL` upon error) */
+    unsigned line;                          /*!< Line number of appearance */
+    bool declaration;                       /*!< Whether appearance is declaration */
+} lookup_t;
+
+/**
+ * \brief                               Lookup log struct
+ * \note                                This structure records the lookups of a parse in the order they were made
+ */
+typedef struct lookup_log {
+    lookup_t *lookups;                      /*!< Array of lookups */
+    unsigned num_of_lookups;                /*!< Number of lookups */
+    unsigned capacity;                      /*!< Number of lookups the array can hold */
+} lookup_log_t;
+
+/**
+ * \brief                               Symbol table struct
+ * \note                                Each parse owns one symbol table; all entries are released by free_symbol_table()
+ */
+typedef struct symbol_table {
+    entry_t **buckets;                      /*!< Array of bucket heads (visible entries only) */
+    unsigned capacity;                      /*!< Number of buckets (zero or a power of two) */
+    unsigned num_of_visible_entries;        /*!< Number of entries currently reachable from a bucket */
+    entry_t *first_entry;                   /*!< First entry in order of declaration */
+    entry_t *last_entry;                    /*!< Last entry in order of declaration */
+    entry_t **scope_stack;                  /*!< Array of most recently declared entry of each open scope */
+    unsigned scope_stack_capacity;          /*!< Number of scopes the scope stack can hold */
+    unsigned cur_scope;                     /*!< Current scope */
+    lookup_log_t *lookup_log;               /*!< Log of appearances of global and unresolved identifiers (`NULL` if
+                                                 appearances are not logged) */
+} symbol_table_t;
+
 
 /*
  * =====================================================================================================================
@@ -179,48 +218,94 @@ char *type_to_str(type_t type);
 
 /**
  * \brief                               Initialize symbol table
+ * \param[out]                          symbol_table: Pointer to symbol table
  */
-void init_symbol_table();
+void init_symbol_table(symbol_table_t *symbol_table);
 
 /**
- * \brief                               Free symbol table
+ * \brief                               Free all entries of symbol table and reinitialize it
+ * \param[in,out]                       symbol_table: Pointer to symbol table
  */
-void free_symbol_table();
+void free_symbol_table(symbol_table_t *symbol_table);
 
 /**
  * \brief                               Insert entry in symbol table and return pointer to that entry
- * \param[in]                           name: Name of entry
- * \param[in]                           length: Length of name string
+ * \param[in,out]                       symbol_table: Pointer to symbol table
+ * \param[in]                           name: Interned name of entry
  * \param[in]                           line_num: Line number of appearance
  * \param[in]                           declaration: Whether appearance is declaration
  * \param[out]                          error_msg: Message to be written in case of an error
  * \return                              Pointer to new symbol table entry
  */
-entry_t *insert(const char *name, unsigned length, unsigned line_num, bool declaration,
+entry_t *insert(symbol_table_t *symbol_table, const interned_str_t *name, unsigned line_num, bool declaration,
                 char error_msg[ERROR_MSG_LENGTH]);
 
+/**
+ * \brief                               Find visible symbol table entry by name
+ * \param[in]                           symbol_table: Pointer to symbol table
+ * \param[in]                           name: Interned name of entry
+ * \param[in]                           hash: Full hash value of name
+ * \return                              Pointer to visible symbol table entry (`NULL` if there is none)
+ */
+entry_t *find_entry(const symbol_table_t *symbol_table, const char *name, unsigned hash);
+
+/**
+ * \brief                               Append line number of an appearance to symbol table entry
+ * \param[in,out]                       entry: Pointer to symbol table entry
+ * \param[in]                           line_num: Line number of appearance
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether appending the line number was successful
+ */
+bool append_line(entry_t *entry, unsigned line_num, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Make global symbol table entry invisible
+ * \note                                The entry stays in the order of declaration and in its scope
+ * \param[in,out]                       symbol_table: Pointer to symbol table
+ * \param[in]                           entry: Pointer to visible symbol table entry of scope `0`
+ */
+void hide_entry(symbol_table_t *symbol_table, entry_t *entry);
+
+/**
+ * \brief                               Make global symbol table entry visible again
+ * \param[in,out]                       symbol_table: Pointer to symbol table
+ * \param[in]                           entry: Pointer to invisible symbol table entry of scope `0`
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether showing the entry was successful
+ */
+bool show_entry(symbol_table_t *symbol_table, entry_t *entry, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Free symbol table entry that is no longer part of any symbol table
+ * \param[in]                           entry: Pointer to symbol table entry
+ */
+void free_entry(entry_t *entry);
+
 /**
  * \brief                               Hide all symbol table entries of current scope and decrease scope counter
+ * \note                                Only touches the entries declared in the current scope; does nothing in the
+ *                                      global scope
+ * \param[in,out]                       symbol_table: Pointer to symbol table
  */
-void hide_scope();
+void hide_scope(symbol_table_t *symbol_table);
 
 /**
  * \brief                               Increase scope counter
+ * \param[in,out]                       symbol_table: Pointer to symbol table
  */
-void incr_scope();
+void incr_scope(symbol_table_t *symbol_table);
 
 /**
  * \brief                               Set type information of symbol table entry
  * \param[in]                           entry: Pointer to symbol table entry
  * \param[in]                           qualifier: Qualifier to be set
  * \param[in]                           type: Type to be set
- * \param[in]                           sizes: Array of sizes to be set
- * \param[in]                           depth: Depth to be set
+ * \param[in]                           shape: Shape to be set (`NULL` for scalars)
  * \param[out]                          error_msg: Message to be written in case of an error
  * \return                              Whether setting the type information was successful
  */
-bool set_type_info(entry_t *entry, qualifier_t qualifier, type_t type, const unsigned sizes[MAX_ARRAY_DEPTH],
-                   unsigned depth, char error_msg[ERROR_MSG_LENGTH]);
+bool set_type_info(entry_t *entry, qualifier_t qualifier, type_t type, const shape_t *shape,
+                   char error_msg[ERROR_MSG_LENGTH]);
 
 /**
  * \brief                               Set function information of symbol table entry
@@ -228,7 +313,7 @@ bool set_type_info(entry_t *entry, qualifier_t qualifier, type_t type, const uns
  * \param[in]                           entry: Pointer to symbol table entry
  * \param[in]                           is_unitary: Whether function is unitary
  * \param[in]                           is_quantizable: Whether function can be used for creating a superposition
- * \param[in]                           pars_type_info: Array of type information of function parameters
+ * \param[in]                           pars_type_info: Array of type information of function parameters (copied)
  * \param[in]                           num_of_pars: Number of function parameters
  * \param[out]                          error_msg: Message to be written in case of an error
  * \return                              Whether setting the function information was successful
@@ -239,8 +324,9 @@ bool set_func_info(entry_t *entry, bool is_unitary, bool is_quantizable, type_in
 /**
  * \brief                               Write symbol table content to output file
  * \param[out]                          output_file: Pointer to output file for symbol table
+ * \param[in]                           symbol_table: Pointer to symbol table
  */
-void fprint_symbol_table(FILE *output_file);
+void fprint_symbol_table(FILE *output_file, const symbol_table_t *symbol_table);
 
 
 /*
@@ -0,0 +1,278 @@
+/**
+ * \file                                thread_pool.c
+ * \brief                               Pinned worker pool
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif /* __linux__ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "thread_pool.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+/* NUMA nodes are looked up by number, stopping at the first gap of this many missing nodes */
+#define MAX_NUMA_NODE_GAP 8
+#define CPU_LIST_LENGTH 4096
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+#ifdef __linux__
+/**
+ * \brief                               Mark the processors of a node's processor list (e.g. "0-3,8-11")
+ * \param[in]                           node: Number of NUMA node
+ * \param[out]                          cpus: Set of processors of the node
+ * \return                              Whether the node exists
+ */
+static bool read_node_cpus(unsigned node, cpu_set_t *cpus) {
+    char path[64];
+    snprintf(path, sizeof (path), "/sys/devices/system/node/node%u/cpulist", node);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    char list[CPU_LIST_LENGTH];
+    bool has_list = fgets(list, sizeof (list), file) != NULL;
+    fclose(file);
+    CPU_ZERO(cpus);
+    for (char *range = list; has_list && *range != '\0' && *range != '\n'; ) {
+        char *end = NULL;
+        unsigned long first = strtoul(range, &end, 10);
+        unsigned long last = first;
+        if (end == range) {
+            break;
+        } else if (*end == '-') {
+            range = end + 1;
+            last = strtoul(range, &end, 10);
+        }
+        for (unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, cpus);
+        }
+        range = (*end == ',') ? end + 1 : end;
+    }
+    return true;
+}
+
+/**
+ * \brief                               List the processors the process may run on, ordered by NUMA node
+ * \note                                Processors not found in any node (or all of them, if the system exposes no node
+ *                                      information) are put on node 0
+ * \param[out]                          cpus: Array of processors (at least `CPU_SETSIZE` entries)
+ * \param[out]                          nodes: Array of NUMA nodes of the processors (at least `CPU_SETSIZE` entries)
+ * \return                              Number of processors
+ */
+static unsigned list_cpus(int *cpus, unsigned *nodes) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof (cpu_set_t), &allowed) != 0) {
+        return 0;
+    }
+
+    unsigned num_of_cpus = 0;
+    cpu_set_t node_cpus;
+    for (unsigned node = 0, gap = 0; gap < MAX_NUMA_NODE_GAP; ++node) {
+        if (!read_node_cpus(node, &node_cpus)) {
+            ++gap;
+            continue;
+        }
+        gap = 0;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &node_cpus) && CPU_ISSET(cpu, &allowed)) {
+                CPU_CLR(cpu, &allowed);
+                cpus[num_of_cpus] = cpu;
+                nodes[num_of_cpus++] = node;
+            }
+        }
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpus[num_of_cpus] = cpu;
+            nodes[num_of_cpus++] = 0;
+        }
+    }
+    return num_of_cpus;
+}
+#endif /* __linux__ */
+
+/**
+ * \brief                               Assign processors to the workers of a pool
+ * \note                                With fewer workers than processors, the workers are spread evenly, so that both
+ *                                      the nodes and the processors of each node are shared out; with more workers,
+ *                                      processors are reused round-robin
+ * \param[in,out]                       pool: Pointer to thread pool
+ * \param[in]                           num_of_threads: Number of workers
+ */
+static void assign_cpus(thread_pool_t *pool, unsigned num_of_threads) {
+    for (unsigned i = 0; i < num_of_threads; ++i) {
+        pool->workers[i].cpu = -1;
+        pool->workers[i].node = 0;
+    }
+    pool->num_of_nodes = 1;
+#ifdef __linux__
+    int *cpus = malloc(CPU_SETSIZE * sizeof (int));
+    unsigned *nodes = malloc(CPU_SETSIZE * sizeof (unsigned));
+    unsigned num_of_cpus = (cpus != NULL && nodes != NULL) ? list_cpus(cpus, nodes) : 0;
+    unsigned last_node = 0;
+    for (unsigned i = 0; i < num_of_threads && num_of_cpus > 0; ++i) {
+        unsigned index = (num_of_threads <= num_of_cpus) ? i * num_of_cpus / num_of_threads : i % num_of_cpus;
+        pool->workers[i].cpu = cpus[index];
+        pool->workers[i].node = nodes[index];
+        if (i > 0 && i < num_of_cpus && nodes[index] != last_node) {
+            ++(pool->num_of_nodes);
+        }
+        last_node = nodes[index];
+    }
+    free(cpus);
+    free(nodes);
+#endif /* __linux__ */
+}
+
+/**
+ * \brief                               Pin worker to its processor, then run posted jobs until stopped
+ * \param[in]                           arg: Pointer to worker
+ * \return                              `NULL`
+ */
+static void *run_worker(void *arg) {
+    pool_worker_t *worker = arg;
+    thread_pool_t *pool = worker->pool;
+#ifdef __linux__
+    if (worker->cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(worker->cpu, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof (cpu_set_t), &cpus);
+    }
+#endif /* __linux__ */
+
+    unsigned long long generation = 0;
+    while (true) {
+        pthread_mutex_lock(&(pool->lock));
+        while (pool->generation == generation) {
+            pthread_cond_wait(&(pool->has_started), &(pool->lock));
+        }
+        generation = pool->generation;
+        pool_job_t job = pool->job;
+        void *context = pool->context;
+        pthread_mutex_unlock(&(pool->lock));
+        if (job == NULL) {
+            return NULL;
+        }
+
+        job(context, worker->id);
+        pthread_mutex_lock(&(pool->lock));
+        if (--(pool->num_of_running) == 0) {
+            pthread_cond_signal(&(pool->has_finished));
+        }
+        pthread_mutex_unlock(&(pool->lock));
+    }
+}
+
+/* See header for documentation */
+bool init_thread_pool(thread_pool_t *pool, unsigned num_of_threads, char error_msg[ERROR_MSG_LENGTH]) {
+    if (num_of_threads == 0 || num_of_threads > MAX_NUM_OF_THREADS) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Number of threads must be between 1 and %u", MAX_NUM_OF_THREADS);
+        return false;
+    }
+
+    pool->num_of_threads = 0;
+    pool->job = NULL;
+    pool->context = NULL;
+    pool->generation = 0;
+    pool->num_of_running = 0;
+    pthread_mutex_init(&(pool->lock), NULL);
+    pthread_cond_init(&(pool->has_started), NULL);
+    pthread_cond_init(&(pool->has_finished), NULL);
+    assign_cpus(pool, num_of_threads);
+    for (unsigned i = 0; i < num_of_threads; ++i) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].id = i;
+        if (pthread_create(pool->threads + i, NULL, run_worker, pool->workers + i) != 0) {
+            snprintf(error_msg, ERROR_MSG_LENGTH, "Starting worker thread %u of %u failed", i + 1, num_of_threads);
+            free_thread_pool(pool);
+            return false;
+        }
+        ++(pool->num_of_threads);
+    }
+    return true;
+}
+
+/* See header for documentation */
+void run_thread_pool(thread_pool_t *pool, pool_job_t job, void *context) {
+    pthread_mutex_lock(&(pool->lock));
+    pool->job = job;
+    pool->context = context;
+    pool->num_of_running = pool->num_of_threads;
+    ++(pool->generation);
+    pthread_cond_broadcast(&(pool->has_started));
+    while (pool->num_of_running > 0) {
+        pthread_cond_wait(&(pool->has_finished), &(pool->lock));
+    }
+    pthread_mutex_unlock(&(pool->lock));
+}
+
+/* See header for documentation */
+void free_thread_pool(thread_pool_t *pool) {
+    pthread_mutex_lock(&(pool->lock));
+    pool->job = NULL;
+    ++(pool->generation);
+    pthread_cond_broadcast(&(pool->has_started));
+    pthread_mutex_unlock(&(pool->lock));
+    for (unsigned i = 0; i < pool->num_of_threads; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pool->num_of_threads = 0;
+    pthread_mutex_destroy(&(pool->lock));
+    pthread_cond_destroy(&(pool->has_started));
+    pthread_cond_destroy(&(pool->has_finished));
+}
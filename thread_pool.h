@@ -0,0 +1,160 @@
+/**
+ * \file                                thread_pool.h
+ * \brief                               Pinned worker pool include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Pool job type
+ * \note                                A job is run once by every worker, receiving the shared context and the index of
+ *                                      the worker
+ */
+typedef void (*pool_job_t)(void *context, unsigned id);
+
+struct thread_pool;
+
+/**
+ * \brief                               Pool worker struct
+ * \note                                This structure defines the argument of one worker thread
+ */
+typedef struct pool_worker {
+    struct thread_pool *pool;               /*!< Pointer to pool of the worker */
+    unsigned id;                            /*!< Index of the worker */
+    int cpu;                                /*!< Processor the worker is pinned to (-1 if not pinned) */
+    unsigned node;                          /*!< NUMA node of the processor */
+} pool_worker_t;
+
+/**
+ * \brief                               Thread pool struct
+ * \note                                This structure defines a fixed set of worker threads, each pinned to its own
+ *                                      processor; consecutive workers share a NUMA node as far as possible, so that
+ *                                      memory first touched by a worker stays close to it and to its neighbours
+ */
+typedef struct thread_pool {
+    pthread_t threads[MAX_NUM_OF_THREADS];  /*!< Array of worker threads */
+    pool_worker_t workers[MAX_NUM_OF_THREADS];  /*!< Array of worker arguments */
+    unsigned num_of_threads;                /*!< Number of worker threads */
+    unsigned num_of_nodes;                  /*!< Number of NUMA nodes the workers are spread over */
+    pthread_mutex_t lock;                   /*!< Lock guarding the job fields */
+    pthread_cond_t has_started;             /*!< Condition signalled when a job is posted */
+    pthread_cond_t has_finished;            /*!< Condition signalled when the last worker finishes a job */
+    pool_job_t job;                         /*!< Current job (`NULL` to stop the workers) */
+    void *context;                          /*!< Context of the current job */
+    unsigned long long generation;          /*!< Number of jobs posted so far */
+    unsigned num_of_running;                /*!< Number of workers still running the current job */
+} thread_pool_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Start worker threads pinned to the processors the process may run on
+ * \note                                Workers are spread evenly over the allowed processors ordered by NUMA node; on
+ *                                      systems without affinity support the workers are left unpinned
+ * \param[out]                          pool: Pointer to thread pool (must not be moved while running)
+ * \param[in]                           num_of_threads: Number of worker threads (at most `MAX_NUM_OF_THREADS`)
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether all worker threads could be started
+ */
+bool init_thread_pool(thread_pool_t *pool, unsigned num_of_threads, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Run a job on every worker and wait until all of them are done
+ * \note                                Jobs of consecutive calls never overlap, so every call acts as a barrier
+ * \param[in,out]                       pool: Pointer to thread pool
+ * \param[in]                           job: Job to be run
+ * \param[in,out]                       context: Context passed to the job
+ */
+void run_thread_pool(thread_pool_t *pool, pool_job_t job, void *context);
+
+/**
+ * \brief                               Stop and join the worker threads
+ * \param[in,out]                       pool: Pointer to thread pool
+ */
+void free_thread_pool(thread_pool_t *pool);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* THREAD_POOL_H */
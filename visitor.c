@@ -0,0 +1,331 @@
+/**
+ * \file                                visitor.c
+ * \brief                               Tree visitor source file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "ast.h"
+#include "rules.h"
+#include "visitor.h"
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Node layout struct
+ * \note                                This structure defines where the children of one node type are stored: a fixed
+ *                                      number of child pointers, optionally followed by a child list of variable length
+ *                                      and further child pointers
+ */
+typedef struct node_layout {
+    unsigned num_of_leading_children;       /*!< Number of child pointers in front of the child list */
+    size_t leading_children[4];             /*!< Offsets of child pointers in front of the child list */
+    bool has_child_list;                    /*!< Whether the node type has a child list */
+    size_t child_list;                      /*!< Offset of the child list (array of child pointers) */
+    size_t child_list_length;               /*!< Offset of the length of the child list */
+    unsigned num_of_trailing_children;      /*!< Number of child pointers behind the child list */
+    size_t trailing_children[1];            /*!< Offsets of child pointers behind the child list */
+} node_layout_t;
+
+/**
+ * \brief                               Tree pass frame struct
+ * \note                                This structure defines a node whose children are being walked by a tree pass
+ */
+typedef struct pass_frame {
+    node_t *node;                           /*!< Pointer to node */
+    size_t depth;                           /*!< Layer depth of node */
+    unsigned next_child;                    /*!< Index of next child slot to be walked */
+    unsigned num_of_children;               /*!< Number of child slots to be walked */
+} pass_frame_t;
+
+/**
+ * \brief                               Tree pass stack struct
+ * \note                                This structure defines the explicit stack of nodes whose children are being
+ *                                      walked by a tree pass
+ */
+typedef struct pass_stack {
+    pass_frame_t *frames;                   /*!< Array of frames (top of the stack at the end) */
+    size_t size;                            /*!< Number of frames */
+    size_t capacity;                        /*!< Number of frames the array can hold */
+} pass_stack_t;
+
+/**
+ * \brief                               Tree visitor adapter struct
+ * \note                                This structure defines the data of the tree pass that walk_tree() runs
+ */
+typedef struct tree_visitor_adapter {
+    tree_visitor_t visitor;                 /*!< Tree visitor to be called */
+    void *data;                             /*!< Data of tree visitor */
+    bool stopped;                           /*!< Whether the tree visitor stopped the walk */
+} tree_visitor_adapter_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Layouts of all node types whose children are stored at fixed places
+ * \note                                Initializer lists of variable definitions and indices of references are
+ *                                      enumerated by get_num_of_children() and get_child() directly
+ */
+static const node_layout_t node_layouts[NUM_OF_NODE_TYPES] = {
+    [BASIC_NODE_T] = {2, {offsetof(node_t, left), offsetof(node_t, right)}},
+    [STMT_LIST_NODE_T] = {0, {0}, true, offsetof(stmt_list_node_t, stmt_list),
+                          offsetof(stmt_list_node_t, num_of_stmts)},
+    [VAR_DEF_NODE_T] = {1, {offsetof(var_def_node_t, node)}},
+    [FUNC_DEF_NODE_T] = {1, {offsetof(func_def_node_t, func_tail)}},
+    [FUNC_CALL_NODE_T] = {0, {0}, true, offsetof(func_call_node_t, pars), offsetof(func_call_node_t, num_of_pars)},
+    [LOGICAL_OP_NODE_T] = {2, {offsetof(logical_op_node_t, left), offsetof(logical_op_node_t, right)}},
+    [COMPARISON_OP_NODE_T] = {2, {offsetof(comparison_op_node_t, left), offsetof(comparison_op_node_t, right)}},
+    [EQUALITY_OP_NODE_T] = {2, {offsetof(equality_op_node_t, left), offsetof(equality_op_node_t, right)}},
+    [NOT_OP_NODE_T] = {1, {offsetof(not_op_node_t, child)}},
+    [INTEGER_OP_NODE_T] = {2, {offsetof(integer_op_node_t, left), offsetof(integer_op_node_t, right)}},
+    [INVERT_OP_NODE_T] = {1, {offsetof(invert_op_node_t, child)}},
+    [IF_NODE_T] = {2, {offsetof(if_node_t, condition), offsetof(if_node_t, if_branch)}, true,
+                   offsetof(if_node_t, else_ifs), offsetof(if_node_t, num_of_else_ifs),
+                   1, {offsetof(if_node_t, else_branch)}},
+    [ELSE_IF_NODE_T] = {2, {offsetof(else_if_node_t, condition), offsetof(else_if_node_t, else_if_branch)}},
+    [SWITCH_NODE_T] = {1, {offsetof(switch_node_t, expression)}, true, offsetof(switch_node_t, cases),
+                       offsetof(switch_node_t, num_of_cases)},
+    [CASE_NODE_T] = {1, {offsetof(case_node_t, case_branch)}},
+    [FOR_NODE_T] = {4, {offsetof(for_node_t, initialize), offsetof(for_node_t, condition),
+                        offsetof(for_node_t, increment), offsetof(for_node_t, for_branch)}},
+    [DO_NODE_T] = {2, {offsetof(do_node_t, do_branch), offsetof(do_node_t, condition)}},
+    [WHILE_NODE_T] = {2, {offsetof(while_node_t, condition), offsetof(while_node_t, while_branch)}},
+    [ASSIGN_NODE_T] = {2, {offsetof(assign_node_t, left), offsetof(assign_node_t, right)}},
+    [PHASE_NODE_T] = {2, {offsetof(phase_node_t, left), offsetof(phase_node_t, right)}},
+    [MEASURE_NODE_T] = {1, {offsetof(measure_node_t, child)}},
+    [RETURN_NODE_T] = {1, {offsetof(return_node_t, return_value)}},
+};
+
+/**
+ * \brief                               Read child pointer at a given offset of a node
+ * \param[in]                           node: Pointer to node
+ * \param[in]                           offset: Offset of child pointer
+ * \return                              Child pointer
+ */
+static node_t *get_child_at(const node_t *node, size_t offset) {
+    return *(node_t *const *) ((const char *) node + offset);
+}
+
+/* See header for documentation */
+unsigned get_num_of_children(const node_t *node) {
+    if (node->node_type == VAR_DEF_NODE_T && ((const var_def_node_t *) node)->is_init_list) {
+        return ((const var_def_node_t *) node)->length;
+    } else if (node->node_type == REFERENCE_NODE_T) {
+        const reference_node_t *reference_node_view = (const reference_node_t *) node;
+        return reference_node_view->entry->depth - reference_node_view->type_info.depth;
+    }
+
+    const node_layout_t *layout = &(node_layouts[node->node_type]);
+    unsigned num_of_children = layout->num_of_leading_children + layout->num_of_trailing_children;
+    if (layout->has_child_list) {
+        num_of_children += *(const unsigned *) ((const char *) node + layout->child_list_length);
+    }
+    return num_of_children;
+}
+
+/* See header for documentation */
+node_t *get_child(const node_t *node, unsigned index) {
+    if (node->node_type == VAR_DEF_NODE_T && ((const var_def_node_t *) node)->is_init_list) {
+        const var_def_node_t *var_def_node_view = (const var_def_node_t *) node;
+        return (var_def_node_view->q_types[index].qualifier != CONST_T)
+               ? var_def_node_view->values[index].node_value : NULL;
+    } else if (node->node_type == REFERENCE_NODE_T) {
+        const reference_node_t *reference_node_view = (const reference_node_t *) node;
+        return (!reference_node_view->index_is_const[index]) ? reference_node_view->indices[index].node_index : NULL;
+    }
+
+    const node_layout_t *layout = &(node_layouts[node->node_type]);
+    if (index < layout->num_of_leading_children) {
+        return get_child_at(node, layout->leading_children[index]);
+    }
+    index -= layout->num_of_leading_children;
+    if (layout->has_child_list) {
+        unsigned child_list_length = *(const unsigned *) ((const char *) node + layout->child_list_length);
+        if (index < child_list_length) {
+            node_t *const *child_list = *(node_t *const *const *) ((const char *) node + layout->child_list);
+            return child_list[index];
+        }
+        index -= child_list_length;
+    }
+    return get_child_at(node, layout->trailing_children[index]);
+}
+
+/**
+ * \brief                               Call a visitor for a node
+ * \param[in]                           visitor: Visitor to be called (`NULL` if there is none)
+ * \param[in,out]                       node: Pointer to visited node
+ * \param[in]                           depth: Layer depth of visited node
+ * \param[in,out]                       data: Pointer to data of the tree pass
+ * \return                              Result of the visitor (`CONTINUE_W` if there is none)
+ */
+static walk_result_t visit_node(node_visitor_t visitor, node_t *node, size_t depth, void *data) {
+    return (visitor != NULL) ? visitor(node, depth, data) : CONTINUE_W;
+}
+
+/**
+ * \brief                               Push node onto the stack of a tree pass
+ * \param[in,out]                       stack: Pointer to stack of the tree pass
+ * \param[in]                           node: Pointer to node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in]                           num_of_children: Number of child slots of node to be walked
+ * \return                              Whether pushing the node was successful
+ */
+static bool push_to_pass_stack(pass_stack_t *stack, node_t *node, size_t depth, unsigned num_of_children) {
+    if (stack->size == stack->capacity) {
+        size_t new_capacity = (stack->capacity == 0) ? INITIAL_WALK_STACK_SIZE : 2 * stack->capacity;
+        pass_frame_t *new_frames = realloc(stack->frames, new_capacity * sizeof (pass_frame_t));
+        if (new_frames == NULL) {
+            return false;
+        }
+        stack->frames = new_frames;
+        stack->capacity = new_capacity;
+    }
+    stack->frames[stack->size].node = node;
+    stack->frames[stack->size].depth = depth;
+    stack->frames[stack->size].next_child = 0;
+    stack->frames[stack->size].num_of_children = num_of_children;
+    ++stack->size;
+    return true;
+}
+
+/**
+ * \brief                               Visit node in pre-order and push it onto the stack of a tree pass
+ * \note                                Nodes without children to be walked are visited in post-order right away instead
+ *                                      of being pushed, which spares the stack traffic for all leaves
+ * \param[in]                           pass: Pointer to tree pass whose default visitors have been resolved
+ * \param[in,out]                       stack: Pointer to stack of the tree pass
+ * \param[in,out]                       node: Pointer to node
+ * \param[in]                           depth: Layer depth of node
+ * \param[in,out]                       data: Pointer to data of the tree pass
+ * \param[out]                          stopped: Whether a visitor stopped the walk
+ * \return                              Whether pushing the node was successful
+ */
+static bool enter_node(const tree_pass_t *pass, pass_stack_t *stack, node_t *node, size_t depth, void *data,
+                       bool *stopped) {
+    walk_result_t result = visit_node(pass->pre_visitors[node->node_type], node, depth, data);
+    if (result == STOP_W) {
+        *stopped = true;
+        return true;
+    }
+
+    unsigned num_of_children = (result == SKIP_CHILDREN_W) ? 0 : get_num_of_children(node);
+    if (num_of_children == 0) {
+        *stopped = visit_node(pass->post_visitors[node->node_type], node, depth, data) == STOP_W;
+        return true;
+    }
+    return push_to_pass_stack(stack, node, depth, num_of_children);
+}
+
+/* See header for documentation */
+bool run_tree_pass(const tree_pass_t *pass, node_t *root, size_t depth, void *data, char error_msg[ERROR_MSG_LENGTH]) {
+    if (root == NULL) {
+        return true;
+    }
+
+    tree_pass_t resolved_pass = *pass;
+    for (unsigned i = 0; i < NUM_OF_NODE_TYPES; ++i) {
+        if (resolved_pass.pre_visitors[i] == NULL) {
+            resolved_pass.pre_visitors[i] = pass->default_pre_visitor;
+        }
+        if (resolved_pass.post_visitors[i] == NULL) {
+            resolved_pass.post_visitors[i] = pass->default_post_visitor;
+        }
+    }
+
+    pass_stack_t stack = {.frames = NULL, .size = 0, .capacity = 0};
+    bool stopped = false;
+    bool success = enter_node(&resolved_pass, &stack, root, depth, data, &stopped);
+    while (success && !stopped && stack.size > 0) {
+        pass_frame_t *frame = &(stack.frames[stack.size - 1]);
+        if (frame->next_child < frame->num_of_children) {
+            node_t *child = get_child(frame->node, frame->next_child++);
+            if (child != NULL) {
+                success = enter_node(&resolved_pass, &stack, child, frame->depth + 1, data, &stopped);
+            }
+        } else {
+            --stack.size;
+            stopped = visit_node(resolved_pass.post_visitors[frame->node->node_type], frame->node, frame->depth,
+                                 data) == STOP_W;
+        }
+    }
+    free(stack.frames);
+
+    if (!success) {
+        snprintf(error_msg, ERROR_MSG_LENGTH, "Allocating memory for tree pass failed");
+    }
+    return success;
+}
+
+/**
+ * \brief                               Call the tree visitor of walk_tree() for a node
+ * \param[in]                           node: Pointer to visited node
+ * \param[in]                           depth: Layer depth of visited node
+ * \param[in,out]                       data: Pointer to tree visitor adapter
+ * \return                              `STOP_W` if the tree visitor stopped the walk, `CONTINUE_W` otherwise
+ */
+static walk_result_t visit_with_tree_visitor(node_t *node, size_t depth, void *data) {
+    tree_visitor_adapter_t *adapter = data;
+    if (!adapter->visitor(node, depth, adapter->data)) {
+        adapter->stopped = true;
+        return STOP_W;
+    }
+    return CONTINUE_W;
+}
+
+/* See header for documentation */
+bool walk_tree(const node_t *root, size_t depth, tree_visitor_t visitor, void *data,
+               char error_msg[ERROR_MSG_LENGTH]) {
+    static const tree_pass_t tree_visitor_pass = {.default_pre_visitor = visit_with_tree_visitor};
+    tree_visitor_adapter_t adapter = {.visitor = visitor, .data = data, .stopped = false};
+    return run_tree_pass(&tree_visitor_pass, (node_t *) root, depth, &adapter, error_msg) && !adapter.stopped;
+}
@@ -0,0 +1,190 @@
+/**
+ * \file                                visitor.h
+ * \brief                               Tree visitor include file
+ */
+
+
+/*
+ * Copyright (c) 2024 Lennart BINKOWSKI
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of cq_compiler.
+ *
+ * Author:          Lennart BINKOWSKI <lennart.binkowski@itp.uni-hannover.de>
+ */
+
+
+
+/*
+ * =====================================================================================================================
+ *                                                header guard
+ * =====================================================================================================================
+ */
+
+#ifndef VISITOR_H
+#define VISITOR_H
+
+
+/*
+ * =====================================================================================================================
+ *                                                includes
+ * =====================================================================================================================
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "ast.h"
+#include "rules.h"
+
+
+/*
+ * =====================================================================================================================
+ *                                                C++ check
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+
+/*
+ * =====================================================================================================================
+ *                                                macros
+ * =====================================================================================================================
+ */
+
+#define NUM_OF_NODE_TYPES (RETURN_NODE_T + 1)
+
+
+/*
+ * =====================================================================================================================
+ *                                                type definitions
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Walk result enumeration
+ * \note                                A node visitor returns one of these to steer the walk of a tree pass
+ */
+typedef enum walk_result {
+    CONTINUE_W,                             /*!< Continue the walk */
+    SKIP_CHILDREN_W,                        /*!< Skip the children of the visited node (pre-order only) */
+    STOP_W,                                 /*!< Stop the walk (early exit) */
+} walk_result_t;
+
+/**
+ * \brief                               Node visitor function type
+ * \note                                A node visitor is called by run_tree_pass() with the visited node, its layer
+ *                                      depth and the data passed to run_tree_pass()
+ */
+typedef walk_result_t (*node_visitor_t)(node_t *node, size_t depth, void *data);
+
+/**
+ * \brief                               Tree visitor function type
+ * \note                                A tree visitor is called by walk_tree() for every node of a tree with the node,
+ *                                      its layer depth and the data passed to walk_tree(); it returns whether the walk
+ *                                      is to be continued
+ */
+typedef bool (*tree_visitor_t)(const node_t *node, size_t depth, void *data);
+
+/**
+ * \brief                               Tree pass struct
+ * \note                                This structure defines an analysis or transformation over the tree by its node
+ *                                      visitors; a zero-initialized tree pass visits nothing, and a node type without
+ *                                      its own visitor falls back to the default visitor of the same order
+ */
+typedef struct tree_pass {
+    node_visitor_t pre_visitors[NUM_OF_NODE_TYPES];   /*!< Pre-order visitors per node type */
+    node_visitor_t post_visitors[NUM_OF_NODE_TYPES];  /*!< Post-order visitors per node type */
+    node_visitor_t default_pre_visitor;     /*!< Visitor called before the children of any other node */
+    node_visitor_t default_post_visitor;    /*!< Visitor called after the children of any other node */
+} tree_pass_t;
+
+
+/*
+ * =====================================================================================================================
+ *                                                function declarations
+ * =====================================================================================================================
+ */
+
+/**
+ * \brief                               Return number of child slots of a node
+ * \note                                Child slots are counted in source order and include optional children that are
+ *                                      absent (e.g., a missing else-branch, a constant array index or a constant entry
+ *                                      of an initializer list), for which get_child() returns `NULL`
+ * \param[in]                           node: Pointer to node
+ * \return                              Number of child slots of the node
+ */
+unsigned get_num_of_children(const node_t *node);
+
+/**
+ * \brief                               Return child of a node
+ * \param[in]                           node: Pointer to node
+ * \param[in]                           index: Index of child slot (less than get_num_of_children())
+ * \return                              Pointer to child or `NULL` if the child slot is empty
+ */
+node_t *get_child(const node_t *node, unsigned index);
+
+/**
+ * \brief                               Run a tree pass over a tree without recursion
+ * \note                                Every node is visited by the pre-order visitor for its node type, then its
+ *                                      children are walked in source order, then it is visited by the post-order
+ *                                      visitor for its node type; pending nodes are kept on an explicit, heap-allocated
+ *                                      stack, so arbitrarily deep trees can be walked
+ * \param[in]                           pass: Pointer to tree pass
+ * \param[in,out]                       root: Pointer to root node of the tree (nothing is visited if `NULL`)
+ * \param[in]                           depth: Layer depth of root node
+ * \param[in,out]                       data: Pointer passed to every call of a node visitor
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether running the tree pass was successful (stopping early is a success)
+ */
+bool run_tree_pass(const tree_pass_t *pass, node_t *root, size_t depth, void *data, char error_msg[ERROR_MSG_LENGTH]);
+
+/**
+ * \brief                               Visit every node of a tree in pre-order without recursion
+ * \note                                Children are visited in source order; this is a shorthand for a tree pass with
+ *                                      a single default pre-order visitor
+ * \param[in]                           root: Pointer to root node of the tree to be walked (nothing is visited if
+ *                                      `NULL`)
+ * \param[in]                           depth: Layer depth of root node
+ * \param[in]                           visitor: Function called for every node; returning `false` stops the walk
+ * \param[in,out]                       data: Pointer passed to every call of the visitor
+ * \param[out]                          error_msg: Message to be written in case of an error
+ * \return                              Whether every node was visited (`false` if the visitor stopped the walk or
+ *                                      upon failure)
+ */
+bool walk_tree(const node_t *root, size_t depth, tree_visitor_t visitor, void *data,
+               char error_msg[ERROR_MSG_LENGTH]);
+
+
+/*
+ * =====================================================================================================================
+ *                                                closing C++ check & header guard
+ * =====================================================================================================================
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* VISITOR_H */